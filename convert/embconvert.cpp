@@ -0,0 +1,343 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <glob.h>
+
+#include "emb-path-data.h"
+#include "emb-pattern.h"
+#include "emb-reader-writer.h"
+#include "emb-stream.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Batch converter: converts many designs at once on all cores.
+//
+//   embconvert <input> <output>
+//   embconvert [-j threads] -m <manifest>
+//   embconvert [-j threads] -f <format> [-o <directory>] <file|directory|glob>...
+//
+// A manifest has one conversion per line, "<input> <output>", separated by a
+// tab if either path contains spaces. Blank lines and lines starting with #
+// are skipped.
+
+struct Job {
+  string input;
+  string output;
+};
+
+/** Returns true if libembroidery has a reader for the extension of fname. */
+static bool readable(const fs::path& fname) {
+  string ext = fname.extension().string();
+  if (ext.size() < 2 || ext.size() > 4) {
+    return false;
+  }
+  EmbReaderWriter* rw = embReaderWriter_getByFileName(fname.string().c_str());
+  bool result = rw && rw->reader;
+  free(rw);
+  return result;
+}
+
+// Sidecar color files
+
+/** Answers embPattern_loadExternalColorFile()'s existence checks from one
+ *  listing per directory, so converting a directory of DSTs costs one scan
+ *  rather than four failed opens per design. Every directory is listed by
+ *  list() before any job starts, so color files written during the batch,
+ *  by this run's own jobs or anyone else, are never seen and the result does
+ *  not depend on which job ran first. Lookups only read, from any thread. */
+class SidecarCache {
+ public:
+  void list(const string& fname) {
+    string dir = fs::path(fname).parent_path().string();
+    if (dirs_.count(dir)) {
+      return;
+    }
+    unordered_set<string>& names = dirs_[dir];
+    error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir.empty() ? "." : dir, ec)) {
+      string ext = entry.path().extension().string();
+      if (ext == ".edr" || ext == ".rgb" || ext == ".col" || ext == ".inf") {
+        names.insert(entry.path().filename().string());
+      }
+    }
+  }
+
+  bool exists(const string& fname) const {
+    fs::path path(fname);
+    auto it = dirs_.find(path.parent_path().string());
+    if (it == dirs_.end()) {
+      return true;  // not listed, let the reader try to open it
+    }
+    return it->second.count(path.filename().string()) > 0;
+  }
+
+  static int probe(const char* fname, void* data) {
+    return static_cast<const SidecarCache*>(data)->exists(fname);
+  }
+
+ private:
+  unordered_map<string, unordered_set<string>> dirs_;
+};
+
+// Work-stealing pool
+
+/** Runs every job on one of `threads` workers. Each worker takes jobs from
+ *  the front of its own queue and, once that is empty, steals from the back
+ *  of the others', so a worker that drew a run of large designs does not hold
+ *  up the rest. */
+class WorkStealingPool {
+ public:
+  explicit WorkStealingPool(unsigned threads) : queues_(threads) {}
+
+  template <typename F>
+  void run(size_t jobs, F work) {
+    for (size_t i = 0; i < jobs; i++) {
+      queues_[i % queues_.size()].jobs.push_back(i);
+    }
+    vector<thread> workers;
+    for (size_t w = 0; w < queues_.size(); w++) {
+      workers.emplace_back([this, w, &work] {
+        size_t job;
+        while (take(w, job)) {
+          work(job);
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+ private:
+  struct Queue {
+    mutex lock;
+    deque<size_t> jobs;
+  };
+
+  bool take(size_t w, size_t& job) {
+    {
+      lock_guard<mutex> lock(queues_[w].lock);
+      if (!queues_[w].jobs.empty()) {
+        job = queues_[w].jobs.front();
+        queues_[w].jobs.pop_front();
+        return true;
+      }
+    }
+    // No job adds more jobs, so once every queue is empty the work is done.
+    for (size_t i = 1; i < queues_.size(); i++) {
+      Queue& victim = queues_[(w + i) % queues_.size()];
+      lock_guard<mutex> lock(victim.lock);
+      if (!victim.jobs.empty()) {
+        job = victim.jobs.back();
+        victim.jobs.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  vector<Queue> queues_;
+};
+
+// Flattening long paths
+
+/** Runs the blocks of a long path given to embPathData_flatten() on up to
+ *  `*data` threads, the calling one included. */
+static void flattenInParallel(int count, void (*work)(void*, int), void* arg, void* data) {
+  unsigned threads = min<unsigned>(*static_cast<unsigned*>(data), count);
+  atomic<int> next{0};
+  auto run = [&] {
+    for (int i; (i = next++) < count;) {
+      work(arg, i);
+    }
+  };
+  vector<thread> helpers;
+  for (unsigned t = 1; t < threads; t++) {
+    helpers.emplace_back(run);
+  }
+  run();
+  for (auto& helper : helpers) {
+    helper.join();
+  }
+}
+
+// Building the job list
+
+static bool readManifest(const string& fname, vector<Job>& jobs) {
+  ifstream in(fname);
+  if (!in) {
+    cerr << "embconvert: cannot open manifest " << fname << endl;
+    return false;
+  }
+  string line;
+  int lineno = 0;
+  while (getline(in, line)) {
+    lineno++;
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    size_t start = line.find_first_not_of(" \t");
+    if (start == string::npos || line[start] == '#') {
+      continue;
+    }
+    Job job;
+    size_t tab = line.find('\t', start);
+    if (tab != string::npos) {
+      job.input = line.substr(start, tab - start);
+      size_t output = line.find_first_not_of('\t', tab);
+      if (output != string::npos) {
+        job.output = line.substr(output);
+      }
+    } else {
+      istringstream fields(line);
+      fields >> job.input >> job.output;
+    }
+    if (job.input.empty() || job.output.empty()) {
+      cerr << "embconvert: " << fname << ":" << lineno << ": expected <input> <output>" << endl;
+      return false;
+    }
+    jobs.push_back(job);
+  }
+  return true;
+}
+
+/** Adds a job converting every design named by arg (a file, a directory or a
+ *  glob pattern) to format, written to outdir or next to the design. */
+static void addInputs(const string& arg, const string& format, const string& outdir, vector<Job>& jobs) {
+  vector<fs::path> inputs;
+  error_code ec;
+  if (fs::is_directory(arg, ec)) {
+    for (const auto& entry : fs::directory_iterator(arg, ec)) {
+      if (entry.is_regular_file(ec) && readable(entry.path())) {
+        inputs.push_back(entry.path());
+      }
+    }
+    sort(inputs.begin(), inputs.end());
+  } else if (arg.find_first_of("*?[") != string::npos) {
+    glob_t matches;
+    if (glob(arg.c_str(), 0, nullptr, &matches) == 0) {
+      for (size_t i = 0; i < matches.gl_pathc; i++) {
+        if (readable(matches.gl_pathv[i])) {
+          inputs.push_back(matches.gl_pathv[i]);
+        }
+      }
+    }
+    globfree(&matches);
+  } else {
+    inputs.push_back(arg);
+  }
+
+  for (const auto& input : inputs) {
+    fs::path output = outdir.empty() ? input.parent_path() : fs::path(outdir);
+    output /= input.stem().string() + "." + format;
+    jobs.push_back(Job{input.string(), output.string()});
+  }
+}
+
+static void usage() {
+  cerr << "usage: embconvert <input> <output>\n"
+       << "       embconvert [-j threads] -m <manifest>\n"
+       << "       embconvert [-j threads] -f <format> [-o <directory>] <file|directory|glob>...\n";
+}
+
+int main(int argc, char* argv[]) {
+  unsigned threads = max(1u, thread::hardware_concurrency());
+  string manifest, format, outdir;
+  vector<string> args;
+
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if ((arg == "-j" || arg == "-m" || arg == "-f" || arg == "-o") && i + 1 < argc) {
+      string value = argv[++i];
+      if (arg == "-j") threads = max(1, atoi(value.c_str()));
+      if (arg == "-m") manifest = value;
+      if (arg == "-f") format = value[0] == '.' ? value.substr(1) : value;
+      if (arg == "-o") outdir = value;
+    } else if (!arg.empty() && arg[0] == '-') {
+      usage();
+      return 2;
+    } else {
+      args.push_back(arg);
+    }
+  }
+
+  vector<Job> jobs;
+  if (!manifest.empty()) {
+    if (!readManifest(manifest, jobs)) {
+      return 2;
+    }
+  } else if (!format.empty()) {
+    for (const auto& arg : args) {
+      addInputs(arg, format, outdir, jobs);
+    }
+  } else if (args.size() == 2) {
+    jobs.push_back(Job{args[0], args[1]});
+  } else {
+    usage();
+    return 2;
+  }
+  if (jobs.empty()) {
+    cerr << "embconvert: nothing to convert" << endl;
+    return 1;
+  }
+  if (!outdir.empty()) {
+    error_code ec;
+    fs::create_directories(outdir, ec);
+  }
+
+  SidecarCache sidecars;
+  for (const auto& job : jobs) {
+    sidecars.list(job.input);
+  }
+  // Threads that have no design of their own help flatten long paths instead
+  unsigned pathThreads = threads / jobs.size();
+  EmbReadOptions readOptions = {SidecarCache::probe, &sidecars, 0, 0};
+  if (pathThreads > 1) {
+    readOptions.parallelFor = flattenInParallel;
+    readOptions.parallelForData = &pathThreads;
+  }
+
+  mutex report;
+  atomic<size_t> failed{0};
+  atomic<uintmax_t> bytes{0};
+  auto start = chrono::steady_clock::now();
+
+  WorkStealingPool pool(min<size_t>(threads, jobs.size()));
+  pool.run(jobs.size(), [&](size_t i) {
+    const Job& job = jobs[i];
+    auto begin = chrono::steady_clock::now();
+    bool ok = embStream_convert(job.input.c_str(), job.output.c_str(), &readOptions);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+    error_code ec;
+    uintmax_t size = fs::file_size(job.input, ec);
+    if (!ec) {
+      bytes += size;
+    }
+    if (!ok) {
+      failed++;
+    }
+    lock_guard<mutex> lock(report);
+    printf("%s %s -> %s (%.1f ms)\n", ok ? "ok    " : "FAILED", job.input.c_str(), job.output.c_str(), ms);
+  });
+
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  printf("converted %zu of %zu files in %.2f s: %.1f files/s, %.2f MB/s read\n",
+         jobs.size() - failed, jobs.size(), seconds, jobs.size() / seconds,
+         bytes / (1024.0 * 1024.0) / seconds);
+  return failed ? 1 : 0;
+}
@@ -9,7 +9,7 @@
 #include <string.h>
 #include <stdlib.h>
 
-static unsigned int sizeOfDirectoryEntry = 128;
+static const unsigned int sizeOfDirectoryEntry = 128;
 
 static unsigned int sectorSize(bcf_file* bcfFile)
 {
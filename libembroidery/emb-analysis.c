@@ -0,0 +1,341 @@
+#include "emb-analysis.h"
+#include "emb-logging.h"
+#include "helpers-misc.h"
+#include <math.h>
+#include <stdlib.h>
+
+/* What one block of stitches adds to the analysis. */
+typedef struct EmbAnalysisBlock_
+{
+    int sewnCount;
+    int jumpCount;
+    int trimCount;
+    int stopCount;
+    int colorChangeCount;
+    EmbRect extents;
+    double sewLength;
+    double jumpLength;
+    double longestStitch;
+    int longestStitchIndex;
+    double longestJump;
+    int longestJumpIndex;
+    int longStitchCount;
+    int firstLongStitch;
+    int longJumpCount;
+    int firstLongJump;
+    EmbColorAnalysis* colors; /* colorCount entries of its own, so blocks never share a sum */
+} EmbAnalysisBlock;
+
+typedef struct EmbAnalysisJob_
+{
+    const EmbStitch* stitches;
+    int count;
+    int colorCount;
+    const EmbMachineLimits* limits;
+    EmbAnalysisBlock* blocks;
+} EmbAnalysisJob;
+
+static void embPattern_analyzeBlock(void* arg, int block)
+{
+    const EmbAnalysisJob* job = (const EmbAnalysisJob*)arg;
+    EmbAnalysisBlock* b = &(job->blocks[block]);
+    const EmbStitch* s;
+    const EmbStitch* prev;
+    int i = block * EMB_ANALYSIS_BLOCK;
+    int last = i + EMB_ANALYSIS_BLOCK;
+    double length;
+
+    if(last > job->count)
+        last = job->count;
+    for(; i < last; i++)
+    {
+        s = &(job->stitches[i]);
+        if(s->flags & JUMP) b->jumpCount++;
+        if(s->flags & TRIM) b->trimCount++;
+        if(s->flags & STOP) b->stopCount++;
+        if(!(s->flags & TRIM))
+        {
+            b->extents.left = (double)min(b->extents.left, s->xx);
+            b->extents.top = (double)min(b->extents.top, s->yy);
+            b->extents.right = (double)max(b->extents.right, s->xx);
+            b->extents.bottom = (double)max(b->extents.bottom, s->yy);
+        }
+        if(i > 0 && s->color != job->stitches[i - 1].color)
+            b->colorChangeCount++;
+        if(s->flags & (STOP | END))
+            continue;
+
+        length = 0.0;
+        if(i > 0)
+        {
+            prev = &(job->stitches[i - 1]);
+            length = sqrt((s->xx - prev->xx) * (s->xx - prev->xx) + (s->yy - prev->yy) * (s->yy - prev->yy));
+        }
+        if(s->flags & (JUMP | TRIM))
+        {
+            b->jumpLength += length;
+            if(b->longestJumpIndex < 0 || length > b->longestJump)
+            {
+                b->longestJump = length;
+                b->longestJumpIndex = i;
+            }
+            if(job->limits->maxJumpLength > 0.0 && length > job->limits->maxJumpLength)
+            {
+                if(!b->longJumpCount) b->firstLongJump = i;
+                b->longJumpCount++;
+            }
+            continue;
+        }
+
+        b->sewnCount++;
+        b->sewLength += length;
+        if(b->longestStitchIndex < 0 || length > b->longestStitch)
+        {
+            b->longestStitch = length;
+            b->longestStitchIndex = i;
+        }
+        if(job->limits->maxStitchLength > 0.0 && length > job->limits->maxStitchLength)
+        {
+            if(!b->longStitchCount) b->firstLongStitch = i;
+            b->longStitchCount++;
+        }
+        if(s->color >= 0 && s->color < job->colorCount)
+        {
+            b->colors[s->color].stitchCount++;
+            b->colors[s->color].threadLength += length;
+        }
+    }
+}
+
+static void embPatternAnalysis_init(EmbPatternAnalysis* analysis)
+{
+    analysis->stitchCount = 0;
+    analysis->sewnCount = 0;
+    analysis->jumpCount = 0;
+    analysis->trimCount = 0;
+    analysis->stopCount = 0;
+    analysis->colorChangeCount = 0;
+    analysis->extents.left = 99999.0;
+    analysis->extents.top = 99999.0;
+    analysis->extents.right = -99999.0;
+    analysis->extents.bottom = -99999.0;
+    analysis->sewLength = 0.0;
+    analysis->jumpLength = 0.0;
+    analysis->longestStitch = 0.0;
+    analysis->longestStitchIndex = -1;
+    analysis->longestJump = 0.0;
+    analysis->longestJumpIndex = -1;
+    analysis->colors = 0;
+    analysis->colorCount = 0;
+    analysis->limits.maxStitchLength = 0.0;
+    analysis->limits.maxJumpLength = 0.0;
+    analysis->limits.maxStitchCount = 0;
+    analysis->longStitchCount = 0;
+    analysis->firstLongStitch = -1;
+    analysis->longJumpCount = 0;
+    analysis->firstLongJump = -1;
+    analysis->tooManyStitches = 0;
+}
+
+/*! Fills (\a analysis) with the counts, lengths and extents of the stitches of the pattern (\a p) and with how they
+ *  break (\a limits), which may be null to check none. Everything is gathered in one walk over the stitches. Patterns
+ *  of at least EMB_ANALYSIS_PARALLEL_STITCHES stitches are handed to (\a parallelFor), if it is not 0, in blocks of
+ *  EMB_ANALYSIS_BLOCK stitches, and it is called with (\a parallelForData), as in embPathData_flatten(). The blocks are
+ *  always added up in the same order, so the result does not depend on the number of threads.
+ *  Free (\a analysis) with embPatternAnalysis_free() afterwards.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int embPattern_analyze(EmbPattern* p, const EmbMachineLimits* limits, EmbParallelFor parallelFor, void* parallelForData, EmbPatternAnalysis* analysis)
+{
+    EmbAnalysisJob job;
+    EmbAnalysisBlock* blocks = 0;
+    EmbColorAnalysis* blockColors = 0;
+    EmbMachineLimits noLimits;
+    int blockCount, i, c;
+
+    if(!p) { embLog_error("emb-analysis.c embPattern_analyze(), p argument is null\n"); return 0; }
+    if(!analysis) { embLog_error("emb-analysis.c embPattern_analyze(), analysis argument is null\n"); return 0; }
+
+    embPatternAnalysis_init(analysis);
+    if(!limits)
+    {
+        noLimits = analysis->limits;
+        limits = &noLimits;
+    }
+    analysis->limits = *limits;
+    analysis->stitchCount = embStitchList_count(p->stitchList);
+    analysis->tooManyStitches = limits->maxStitchCount > 0 && analysis->stitchCount > limits->maxStitchCount;
+    if(analysis->stitchCount == 0)
+        return 1;
+
+    analysis->colorCount = embPattern_stats(p)->maxColorIndex + 1;
+    blockCount = (analysis->stitchCount + EMB_ANALYSIS_BLOCK - 1) / EMB_ANALYSIS_BLOCK;
+    analysis->colors = (EmbColorAnalysis*)calloc((size_t)analysis->colorCount, sizeof(EmbColorAnalysis));
+    blocks = (EmbAnalysisBlock*)malloc(sizeof(EmbAnalysisBlock) * (size_t)blockCount);
+    blockColors = (EmbColorAnalysis*)calloc((size_t)blockCount * (size_t)analysis->colorCount, sizeof(EmbColorAnalysis));
+    if(!analysis->colors || !blocks || !blockColors)
+    {
+        embLog_error("emb-analysis.c embPattern_analyze(), cannot allocate memory for %d blocks of %d colors\n", blockCount, analysis->colorCount);
+        free(blocks);
+        free(blockColors);
+        embPatternAnalysis_free(analysis);
+        return 0;
+    }
+
+    for(i = 0; i < blockCount; i++)
+    {
+        EmbAnalysisBlock* b = &(blocks[i]);
+        b->sewnCount = b->jumpCount = b->trimCount = b->stopCount = b->colorChangeCount = 0;
+        b->extents = analysis->extents;
+        b->sewLength = b->jumpLength = b->longestStitch = b->longestJump = 0.0;
+        b->longestStitchIndex = b->longestJumpIndex = -1;
+        b->longStitchCount = b->longJumpCount = 0;
+        b->firstLongStitch = b->firstLongJump = -1;
+        b->colors = blockColors + (size_t)i * (size_t)analysis->colorCount;
+    }
+
+    job.stitches = p->stitchList->stitch;
+    job.count = analysis->stitchCount;
+    job.colorCount = analysis->colorCount;
+    job.limits = limits;
+    job.blocks = blocks;
+    if(parallelFor && job.count >= EMB_ANALYSIS_PARALLEL_STITCHES)
+        parallelFor(blockCount, embPattern_analyzeBlock, &job, parallelForData);
+    else
+        for(i = 0; i < blockCount; i++)
+            embPattern_analyzeBlock(&job, i);
+
+    for(i = 0; i < blockCount; i++)
+    {
+        const EmbAnalysisBlock* b = &(blocks[i]);
+        analysis->sewnCount += b->sewnCount;
+        analysis->jumpCount += b->jumpCount;
+        analysis->trimCount += b->trimCount;
+        analysis->stopCount += b->stopCount;
+        analysis->colorChangeCount += b->colorChangeCount;
+        analysis->extents.left = (double)min(analysis->extents.left, b->extents.left);
+        analysis->extents.top = (double)min(analysis->extents.top, b->extents.top);
+        analysis->extents.right = (double)max(analysis->extents.right, b->extents.right);
+        analysis->extents.bottom = (double)max(analysis->extents.bottom, b->extents.bottom);
+        analysis->sewLength += b->sewLength;
+        analysis->jumpLength += b->jumpLength;
+        /* Strictly longer only, so a tie keeps the earlier stitch as it would in a single walk */
+        if(b->longestStitchIndex >= 0 && (analysis->longestStitchIndex < 0 || b->longestStitch > analysis->longestStitch))
+        {
+            analysis->longestStitch = b->longestStitch;
+            analysis->longestStitchIndex = b->longestStitchIndex;
+        }
+        if(b->longestJumpIndex >= 0 && (analysis->longestJumpIndex < 0 || b->longestJump > analysis->longestJump))
+        {
+            analysis->longestJump = b->longestJump;
+            analysis->longestJumpIndex = b->longestJumpIndex;
+        }
+        if(b->longStitchCount && !analysis->longStitchCount) analysis->firstLongStitch = b->firstLongStitch;
+        if(b->longJumpCount && !analysis->longJumpCount) analysis->firstLongJump = b->firstLongJump;
+        analysis->longStitchCount += b->longStitchCount;
+        analysis->longJumpCount += b->longJumpCount;
+        for(c = 0; c < analysis->colorCount; c++)
+        {
+            analysis->colors[c].stitchCount += b->colors[c].stitchCount;
+            analysis->colors[c].threadLength += b->colors[c].threadLength;
+        }
+    }
+    for(c = 0; c < analysis->colorCount; c++)
+    {
+        analysis->colors[c].hasThread = c < embThreadList_count(p->threadList);
+        if(analysis->colors[c].hasThread)
+            analysis->colors[c].thread = p->threadList->thread[c].color;
+    }
+
+    free(blocks);
+    free(blockColors);
+    return 1;
+}
+
+/*! Frees the memory held by (\a analysis), leaving it empty. */
+void embPatternAnalysis_free(EmbPatternAnalysis* analysis)
+{
+    if(!analysis) return;
+    free(analysis->colors);
+    analysis->colors = 0;
+    analysis->colorCount = 0;
+}
+
+/*! Returns the number of ways in which the pattern of (\a analysis) breaks its machine limits: the number of
+ *  stitches and jumps that are too long, plus one if it has too many stitches. 0 means it can be sewn as it is. */
+int embPatternAnalysis_violationCount(const EmbPatternAnalysis* analysis)
+{
+    if(!analysis) { embLog_error("emb-analysis.c embPatternAnalysis_violationCount(), analysis argument is null\n"); return 0; }
+    return analysis->longStitchCount + analysis->longJumpCount + analysis->tooManyStitches;
+}
+
+/* Writes the JSON member (name) with the value (length) to (file), followed by (after). JSON has no number
+ * for an infinity or NaN, which stitches at such positions give, so those are written as null. */
+static void embPatternAnalysis_writeLength(EmbFile* file, const char* name, double length, const char* after)
+{
+    if(length - length == 0.0) /* false only if length is not finite */
+        embFile_printf(file, "\"%s\":%.3f%s", name, length, after);
+    else
+        embFile_printf(file, "\"%s\":null%s", name, after);
+}
+
+/*! Writes (\a analysis) to (\a file) as one line of JSON, lengths in mm to the nearest micron.
+ *  Limits that were not checked are written as null, as are the extents of a pattern with no stitches,
+ *  the thread of a color the pattern has none for and lengths that are infinite or NaN.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int embPatternAnalysis_writeJson(const EmbPatternAnalysis* analysis, EmbFile* file)
+{
+    const EmbMachineLimits* limits;
+    int i;
+
+    if(!analysis) { embLog_error("emb-analysis.c embPatternAnalysis_writeJson(), analysis argument is null\n"); return 0; }
+    if(!file) { embLog_error("emb-analysis.c embPatternAnalysis_writeJson(), file argument is null\n"); return 0; }
+
+    embFile_printf(file, "{\"stitchCount\":%d,\"sewnCount\":%d,\"jumpCount\":%d,\"trimCount\":%d,\"stopCount\":%d,\"colorChangeCount\":%d,",
+                   analysis->stitchCount, analysis->sewnCount, analysis->jumpCount, analysis->trimCount,
+                   analysis->stopCount, analysis->colorChangeCount);
+    if(analysis->extents.left <= analysis->extents.right)
+    {
+        embFile_printf(file, "\"extents\":{");
+        embPatternAnalysis_writeLength(file, "left", analysis->extents.left, ",");
+        embPatternAnalysis_writeLength(file, "top", analysis->extents.top, ",");
+        embPatternAnalysis_writeLength(file, "right", analysis->extents.right, ",");
+        embPatternAnalysis_writeLength(file, "bottom", analysis->extents.bottom, "},");
+    }
+    else
+        embFile_printf(file, "\"extents\":null,");
+    embPatternAnalysis_writeLength(file, "sewLength", analysis->sewLength, ",");
+    embPatternAnalysis_writeLength(file, "jumpLength", analysis->jumpLength, ",");
+    embFile_printf(file, "\"longestStitch\":{");
+    embPatternAnalysis_writeLength(file, "length", analysis->longestStitch, ",");
+    embFile_printf(file, "\"index\":%d},\"longestJump\":{", analysis->longestStitchIndex);
+    embPatternAnalysis_writeLength(file, "length", analysis->longestJump, ",");
+    embFile_printf(file, "\"index\":%d},", analysis->longestJumpIndex);
+
+    embFile_printf(file, "\"colors\":[");
+    for(i = 0; i < analysis->colorCount; i++)
+    {
+        const EmbColorAnalysis* color = &(analysis->colors[i]);
+        embFile_printf(file, "%s{\"index\":%d,\"stitchCount\":%d,", i ? "," : "", i, color->stitchCount);
+        embPatternAnalysis_writeLength(file, "threadLength", color->threadLength, ",");
+        if(color->hasThread)
+            embFile_printf(file, "\"thread\":\"#%02x%02x%02x\"}", color->thread.r, color->thread.g, color->thread.b);
+        else
+            embFile_printf(file, "\"thread\":null}");
+    }
+    embFile_printf(file, "],");
+
+    limits = &(analysis->limits);
+    embFile_printf(file, "\"limits\":{");
+    if(limits->maxStitchLength > 0.0) embPatternAnalysis_writeLength(file, "maxStitchLength", limits->maxStitchLength, ",");
+    else embFile_printf(file, "\"maxStitchLength\":null,");
+    if(limits->maxJumpLength > 0.0) embPatternAnalysis_writeLength(file, "maxJumpLength", limits->maxJumpLength, ",");
+    else embFile_printf(file, "\"maxJumpLength\":null,");
+    if(limits->maxStitchCount > 0) embFile_printf(file, "\"maxStitchCount\":%d},", limits->maxStitchCount);
+    else embFile_printf(file, "\"maxStitchCount\":null},");
+    embFile_printf(file, "\"violations\":{\"longStitches\":{\"count\":%d,\"first\":%d},\"longJumps\":{\"count\":%d,\"first\":%d},\"tooManyStitches\":%s}}\n",
+                   analysis->longStitchCount, analysis->firstLongStitch, analysis->longJumpCount, analysis->firstLongJump,
+                   analysis->tooManyStitches ? "true" : "false");
+    return 1;
+}
+
+/* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -0,0 +1,78 @@
+/*! @file emb-analysis.h */
+#ifndef EMB_ANALYSIS_H
+#define EMB_ANALYSIS_H
+
+#include "emb-color.h"
+#include "emb-file.h"
+#include "emb-path-data.h"
+#include "emb-pattern.h"
+#include "emb-rect.h"
+
+#include "api-start.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EMB_ANALYSIS_PARALLEL_STITCHES 65536 /* patterns with fewer stitches are always analyzed on the calling thread */
+#define EMB_ANALYSIS_BLOCK             16384 /* stitches summed by one work item, whether run in parallel or not */
+
+/* What the machine a design is meant for can sew. A limit of 0 is not checked. */
+typedef struct EmbMachineLimits_
+{
+    double maxStitchLength; /* longest sewn stitch, in mm */
+    double maxJumpLength;   /* longest single jump or trim move, in mm */
+    int maxStitchCount;     /* most stitches, control stitches included */
+} EmbMachineLimits;
+
+/* The stitches sewn in one color of a pattern. */
+typedef struct EmbColorAnalysis_
+{
+    int stitchCount;       /* sewn stitches */
+    double threadLength;   /* length of the sewn stitches in mm, with no allowance for tie-offs or the bobbin */
+    int hasThread;         /* 0 if the pattern has no thread for this color index */
+    EmbColor thread;
+} EmbColorAnalysis;
+
+/* Everything embPattern_analyze() finds out about the stitches of a pattern.
+ * A stitch is sewn if it has none of JUMP, TRIM, STOP or END set; its length
+ * is the distance from the stitch before it. */
+typedef struct EmbPatternAnalysis_
+{
+    int stitchCount;
+    int sewnCount;
+    int jumpCount;            /* stitches with JUMP set */
+    int trimCount;            /* stitches with TRIM set */
+    int stopCount;            /* stitches with STOP set */
+    int colorChangeCount;     /* stitches whose color differs from the one before */
+    EmbRect extents;          /* bounding box of the stitches that are not TRIMs, empty as in EmbPatternStats if there are none */
+    double sewLength;         /* total length of the sewn stitches in mm */
+    double jumpLength;        /* total length of the JUMP and TRIM moves in mm */
+    double longestStitch;     /* longest sewn stitch in mm */
+    int longestStitchIndex;   /* -1 if nothing is sewn */
+    double longestJump;       /* longest JUMP or TRIM move in mm */
+    int longestJumpIndex;     /* -1 if there are none */
+
+    EmbColorAnalysis* colors; /* indexed by the color of the stitches */
+    int colorCount;
+
+    EmbMachineLimits limits;  /* the limits the rest is checked against */
+    int longStitchCount;      /* sewn stitches longer than limits.maxStitchLength */
+    int firstLongStitch;      /* -1 if there are none */
+    int longJumpCount;        /* JUMP and TRIM moves longer than limits.maxJumpLength */
+    int firstLongJump;        /* -1 if there are none */
+    int tooManyStitches;      /* stitchCount is above limits.maxStitchCount */
+} EmbPatternAnalysis;
+
+extern EMB_PUBLIC int EMB_CALL embPattern_analyze(EmbPattern* p, const EmbMachineLimits* limits, EmbParallelFor parallelFor, void* parallelForData, EmbPatternAnalysis* analysis);
+extern EMB_PUBLIC void EMB_CALL embPatternAnalysis_free(EmbPatternAnalysis* analysis);
+extern EMB_PUBLIC int EMB_CALL embPatternAnalysis_violationCount(const EmbPatternAnalysis* analysis);
+extern EMB_PUBLIC int EMB_CALL embPatternAnalysis_writeJson(const EmbPatternAnalysis* analysis, EmbFile* file);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#include "api-stop.h"
+
+#endif /* EMB_ANALYSIS_H */
+
+/* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -0,0 +1,120 @@
+#include "emb-arena.h"
+#include "emb-logging.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef union EmbArenaAlign_
+{
+    double d;
+    long l;
+    void* p;
+} EmbArenaAlign;
+
+#define EMB_ARENA_ALIGN(n) (((n) + sizeof(EmbArenaAlign) - 1) / sizeof(EmbArenaAlign) * sizeof(EmbArenaAlign))
+#define EMB_ARENA_HEADER   EMB_ARENA_ALIGN(sizeof(EmbArenaChunk))
+
+/*! Prepares the empty arena (\a arena). Chunks of (\a chunkSize) bytes are allocated as they are needed;
+ *  0 selects EMB_ARENA_DEFAULT_CHUNK. */
+void embArena_init(EmbArena* arena, size_t chunkSize)
+{
+    if(!arena) { embLog_error("emb-arena.c embArena_init(), arena argument is null\n"); return; }
+    arena->first = 0;
+    arena->current = 0;
+    arena->chunkSize = chunkSize ? chunkSize : EMB_ARENA_DEFAULT_CHUNK;
+}
+
+/*! Returns (\a size) bytes from (\a arena), suitably aligned for any type, or 0 if memory cannot be allocated.
+ *  The memory stays valid until the arena is reset or freed. */
+void* embArena_alloc(EmbArena* arena, size_t size)
+{
+    EmbArenaChunk* chunk = 0;
+    size_t chunkSize;
+
+    if(!arena) { embLog_error("emb-arena.c embArena_alloc(), arena argument is null\n"); return 0; }
+    size = EMB_ARENA_ALIGN(size ? size : 1);
+
+    chunk = arena->current;
+    if(chunk && chunk->size - chunk->used >= size)
+    {
+        chunk->used += size;
+        return (char*)chunk + EMB_ARENA_HEADER + chunk->used - size;
+    }
+
+    /* Chunks after the current one are left over from before a reset */
+    if(chunk && chunk->next && chunk->next->size >= size)
+    {
+        chunk = chunk->next;
+    }
+    else
+    {
+        EmbArenaChunk* grown = 0;
+        chunkSize = size > arena->chunkSize ? size : arena->chunkSize;
+        grown = (EmbArenaChunk*)malloc(EMB_ARENA_HEADER + chunkSize);
+        if(!grown) { embLog_error("emb-arena.c embArena_alloc(), cannot allocate memory for chunk\n"); return 0; }
+        grown->size = chunkSize;
+        grown->used = 0;
+        if(chunk)
+        {
+            grown->next = chunk->next;
+            chunk->next = grown;
+        }
+        else
+        {
+            grown->next = arena->first;
+            arena->first = grown;
+        }
+        chunk = grown;
+    }
+    arena->current = chunk;
+    chunk->used = size;
+    return (char*)chunk + EMB_ARENA_HEADER;
+}
+
+/*! Returns a copy of the string (\a src) allocated from (\a arena), or 0 on error. */
+char* embArena_strdup(EmbArena* arena, const char* src)
+{
+    if(!src) { embLog_error("emb-arena.c embArena_strdup(), src argument is null\n"); return 0; }
+    return embArena_strndup(arena, src, strlen(src));
+}
+
+/*! Returns a null terminated copy of the first (\a length) bytes of (\a src) allocated from (\a arena), or 0 on error. */
+char* embArena_strndup(EmbArena* arena, const char* src, size_t length)
+{
+    char* dest = 0;
+    if(!src) { embLog_error("emb-arena.c embArena_strndup(), src argument is null\n"); return 0; }
+    dest = (char*)embArena_alloc(arena, length + 1);
+    if(!dest) return 0;
+    memcpy(dest, src, length);
+    dest[length] = 0;
+    return dest;
+}
+
+/*! Discards everything allocated from (\a arena) while keeping its chunks for reuse. */
+void embArena_reset(EmbArena* arena)
+{
+    EmbArenaChunk* chunk = 0;
+    if(!arena) { embLog_error("emb-arena.c embArena_reset(), arena argument is null\n"); return; }
+    for(chunk = arena->first; chunk; chunk = chunk->next)
+    {
+        chunk->used = 0;
+    }
+    arena->current = arena->first;
+}
+
+/*! Frees every chunk of (\a arena), leaving it empty and ready for reuse. */
+void embArena_free(EmbArena* arena)
+{
+    EmbArenaChunk* chunk = 0;
+    if(!arena) { embLog_error("emb-arena.c embArena_free(), arena argument is null\n"); return; }
+    chunk = arena->first;
+    while(chunk)
+    {
+        EmbArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->first = 0;
+    arena->current = 0;
+}
+
+/* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -0,0 +1,47 @@
+/*! @file emb-arena.h */
+#ifndef EMB_ARENA_H
+#define EMB_ARENA_H
+
+#include <stddef.h>
+
+#include "api-start.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EMB_ARENA_DEFAULT_CHUNK 4096
+
+typedef struct EmbArenaChunk_
+{
+    struct EmbArenaChunk_* next;
+    size_t size; /* bytes available after the chunk header */
+    size_t used;
+} EmbArenaChunk;
+
+/* Bump allocator for data that lives exactly as long as its owner, such as
+ * the object lists and strings of a pattern. Allocations are carved from a
+ * list of chunks and are never freed individually; embArena_reset() makes the
+ * chunks available again without returning them to the system, and
+ * embArena_free() releases them all at once. */
+typedef struct EmbArena_
+{
+    EmbArenaChunk* first;
+    EmbArenaChunk* current;
+    size_t chunkSize;
+} EmbArena;
+
+extern EMB_PUBLIC void EMB_CALL embArena_init(EmbArena* arena, size_t chunkSize);
+extern EMB_PUBLIC void* EMB_CALL embArena_alloc(EmbArena* arena, size_t size);
+extern EMB_PUBLIC char* EMB_CALL embArena_strdup(EmbArena* arena, const char* src);
+extern EMB_PUBLIC char* EMB_CALL embArena_strndup(EmbArena* arena, const char* src, size_t length);
+extern EMB_PUBLIC void EMB_CALL embArena_reset(EmbArena* arena);
+extern EMB_PUBLIC void EMB_CALL embArena_free(EmbArena* arena);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#include "api-stop.h"
+
+#endif /* EMB_ARENA_H */
+
+/* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
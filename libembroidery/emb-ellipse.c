@@ -58,6 +58,7 @@ EmbEllipseObject embEllipseObject_make(double cx, double cy, double rx, double r
     stackEllipseObj.ellipse.centerY = cy;
     stackEllipseObj.ellipse.radiusX = rx;
     stackEllipseObj.ellipse.radiusY = ry;
+    stackEllipseObj.rotation = 0.0;
     return stackEllipseObj;
 }
 
@@ -70,6 +71,7 @@ EmbEllipseObject* embEllipseObject_create(double cx, double cy, double rx, doubl
     heapEllipseObj->ellipse.centerY = cy;
     heapEllipseObj->ellipse.radiusX = rx;
     heapEllipseObj->ellipse.radiusY = ry;
+    heapEllipseObj->rotation = 0.0;
     return heapEllipseObj;
 }
 
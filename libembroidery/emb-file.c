@@ -1,18 +1,181 @@
 #include "emb-file.h"
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
 
+#if !defined(ARDUINO) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__)))
+#define EMB_FILE_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Files at least this big are mapped rather than read into a buffer, where
+ * the cost of setting up the mapping is repaid. */
+#define EMB_FILE_MMAP_MIN (64 * 1024)
+
+/* Initial size of the buffer behind embFile_openBuffer(), enough for most designs in one go */
+#define EMB_FILE_BUFFER_MIN 4096
+
+#ifndef ARDUINO
+static EmbFile* embFile_alloc(int backend)
+{
+    EmbFile* eFile = (EmbFile*)malloc(sizeof(EmbFile));
+    if(!eFile)
+        return 0;
+    eFile->file = 0;
+    eFile->data = 0;
+    eFile->size = 0;
+    eFile->capacity = 0;
+    eFile->pos = 0;
+    eFile->eof = 0;
+    eFile->backend = backend;
+    return eFile;
+}
+
+/* Only plain read-only opens are served from memory. Windows text mode
+ * translates line endings, which reading the raw bytes would not do. */
+static int embFile_isReadOnly(const char* mode)
+{
+    if(!mode || mode[0] != 'r' || strchr(mode, '+'))
+        return 0;
+#ifdef _WIN32
+    if(!strchr(mode, 'b'))
+        return 0;
+#endif
+    return 1;
+}
+
+/* Reads or maps the whole of (fileName) into (eFile).
+ * Returns 0 if the file should be opened with stdio instead. */
+static int embFile_load(EmbFile* eFile, const char* fileName)
+{
+#ifdef EMB_FILE_POSIX
+    struct stat st;
+    size_t got = 0;
+    int fd = open(fileName, O_RDONLY);
+    if(fd < 0)
+        return 0;
+    if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        close(fd);
+        return 0;
+    }
+    eFile->size = (size_t)st.st_size;
+
+    if(eFile->size >= EMB_FILE_MMAP_MIN)
+    {
+        void* mapped = mmap(0, eFile->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapped != MAP_FAILED)
+        {
+            close(fd);
+            eFile->data = (unsigned char*)mapped;
+            eFile->backend = EMB_FILE_MAPPED;
+            return 1;
+        }
+    }
+
+    eFile->data = (unsigned char*)malloc(eFile->size ? eFile->size : 1);
+    if(!eFile->data)
+    {
+        close(fd);
+        return 0;
+    }
+    while(got < eFile->size)
+    {
+        ssize_t n = read(fd, eFile->data + got, eFile->size - got);
+        if(n <= 0)
+            break;
+        got += (size_t)n;
+    }
+    close(fd);
+    eFile->size = got;
+    eFile->backend = EMB_FILE_BUFFER;
+    return 1;
+#else /* EMB_FILE_POSIX */
+    long length;
+    FILE* oFile = fopen(fileName, "rb");
+    if(!oFile)
+        return 0;
+    if(fseek(oFile, 0, SEEK_END) != 0 || (length = ftell(oFile)) < 0 || fseek(oFile, 0, SEEK_SET) != 0)
+    {
+        fclose(oFile);
+        return 0;
+    }
+    eFile->data = (unsigned char*)malloc(length ? (size_t)length : 1);
+    if(!eFile->data)
+    {
+        fclose(oFile);
+        return 0;
+    }
+    eFile->size = fread(eFile->data, 1, (size_t)length, oFile);
+    fclose(oFile);
+    eFile->backend = EMB_FILE_BUFFER;
+    return 1;
+#endif /* EMB_FILE_POSIX */
+}
+
+/* Makes room in the EMB_FILE_MEMORY file (stream) for (count) bytes at the current position.
+ * Bytes between the old end and the position, left by seeking past the end, read as zero. */
+static int embFile_reserve(EmbFile* stream, size_t count)
+{
+    size_t needed = stream->pos + count;
+    if(needed > stream->capacity)
+    {
+        size_t capacity = stream->capacity ? stream->capacity : EMB_FILE_BUFFER_MIN;
+        unsigned char* grown = 0;
+        while(capacity < needed)
+            capacity *= 2;
+        grown = (unsigned char*)realloc(stream->data, capacity);
+        if(!grown)
+            return 0;
+        stream->data = grown;
+        stream->capacity = capacity;
+    }
+    if(stream->pos > stream->size)
+        memset(stream->data + stream->size, 0, stream->pos - stream->size);
+    return 1;
+}
+
+/* Writes (count) bytes at the current position of the EMB_FILE_MEMORY file (stream), overwriting or extending it. */
+static size_t embFile_writeMemory(EmbFile* stream, const void* ptr, size_t count)
+{
+    if(!embFile_reserve(stream, count))
+        return 0;
+    memcpy(stream->data + stream->pos, ptr, count);
+    stream->pos += count;
+    if(stream->pos > stream->size)
+        stream->size = stream->pos;
+    return count;
+}
+#endif /* ARDUINO */
+
+/*! Opens the file (\a fileName) with the fopen() (\a mode). Files opened for reading only are
+ *  read into memory, or mapped when large, so that reading them costs no system calls. */
 EmbFile* embFile_open(const char* fileName, const char* mode)
 {
 #ifdef ARDUINO
     return inoFile_open(fileName, mode);
 #else
     EmbFile* eFile = 0;
-    FILE* oFile = fopen(fileName, mode);
+    FILE* oFile = 0;
+
+    if(embFile_isReadOnly(mode))
+    {
+        eFile = embFile_alloc(EMB_FILE_BUFFER);
+        if(!eFile)
+            return 0;
+        if(embFile_load(eFile, fileName))
+            return eFile;
+        free(eFile);
+    }
+
+    oFile = fopen(fileName, mode);
     if(!oFile)
         return 0;
 
-    eFile = (EmbFile*)malloc(sizeof(EmbFile));
+    eFile = embFile_alloc(EMB_FILE_STDIO);
     if(!eFile)
     {
         fclose(oFile);
@@ -24,12 +187,120 @@ EmbFile* embFile_open(const char* fileName, const char* mode)
 #endif
 }
 
+/*! Opens the (\a size) bytes at (\a data) as a read-only file. The bytes are not copied
+ *  and must stay valid until the file is closed. Returns 0 on error. */
+EmbFile* embFile_openMemory(const void* data, size_t size)
+{
+#ifdef ARDUINO
+    return 0; /* ARDUINO TODO: Implement memory backed files. */
+#else /* ARDUINO */
+    EmbFile* eFile = 0;
+    if(!data && size)
+        return 0;
+    eFile = embFile_alloc(EMB_FILE_VIEW);
+    if(!eFile)
+        return 0;
+    eFile->data = (unsigned char*)data;
+    eFile->size = size;
+    return eFile;
+#endif /* ARDUINO */
+}
+
+/*! Returns an empty file held in a growable memory buffer. It can be written, read and seeked like a
+ *  file opened with "w+b", so writers can patch earlier offsets. Hand the contents over with
+ *  embFile_release() or write them out with embFile_save(). Returns 0 on error. */
+EmbFile* embFile_openBuffer(void)
+{
+#ifdef ARDUINO
+    return 0; /* ARDUINO TODO: Implement memory backed files. */
+#else /* ARDUINO */
+    EmbFile* eFile = embFile_alloc(EMB_FILE_MEMORY);
+    if(!eFile)
+        return 0;
+    eFile->data = (unsigned char*)malloc(EMB_FILE_BUFFER_MIN);
+    if(!eFile->data)
+    {
+        free(eFile);
+        return 0;
+    }
+    eFile->capacity = EMB_FILE_BUFFER_MIN;
+    return eFile;
+#endif /* ARDUINO */
+}
+
+/*! Closes the memory file (\a stream) and returns its contents, storing their length in (\a size).
+ *  The caller is responsible for freeing the returned buffer with free(). Returns 0 on error. */
+unsigned char* embFile_release(EmbFile* stream, size_t* size)
+{
+#ifdef ARDUINO
+    if(size) *size = 0;
+    return 0;
+#else /* ARDUINO */
+    unsigned char* data = 0;
+    if(size) *size = 0;
+    if(!stream || stream->backend != EMB_FILE_MEMORY)
+        return 0;
+    data = stream->data;
+    if(size) *size = stream->size;
+    free(stream);
+    return data;
+#endif /* ARDUINO */
+}
+
+/*! Writes the whole contents of the memory file (\a stream) to (\a fileName) with a single write,
+ *  opening it with the fopen() (\a mode). Returns \c true if successful, otherwise returns \c false. */
+int embFile_save(EmbFile* stream, const char* fileName, const char* mode)
+{
+#ifdef ARDUINO
+    return 0;
+#else /* ARDUINO */
+    FILE* oFile = 0;
+    int ok;
+    if(!stream || stream->backend == EMB_FILE_STDIO || !fileName || !mode)
+        return 0;
+    oFile = fopen(fileName, mode);
+    if(!oFile)
+        return 0;
+    ok = fwrite(stream->data, 1, stream->size, oFile) == stream->size;
+    if(fclose(oFile) != 0)
+        ok = 0;
+    return ok;
+#endif /* ARDUINO */
+}
+
+/*! Returns a pointer to the unread contents of (\a stream) and stores their length in (\a length),
+ *  letting a reader decode straight from memory. Advance past what was consumed with embFile_seek().
+ *  Returns 0 if (\a stream) is not held in memory, in which case it has to be read normally. */
+const unsigned char* embFile_view(EmbFile* stream, size_t* length)
+{
+#ifdef ARDUINO
+    if(length) *length = 0;
+    return 0;
+#else /* ARDUINO */
+    if(length) *length = 0;
+    if(!stream || stream->backend == EMB_FILE_STDIO)
+        return 0;
+    if(stream->pos >= stream->size)
+        return stream->data + stream->size;
+    if(length) *length = stream->size - stream->pos;
+    return stream->data + stream->pos;
+#endif /* ARDUINO */
+}
+
 int embFile_close(EmbFile* stream)
 {
 #ifdef ARDUINO
     return inoFile_close(stream);
 #else /* ARDUINO */
-    int retVal = fclose(stream->file);
+    int retVal = 0;
+    if(stream->backend == EMB_FILE_STDIO)
+        retVal = fclose(stream->file);
+#ifdef EMB_FILE_POSIX
+    else if(stream->backend == EMB_FILE_MAPPED)
+        retVal = munmap(stream->data, stream->size);
+#endif /* EMB_FILE_POSIX */
+    else if(stream->backend == EMB_FILE_BUFFER || stream->backend == EMB_FILE_MEMORY)
+        free(stream->data);
     free(stream);
     stream = 0;
     return retVal;
@@ -41,6 +312,8 @@ int embFile_eof(EmbFile* stream)
 #ifdef ARDUINO
     return inoFile_eof(stream);
 #else /* ARDUINO */
+    if(stream->backend != EMB_FILE_STDIO)
+        return stream->eof;
     return feof(stream->file);
 #endif /* ARDUINO */
 }
@@ -50,6 +323,13 @@ int embFile_getc(EmbFile* stream)
 #ifdef ARDUINO
     return inoFile_getc(stream);
 #else /* ARDUINO */
+    if(stream->backend != EMB_FILE_STDIO)
+    {
+        if(stream->pos < stream->size)
+            return stream->data[stream->pos++];
+        stream->eof = 1;
+        return EOF;
+    }
     return fgetc(stream->file);
 #endif /* ARDUINO */
 }
@@ -59,6 +339,21 @@ size_t embFile_read(void* ptr, size_t size, size_t nmemb, EmbFile* stream)
 #ifdef ARDUINO
     return 0; /* ARDUINO TODO: SD File read() doesn't appear to return the same way as fread(). This will need work. */
 #else /* ARDUINO */
+    if(stream->backend != EMB_FILE_STDIO)
+    {
+        size_t bytes = size * nmemb;
+        size_t avail = stream->pos < stream->size ? stream->size - stream->pos : 0;
+        if(!size || !nmemb)
+            return 0;
+        if(bytes > avail)
+        {
+            bytes = avail;
+            stream->eof = 1;
+        }
+        memcpy(ptr, stream->data + stream->pos, bytes);
+        stream->pos += bytes;
+        return bytes / size;
+    }
     return fread(ptr, size, nmemb, stream->file);
 #endif /* ARDUINO */
 }
@@ -68,6 +363,10 @@ size_t embFile_write(const void* ptr, size_t size, size_t nmemb, EmbFile* stream
 #ifdef ARDUINO
     return 0; /* ARDUINO TODO: Implement inoFile_write. */
 #else /* ARDUINO */
+    if(stream->backend == EMB_FILE_MEMORY)
+        return size ? embFile_writeMemory(stream, ptr, size * nmemb) / size : 0;
+    if(stream->backend != EMB_FILE_STDIO)
+        return 0; /* the other memory backed files are read-only */
     return fwrite(ptr, size, nmemb, stream->file);
 #endif /* ARDUINO */
 }
@@ -77,6 +376,19 @@ int embFile_seek(EmbFile* stream, long offset, int origin)
 #ifdef ARDUINO
     return inoFile_seek(stream, offset, origin);
 #else /* ARDUINO */
+    if(stream->backend != EMB_FILE_STDIO)
+    {
+        long base;
+        if(origin == SEEK_SET)      base = 0;
+        else if(origin == SEEK_CUR) base = (long)stream->pos;
+        else if(origin == SEEK_END) base = (long)stream->size;
+        else return -1;
+        if(base + offset < 0)
+            return -1;
+        stream->pos = (size_t)(base + offset);
+        stream->eof = 0;
+        return 0;
+    }
     return fseek(stream->file, offset, origin);
 #endif /* ARDUINO */
 }
@@ -86,6 +398,8 @@ long embFile_tell(EmbFile* stream)
 #ifdef ARDUINO
     return inoFile_tell(stream);
 #else /* ARDUINO */
+    if(stream->backend != EMB_FILE_STDIO)
+        return (long)stream->pos;
     return ftell(stream->file);
 #endif /* ARDUINO */
 }
@@ -100,7 +414,7 @@ EmbFile* embFile_tmpfile(void)
     if(!tFile)
         return 0;
 
-    eFile = (EmbFile*)malloc(sizeof(EmbFile));
+    eFile = embFile_alloc(EMB_FILE_STDIO);
     if(!eFile)
     {
         fclose(tFile);
@@ -117,6 +431,13 @@ int embFile_putc(int ch, EmbFile* stream)
 #ifdef ARDUINO
     return inoFile_putc(ch, stream);
 #else /* ARDUINO */
+    if(stream->backend == EMB_FILE_MEMORY)
+    {
+        unsigned char c = (unsigned char)ch;
+        return embFile_writeMemory(stream, &c, 1) ? c : EOF;
+    }
+    if(stream->backend != EMB_FILE_STDIO)
+        return EOF; /* the other memory backed files are read-only */
     return fputc(ch, stream->file);
 #endif /* ARDUINO */
 }
@@ -133,6 +454,32 @@ int embFile_printf(EmbFile* stream, const char* format, ...)
 #else /* ARDUINO */
     int retVal;
     va_list args;
+    if(stream->backend == EMB_FILE_MEMORY)
+    {
+        char buff[256];
+        char* out = buff;
+        va_start(args, format);
+        retVal = vsnprintf(buff, sizeof(buff), format, args);
+        va_end(args);
+        if(retVal < 0)
+            return retVal;
+        if((size_t)retVal >= sizeof(buff))
+        {
+            out = (char*)malloc((size_t)retVal + 1);
+            if(!out)
+                return -1;
+            va_start(args, format);
+            vsnprintf(out, (size_t)retVal + 1, format, args);
+            va_end(args);
+        }
+        if(embFile_writeMemory(stream, out, (size_t)retVal) != (size_t)retVal)
+            retVal = -1;
+        if(out != buff)
+            free(out);
+        return retVal;
+    }
+    if(stream->backend != EMB_FILE_STDIO)
+        return -1; /* the other memory backed files are read-only */
     va_start(args, format);
     retVal = vfprintf(stream->file, format, args);
     va_end(args);
@@ -12,13 +12,31 @@ extern "C" {
 #ifdef ARDUINO
 #include "utility/ino-file.h"
 #else
+/* Where the data of an EmbFile lives */
+#define EMB_FILE_STDIO  0 /* a FILE*, used for writing and when a file cannot be read into memory */
+#define EMB_FILE_BUFFER 1 /* the whole file read into a heap buffer owned by the EmbFile */
+#define EMB_FILE_MAPPED 2 /* the whole file mapped read-only with mmap() */
+#define EMB_FILE_VIEW   3 /* a caller's buffer, see embFile_openMemory() */
+#define EMB_FILE_MEMORY 4 /* a growable heap buffer that can also be written, see embFile_openBuffer() */
+
 typedef struct EmbFile_
 {
-    FILE* file;
+    FILE* file;          /* EMB_FILE_STDIO only */
+    unsigned char* data; /* the other backends: the contents of the file */
+    size_t size;
+    size_t capacity;     /* EMB_FILE_MEMORY only: bytes allocated for data */
+    size_t pos;
+    int eof;
+    int backend;
 } EmbFile;
 #endif /* ARDUINO */
 
 extern EMB_PUBLIC EmbFile* EMB_CALL embFile_open(const char* fileName, const char* mode);
+extern EMB_PUBLIC EmbFile* EMB_CALL embFile_openMemory(const void* data, size_t size);
+extern EMB_PUBLIC EmbFile* EMB_CALL embFile_openBuffer(void);
+extern EMB_PUBLIC unsigned char* EMB_CALL embFile_release(EmbFile* stream, size_t* size);
+extern EMB_PUBLIC int EMB_CALL embFile_save(EmbFile* stream, const char* fileName, const char* mode);
+extern EMB_PUBLIC const unsigned char* EMB_CALL embFile_view(EmbFile* stream, size_t* length);
 extern EMB_PUBLIC int EMB_CALL embFile_close(EmbFile* stream);
 extern EMB_PUBLIC int EMB_CALL embFile_eof(EmbFile* stream);
 extern EMB_PUBLIC int EMB_CALL embFile_getc(EmbFile* stream);
@@ -0,0 +1,270 @@
+#include "emb-palette.h"
+#include "emb-logging.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define EMB_PALETTE_MIN_CACHE 64
+
+static double embPalette_srgbToLinear(unsigned char value)
+{
+    double c = value / 255.0;
+    if(c <= 0.04045)
+        return c / 12.92;
+    return pow((c + 0.055) / 1.055, 2.4);
+}
+
+static double embPalette_labF(double t)
+{
+    if(t > 216.0 / 24389.0)
+        return pow(t, 1.0 / 3.0);
+    return (24389.0 / 27.0 * t + 16.0) / 116.0;
+}
+
+/* Converts (color) to the coordinates matching is done in. */
+static void embPalette_toCoords(int metric, EmbColor color, double* out)
+{
+    double r, g, b, fx, fy, fz;
+
+    if(metric != EMB_PALETTE_CIELAB)
+    {
+        out[0] = color.r;
+        out[1] = color.g;
+        out[2] = color.b;
+        return;
+    }
+    r = embPalette_srgbToLinear(color.r);
+    g = embPalette_srgbToLinear(color.g);
+    b = embPalette_srgbToLinear(color.b);
+    /* sRGB to XYZ, normalized by the D65 white point */
+    fx = embPalette_labF((0.4124564 * r + 0.3575761 * g + 0.1804375 * b) / 0.95047);
+    fy = embPalette_labF( 0.2126729 * r + 0.7151522 * g + 0.0721750 * b);
+    fz = embPalette_labF((0.0193339 * r + 0.1191920 * g + 0.9503041 * b) / 1.08883);
+    out[0] = 116.0 * fy - 16.0;
+    out[1] = 500.0 * (fx - fy);
+    out[2] = 200.0 * (fy - fz);
+}
+
+/* Orders palette entries along (axis), breaking ties by index so the tree is deterministic. */
+static int embPalette_less(const EmbPalette* p, int a, int b, int axis)
+{
+    double ca = p->coords[a * 3 + axis];
+    double cb = p->coords[b * 3 + axis];
+    if(ca != cb)
+        return ca < cb;
+    return a < b;
+}
+
+/* Partially sorts tree[lo, hi) so that tree[k] holds the entry that belongs there along (axis). */
+static void embPalette_select(EmbPalette* p, int lo, int hi, int k, int axis)
+{
+    int* t = p->tree;
+    while(hi - lo > 1)
+    {
+        int i, store = lo, tmp, pivot;
+        int mid = lo + (hi - lo) / 2;
+        tmp = t[mid]; t[mid] = t[hi - 1]; t[hi - 1] = tmp;
+        pivot = t[hi - 1];
+        for(i = lo; i < hi - 1; i++)
+        {
+            if(embPalette_less(p, t[i], pivot, axis))
+            {
+                tmp = t[i]; t[i] = t[store]; t[store] = tmp;
+                store++;
+            }
+        }
+        tmp = t[store]; t[store] = t[hi - 1]; t[hi - 1] = tmp;
+        if(store == k) return;
+        if(k < store) hi = store;
+        else lo = store + 1;
+    }
+}
+
+static void embPalette_build(EmbPalette* p, int lo, int hi, int depth)
+{
+    int mid;
+    if(hi - lo <= 1) return;
+    mid = lo + (hi - lo) / 2;
+    embPalette_select(p, lo, hi, mid, depth % 3);
+    embPalette_build(p, lo, mid, depth + 1);
+    embPalette_build(p, mid + 1, hi, depth + 1);
+}
+
+static double embPalette_distance(const EmbPalette* p, const double* q, int index)
+{
+    const double* c = &(p->coords[index * 3]);
+    double d0 = q[0] - c[0];
+    double d1 = q[1] - c[1];
+    double d2 = q[2] - c[2];
+    return d0 * d0 + d1 * d1 + d2 * d2;
+}
+
+/* Equal distances go to the later palette entry, as in embThread_findNearestColorInArray(). */
+static void embPalette_search(const EmbPalette* p, int lo, int hi, int depth, const double* q, int* best, double* bestDist)
+{
+    int mid, index, axis;
+    double d, diff;
+
+    if(lo >= hi) return;
+    mid = lo + (hi - lo) / 2;
+    index = p->tree[mid];
+    axis = depth % 3;
+
+    d = embPalette_distance(p, q, index);
+    if(*best < 0 || d < *bestDist || (d == *bestDist && index > *best))
+    {
+        *best = index;
+        *bestDist = d;
+    }
+
+    diff = q[axis] - p->coords[index * 3 + axis];
+    if(diff < 0)
+    {
+        embPalette_search(p, lo, mid, depth + 1, q, best, bestDist);
+        if(diff * diff <= *bestDist)
+            embPalette_search(p, mid + 1, hi, depth + 1, q, best, bestDist);
+    }
+    else
+    {
+        embPalette_search(p, mid + 1, hi, depth + 1, q, best, bestDist);
+        if(diff * diff <= *bestDist)
+            embPalette_search(p, lo, mid, depth + 1, q, best, bestDist);
+    }
+}
+
+static unsigned int embPalette_hash(unsigned int key)
+{
+    return key * 2654435761u;
+}
+
+static int embPalette_growCache(EmbPalette* p)
+{
+    int i, size = p->cache ? (p->cacheMask + 1) * 2 : EMB_PALETTE_MIN_CACHE;
+    EmbPaletteCacheEntry* old = p->cache;
+    int oldSize = p->cache ? p->cacheMask + 1 : 0;
+    EmbPaletteCacheEntry* grown = (EmbPaletteCacheEntry*)calloc((size_t)size, sizeof(EmbPaletteCacheEntry));
+
+    if(!grown) { embLog_error("emb-palette.c embPalette_growCache(), cannot allocate memory for cache\n"); return 0; }
+    p->cache = grown;
+    p->cacheMask = size - 1;
+    for(i = 0; i < oldSize; i++)
+    {
+        if(old[i].key)
+        {
+            unsigned int slot = embPalette_hash(old[i].key) & (unsigned int)p->cacheMask;
+            while(grown[slot].key)
+                slot = (slot + 1) & (unsigned int)p->cacheMask;
+            grown[slot] = old[i];
+        }
+    }
+    free(old);
+    return 1;
+}
+
+/*! Returns a matcher for the (\a count) threads in (\a threads), comparing colors with (\a metric)
+ *  (EMB_PALETTE_RGB or EMB_PALETTE_CIELAB). (\a threads) is not copied and must outlive the matcher.
+ *  The caller is responsible for freeing the matcher with embPalette_free(). */
+EmbPalette* embPalette_create(const EmbThread* threads, int count, int metric)
+{
+    int i;
+    EmbPalette* p = 0;
+
+    if(!threads || count <= 0) { embLog_error("emb-palette.c embPalette_create(), palette is empty\n"); return 0; }
+    p = (EmbPalette*)malloc(sizeof(EmbPalette));
+    if(!p) { embLog_error("emb-palette.c embPalette_create(), cannot allocate memory for p\n"); return 0; }
+    p->threads = threads;
+    p->count = count;
+    p->metric = metric;
+    p->coords = (double*)malloc(sizeof(double) * 3 * (size_t)count);
+    p->tree = (int*)malloc(sizeof(int) * (size_t)count);
+    p->cache = 0;
+    p->cacheUsed = 0;
+    p->cacheMask = 0;
+    if(!p->coords || !p->tree || !embPalette_growCache(p))
+    {
+        embLog_error("emb-palette.c embPalette_create(), cannot allocate memory for the palette index\n");
+        embPalette_free(p);
+        return 0;
+    }
+    for(i = 0; i < count; i++)
+    {
+        embPalette_toCoords(metric, threads[i].color, &(p->coords[i * 3]));
+        p->tree[i] = i;
+    }
+    embPalette_build(p, 0, count, 0);
+    return p;
+}
+
+void embPalette_free(EmbPalette* palette)
+{
+    if(!palette) return;
+    free(palette->coords);
+    free(palette->tree);
+    free(palette->cache);
+    free(palette);
+}
+
+/*! Returns the index of the palette entry nearest to (\a color), or -1 on error. */
+int embPalette_nearest(EmbPalette* palette, EmbColor color)
+{
+    unsigned int key, slot;
+    int best = -1;
+    double bestDist = 0.0;
+    double q[3];
+
+    if(!palette) { embLog_error("emb-palette.c embPalette_nearest(), palette argument is null\n"); return -1; }
+
+    key = ((unsigned int)color.r << 16 | (unsigned int)color.g << 8 | color.b) + 1;
+    slot = embPalette_hash(key) & (unsigned int)palette->cacheMask;
+    while(palette->cache[slot].key)
+    {
+        if(palette->cache[slot].key == key)
+            return palette->cache[slot].index;
+        slot = (slot + 1) & (unsigned int)palette->cacheMask;
+    }
+
+    embPalette_toCoords(palette->metric, color, q);
+    embPalette_search(palette, 0, palette->count, 0, q, &best, &bestDist);
+
+    if((palette->cacheUsed + 1) * 2 > palette->cacheMask + 1)
+    {
+        if(!embPalette_growCache(palette))
+            return best;
+        slot = embPalette_hash(key) & (unsigned int)palette->cacheMask;
+        while(palette->cache[slot].key)
+            slot = (slot + 1) & (unsigned int)palette->cacheMask;
+    }
+    palette->cache[slot].key = key;
+    palette->cache[slot].index = best;
+    palette->cacheUsed++;
+    return best;
+}
+
+/*! Maps each of the (\a count) colors in (\a colors) to its nearest palette entry, storing the results in (\a indices).
+ *  Returns \c true if successful, otherwise returns \c false. */
+int embPalette_mapColors(EmbPalette* palette, const EmbColor* colors, int count, int* indices)
+{
+    int i;
+
+    if(!palette || !colors || !indices) { embLog_error("emb-palette.c embPalette_mapColors(), invalid argument\n"); return 0; }
+    for(i = 0; i < count; i++)
+    {
+        indices[i] = embPalette_nearest(palette, colors[i]);
+    }
+    return 1;
+}
+
+/*! Maps every thread of (\a list) to its nearest palette entry. (\a indices) must have room for
+ *  embThreadList_count(\a list) entries. Returns \c true if successful, otherwise returns \c false. */
+int embPalette_mapThreadList(EmbPalette* palette, EmbThreadList* list, int* indices)
+{
+    int i;
+
+    if(!palette || !list || !indices) { embLog_error("emb-palette.c embPalette_mapThreadList(), invalid argument\n"); return 0; }
+    for(i = 0; i < list->count; i++)
+    {
+        indices[i] = embPalette_nearest(palette, list->thread[i].color);
+    }
+    return 1;
+}
+
+/* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
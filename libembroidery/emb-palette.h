@@ -0,0 +1,54 @@
+/*! @file emb-palette.h */
+#ifndef EMB_PALETTE_H
+#define EMB_PALETTE_H
+
+#include "emb-color.h"
+#include "emb-thread.h"
+
+#include "api-start.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* How the distance between two colors is measured when matching. */
+#define EMB_PALETTE_RGB    0 /* euclidean distance in RGB, as embThread_findNearestColorInArray() */
+#define EMB_PALETTE_CIELAB 1 /* CIE76 delta E, euclidean distance in CIELAB (D65) */
+
+typedef struct EmbPaletteCacheEntry_
+{
+    unsigned int key; /* 0x00RRGGBB + 1, 0 marks an unused slot */
+    int index;
+} EmbPaletteCacheEntry;
+
+/* Nearest-color matcher for one fixed palette, such as the PEC or JEF thread
+ * charts. The palette is indexed by a k-d tree when it is created, and every
+ * source color that has been matched is remembered, so mapping the colors of
+ * a design costs a hash lookup per color once they have been seen. */
+typedef struct EmbPalette_
+{
+    const EmbThread* threads; /* the palette, not owned */
+    int count;
+    int metric;
+
+    double* coords;           /* 3 coordinates per palette entry in the chosen metric's space */
+    int* tree;                /* palette indices, arranged as an implicit balanced k-d tree */
+
+    EmbPaletteCacheEntry* cache;
+    int cacheUsed;
+    int cacheMask;
+} EmbPalette;
+
+extern EMB_PUBLIC EmbPalette* EMB_CALL embPalette_create(const EmbThread* threads, int count, int metric);
+extern EMB_PUBLIC void EMB_CALL embPalette_free(EmbPalette* palette);
+extern EMB_PUBLIC int EMB_CALL embPalette_nearest(EmbPalette* palette, EmbColor color);
+extern EMB_PUBLIC int EMB_CALL embPalette_mapColors(EmbPalette* palette, const EmbColor* colors, int count, int* indices);
+extern EMB_PUBLIC int EMB_CALL embPalette_mapThreadList(EmbPalette* palette, EmbThreadList* list, int* indices);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#include "api-stop.h"
+
+#endif /* EMB_PALETTE_H */
+
+/* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -0,0 +1,545 @@
+#include "emb-path-data.h"
+#include "emb-logging.h"
+#include "helpers-misc.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define EMB_PATH_DATA_MIN_CAPACITY 64
+#define EMB_PATH_PI 3.14159265358979323846
+
+/**************************************************/
+/* EmbPathData                                    */
+/**************************************************/
+
+void embPathData_init(EmbPathData* data)
+{
+    if(!data) { embLog_error("emb-path-data.c embPathData_init(), data argument is null\n"); return; }
+    data->segments = 0;
+    data->count = 0;
+    data->capacity = 0;
+}
+
+/*! Removes every segment from (\a data) but keeps its storage for the next path. */
+void embPathData_clear(EmbPathData* data)
+{
+    if(!data) return;
+    data->count = 0;
+}
+
+void embPathData_free(EmbPathData* data)
+{
+    if(!data) return;
+    free(data->segments);
+    embPathData_init(data);
+}
+
+/* Appends a segment of (type) from (start) to (end), returning it so the caller can fill in the rest, or 0 if out of memory. */
+static EmbPathSegment* embPathData_add(EmbPathData* data, int type, EmbPoint start, EmbPoint end)
+{
+    EmbPathSegment* s = 0;
+
+    if(data->count == data->capacity)
+    {
+        int capacity = data->capacity * 2;
+        EmbPathSegment* grown = 0;
+        if(capacity < EMB_PATH_DATA_MIN_CAPACITY)
+            capacity = EMB_PATH_DATA_MIN_CAPACITY;
+        grown = (EmbPathSegment*)realloc(data->segments, sizeof(EmbPathSegment) * (size_t)capacity);
+        if(!grown) { embLog_error("emb-path-data.c embPathData_add(), cannot allocate memory for %d segments\n", capacity); return 0; }
+        data->segments = grown;
+        data->capacity = capacity;
+    }
+    s = &(data->segments[data->count++]);
+    s->type = type;
+    s->start = start;
+    s->control1 = start;
+    s->control2 = end;
+    s->end = end;
+    s->rotation = 0.0;
+    s->startAngle = 0.0;
+    s->sweep = 0.0;
+    return s;
+}
+
+/* Appends the elliptical arc of the SVG 'A' command from (start) to (end), converted to center parameterization
+ * as described in the SVG 1.1 implementation notes (F.6.5 and F.6.6). Returns the type of segment added, or 0. */
+static int embPathData_addArc(EmbPathData* data, EmbPoint start, double rx, double ry, double degrees,
+                              int largeArc, int sweep, EmbPoint end)
+{
+    EmbPathSegment* s = 0;
+    double phi, cosPhi, sinPhi, dx, dy, x1, y1, lambda, num, den, coef, cx, cy, ux, uy, vx, vy, theta, delta;
+
+    if(start.xx == end.xx && start.yy == end.yy)
+        return 0; /* the arc is omitted entirely */
+    rx = fabs(rx);
+    ry = fabs(ry);
+    if(rx == 0.0 || ry == 0.0)
+        return embPathData_add(data, LINETO, start, end) ? LINETO : 0;
+
+    phi = fmod(degrees, 360.0) * EMB_PATH_PI / 180.0;
+    cosPhi = cos(phi);
+    sinPhi = sin(phi);
+    dx = (start.xx - end.xx) / 2.0;
+    dy = (start.yy - end.yy) / 2.0;
+    x1 = cosPhi * dx + sinPhi * dy;
+    y1 = -sinPhi * dx + cosPhi * dy;
+
+    /* Scale radii that are too small to reach the end point up just enough */
+    lambda = (x1 * x1) / (rx * rx) + (y1 * y1) / (ry * ry);
+    if(lambda > 1.0)
+    {
+        rx *= sqrt(lambda);
+        ry *= sqrt(lambda);
+    }
+
+    num = rx * rx * ry * ry - rx * rx * y1 * y1 - ry * ry * x1 * x1;
+    den = rx * rx * y1 * y1 + ry * ry * x1 * x1;
+    coef = (num > 0.0 && den > 0.0) ? sqrt(num / den) : 0.0;
+    if(largeArc == sweep)
+        coef = -coef;
+    cx = coef * rx * y1 / ry;
+    cy = -coef * ry * x1 / rx;
+
+    ux = (x1 - cx) / rx;
+    uy = (y1 - cy) / ry;
+    vx = (-x1 - cx) / rx;
+    vy = (-y1 - cy) / ry;
+    theta = atan2(uy, ux);
+    delta = atan2(ux * vy - uy * vx, ux * vx + uy * vy);
+    if(!sweep && delta > 0.0)
+        delta -= 2.0 * EMB_PATH_PI;
+    else if(sweep && delta < 0.0)
+        delta += 2.0 * EMB_PATH_PI;
+
+    s = embPathData_add(data, ELLIPSETOEND, start, end);
+    if(!s) return 0;
+    s->control1 = embPoint_make(cosPhi * cx - sinPhi * cy + (start.xx + end.xx) / 2.0,
+                                sinPhi * cx + cosPhi * cy + (start.yy + end.yy) / 2.0);
+    s->control2 = embPoint_make(rx, ry);
+    s->rotation = phi;
+    s->startAngle = theta;
+    s->sweep = delta;
+    return ELLIPSETOEND;
+}
+
+#define EMB_PATH_IS_SEPARATOR(c) ((c) == ' ' || (c) == '\t' || (c) == '\r' || (c) == '\n' || (c) == ',')
+
+static const char* embPathData_skip(const char* p, const char* end)
+{
+    while(p < end && EMB_PATH_IS_SEPARATOR(*p))
+        p++;
+    return p;
+}
+
+/* Returns how many numbers follow the path command (cmd), or -1 if it is not a command. */
+static int embPathData_argumentCount(char cmd)
+{
+    switch(cmd)
+    {
+        case 'Z': case 'z': return 0;
+        case 'H': case 'h': case 'V': case 'v': return 1;
+        case 'M': case 'm': case 'L': case 'l': case 'T': case 't': return 2;
+        case 'S': case 's': case 'Q': case 'q': return 4;
+        case 'C': case 'c': return 6;
+        case 'A': case 'a': return 7;
+    }
+    return -1;
+}
+
+/* Reads the (count) arguments of (cmd) starting at (p) into (args). The large-arc and sweep flags of an arc are
+ * single digits that need not be separated from what follows. Returns the end of the arguments, or 0 if they are not all there. */
+static const char* embPathData_readArguments(const char* p, const char* end, char cmd, double* args, int count)
+{
+    const char* next = 0;
+    int i;
+
+    for(i = 0; i < count; i++)
+    {
+        p = embPathData_skip(p, end);
+        if((cmd == 'A' || cmd == 'a') && (i == 3 || i == 4))
+        {
+            if(p == end || (*p != '0' && *p != '1'))
+                return 0;
+            args[i] = *p++ - '0';
+            continue;
+        }
+        next = emb_fromChars(p, end, &args[i]);
+        if(next == p)
+            return 0;
+        p = next;
+    }
+    return p;
+}
+
+/*! Parses the (\a length) characters of SVG path data at (\a pathData), the value of a path's d attribute, and
+ *  appends its segments to (\a data) in absolute coordinates. Relative, shorthand, smooth and closing commands are
+ *  resolved here, so every segment is one of the types EmbPathSegment lists. Parsing stops at the first error, keeping
+ *  the segments before it as SVG renderers do.
+ *  Returns \c true if the whole of the path data was read, otherwise returns \c false. */
+int embPathData_parse(EmbPathData* data, const char* pathData, size_t length)
+{
+    const char* p = pathData;
+    const char* end = pathData + length;
+    const char* next = 0;
+    EmbPoint current = embPoint_make(0.0, 0.0);
+    EmbPoint subpathStart = current;
+    EmbPoint lastControl = current;
+    EmbPoint base, c1, c2, to;
+    EmbPathSegment* s = 0;
+    int lastType = 0;
+    int first = 1;
+    char cmd = 0;
+    double args[7];
+
+    if(!data) { embLog_error("emb-path-data.c embPathData_parse(), data argument is null\n"); return 0; }
+    if(!pathData) { embLog_error("emb-path-data.c embPathData_parse(), pathData argument is null\n"); return 0; }
+
+    for(;;)
+    {
+        p = embPathData_skip(p, end);
+        if(p == end)
+            break;
+        if(embPathData_argumentCount(*p) >= 0)
+        {
+            cmd = *p++;
+            if(first && cmd != 'M' && cmd != 'm')
+            {
+                embLog_error("emb-path-data.c embPathData_parse(), path data must start with a moveto, found '%c'\n", cmd);
+                return 0;
+            }
+            first = 0;
+            if(cmd == 'Z' || cmd == 'z')
+            {
+                if(current.xx != subpathStart.xx || current.yy != subpathStart.yy)
+                {
+                    if(!embPathData_add(data, LINETO, current, subpathStart))
+                        return 0;
+                }
+                current = subpathStart;
+                lastType = LINETO;
+                continue;
+            }
+        }
+        else if(!cmd || cmd == 'Z' || cmd == 'z')
+        {
+            embLog_error("emb-path-data.c embPathData_parse(), unexpected '%c' in path data, the rest is skipped\n", *p);
+            return 0;
+        }
+
+        next = embPathData_readArguments(p, end, cmd, args, embPathData_argumentCount(cmd));
+        if(!next)
+        {
+            embLog_error("emb-path-data.c embPathData_parse(), bad or missing arguments for path command '%c', the rest is skipped\n", cmd);
+            return 0;
+        }
+        p = next;
+
+        base = (cmd >= 'a') ? current : embPoint_make(0.0, 0.0);
+        s = 0;
+        switch(cmd)
+        {
+            case 'M':
+            case 'm':
+                to = embPoint_make(base.xx + args[0], base.yy + args[1]);
+                /* A moveto that draws nothing is replaced by the next one */
+                if(lastType == MOVETO)
+                    data->segments[data->count - 1].end = to;
+                else if(!embPathData_add(data, MOVETO, current, to))
+                    return 0;
+                subpathStart = current = to;
+                lastType = MOVETO;
+                /* Coordinates after a moveto are implicit linetos */
+                cmd = (cmd == 'M') ? 'L' : 'l';
+                continue;
+            case 'L':
+            case 'l':
+                to = embPoint_make(base.xx + args[0], base.yy + args[1]);
+                s = embPathData_add(data, LINETO, current, to);
+                break;
+            case 'H':
+            case 'h':
+                to = embPoint_make(base.xx + args[0], current.yy);
+                s = embPathData_add(data, LINETO, current, to);
+                break;
+            case 'V':
+            case 'v':
+                to = embPoint_make(current.xx, base.yy + args[0]);
+                s = embPathData_add(data, LINETO, current, to);
+                break;
+            case 'C':
+            case 'c':
+            case 'S':
+            case 's':
+                if(cmd == 'C' || cmd == 'c')
+                {
+                    c1 = embPoint_make(base.xx + args[0], base.yy + args[1]);
+                    c2 = embPoint_make(base.xx + args[2], base.yy + args[3]);
+                    to = embPoint_make(base.xx + args[4], base.yy + args[5]);
+                }
+                else
+                {
+                    /* The first control point mirrors the last one of a preceding cubic */
+                    c1 = current;
+                    if(lastType == CUBICTOEND)
+                        c1 = embPoint_make(2.0 * current.xx - lastControl.xx, 2.0 * current.yy - lastControl.yy);
+                    c2 = embPoint_make(base.xx + args[0], base.yy + args[1]);
+                    to = embPoint_make(base.xx + args[2], base.yy + args[3]);
+                }
+                s = embPathData_add(data, CUBICTOEND, current, to);
+                if(s)
+                {
+                    s->control1 = c1;
+                    s->control2 = c2;
+                }
+                lastControl = c2;
+                break;
+            case 'Q':
+            case 'q':
+            case 'T':
+            case 't':
+                if(cmd == 'Q' || cmd == 'q')
+                {
+                    c1 = embPoint_make(base.xx + args[0], base.yy + args[1]);
+                    to = embPoint_make(base.xx + args[2], base.yy + args[3]);
+                }
+                else
+                {
+                    c1 = current;
+                    if(lastType == QUADTOEND)
+                        c1 = embPoint_make(2.0 * current.xx - lastControl.xx, 2.0 * current.yy - lastControl.yy);
+                    to = embPoint_make(base.xx + args[0], base.yy + args[1]);
+                }
+                s = embPathData_add(data, QUADTOEND, current, to);
+                if(s)
+                    s->control1 = c1;
+                lastControl = c1;
+                break;
+            case 'A':
+            case 'a':
+                to = embPoint_make(base.xx + args[5], base.yy + args[6]);
+                lastType = embPathData_addArc(data, current, args[0], args[1], args[2], args[3] != 0.0, args[4] != 0.0, to);
+                current = to;
+                continue;
+        }
+        if(!s)
+            return 0;
+        lastType = s->type;
+        current = to;
+    }
+    return 1;
+}
+
+/* Returns |a - 2b + c|, the second difference of three consecutive control points. */
+static double embPathData_secondDifference(EmbPoint a, EmbPoint b, EmbPoint c)
+{
+    double x = a.xx - 2.0 * b.xx + c.xx;
+    double y = a.yy - 2.0 * b.yy + c.yy;
+    return sqrt(x * x + y * y);
+}
+
+/* Returns how many points (s) is flattened into so that no point of the curve is more than (tolerance) from the
+ * lines through them. Curves use Wang's bound for evenly spaced parameters, arcs the sagitta of the larger radius,
+ * which also bounds the error of the ellipse as it is an affine image of the unit circle. */
+static int embPathData_pointCount(const EmbPathSegment* s, double tolerance)
+{
+    double n = 1.0;
+    double d1, d2, r, step;
+
+    switch(s->type)
+    {
+        case QUADTOEND:
+            n = ceil(sqrt(embPathData_secondDifference(s->start, s->control1, s->end) / (4.0 * tolerance)));
+            break;
+        case CUBICTOEND:
+            d1 = embPathData_secondDifference(s->start, s->control1, s->control2);
+            d2 = embPathData_secondDifference(s->control1, s->control2, s->end);
+            n = ceil(sqrt(0.75 * (d1 > d2 ? d1 : d2) / tolerance));
+            break;
+        case ELLIPSETOEND:
+            r = s->control2.xx > s->control2.yy ? s->control2.xx : s->control2.yy;
+            step = EMB_PATH_PI / 2.0;
+            if(tolerance < r && 2.0 * acos(1.0 - tolerance / r) < step)
+                step = 2.0 * acos(1.0 - tolerance / r);
+            n = ceil(fabs(s->sweep) / step);
+            break;
+    }
+    if(!(n >= 1.0)) /* also catches NaN from non-finite coordinates */
+        return 1;
+    if(n > EMB_PATH_MAX_CURVE_POINTS)
+        return EMB_PATH_MAX_CURVE_POINTS;
+    return (int)n;
+}
+
+/* Stores the (n) points of (s) in (points) and their flags in (flags). The last one is always the exact end point. */
+static void embPathData_flattenSegment(const EmbPathSegment* s, int n, EmbPoint* points, EmbFlag* flags)
+{
+    double t, u, a, b, c, d, theta, cosPhi, sinPhi, ex, ey;
+    int i;
+
+    cosPhi = cos(s->rotation);
+    sinPhi = sin(s->rotation);
+    for(i = 1; i < n; i++)
+    {
+        t = (double)i / n;
+        u = 1.0 - t;
+        switch(s->type)
+        {
+            case QUADTOEND:
+                a = u * u;
+                b = 2.0 * u * t;
+                c = t * t;
+                points[i - 1].xx = a * s->start.xx + b * s->control1.xx + c * s->end.xx;
+                points[i - 1].yy = a * s->start.yy + b * s->control1.yy + c * s->end.yy;
+                break;
+            case CUBICTOEND:
+                a = u * u * u;
+                b = 3.0 * u * u * t;
+                c = 3.0 * u * t * t;
+                d = t * t * t;
+                points[i - 1].xx = a * s->start.xx + b * s->control1.xx + c * s->control2.xx + d * s->end.xx;
+                points[i - 1].yy = a * s->start.yy + b * s->control1.yy + c * s->control2.yy + d * s->end.yy;
+                break;
+            case ELLIPSETOEND:
+                theta = s->startAngle + t * s->sweep;
+                ex = s->control2.xx * cos(theta);
+                ey = s->control2.yy * sin(theta);
+                points[i - 1].xx = s->control1.xx + ex * cosPhi - ey * sinPhi;
+                points[i - 1].yy = s->control1.yy + ex * sinPhi + ey * cosPhi;
+                break;
+        }
+        flags[i - 1] = LINETO;
+    }
+    points[n - 1] = s->end;
+    flags[n - 1] = (s->type == MOVETO) ? MOVETO : LINETO;
+}
+
+typedef struct EmbPathFlattenJob_
+{
+    const EmbPathData* data;
+    double tolerance;
+    EmbFlatPath* flat;
+    const int* blockStart; /* index in (flat) of the first point of each block of segments */
+} EmbPathFlattenJob;
+
+static void embPathData_flattenBlock(void* arg, int block)
+{
+    const EmbPathFlattenJob* job = (const EmbPathFlattenJob*)arg;
+    int i = block * EMB_PATH_PARALLEL_BLOCK;
+    int last = i + EMB_PATH_PARALLEL_BLOCK;
+    int offset = job->blockStart[block];
+    int n;
+
+    if(last > job->data->count)
+        last = job->data->count;
+    for(; i < last; i++)
+    {
+        n = embPathData_pointCount(&(job->data->segments[i]), job->tolerance);
+        embPathData_flattenSegment(&(job->data->segments[i]), n, job->flat->points + offset, job->flat->flags + offset);
+        offset += n;
+    }
+}
+
+static int embFlatPath_reserve(EmbFlatPath* flat, int capacity)
+{
+    EmbPoint* points = 0;
+    EmbFlag* flags = 0;
+
+    if(capacity <= flat->capacity)
+        return 1;
+    if(capacity < 2 * flat->capacity)
+        capacity = 2 * flat->capacity;
+    points = (EmbPoint*)realloc(flat->points, sizeof(EmbPoint) * (size_t)capacity);
+    if(points) flat->points = points;
+    flags = (EmbFlag*)realloc(flat->flags, sizeof(EmbFlag) * (size_t)capacity);
+    if(flags) flat->flags = flags;
+    if(!points || !flags) { embLog_error("emb-path-data.c embFlatPath_reserve(), cannot allocate memory for %d points\n", capacity); return 0; }
+    flat->capacity = capacity;
+    return 1;
+}
+
+/*! Appends (\a data) to (\a flat) as straight lines, placing as few points on each curve and arc as keep every point
+ *  of it within (\a tolerance) of the lines. The number of points each segment takes is worked out first, so the
+ *  segments of a long path can be flattened independently: paths of at least EMB_PATH_PARALLEL_SEGMENTS segments are
+ *  handed to (\a parallelFor), if it is not 0, in blocks, and it is called with (\a parallelForData). The library
+ *  starts no threads of its own. Returns \c true if successful, otherwise returns \c false. */
+int embPathData_flatten(const EmbPathData* data, double tolerance, EmbParallelFor parallelFor, void* parallelForData, EmbFlatPath* flat)
+{
+    EmbPathFlattenJob job;
+    int* blockStart = 0;
+    int blocks, total, n, i;
+
+    if(!data) { embLog_error("emb-path-data.c embPathData_flatten(), data argument is null\n"); return 0; }
+    if(!flat) { embLog_error("emb-path-data.c embPathData_flatten(), flat argument is null\n"); return 0; }
+    if(!(tolerance > 0.0)) { embLog_error("emb-path-data.c embPathData_flatten(), tolerance must be positive, tolerance = %f\n", tolerance); return 0; }
+
+    blocks = (data->count + EMB_PATH_PARALLEL_BLOCK - 1) / EMB_PATH_PARALLEL_BLOCK;
+    if(parallelFor && data->count >= EMB_PATH_PARALLEL_SEGMENTS)
+    {
+        blockStart = (int*)malloc(sizeof(int) * (size_t)blocks);
+        if(!blockStart) { embLog_error("emb-path-data.c embPathData_flatten(), cannot allocate memory for blockStart\n"); return 0; }
+    }
+
+    total = flat->count;
+    for(i = 0; i < data->count; i++)
+    {
+        if(blockStart && i % EMB_PATH_PARALLEL_BLOCK == 0)
+            blockStart[i / EMB_PATH_PARALLEL_BLOCK] = total;
+        total += embPathData_pointCount(&(data->segments[i]), tolerance);
+    }
+    if(!embFlatPath_reserve(flat, total))
+    {
+        free(blockStart);
+        return 0;
+    }
+
+    job.data = data;
+    job.tolerance = tolerance;
+    job.flat = flat;
+    if(blockStart)
+    {
+        job.blockStart = blockStart;
+        parallelFor(blocks, embPathData_flattenBlock, &job, parallelForData);
+        free(blockStart);
+    }
+    else
+    {
+        for(i = 0; i < data->count; i++)
+        {
+            n = embPathData_pointCount(&(data->segments[i]), tolerance);
+            embPathData_flattenSegment(&(data->segments[i]), n, flat->points + flat->count, flat->flags + flat->count);
+            flat->count += n;
+        }
+    }
+    flat->count = total;
+    return 1;
+}
+
+/**************************************************/
+/* EmbFlatPath                                    */
+/**************************************************/
+
+void embFlatPath_init(EmbFlatPath* flat)
+{
+    if(!flat) { embLog_error("emb-path-data.c embFlatPath_init(), flat argument is null\n"); return; }
+    flat->points = 0;
+    flat->flags = 0;
+    flat->count = 0;
+    flat->capacity = 0;
+}
+
+/*! Removes every point from (\a flat) but keeps its storage for the next path. */
+void embFlatPath_clear(EmbFlatPath* flat)
+{
+    if(!flat) return;
+    flat->count = 0;
+}
+
+void embFlatPath_free(EmbFlatPath* flat)
+{
+    if(!flat) return;
+    free(flat->points);
+    free(flat->flags);
+    embFlatPath_init(flat);
+}
+
+/* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -0,0 +1,71 @@
+/*! @file emb-path-data.h */
+#ifndef EMB_PATH_DATA_H
+#define EMB_PATH_DATA_H
+
+#include <stddef.h>
+
+#include "emb-flag.h"
+#include "emb-path.h"
+#include "emb-point.h"
+
+#include "api-start.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EMB_PATH_MAX_CURVE_POINTS  4096 /* most points one curve or arc is flattened into */
+#define EMB_PATH_PARALLEL_SEGMENTS 4096 /* paths with fewer segments are always flattened on the calling thread */
+#define EMB_PATH_PARALLEL_BLOCK    1024 /* segments flattened by one parallel work item */
+
+/* One drawing command of a path, in absolute coordinates. Each segment keeps
+ * its own start point, so segments can be flattened independently. */
+typedef struct EmbPathSegment_
+{
+    int type;          /* MOVETO, LINETO, QUADTOEND, CUBICTOEND or ELLIPSETOEND */
+    EmbPoint start;
+    EmbPoint control1; /* first control point; the center for ELLIPSETOEND */
+    EmbPoint control2; /* second control point of CUBICTOEND; the radii for ELLIPSETOEND */
+    EmbPoint end;
+    double rotation;   /* ELLIPSETOEND only: x-axis rotation, angle of (start) and signed sweep, all in radians */
+    double startAngle;
+    double sweep;
+} EmbPathSegment;
+
+/* The segments of a path as parsed from SVG path data, stored contiguously. */
+typedef struct EmbPathData_
+{
+    EmbPathSegment* segments;
+    int count;
+    int capacity;
+} EmbPathData;
+
+/* A path flattened to straight lines: MOVETO starts a subpath at its point, LINETO draws to its point. */
+typedef struct EmbFlatPath_
+{
+    EmbPoint* points;
+    EmbFlag* flags;
+    int count;
+    int capacity;
+} EmbFlatPath;
+
+/* Runs work(arg, i) for every i in [0, count) and returns once all of them are done, see embPathData_flatten(). */
+typedef void (*EmbParallelFor)(int count, void (*work)(void* arg, int index), void* arg, void* data);
+
+extern EMB_PUBLIC void EMB_CALL embPathData_init(EmbPathData* data);
+extern EMB_PUBLIC void EMB_CALL embPathData_clear(EmbPathData* data);
+extern EMB_PUBLIC void EMB_CALL embPathData_free(EmbPathData* data);
+extern EMB_PUBLIC int EMB_CALL embPathData_parse(EmbPathData* data, const char* pathData, size_t length);
+extern EMB_PUBLIC int EMB_CALL embPathData_flatten(const EmbPathData* data, double tolerance, EmbParallelFor parallelFor, void* parallelForData, EmbFlatPath* flat);
+
+extern EMB_PUBLIC void EMB_CALL embFlatPath_init(EmbFlatPath* flat);
+extern EMB_PUBLIC void EMB_CALL embFlatPath_clear(EmbFlatPath* flat);
+extern EMB_PUBLIC void EMB_CALL embFlatPath_free(EmbFlatPath* flat);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#include "api-stop.h"
+
+#endif /* EMB_PATH_DATA_H */
+
+/* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
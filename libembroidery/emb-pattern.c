@@ -13,20 +13,66 @@
 #include "utility/ino-event.h"
 #endif
 
-/*! Returns a pointer to an EmbPattern. It is created on the heap. The caller is responsible for freeing the allocated memory with embPattern_free(). */
-EmbPattern* embPattern_create(void)
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static void embPattern_resetStats(EmbPattern* p)
 {
-    EmbPattern* p = 0;
-    p = (EmbPattern*)malloc(sizeof(EmbPattern));
-    if(!p) { embLog_error("emb-pattern.c embPattern_create(), unable to allocate memory for p\n"); return 0; }
+    p->stats.valid = 1;
+    p->stats.jumpCount = 0;
+    p->stats.trimCount = 0;
+    p->stats.stopCount = 0;
+    p->stats.controlCount = 0;
+    p->stats.maxColorIndex = 0;
+    p->stats.extents.left = 99999.0;
+    p->stats.extents.top = 99999.0;
+    p->stats.extents.right = -99999.0;
+    p->stats.extents.bottom = -99999.0;
+    p->stats.colorBlockCount = 0;
+}
 
-    p->settings = embSettings_init();
-    p->currentColorIndex = 0;
-    p->stitchList = 0;
-    p->threadList = 0;
+/* Folds stitch (i) of pattern (p) into its stats. Stitches must be tracked in order. */
+static void embPattern_trackStitch(EmbPattern* p, int i)
+{
+    EmbPatternStats* st = &(p->stats);
+    const EmbStitch* s = &(p->stitchList->stitch[i]);
+
+    if(!st->valid) return;
+    if(s->flags & JUMP) st->jumpCount++;
+    if(s->flags & TRIM) st->trimCount++;
+    if(s->flags & STOP) st->stopCount++;
+    if(s->flags & (JUMP | TRIM | STOP)) st->controlCount++;
+    st->maxColorIndex = max(st->maxColorIndex, s->color);
+    if(!(s->flags & TRIM))
+    {
+        st->extents.left = (double)min(st->extents.left, s->xx);
+        st->extents.top = (double)min(st->extents.top, s->yy);
+        st->extents.right = (double)max(st->extents.right, s->xx);
+        st->extents.bottom = (double)max(st->extents.bottom, s->yy);
+    }
+    if(i == 0 || s->color != p->stitchList->stitch[i - 1].color)
+    {
+        if(st->colorBlockCount == st->colorBlockCapacity)
+        {
+            int newCapacity = st->colorBlockCapacity ? st->colorBlockCapacity * 2 : 16;
+            int* blocks = (int*)realloc(st->colorBlocks, newCapacity * sizeof(int));
+            if(!blocks)
+            {
+                embLog_error("emb-pattern.c embPattern_trackStitch(), cannot allocate memory for colorBlocks\n");
+                st->valid = 0;
+                return;
+            }
+            st->colorBlocks = blocks;
+            st->colorBlockCapacity = newCapacity;
+        }
+        st->colorBlocks[st->colorBlockCount++] = i;
+    }
+}
 
-    p->hoop.height = 0.0;
-    p->hoop.width = 0.0;
+/* Empties the object lists of the pattern (\a p) without touching the arena their nodes came from. */
+static void embPattern_clearObjects(EmbPattern* p)
+{
     p->arcObjList = 0;
     p->circleObjList = 0;
     p->ellipseObjList = 0;
@@ -38,9 +84,6 @@ EmbPattern* embPattern_create(void)
     p->rectObjList = 0;
     p->splineObjList = 0;
 
-    p->lastStitch = 0;
-    p->lastThread = 0;
-
     p->lastArcObj = 0;
     p->lastCircleObj = 0;
     p->lastLineObj = 0;
@@ -51,10 +94,75 @@ EmbPattern* embPattern_create(void)
     p->lastPolylineObj = 0;
     p->lastRectObj = 0;
     p->lastSplineObj = 0;
+}
+
+/* Returns a copy of the point list (\a list) allocated from the arena of the pattern (\a p). */
+static EmbPointList* embPattern_copyPointList(EmbPattern* p, const EmbPointList* list)
+{
+    EmbPointList* first = 0;
+    EmbPointList* last = 0;
+    for(; list; list = list->next)
+    {
+        EmbPointList* node = (EmbPointList*)embArena_alloc(&p->arena, sizeof(EmbPointList));
+        if(!node) { embLog_error("emb-pattern.c embPattern_copyPointList(), cannot allocate memory for node\n"); return 0; }
+        node->point = list->point;
+        node->next = 0;
+        if(last) last->next = node;
+        else first = node;
+        last = node;
+    }
+    return first;
+}
+
+/* Returns a copy of the flag list (\a list) allocated from the arena of the pattern (\a p). */
+static EmbFlagList* embPattern_copyFlagList(EmbPattern* p, const EmbFlagList* list)
+{
+    EmbFlagList* first = 0;
+    EmbFlagList* last = 0;
+    for(; list; list = list->next)
+    {
+        EmbFlagList* node = (EmbFlagList*)embArena_alloc(&p->arena, sizeof(EmbFlagList));
+        if(!node) { embLog_error("emb-pattern.c embPattern_copyFlagList(), cannot allocate memory for node\n"); return 0; }
+        node->flag = list->flag;
+        node->next = 0;
+        if(last) last->next = node;
+        else first = node;
+        last = node;
+    }
+    return first;
+}
+
+/*! Returns a pointer to an EmbPattern. It is created on the heap. The caller is responsible for freeing the allocated memory with embPattern_free(). */
+EmbPattern* embPattern_create(void)
+{
+    EmbPattern* p = 0;
+    p = (EmbPattern*)malloc(sizeof(EmbPattern));
+    if(!p) { embLog_error("emb-pattern.c embPattern_create(), unable to allocate memory for p\n"); return 0; }
+
+    p->settings = embSettings_init();
+    p->currentColorIndex = 0;
+    p->stitchList = embStitchList_create();
+    if(!p->stitchList) { free(p); return 0; }
+    p->threadList = embThreadList_create();
+    if(!p->threadList) { embStitchList_free(p->stitchList); free(p); return 0; }
+
+    p->hoop.height = 0.0;
+    p->hoop.width = 0.0;
+    embPattern_clearObjects(p);
+    embArena_init(&p->arena, EMB_ARENA_DEFAULT_CHUNK);
 
     p->lastX = 0.0;
     p->lastY = 0.0;
 
+    p->stats.colorBlocks = 0;
+    p->stats.colorBlockCapacity = 0;
+    embPattern_resetStats(p);
+
+    p->readOptions.colorFileProbe = 0;
+    p->readOptions.colorFileProbeData = 0;
+    p->readOptions.parallelFor = 0;
+    p->readOptions.parallelForData = 0;
+
     return p;
 }
 
@@ -62,57 +170,88 @@ void embPattern_hideStitchesOverLength(EmbPattern* p, int length)
 {
     double prevX = 0;
     double prevY = 0;
-    EmbStitchList* pointer = 0;
+    EmbStitch* st = 0;
+    int i;
 
     if(!p) { embLog_error("emb-pattern.c embPattern_hideStitchesOverLength(), p argument is null\n"); return; }
-    pointer = p->stitchList;
-    while(pointer)
+    for(i = 0; i < embStitchList_count(p->stitchList); i++)
     {
-        if((fabs(pointer->stitch.xx - prevX) > length) || (fabs(pointer->stitch.yy - prevY) > length))
+        st = &(p->stitchList->stitch[i]);
+        if((fabs(st->xx - prevX) > length) || (fabs(st->yy - prevY) > length))
         {
-            pointer->stitch.flags |= TRIM;
-            pointer->stitch.flags &= ~NORMAL;
+            st->flags |= TRIM;
+            st->flags &= ~NORMAL;
         }
-        prevX = pointer->stitch.xx;
-        prevY = pointer->stitch.yy;
-        pointer = pointer->next;
+        prevX = st->xx;
+        prevY = st->yy;
     }
+    embPattern_invalidateStats(p);
 }
 
 int embPattern_addThread(EmbPattern* p, EmbThread thread)
 {
     if(!p) { embLog_error("emb-pattern.c embPattern_addThread(), p argument is null\n"); return 0; }
-    if(embThreadList_empty(p->threadList))
-    {
-        p->threadList = p->lastThread = embThreadList_create(thread);
-    }
-    else
+    return embThreadList_add(p->threadList, thread);
+}
+
+/*! Returns the number of threads in the pattern (\a p). */
+int embPattern_threadCount(const EmbPattern* p)
+{
+    if(!p) { embLog_error("emb-pattern.c embPattern_threadCount(), p argument is null\n"); return 0; }
+    return embThreadList_count(p->threadList);
+}
+
+/*! Removes all of the threads from the pattern (\a p). */
+void embPattern_clearThreads(EmbPattern* p)
+{
+    if(!p) { embLog_error("emb-pattern.c embPattern_clearThreads(), p argument is null\n"); return; }
+    embThreadList_clear(p->threadList);
+}
+
+/*! Returns the stitch counts, extents and color blocks of the pattern (\a p).
+ *  These are kept up to date as stitches are added, so this is normally O(1).
+ *  After an in-place edit has invalidated them they are rebuilt here in a single pass. */
+const EmbPatternStats* embPattern_stats(EmbPattern* p)
+{
+    int i;
+
+    if(!p) { embLog_error("emb-pattern.c embPattern_stats(), p argument is null\n"); return 0; }
+    if(!p->stats.valid)
     {
-        p->lastThread = embThreadList_add(p->lastThread, thread);
+        embPattern_resetStats(p);
+        for(i = 0; i < embStitchList_count(p->stitchList); i++)
+        {
+            embPattern_trackStitch(p, i);
+        }
     }
-    return 1;
+    return &(p->stats);
+}
+
+/*! Marks the stats of the pattern (\a p) as stale. Call this after editing the stitches of (\a p) in place. */
+void embPattern_invalidateStats(EmbPattern* p)
+{
+    if(!p) { embLog_error("emb-pattern.c embPattern_invalidateStats(), p argument is null\n"); return; }
+    p->stats.valid = 0;
 }
 
 void embPattern_fixColorCount(EmbPattern* p)
 {
     /* fix color count to be max of color index. */
     int maxColorIndex = 0;
-    EmbStitchList* list = 0;
+    unsigned int seed;
 
     if(!p) { embLog_error("emb-pattern.c embPattern_fixColorCount(), p argument is null\n"); return; }
-    list = p->stitchList;
-    while(list)
-    {
-        maxColorIndex = max(maxColorIndex, list->stitch.color);
-        list = list->next;
-    }
+    maxColorIndex = embPattern_stats(p)->maxColorIndex;
 #ifndef ARDUINO
     /* ARDUINO TODO: The while loop below never ends because memory cannot be allocated in the addThread
      *               function and thus the thread count is never incremented. Arduino or not, it's wrong.
      */
-    while((int)embThreadList_count(p->threadList) <= maxColorIndex)
+    /* Seeded by position so a given design always gets the same colors, whichever thread reads it */
+    seed = (unsigned int)embThreadList_count(p->threadList);
+    while(embThreadList_count(p->threadList) <= maxColorIndex)
     {
-        embPattern_addThread(p, embThread_getRandom());
+        if(!embPattern_addThread(p, embThread_getRandomR(&seed)))
+            break;
     }
 #endif
     /*
@@ -126,7 +265,8 @@ void embPattern_fixColorCount(EmbPattern* p)
 /*! Copies all of the EmbStitchList data to EmbPolylineObjectList data for pattern (\a p). */
 void embPattern_copyStitchListToPolylines(EmbPattern* p)
 {
-    EmbStitchList* stList = 0;
+    EmbStitch* st = 0;
+    int i = 0, count;
     int breakAtFlags;
 
     if(!p) { embLog_error("emb-pattern.c embPattern_copyStitchListToPolylines(), p argument is null\n"); return; }
@@ -137,55 +277,61 @@ void embPattern_copyStitchListToPolylines(EmbPattern* p)
     breakAtFlags = (STOP | JUMP | TRIM);
 #endif /* EMB_DEBUG_JUMP */
 
-    stList = p->stitchList;
-    while(stList)
+    count = embStitchList_count(p->stitchList);
+    while(i < count)
     {
         EmbPointList* pointList = 0;
         EmbPointList* lastPoint = 0;
         EmbColor color;
-        while(stList)
+        for(; i < count; i++)
         {
-            if(stList->stitch.flags & breakAtFlags)
+            st = &(p->stitchList->stitch[i]);
+            if(st->flags & breakAtFlags)
             {
                 break;
             }
-            if(!(stList->stitch.flags & JUMP))
+            if(!(st->flags & JUMP))
             {
+                EmbPointList* node = (EmbPointList*)embArena_alloc(&p->arena, sizeof(EmbPointList));
+                if(!node) { embLog_error("emb-pattern.c embPattern_copyStitchListToPolylines(), cannot allocate memory for node\n"); return; }
+                node->point = embPoint_make(st->xx, st->yy);
+                node->next = 0;
                 if(!pointList)
                 {
-                    pointList = lastPoint = embPointList_create(stList->stitch.xx, stList->stitch.yy);
-                    color = embThreadList_getAt(p->threadList, stList->stitch.color).color;
+                    pointList = node;
+                    color = embThreadList_getAt(p->threadList, st->color).color;
                 }
                 else
                 {
-                    lastPoint = embPointList_add(lastPoint, embPoint_make(stList->stitch.xx, stList->stitch.yy));
+                    lastPoint->next = node;
                 }
+                lastPoint = node;
             }
-            stList = stList->next;
         }
 
         /* NOTE: Ensure empty polylines are not created. This is critical. */
         if(pointList)
         {
-            EmbPolylineObject* currentPolyline = (EmbPolylineObject*)malloc(sizeof(EmbPolylineObject));
-            if(!currentPolyline) { embLog_error("emb-pattern.c embPattern_copyStitchListToPolylines(), cannot allocate memory for currentPolyline\n"); return; }
+            EmbPolylineObject* currentPolyline = (EmbPolylineObject*)embArena_alloc(&p->arena, sizeof(EmbPolylineObject));
+            EmbPolylineObjectList* node = (EmbPolylineObjectList*)embArena_alloc(&p->arena, sizeof(EmbPolylineObjectList));
+            if(!currentPolyline || !node) { embLog_error("emb-pattern.c embPattern_copyStitchListToPolylines(), cannot allocate memory for currentPolyline\n"); return; }
             currentPolyline->pointList = pointList;
             currentPolyline->color = color;
             currentPolyline->lineType = 1; /* TODO: Determine what the correct value should be */
 
+            node->polylineObj = currentPolyline;
+            node->next = 0;
             if(embPolylineObjectList_empty(p->polylineObjList))
             {
-                p->polylineObjList = p->lastPolylineObj = embPolylineObjectList_create(currentPolyline);
+                p->polylineObjList = node;
             }
             else
             {
-                p->lastPolylineObj = embPolylineObjectList_add(p->lastPolylineObj, currentPolyline);
+                p->lastPolylineObj->next = node;
             }
+            p->lastPolylineObj = node;
         }
-        if(stList)
-        {
-            stList = stList->next;
-        }
+        i++; /* skip the stitch that broke the polyline */
     }
 }
 
@@ -238,12 +384,9 @@ void embPattern_moveStitchListToPolylines(EmbPattern* p)
     if(!p) { embLog_error("emb-pattern.c embPattern_moveStitchListToPolylines(), p argument is null\n"); return; }
     embPattern_copyStitchListToPolylines(p);
     /* Free the stitchList and threadList since their data has now been transferred to polylines */
-    embStitchList_free(p->stitchList);
-    p->stitchList = 0;
-    p->lastStitch = 0;
-    embThreadList_free(p->threadList);
-    p->threadList = 0;
-    p->lastThread = 0;
+    embStitchList_clear(p->stitchList);
+    embPattern_resetStats(p);
+    embPattern_clearThreads(p);
 }
 
 /*! Moves all of the EmbPolylineObjectList data to EmbStitchList data for pattern (\a p). */
@@ -251,7 +394,7 @@ void embPattern_movePolylinesToStitchList(EmbPattern* p)
 {
     if(!p) { embLog_error("emb-pattern.c embPattern_movePolylinesToStitchList(), p argument is null\n"); return; }
     embPattern_copyPolylinesToStitchList(p);
-    embPolylineObjectList_free(p->polylineObjList);
+    /* The polylines were allocated from the arena and are released with it */
     p->polylineObjList = 0;
     p->lastPolylineObj = 0;
 }
@@ -268,7 +411,7 @@ void embPattern_addStitchAbs(EmbPattern* p, double x, double y, int flags, int i
         if(embStitchList_empty(p->stitchList))
             return;
         /* Prevent unnecessary multiple END stitches */
-        if(p->lastStitch->stitch.flags & END)
+        if(embStitchList_last(p->stitchList)->flags & END)
         {
             embLog_error("emb-pattern.c embPattern_addStitchAbs(), found multiple END stitches\n");
             return;
@@ -297,7 +440,8 @@ void embPattern_addStitchAbs(EmbPattern* p, double x, double y, int flags, int i
         h.yy = home.yy;
         h.flags = JUMP;
         h.color = p->currentColorIndex;
-        p->stitchList = p->lastStitch = embStitchList_create(h);
+        embStitchList_add(p->stitchList, h);
+        embPattern_trackStitch(p, 0);
     }
 
     s.xx = x;
@@ -307,7 +451,8 @@ void embPattern_addStitchAbs(EmbPattern* p, double x, double y, int flags, int i
 #ifdef ARDUINO
     inoEvent_addStitchAbs(p, s.xx, s.yy, s.flags, s.color);
 #else /* ARDUINO */
-    p->lastStitch = embStitchList_add(p->lastStitch, s);
+    if(embStitchList_add(p->stitchList, s))
+        embPattern_trackStitch(p, embStitchList_count(p->stitchList) - 1);
 #endif /* ARDUINO */
     p->lastX = s.xx;
     p->lastY = s.yy;
@@ -326,7 +471,7 @@ void embPattern_addStitchRel(EmbPattern* p, double dx, double dy, int flags, int
     }
     else
     {
-        /* NOTE: The stitchList is empty, so add it to the HOME position. The embStitchList_create function will ensure the first coordinate is at the HOME position. */
+        /* NOTE: The stitchList is empty, so add it to the HOME position. embPattern_addStitchAbs will ensure the first coordinate is at the HOME position. */
         EmbPoint home = embSettings_home(&(p->settings));
         x = home.xx + dx;
         y = home.yy + dy;
@@ -334,6 +479,117 @@ void embPattern_addStitchRel(EmbPattern* p, double dx, double dy, int flags, int
     embPattern_addStitchAbs(p, x, y, flags, isAutoColorIndex);
 }
 
+/*! Adds (\a count) stitches to the pattern (\a p) at the absolute positions in (\a points), all with the same (\a flags).
+ *  This is equivalent to calling embPattern_addStitchAbs() for each point, but storage is reserved once for the whole run. */
+void embPattern_addStitchesAbs(EmbPattern* p, const EmbPoint* points, int count, int flags, int isAutoColorIndex)
+{
+    int i;
+    EmbStitch s;
+
+    if(!p) { embLog_error("emb-pattern.c embPattern_addStitchesAbs(), p argument is null\n"); return; }
+    if(count <= 0) return;
+    if(!points) { embLog_error("emb-pattern.c embPattern_addStitchesAbs(), points argument is null\n"); return; }
+
+#ifndef ARDUINO
+    if(!(flags & (END | STOP)))
+    {
+        /* The first stitch takes care of the HOME stitch, the rest can be appended directly. */
+        embPattern_addStitchAbs(p, points[0].xx, points[0].yy, flags, isAutoColorIndex);
+        if(!embStitchList_reserve(p->stitchList, embStitchList_count(p->stitchList) + count - 1))
+            return;
+        s.flags = flags;
+        s.color = p->currentColorIndex;
+        for(i = 1; i < count; i++)
+        {
+            s.xx = points[i].xx;
+            s.yy = points[i].yy;
+            if(embStitchList_add(p->stitchList, s))
+                embPattern_trackStitch(p, embStitchList_count(p->stitchList) - 1);
+        }
+        p->lastX = points[count - 1].xx;
+        p->lastY = points[count - 1].yy;
+        return;
+    }
+#endif /* ARDUINO */
+
+    for(i = 0; i < count; i++)
+    {
+        embPattern_addStitchAbs(p, points[i].xx, points[i].yy, flags, isAutoColorIndex);
+    }
+}
+
+/*! Adds (\a count) stitches to the pattern (\a p), each one offset by the matching entry of (\a deltas) from the stitch before it.
+ *  This is equivalent to calling embPattern_addStitchRel() for each delta, but storage is reserved once for the whole run. */
+void embPattern_addStitchesRel(EmbPattern* p, const EmbPoint* deltas, int count, int flags, int isAutoColorIndex)
+{
+    int i;
+    EmbStitch s;
+
+    if(!p) { embLog_error("emb-pattern.c embPattern_addStitchesRel(), p argument is null\n"); return; }
+    if(count <= 0) return;
+    if(!deltas) { embLog_error("emb-pattern.c embPattern_addStitchesRel(), deltas argument is null\n"); return; }
+
+#ifndef ARDUINO
+    if(!(flags & (END | STOP)))
+    {
+        embPattern_addStitchRel(p, deltas[0].xx, deltas[0].yy, flags, isAutoColorIndex);
+        if(!embStitchList_reserve(p->stitchList, embStitchList_count(p->stitchList) + count - 1))
+            return;
+        s.flags = flags;
+        s.color = p->currentColorIndex;
+        s.xx = p->lastX;
+        s.yy = p->lastY;
+        for(i = 1; i < count; i++)
+        {
+            s.xx += deltas[i].xx;
+            s.yy += deltas[i].yy;
+            if(embStitchList_add(p->stitchList, s))
+                embPattern_trackStitch(p, embStitchList_count(p->stitchList) - 1);
+        }
+        p->lastX = s.xx;
+        p->lastY = s.yy;
+        return;
+    }
+#endif /* ARDUINO */
+
+    for(i = 0; i < count; i++)
+    {
+        embPattern_addStitchRel(p, deltas[i].xx, deltas[i].yy, flags, isAutoColorIndex);
+    }
+}
+
+/*! Appends the (\a count) fully decoded stitches in (\a stitches) to the pattern (\a p) as they are, with their own
+ *  positions, flags and colors. Unlike embPattern_addStitchAbs() no HOME stitch is added to an empty pattern and
+ *  STOP and END are not interpreted, so this is meant for readers that have already decoded a block of records. */
+void embPattern_appendStitches(EmbPattern* p, const EmbStitch* stitches, int count)
+{
+    int i, first;
+
+    if(!p) { embLog_error("emb-pattern.c embPattern_appendStitches(), p argument is null\n"); return; }
+    if(count <= 0) return;
+    if(!stitches) { embLog_error("emb-pattern.c embPattern_appendStitches(), stitches argument is null\n"); return; }
+
+#ifdef ARDUINO
+    for(i = 0; i < count; i++)
+    {
+        p->currentColorIndex = stitches[i].color;
+        embPattern_addStitchAbs(p, stitches[i].xx, stitches[i].yy, stitches[i].flags, 0);
+    }
+#else /* ARDUINO */
+    first = embStitchList_count(p->stitchList);
+    if(!embStitchList_reserve(p->stitchList, first + count))
+        return;
+    memcpy(p->stitchList->stitch + first, stitches, sizeof(EmbStitch) * (size_t)count);
+    p->stitchList->count = first + count;
+    for(i = first; i < first + count; i++)
+    {
+        embPattern_trackStitch(p, i);
+    }
+    p->lastX = stitches[count - 1].xx;
+    p->lastY = stitches[count - 1].yy;
+#endif /* ARDUINO */
+}
+
 void embPattern_changeColor(EmbPattern* p, int index)
 {
     if(!p) { embLog_error("emb-pattern.c embPattern_changeColor(), p argument is null\n"); return; }
@@ -376,32 +632,125 @@ int embPattern_write(EmbPattern* pattern, const char* fileName) /* TODO: Write t
     return result;
 }
 
+/*! Encodes \a pattern into memory in the format named by \a format, which is a file name or
+ *  extension such as "design.pes", ".dst" or "dst". The file name, if any, is only used by formats
+ *  that record the design name. On success \a buffer receives the encoded bytes and \a size their
+ *  length; the caller is responsible for freeing the buffer with free().
+ *  Returns \c true if successful, otherwise returns \c false. */
+int embPattern_writeMemory(EmbPattern* pattern, const char* format, unsigned char** buffer, size_t* size)
+{
+    EmbReaderWriter* writer = 0;
+    EmbFile* file = 0;
+    const char* name = format;
+    const char* ending = 0;
+    char extension[6];
+    int result = 0;
+
+    if(!pattern) { embLog_error("emb-pattern.c embPattern_writeMemory(), pattern argument is null\n"); return 0; }
+    if(!format) { embLog_error("emb-pattern.c embPattern_writeMemory(), format argument is null\n"); return 0; }
+    if(!buffer || !size) { embLog_error("emb-pattern.c embPattern_writeMemory(), buffer and size arguments must not be null\n"); return 0; }
+    *buffer = 0;
+    *size = 0;
+
+    ending = strrchr(format, '.');
+    if(!ending)
+    {
+        if(strlen(format) > 4) { embLog_error("emb-pattern.c embPattern_writeMemory(), unsupported write file type: %s\n", format); return 0; }
+        extension[0] = '.';
+        strcpy(extension + 1, format);
+        name = extension;
+    }
+    else if(strlen(ending) > 4) { embLog_error("emb-pattern.c embPattern_writeMemory(), unsupported write file type: %s\n", format); return 0; }
+
+    writer = embReaderWriter_getByFileName(name);
+    if(!writer) { embLog_error("emb-pattern.c embPattern_writeMemory(), unsupported write file type: %s\n", format); return 0; }
+    if(!writer->streamWriter)
+    {
+        embLog_error("emb-pattern.c embPattern_writeMemory(), %s cannot be written to memory\n", format);
+        free(writer);
+        return 0;
+    }
+
+    file = embFile_openBuffer();
+    if(!file) { embLog_error("emb-pattern.c embPattern_writeMemory(), cannot allocate memory for file\n"); free(writer); return 0; }
+    result = writer->streamWriter(pattern, file, name);
+    free(writer);
+    writer = 0;
+    if(!result)
+    {
+        embFile_close(file);
+        return 0;
+    }
+    *buffer = embFile_release(file, size);
+    return *buffer != 0;
+}
+
 /* Very simple scaling of the x and y axis for every point.
 * Doesn't insert or delete stitches to preserve density. */
 void embPattern_scale(EmbPattern* p, double scale)
 {
-    EmbStitchList* pointer = 0;
-
     if(!p) { embLog_error("emb-pattern.c embPattern_scale(), p argument is null\n"); return; }
-    pointer = p->stitchList;
-    while(pointer)
+    embPattern_transform(p, embTransform_scale(scale, scale));
+}
+
+/* Returns the box around the corners of the rect (r) once moved by (t).
+ * Affine maps and rounding are both monotonic along each axis, so when (t) keeps the axes
+ * the box is exactly the extents the moved points would have. */
+static EmbRect embPattern_boxUnder(EmbRect r, EmbTransform t)
+{
+    EmbRect box;
+    EmbPoint corner1 = embTransform_apply(t, embPoint_make(r.left, r.top));
+    EmbPoint corner2 = embTransform_apply(t, embPoint_make(r.right, r.bottom));
+
+    box.left = (double)min(corner1.xx, corner2.xx);
+    box.top = (double)min(corner1.yy, corner2.yy);
+    box.right = (double)max(corner1.xx, corner2.xx);
+    box.bottom = (double)max(corner1.yy, corner2.yy);
+    return box;
+}
+
+/* Returns the extents of the stitches of pattern (p) as seen through (t), empty as in EmbPatternStats if there are none. */
+static EmbRect embPattern_stitchExtentsUnder(EmbPattern* p, EmbTransform t)
+{
+    EmbRect extents = embPattern_stats(p)->extents;
+    int i;
+
+    if(embTransform_keepsAxes(t))
     {
-        pointer->stitch.xx *= scale;
-        pointer->stitch.yy *= scale;
-        pointer = pointer->next;
+        if(extents.left <= extents.right)
+            extents = embPattern_boxUnder(extents, t);
+        return extents;
     }
+    /* Rotated or sheared, the moved corners only bound the stitches loosely, so walk them */
+    extents.left = 99999.0;
+    extents.top = 99999.0;
+    extents.right = -99999.0;
+    extents.bottom = -99999.0;
+    for(i = 0; i < embStitchList_count(p->stitchList); i++)
+    {
+        const EmbStitch* s = &(p->stitchList->stitch[i]);
+        EmbPoint point;
+        if(s->flags & TRIM) continue;
+        point = embTransform_apply(t, embPoint_make(s->xx, s->yy));
+        extents.left = (double)min(extents.left, point.xx);
+        extents.top = (double)min(extents.top, point.yy);
+        extents.right = (double)max(extents.right, point.xx);
+        extents.bottom = (double)max(extents.bottom, point.yy);
+    }
+    return extents;
 }
 
-/*! Returns an EmbRect that encapsulates all stitches and objects in the pattern (\a p). */
-EmbRect embPattern_calcBoundingBox(EmbPattern* p)
+/* Does the work of embPattern_calcBoundingBox() and embPatternView_boundingBox() for the pattern (p) as seen through (t). */
+static EmbRect embPattern_boundingBoxUnder(EmbPattern* p, EmbTransform t)
 {
-    EmbStitchList* pointer = 0;
     EmbRect boundingRect;
-    EmbStitch pt;
+    EmbRect stitchExtents;
     EmbArcObjectList* aObjList = 0;
     EmbArc arc;
     EmbCircleObjectList* cObjList = 0;
     EmbCircle circle;
+    EmbPoint center;
+    double halfWidth, halfHeight;
     EmbEllipseObjectList* eObjList = 0;
     EmbEllipse ellipse;
     EmbLineObjectList* liObjList = 0;
@@ -451,21 +800,12 @@ EmbRect embPattern_calcBoundingBox(EmbPattern* p)
     boundingRect.right = -99999.0;
     boundingRect.bottom = -99999.0;
 
-    pointer = p->stitchList;
-    while(pointer)
-    {
-        /* If the point lies outside of the accumulated bounding
-        * rectangle, then inflate the bounding rect to include it. */
-        pt = pointer->stitch;
-        if(!(pt.flags & TRIM))
-        {
-            boundingRect.left = (double)min(boundingRect.left, pt.xx);
-            boundingRect.top = (double)min(boundingRect.top, pt.yy);
-            boundingRect.right = (double)max(boundingRect.right, pt.xx);
-            boundingRect.bottom = (double)max(boundingRect.bottom, pt.yy);
-        }
-        pointer = pointer->next;
-    }
+    /* The extents of the stitches are kept up to date as they are added. */
+    stitchExtents = embPattern_stitchExtentsUnder(p, t);
+    boundingRect.left = (double)min(boundingRect.left, stitchExtents.left);
+    boundingRect.top = (double)min(boundingRect.top, stitchExtents.top);
+    boundingRect.right = (double)max(boundingRect.right, stitchExtents.right);
+    boundingRect.bottom = (double)max(boundingRect.bottom, stitchExtents.bottom);
 
     aObjList = p->arcObjList;
     while(aObjList)
@@ -480,10 +820,14 @@ EmbRect embPattern_calcBoundingBox(EmbPattern* p)
     while(cObjList)
     {
         circle = cObjList->circleObj.circle;
-        boundingRect.left = (double)min(boundingRect.left, circle.centerX - circle.radius);
-        boundingRect.top = (double)min(boundingRect.top, circle.centerY - circle.radius);
-        boundingRect.right = (double)max(boundingRect.right, circle.centerX + circle.radius);
-        boundingRect.bottom = (double)max(boundingRect.bottom, circle.centerY + circle.radius);
+        center = embTransform_apply(t, embPoint_make(circle.centerX, circle.centerY));
+        /* A circle seen through (t) is an ellipse whose box has these half-sizes */
+        halfWidth = circle.radius * sqrt(t.a * t.a + t.c * t.c);
+        halfHeight = circle.radius * sqrt(t.b * t.b + t.d * t.d);
+        boundingRect.left = (double)min(boundingRect.left, center.xx - halfWidth);
+        boundingRect.top = (double)min(boundingRect.top, center.yy - halfHeight);
+        boundingRect.right = (double)max(boundingRect.right, center.xx + halfWidth);
+        boundingRect.bottom = (double)max(boundingRect.bottom, center.yy + halfHeight);
 
         cObjList = cObjList->next;
     }
@@ -564,6 +908,12 @@ EmbRect embPattern_calcBoundingBox(EmbPattern* p)
     return boundingRect;
 }
 
+/*! Returns an EmbRect that encapsulates all stitches and objects in the pattern (\a p). */
+EmbRect embPattern_calcBoundingBox(EmbPattern* p)
+{
+    return embPattern_boundingBoxUnder(p, embTransform_identity());
+}
+
 /*! Flips the entire pattern (\a p) horizontally about the y-axis. */
 void embPattern_flipHorizontal(EmbPattern* p)
 {
@@ -582,156 +932,417 @@ void embPattern_flipVertical(EmbPattern* p)
  *  Flips the entire pattern (\a p) vertically about the y-axis if (\a vert) is true. */
 void embPattern_flip(EmbPattern* p, int horz, int vert)
 {
-    EmbStitchList* stList = 0;
-    EmbArcObjectList* aObjList = 0;
-    EmbCircleObjectList* cObjList = 0;
-    EmbEllipseObjectList* eObjList = 0;
-    EmbLineObjectList* liObjList = 0;
-    EmbPathObjectList* paObjList = 0;
-    EmbPointList* paPointList = 0;
-    EmbPointObjectList* pObjList = 0;
-    EmbPolygonObjectList* pogObjList = 0;
-    EmbPointList* pogPointList = 0;
-    EmbPolylineObjectList* polObjList = 0;
-    EmbPointList* polPointList = 0;
-    EmbRectObjectList* rObjList = 0;
-    EmbSplineObjectList* sObjList = 0;
-
     if(!p) { embLog_error("emb-pattern.c embPattern_flip(), p argument is null\n"); return; }
+    embPattern_transform(p, embTransform_scale(horz ? -1.0 : 1.0, vert ? -1.0 : 1.0));
+}
+
+/* Moves every stitch of pattern (p) by (t) and keeps the stitch extents and the position
+ * the next relative stitch is added from in step. */
+static void embPattern_transformStitches(EmbPattern* p, EmbTransform t)
+{
+    EmbStitch* st = p->stitchList->stitch;
+    int count = embStitchList_count(p->stitchList);
+    EmbPoint last = embTransform_apply(t, embPoint_make(p->lastX, p->lastY));
+    int i;
+
+    p->lastX = last.xx;
+    p->lastY = last.yy;
 
-    stList = p->stitchList;
-    while(stList)
+    /* Scales and flips, by far the most common, get a loop with nothing but a multiply
+     * per coordinate; the translation is added in passes of its own when there is one. */
+    if(t.b == 0.0 && t.c == 0.0)
+    {
+        for(i = 0; i < count; i++)
+        {
+            st[i].xx *= t.a;
+            st[i].yy *= t.d;
+        }
+        if(t.e != 0.0)
+            for(i = 0; i < count; i++)
+                st[i].xx += t.e;
+        if(t.f != 0.0)
+            for(i = 0; i < count; i++)
+                st[i].yy += t.f;
+    }
+    else
     {
-        if(horz) { stList->stitch.xx = -stList->stitch.xx; }
-        if(vert) { stList->stitch.yy = -stList->stitch.yy; }
-        stList = stList->next;
+        for(i = 0; i < count; i++)
+        {
+            EmbPoint point = embTransform_apply(t, embPoint_make(st[i].xx, st[i].yy));
+            st[i].xx = point.xx;
+            st[i].yy = point.yy;
+        }
     }
 
-    aObjList = p->arcObjList;
-    while(aObjList)
+    /* The counts and color blocks do not change. The extents follow the box exactly unless the stitches were rotated. */
+    if(p->stats.valid && p->stats.extents.left <= p->stats.extents.right)
     {
-        /* TODO: embPattern_flip for arcs */
-        aObjList = aObjList->next;
+        if(embTransform_keepsAxes(t))
+            p->stats.extents = embPattern_boxUnder(p->stats.extents, t);
+        else
+            embPattern_invalidateStats(p);
     }
+}
 
-    cObjList = p->circleObjList;
-    while(cObjList)
+static void embPointList_transform(EmbPointList* list, EmbTransform t)
+{
+    for(; list; list = list->next)
     {
-        if(horz) { cObjList->circleObj.circle.centerX = -cObjList->circleObj.circle.centerX; }
-        if(vert) { cObjList->circleObj.circle.centerY = -cObjList->circleObj.circle.centerY; }
-        cObjList = cObjList->next;
+        list->point = embTransform_apply(t, list->point);
     }
+}
 
-    eObjList = p->ellipseObjList;
-    while(eObjList)
+/* Finds the radii and rotation in degrees of the ellipse with radii (rx, ry) rotated
+ * by (rotation) degrees once (t) is applied. They are the singular values and the left
+ * singular vector of the linear part of (t) times the rotation times the radii, which
+ * for a 2x2 matrix have a closed form. */
+static void embPattern_transformRadii(EmbTransform t, double rx, double ry, double rotation,
+                                      double* newRx, double* newRy, double* newRotation)
+{
+    double cosA = cos(rotation * M_PI / 180.0);
+    double sinA = sin(rotation * M_PI / 180.0);
+    double m00 = (t.a * cosA + t.c * sinA) * rx;
+    double m10 = (t.b * cosA + t.d * sinA) * rx;
+    double m01 = (t.c * cosA - t.a * sinA) * ry;
+    double m11 = (t.d * cosA - t.b * sinA) * ry;
+    double e = (m00 + m11) / 2.0;
+    double f = (m00 - m11) / 2.0;
+    double g = (m10 + m01) / 2.0;
+    double h = (m10 - m01) / 2.0;
+    double q = sqrt(e * e + h * h);
+    double r = sqrt(f * f + g * g);
+
+    *newRx = q + r;
+    *newRy = fabs(q - r);
+    *newRotation = (atan2(h, e) + atan2(g, f)) / 2.0 * 180.0 / M_PI;
+}
+
+static void embPattern_transformEllipses(EmbPattern* p, EmbTransform t)
+{
+    EmbEllipseObjectList* node = p->ellipseObjList;
+    int keepsAxes = embTransform_keepsAxes(t);
+
+    for(; node; node = node->next)
     {
-        if(horz) { eObjList->ellipseObj.ellipse.centerX = -eObjList->ellipseObj.ellipse.centerX; }
-        if(vert) { eObjList->ellipseObj.ellipse.centerY = -eObjList->ellipseObj.ellipse.centerY; }
-        eObjList = eObjList->next;
+        EmbEllipseObject* obj = &(node->ellipseObj);
+        EmbEllipse* ellipse = &(obj->ellipse);
+        EmbPoint center = embTransform_apply(t, embPoint_make(ellipse->centerX, ellipse->centerY));
+
+        ellipse->centerX = center.xx;
+        ellipse->centerY = center.yy;
+        if(keepsAxes && obj->rotation == 0.0)
+        {
+            double rx = ellipse->radiusX;
+            double ry = ellipse->radiusY;
+            if(t.b == 0.0 && t.c == 0.0)
+            {
+                ellipse->radiusX = fabs(t.a) * rx;
+                ellipse->radiusY = fabs(t.d) * ry;
+            }
+            else /* a quarter turn swaps the axes */
+            {
+                ellipse->radiusX = fabs(t.c) * ry;
+                ellipse->radiusY = fabs(t.b) * rx;
+            }
+        }
+        else
+        {
+            embPattern_transformRadii(t, ellipse->radiusX, ellipse->radiusY, obj->rotation,
+                                      &(ellipse->radiusX), &(ellipse->radiusY), &(obj->rotation));
+        }
     }
+}
 
-    liObjList = p->lineObjList;
-    while(liObjList)
+/* Circles stretched unevenly become ellipses, so this runs after the existing ellipses have been moved. */
+static void embPattern_transformCircles(EmbPattern* p, EmbTransform t)
+{
+    EmbCircleObjectList* node = p->circleObjList;
+    EmbCircleObjectList* prev = 0;
+    int similar = embTransform_isSimilarity(t);
+    double scale = sqrt(fabs(embTransform_determinant(t)));
+
+    while(node)
     {
-        if(horz)
+        EmbCircleObjectList* next = node->next;
+        EmbCircle* circle = &(node->circleObj.circle);
+        EmbPoint center = embTransform_apply(t, embPoint_make(circle->centerX, circle->centerY));
+        EmbEllipseObjectList* lastEllipse = p->lastEllipseObj;
+        double rx, ry, rotation;
+
+        if(!similar)
         {
-            liObjList->lineObj.line.x1 = -liObjList->lineObj.line.x1;
-            liObjList->lineObj.line.x2 = -liObjList->lineObj.line.x2;
+            embPattern_transformRadii(t, circle->radius, circle->radius, 0.0, &rx, &ry, &rotation);
+            embPattern_addEllipseObjectAbs(p, center.xx, center.yy, rx, ry);
         }
-        if(vert)
+        if(similar || p->lastEllipseObj == lastEllipse) /* kept as a circle, or there was no memory for the ellipse */
         {
-            liObjList->lineObj.line.y1 = -liObjList->lineObj.line.y1;
-            liObjList->lineObj.line.y2 = -liObjList->lineObj.line.y2;
+            circle->centerX = center.xx;
+            circle->centerY = center.yy;
+            circle->radius *= scale;
+            prev = node;
         }
-        liObjList = liObjList->next;
+        else
+        {
+            p->lastEllipseObj->ellipseObj.rotation = rotation;
+            p->lastEllipseObj->ellipseObj.lineType = node->circleObj.lineType;
+            p->lastEllipseObj->ellipseObj.color = node->circleObj.color;
+            if(prev) prev->next = next;
+            else p->circleObjList = next;
+            if(p->lastCircleObj == node) p->lastCircleObj = prev;
+        }
+        node = next;
     }
+}
 
-    paObjList = p->pathObjList;
-    while(paObjList)
+/* Rects that can no longer be described by a box and a rotation become polygons,
+ * so this runs after the existing polygons have been moved. */
+static void embPattern_transformRects(EmbPattern* p, EmbTransform t)
+{
+    EmbRectObjectList* node = p->rectObjList;
+    EmbRectObjectList* prev = 0;
+    int keepsAxes = embTransform_keepsAxes(t);
+    int similar = embTransform_isSimilarity(t);
+    double det = embTransform_determinant(t);
+    double scale = sqrt(fabs(det));
+    double turn = atan2(t.b, t.a) * 180.0 / M_PI;
+
+    while(node)
     {
-        paPointList = paObjList->pathObj->pointList;
-        while(paPointList)
+        EmbRectObjectList* next = node->next;
+        EmbRectObject* obj = &(node->rectObj);
+        EmbRect* rect = &(obj->rect);
+        double cx = (rect->left + rect->right) / 2.0;
+        double cy = (rect->top + rect->bottom) / 2.0;
+        double halfWidth = embRect_width(*rect) / 2.0;
+        double halfHeight = embRect_height(*rect) / 2.0;
+
+        if(keepsAxes && obj->rotation == 0.0)
+        {
+            EmbPoint corner1 = embTransform_apply(t, embPoint_make(rect->left, rect->top));
+            EmbPoint corner2 = embTransform_apply(t, embPoint_make(rect->right, rect->bottom));
+            rect->left = corner1.xx;
+            rect->top = corner1.yy;
+            rect->right = corner2.xx;
+            rect->bottom = corner2.yy;
+            obj->radius *= scale;
+            prev = node;
+        }
+        else if(similar)
+        {
+            /* Turned about its center; a mirror also reverses the turn it already had */
+            EmbPoint center = embTransform_apply(t, embPoint_make(cx, cy));
+            rect->left = center.xx - halfWidth * scale;
+            rect->right = center.xx + halfWidth * scale;
+            rect->top = center.yy - halfHeight * scale;
+            rect->bottom = center.yy + halfHeight * scale;
+            obj->rotation = det < 0.0 ? turn - obj->rotation : obj->rotation + turn;
+            obj->radius *= scale;
+            prev = node;
+        }
+        else
         {
-            if(horz) { paPointList->point.xx = -paPointList->point.xx; }
-            if(vert) { paPointList->point.yy = -paPointList->point.yy; }
-            paPointList = paPointList->next;
+            static const double cornerX[4] = { -1.0, 1.0, 1.0, -1.0 };
+            static const double cornerY[4] = { -1.0, -1.0, 1.0, 1.0 };
+            double cosA = cos(obj->rotation * M_PI / 180.0);
+            double sinA = sin(obj->rotation * M_PI / 180.0);
+            EmbPointList* first = 0;
+            EmbPointList* last = 0;
+            EmbPolygonObject* polygon = 0;
+            EmbPolygonObjectList* lastPolygon = p->lastPolygonObj;
+            int i;
+
+            for(i = 0; i < 4; i++)
+            {
+                double dx = cornerX[i] * halfWidth;
+                double dy = cornerY[i] * halfHeight;
+                EmbPoint corner = embTransform_apply(t, embPoint_make(cx + dx * cosA - dy * sinA, cy + dx * sinA + dy * cosA));
+                last = first ? embPointList_add(last, corner) : embPointList_create(corner.xx, corner.yy);
+                if(!first) first = last;
+                if(!last) break;
+            }
+            if(last) polygon = embPolygonObject_create(first, obj->color, obj->lineType);
+            if(polygon) embPattern_addPolygonObjectAbs(p, polygon);
+            else embPointList_free(first);
+
+            if(p->lastPolygonObj == lastPolygon)
+            {
+                embLog_error("emb-pattern.c embPattern_transformRects(), cannot allocate memory for the polygon of a rect\n");
+                prev = node;
+            }
+            else
+            {
+                if(prev) prev->next = next;
+                else p->rectObjList = next;
+                if(p->lastRectObj == node) p->lastRectObj = prev;
+            }
         }
-        paObjList = paObjList->next;
+        node = next;
     }
+}
 
-    pObjList = p->pointObjList;
-    while(pObjList)
+/*! Applies the affine transform (\a t) to every stitch and object of the pattern (\a p) in one pass.
+ *  Circles that are stretched unevenly become ellipses, and rects that are sheared or stretched
+ *  across their rotation become polygons. Arcs keep their three points, so they stay circular. */
+void embPattern_transform(EmbPattern* p, EmbTransform t)
+{
+    EmbArcObjectList* aObjList = 0;
+    EmbLineObjectList* liObjList = 0;
+    EmbPathObjectList* paObjList = 0;
+    EmbPointObjectList* pObjList = 0;
+    EmbPolygonObjectList* pogObjList = 0;
+    EmbPolylineObjectList* polObjList = 0;
+    EmbSplineObjectList* sObjList = 0;
+    EmbPoint point;
+
+    if(!p) { embLog_error("emb-pattern.c embPattern_transform(), p argument is null\n"); return; }
+    if(embTransform_isIdentity(t)) return;
+
+    embPattern_transformStitches(p, t);
+
+    for(aObjList = p->arcObjList; aObjList; aObjList = aObjList->next)
     {
-        if(horz) { pObjList->pointObj.point.xx = -pObjList->pointObj.point.xx; }
-        if(vert) { pObjList->pointObj.point.yy = -pObjList->pointObj.point.yy; }
-        pObjList = pObjList->next;
+        EmbArc* arc = &(aObjList->arcObj.arc);
+        point = embTransform_apply(t, embPoint_make(arc->startX, arc->startY));
+        arc->startX = point.xx;
+        arc->startY = point.yy;
+        point = embTransform_apply(t, embPoint_make(arc->midX, arc->midY));
+        arc->midX = point.xx;
+        arc->midY = point.yy;
+        point = embTransform_apply(t, embPoint_make(arc->endX, arc->endY));
+        arc->endX = point.xx;
+        arc->endY = point.yy;
     }
 
-    pogObjList = p->polygonObjList;
-    while(pogObjList)
+    embPattern_transformEllipses(p, t);
+    embPattern_transformCircles(p, t);
+
+    for(liObjList = p->lineObjList; liObjList; liObjList = liObjList->next)
     {
-        pogPointList = pogObjList->polygonObj->pointList;
-        while(pogPointList)
-        {
-            if(horz) { pogPointList->point.xx = -pogPointList->point.xx; }
-            if(vert) { pogPointList->point.yy = -pogPointList->point.yy; }
-            pogPointList = pogPointList->next;
-        }
-        pogObjList = pogObjList->next;
+        EmbLine* line = &(liObjList->lineObj.line);
+        point = embTransform_apply(t, embPoint_make(line->x1, line->y1));
+        line->x1 = point.xx;
+        line->y1 = point.yy;
+        point = embTransform_apply(t, embPoint_make(line->x2, line->y2));
+        line->x2 = point.xx;
+        line->y2 = point.yy;
     }
 
-    polObjList = p->polylineObjList;
-    while(polObjList)
+    for(paObjList = p->pathObjList; paObjList; paObjList = paObjList->next)
     {
-        polPointList = polObjList->polylineObj->pointList;
-        while(polPointList)
-        {
-            if(horz) { polPointList->point.xx = -polPointList->point.xx; }
-            if(vert) { polPointList->point.yy = -polPointList->point.yy; }
-            polPointList = polPointList->next;
-        }
-        polObjList = polObjList->next;
+        embPointList_transform(paObjList->pathObj->pointList, t);
     }
 
-    rObjList = p->rectObjList;
-    while(rObjList)
+    for(pObjList = p->pointObjList; pObjList; pObjList = pObjList->next)
     {
-        if(horz)
-        {
-            rObjList->rectObj.rect.left = -rObjList->rectObj.rect.left;
-            rObjList->rectObj.rect.right = -rObjList->rectObj.rect.right;
-        }
-        if(vert)
-        {
-            rObjList->rectObj.rect.top = -rObjList->rectObj.rect.top;
-            rObjList->rectObj.rect.bottom = -rObjList->rectObj.rect.bottom;
-        }
-        rObjList = rObjList->next;
+        pObjList->pointObj.point = embTransform_apply(t, pObjList->pointObj.point);
     }
 
-    sObjList = p->splineObjList;
-    while(sObjList)
+    for(pogObjList = p->polygonObjList; pogObjList; pogObjList = pogObjList->next)
     {
-        /* TODO: embPattern_flip for splines */
-        sObjList = sObjList->next;
+        embPointList_transform(pogObjList->polygonObj->pointList, t);
+    }
+
+    for(polObjList = p->polylineObjList; polObjList; polObjList = polObjList->next)
+    {
+        embPointList_transform(polObjList->polylineObj->pointList, t);
     }
+
+    embPattern_transformRects(p, t);
+
+    for(sObjList = p->splineObjList; sObjList; sObjList = sObjList->next)
+    {
+        EmbBezier* bezier = &(sObjList->splineObj.bezier);
+        point = embTransform_apply(t, embPoint_make(bezier->startX, bezier->startY));
+        bezier->startX = point.xx;
+        bezier->startY = point.yy;
+        point = embTransform_apply(t, embPoint_make(bezier->control1X, bezier->control1Y));
+        bezier->control1X = point.xx;
+        bezier->control1Y = point.yy;
+        point = embTransform_apply(t, embPoint_make(bezier->control2X, bezier->control2Y));
+        bezier->control2X = point.xx;
+        bezier->control2Y = point.yy;
+        point = embTransform_apply(t, embPoint_make(bezier->endX, bezier->endY));
+        bezier->endX = point.xx;
+        bezier->endY = point.yy;
+    }
+}
+
+/*! Returns a view of the pattern (\a p) as if (\a t) had been applied to it.
+ *  Nothing is computed or copied until the view is read. */
+EmbPatternView embPattern_view(EmbPattern* p, EmbTransform t)
+{
+    EmbPatternView view;
+    view.pattern = p;
+    view.transform = t;
+    return view;
+}
+
+/*! Returns the number of stitches seen through the view (\a view). */
+int embPatternView_stitchCount(const EmbPatternView* view)
+{
+    if(!view || !view->pattern) { embLog_error("emb-pattern.c embPatternView_stitchCount(), view argument is null\n"); return 0; }
+    return embStitchList_count(view->pattern->stitchList);
+}
+
+/*! Returns stitch (\a index) of the pattern as seen through the view (\a view),
+ *  or a zeroed stitch if there is no such stitch. */
+EmbStitch embPatternView_stitch(const EmbPatternView* view, int index)
+{
+    EmbStitch st = { 0, 0.0, 0.0, 0 };
+    EmbPoint point;
+
+    if(!view || !view->pattern) { embLog_error("emb-pattern.c embPatternView_stitch(), view argument is null\n"); return st; }
+    if(index < 0 || index >= embStitchList_count(view->pattern->stitchList))
+    {
+        embLog_error("emb-pattern.c embPatternView_stitch(), index %d is out of range\n", index);
+        return st;
+    }
+    st = view->pattern->stitchList->stitch[index];
+    point = embTransform_apply(view->transform, embPoint_make(st.xx, st.yy));
+    st.xx = point.xx;
+    st.yy = point.yy;
+    return st;
+}
+
+/*! Returns the position (\a x,\a y) of the pattern as seen through the view (\a view). */
+EmbPoint embPatternView_point(const EmbPatternView* view, double x, double y)
+{
+    return embTransform_apply(view->transform, embPoint_make(x, y));
+}
+
+/*! Returns what embPattern_calcBoundingBox() would for the pattern of the view (\a view) once transformed. */
+EmbRect embPatternView_boundingBox(const EmbPatternView* view)
+{
+    EmbRect empty;
+
+    if(!view)
+    {
+        embLog_error("emb-pattern.c embPatternView_boundingBox(), view argument is null\n");
+        empty.left = empty.top = empty.right = empty.bottom = 0.0;
+        return empty;
+    }
+    return embPattern_boundingBoxUnder(view->pattern, view->transform);
 }
 
 void embPattern_combineJumpStitches(EmbPattern* p)
 {
-    EmbStitchList* pointer = 0;
+    EmbStitch* st = 0;
     int jumpCount = 0;
-    EmbStitchList* jumpListStart = 0;
+    int jumpListStart = 0;
+    int i, out = 0;
 
     if(!p) { embLog_error("emb-pattern.c embPattern_combineJumpStitches(), p argument is null\n"); return; }
-    pointer = p->stitchList;
-    while(pointer)
+    /* Compact in place: each run of JUMP stitches collapses into its first
+     * stitch, moved to the position of the stitch that ends the run. */
+    st = p->stitchList->stitch;
+    for(i = 0; i < embStitchList_count(p->stitchList); i++)
     {
-        if(pointer->stitch.flags & JUMP)
+        if(st[i].flags & JUMP)
         {
             if(jumpCount == 0)
             {
-                jumpListStart = pointer;
+                jumpListStart = out;
+                st[out++] = st[i];
             }
             jumpCount++;
         }
@@ -739,110 +1350,97 @@ void embPattern_combineJumpStitches(EmbPattern* p)
         {
             if(jumpCount > 0)
             {
-                EmbStitchList* removePointer = jumpListStart->next;
-                jumpListStart->stitch.xx = pointer->stitch.xx;
-                jumpListStart->stitch.yy = pointer->stitch.yy;
-                jumpListStart->next = pointer;
-
-                for(; jumpCount > 0; jumpCount--)
-                {
-                    EmbStitchList* tempPointer = removePointer->next;
-                    free(removePointer);
-                    removePointer = tempPointer;
-                }
+                st[jumpListStart].xx = st[i].xx;
+                st[jumpListStart].yy = st[i].yy;
                 jumpCount = 0;
             }
+            st[out++] = st[i];
         }
-        pointer = pointer->next;
     }
+    /* A trailing run of jumps is not terminated by a stitch, so it is kept as-is. */
+    for(i = embStitchList_count(p->stitchList) - jumpCount + 1; jumpCount > 1; jumpCount--, i++)
+    {
+        st[out++] = st[i];
+    }
+    p->stitchList->count = out;
+    embPattern_invalidateStats(p);
 }
 
 /*TODO: The params determine the max XY movement rather than the length. They need renamed or clarified further. */
 void embPattern_correctForMaxStitchLength(EmbPattern* p, double maxStitchLength, double maxJumpLength)
 {
-    int j = 0, splits;
+    int i, j = 0, splits, inserted = 0;
     double maxXY, maxLen, addX, addY;
+    EmbStitch* last = 0;
 
     if(!p) { embLog_error("emb-pattern.c embPattern_correctForMaxStitchLength(), p argument is null\n"); return; }
     if(embStitchList_count(p->stitchList) > 1)
     {
-        EmbStitchList* pointer = 0;
-        EmbStitchList* prev = 0;
-        prev = p->stitchList;
-        pointer = prev->next;
-
-        while(pointer)
+        EmbStitchList* corrected = embStitchList_create();
+        EmbStitch prev;
+        if(!corrected) { embLog_error("emb-pattern.c embPattern_correctForMaxStitchLength(), cannot allocate memory for corrected\n"); return; }
+        if(!embStitchList_reserve(corrected, embStitchList_count(p->stitchList))) { embStitchList_free(corrected); return; }
+
+        prev = p->stitchList->stitch[0];
+        embStitchList_add(corrected, prev);
+        for(i = 1; i < embStitchList_count(p->stitchList); i++)
         {
-            double xx = prev->stitch.xx;
-            double yy = prev->stitch.yy;
-            double dx = pointer->stitch.xx - xx;
-            double dy = pointer->stitch.yy - yy;
+            EmbStitch st = p->stitchList->stitch[i];
+            double xx = prev.xx;
+            double yy = prev.yy;
+            double dx = st.xx - xx;
+            double dy = st.yy - yy;
             if((fabs(dx) > maxStitchLength) || (fabs(dy) > maxStitchLength))
             {
                 maxXY = max(fabs(dx), fabs(dy));
-                if(pointer->stitch.flags & (JUMP | TRIM)) maxLen = maxJumpLength;
+                if(st.flags & (JUMP | TRIM)) maxLen = maxJumpLength;
                 else maxLen = maxStitchLength;
 
                 splits = (int)ceil((double)maxXY / maxLen);
 
                 if(splits > 1)
                 {
-                    int flagsToUse = pointer->stitch.flags;
-                    int colorToUse = pointer->stitch.color;
                     addX = (double)dx / splits;
                     addY = (double)dy / splits;
 
                     for(j = 1; j < splits; j++)
                     {
-                        EmbStitchList* item = 0;
                         EmbStitch s;
                         s.xx = xx + addX * j;
                         s.yy = yy + addY * j;
-                        s.flags = flagsToUse;
-                        s.color = colorToUse;
-                        item = (EmbStitchList*)malloc(sizeof(EmbStitchList));
-                        if(!item) { embLog_error("emb-pattern.c embPattern_correctForMaxStitchLength(), cannot allocate memory for item\n"); return; }
-                        item->stitch = s;
-                        item->next = pointer;
-                        prev->next = item;
-                        prev = item;
+                        s.flags = st.flags;
+                        s.color = st.color;
+                        if(!embStitchList_add(corrected, s)) { embStitchList_free(corrected); return; }
                     }
+                    inserted = 1;
                 }
             }
-            prev = pointer;
-            if(pointer)
-            {
-                pointer = pointer->next;
-            }
+            if(!embStitchList_add(corrected, st)) { embStitchList_free(corrected); return; }
+            prev = st;
         }
+
+        embStitchList_free(p->stitchList);
+        p->stitchList = corrected;
+        /* Split stitches lie between stitches that were already counted, but they shift the color block indices. */
+        if(inserted)
+            embPattern_invalidateStats(p);
     }
-    if(p->lastStitch && p->lastStitch->stitch.flags != END)
+    last = embStitchList_last(p->stitchList);
+    if(last && last->flags != END)
     {
-        embPattern_addStitchAbs(p, p->lastStitch->stitch.xx, p->lastStitch->stitch.yy, END, 1);
+        embPattern_addStitchAbs(p, last->xx, last->yy, END, 1);
     }
 }
 
+/*! Moves the pattern (\a p) so that the center of its bounding box is at the origin. */
 void embPattern_center(EmbPattern* p)
 {
-    /* TODO: review this. currently not used in anywhere. Also needs to handle various design objects */
-    int moveLeft, moveTop;
     EmbRect boundingRect;
-    EmbStitchList* pointer = 0;
 
     if(!p) { embLog_error("emb-pattern.c embPattern_center(), p argument is null\n"); return; }
     boundingRect = embPattern_calcBoundingBox(p);
-
-    moveLeft = (int)(boundingRect.left - (embRect_width(boundingRect) / 2.0));
-    moveTop = (int)(boundingRect.top - (embRect_height(boundingRect) / 2.0));
-
-    pointer = p->stitchList;
-    while(pointer)
-    {
-        EmbStitch s;
-        s = pointer->stitch;
-        s.xx -= moveLeft;
-        s.yy -= moveTop;
-    }
+    embPattern_transform(p, embTransform_translate(-(boundingRect.left + boundingRect.right) / 2.0,
+                                                   -(boundingRect.top + boundingRect.bottom) / 2.0));
 }
 
 /*TODO: Description needed. */
@@ -852,86 +1450,87 @@ void embPattern_loadExternalColorFile(EmbPattern* p, const char* fileName)
     return; /* TODO ARDUINO: This function leaks memory. While it isn't crucial to running the machine, it would be nice use this function, so fix it up. */
 #endif /* ARDUINO */
 
+    static const char* const colorFileEndings[] = { ".edr", ".rgb", ".col", ".inf" };
     char hasRead = 0;
     EmbReaderWriter* colorFile = 0;
-    const char* dotPos = strrchr(fileName, '.');
+    const char* dotPos = 0;
     char* extractName = 0;
+    int i;
 
     if(!p) { embLog_error("emb-pattern.c embPattern_loadExternalColorFile(), p argument is null\n"); return; }
     if(!fileName) { embLog_error("emb-pattern.c embPattern_loadExternalColorFile(), fileName argument is null\n"); return; }
 
+    dotPos = strrchr(fileName, '.');
     extractName = (char*)malloc(dotPos - fileName + 5);
     if(!extractName) { embLog_error("emb-pattern.c embPattern_loadExternalColorFile(), cannot allocate memory for extractName\n"); return; }
-    extractName = (char*)memcpy(extractName, fileName, dotPos - fileName);
-    extractName[dotPos - fileName] = '\0';
-    strcat(extractName,".edr");
-    colorFile = embReaderWriter_getByFileName(extractName);
-    if(colorFile)
-    {
-        hasRead = (char)colorFile->reader(p, extractName);
-    }
-    if(!hasRead)
+    for(i = 0; i < 4 && !hasRead; i++)
     {
-        free(colorFile);
-        colorFile = 0;
-        extractName = (char*)memcpy(extractName, fileName, dotPos - fileName);
-        extractName[dotPos - fileName] = '\0';
-        strcat(extractName,".rgb");
-        colorFile = embReaderWriter_getByFileName(extractName);
-        if(colorFile)
-        {
-            hasRead = (char)colorFile->reader(p, extractName);
-        }
-    }
-    if(!hasRead)
-    {
-        free(colorFile);
-        colorFile = 0;
         extractName = (char*)memcpy(extractName, fileName, dotPos - fileName);
         extractName[dotPos - fileName] = '\0';
-        strcat(extractName,".col");
+        strcat(extractName, colorFileEndings[i]);
+        if(p->readOptions.colorFileProbe && !p->readOptions.colorFileProbe(extractName, p->readOptions.colorFileProbeData))
+            continue;
         colorFile = embReaderWriter_getByFileName(extractName);
         if(colorFile)
         {
             hasRead = (char)colorFile->reader(p, extractName);
         }
-    }
-    if(!hasRead)
-    {
         free(colorFile);
         colorFile = 0;
-        extractName = (char*)memcpy(extractName, fileName, dotPos - fileName);
-        extractName[dotPos - fileName] = '\0';
-        strcat(extractName,".inf");
-        colorFile = embReaderWriter_getByFileName(extractName);
-        if(colorFile)
-        {
-            hasRead = (char)colorFile->reader(p, extractName);
-        }
     }
-    free(colorFile);
-    colorFile = 0;
     free(extractName);
     extractName = 0;
 }
 
+/*! Makes the readers read into the pattern (\a p) as (\a options) say, or the default way if (\a options) is 0.
+ *  The options belong to the pattern, so readers on other threads are not affected, and embPattern_reset() keeps them. */
+void embPattern_setReadOptions(EmbPattern* p, const EmbReadOptions* options)
+{
+    if(!p) { embLog_error("emb-pattern.c embPattern_setReadOptions(), p argument is null\n"); return; }
+    if(options)
+    {
+        p->readOptions = *options;
+    }
+    else
+    {
+        p->readOptions.colorFileProbe = 0;
+        p->readOptions.colorFileProbeData = 0;
+        p->readOptions.parallelFor = 0;
+        p->readOptions.parallelForData = 0;
+    }
+}
+
+/*! Empties the pattern (\a p) so it can be reused for another design, keeping the memory
+ *  it has already allocated for stitches, threads and objects. */
+void embPattern_reset(EmbPattern* p)
+{
+    if(!p) { embLog_error("emb-pattern.c embPattern_reset(), p argument is null\n"); return; }
+    p->settings = embSettings_init();
+    p->currentColorIndex = 0;
+    embStitchList_clear(p->stitchList);
+    embThreadList_clear(p->threadList);
+    embPattern_resetStats(p);
+
+    p->hoop.height = 0.0;
+    p->hoop.width = 0.0;
+    embPattern_clearObjects(p);
+    embArena_reset(&p->arena);
+
+    p->lastX = 0.0;
+    p->lastY = 0.0;
+}
+
 /*! Frees all memory allocated in the pattern (\a p). */
 void embPattern_free(EmbPattern* p)
 {
     if(!p) { embLog_error("emb-pattern.c embPattern_free(), p argument is null\n"); return; }
-    embStitchList_free(p->stitchList);              p->stitchList = 0;      p->lastStitch = 0;
-    embThreadList_free(p->threadList);              p->threadList = 0;      p->lastThread = 0;
-
-    embArcObjectList_free(p->arcObjList);           p->arcObjList = 0;      p->lastArcObj = 0;
-    embCircleObjectList_free(p->circleObjList);     p->circleObjList = 0;   p->lastCircleObj = 0;
-    embEllipseObjectList_free(p->ellipseObjList);   p->ellipseObjList = 0;  p->lastEllipseObj = 0;
-    embLineObjectList_free(p->lineObjList);         p->lineObjList = 0;     p->lastLineObj = 0;
-    embPathObjectList_free(p->pathObjList);         p->pathObjList = 0;     p->lastPathObj = 0;
-    embPointObjectList_free(p->pointObjList);       p->pointObjList = 0;    p->lastPointObj = 0;
-    embPolygonObjectList_free(p->polygonObjList);   p->polygonObjList = 0;  p->lastPolygonObj = 0;
-    embPolylineObjectList_free(p->polylineObjList); p->polylineObjList = 0; p->lastPolylineObj = 0;
-    embRectObjectList_free(p->rectObjList);         p->rectObjList = 0;     p->lastRectObj = 0;
- /* embSplineObjectList_free(p->splineObjList);     p->splineObjList = 0;   p->lastSplineObj = 0; TODO: finish this */
+    embStitchList_free(p->stitchList);              p->stitchList = 0;
+    embThreadList_free(p->threadList);              p->threadList = 0;
+    free(p->stats.colorBlocks);                     p->stats.colorBlocks = 0;
+
+    /* Every object list node and string of the pattern lives in the arena */
+    embPattern_clearObjects(p);
+    embArena_free(&p->arena);
 
     free(p);
     p = 0;
@@ -940,129 +1539,240 @@ void embPattern_free(EmbPattern* p)
 /*! Adds a circle object to pattern (\a p) with its center at the absolute position (\a cx,\a cy) with a radius of (\a r). Positive y is up. Units are in millimeters. */
 void embPattern_addCircleObjectAbs(EmbPattern* p, double cx, double cy, double r)
 {
-    EmbCircleObject circleObj = embCircleObject_make(cx, cy, r);
+    EmbCircleObjectList* node = 0;
 
     if(!p) { embLog_error("emb-pattern.c embPattern_addCircleObjectAbs(), p argument is null\n"); return; }
+    node = (EmbCircleObjectList*)embArena_alloc(&p->arena, sizeof(EmbCircleObjectList));
+    if(!node) { embLog_error("emb-pattern.c embPattern_addCircleObjectAbs(), cannot allocate memory for node\n"); return; }
+    node->circleObj = embCircleObject_make(cx, cy, r);
+    node->next = 0;
     if(embCircleObjectList_empty(p->circleObjList))
     {
-        p->circleObjList = p->lastCircleObj = embCircleObjectList_create(circleObj);
+        p->circleObjList = node;
     }
     else
     {
-        p->lastCircleObj = embCircleObjectList_add(p->lastCircleObj, circleObj);
+        p->lastCircleObj->next = node;
     }
+    p->lastCircleObj = node;
 }
 
 /*! Adds an ellipse object to pattern (\a p) with its center at the absolute position (\a cx,\a cy) with radii of (\a rx,\a ry). Positive y is up. Units are in millimeters. */
 void embPattern_addEllipseObjectAbs(EmbPattern* p, double cx, double cy, double rx, double ry)
 {
-    EmbEllipseObject ellipseObj = embEllipseObject_make(cx, cy, rx, ry);
+    EmbEllipseObjectList* node = 0;
 
     if(!p) { embLog_error("emb-pattern.c embPattern_addEllipseObjectAbs(), p argument is null\n"); return; }
+    node = (EmbEllipseObjectList*)embArena_alloc(&p->arena, sizeof(EmbEllipseObjectList));
+    if(!node) { embLog_error("emb-pattern.c embPattern_addEllipseObjectAbs(), cannot allocate memory for node\n"); return; }
+    node->ellipseObj = embEllipseObject_make(cx, cy, rx, ry);
+    node->next = 0;
     if(embEllipseObjectList_empty(p->ellipseObjList))
     {
-        p->ellipseObjList = p->lastEllipseObj = embEllipseObjectList_create(ellipseObj);
+        p->ellipseObjList = node;
     }
     else
     {
-        p->lastEllipseObj = embEllipseObjectList_add(p->lastEllipseObj, ellipseObj);
+        p->lastEllipseObj->next = node;
     }
+    p->lastEllipseObj = node;
 }
 
 /*! Adds a line object to pattern (\a p) starting at the absolute position (\a x1,\a y1) and ending at the absolute position (\a x2,\a y2). Positive y is up. Units are in millimeters. */
 void embPattern_addLineObjectAbs(EmbPattern* p, double x1, double y1, double x2, double y2)
 {
-    EmbLineObject lineObj = embLineObject_make(x1, y1, x2, y2);
+    EmbLineObjectList* node = 0;
 
     if(!p) { embLog_error("emb-pattern.c embPattern_addLineObjectAbs(), p argument is null\n"); return; }
+    node = (EmbLineObjectList*)embArena_alloc(&p->arena, sizeof(EmbLineObjectList));
+    if(!node) { embLog_error("emb-pattern.c embPattern_addLineObjectAbs(), cannot allocate memory for node\n"); return; }
+    node->lineObj = embLineObject_make(x1, y1, x2, y2);
+    node->next = 0;
     if(embLineObjectList_empty(p->lineObjList))
     {
-        p->lineObjList = p->lastLineObj = embLineObjectList_create(lineObj);
+        p->lineObjList = node;
     }
     else
     {
-        p->lastLineObj = embLineObjectList_add(p->lastLineObj, lineObj);
+        p->lastLineObj->next = node;
     }
+    p->lastLineObj = node;
 }
 
+/*! Adds the path object (\a obj) to pattern (\a p). The pattern keeps a copy in its arena and frees (\a obj). */
 void embPattern_addPathObjectAbs(EmbPattern* p, EmbPathObject* obj)
 {
+    EmbPathObject* copy = 0;
+    EmbPathObjectList* node = 0;
+
     if(!p) { embLog_error("emb-pattern.c embPattern_addPathObjectAbs(), p argument is null\n"); return; }
     if(!obj) { embLog_error("emb-pattern.c embPattern_addPathObjectAbs(), obj argument is null\n"); return; }
     if(embPointList_empty(obj->pointList)) { embLog_error("emb-pattern.c embPattern_addPathObjectAbs(), obj->pointList is empty\n"); return; }
 
+    copy = (EmbPathObject*)embArena_alloc(&p->arena, sizeof(EmbPathObject));
+    node = (EmbPathObjectList*)embArena_alloc(&p->arena, sizeof(EmbPathObjectList));
+    if(!copy || !node) { embLog_error("emb-pattern.c embPattern_addPathObjectAbs(), cannot allocate memory for node\n"); return; }
+    *copy = *obj;
+    copy->pointList = embPattern_copyPointList(p, obj->pointList);
+    copy->flagList = embPattern_copyFlagList(p, obj->flagList);
+    embPathObject_free(obj);
+
+    node->pathObj = copy;
+    node->next = 0;
     if(embPathObjectList_empty(p->pathObjList))
     {
-        p->pathObjList = p->lastPathObj = embPathObjectList_create(obj);
+        p->pathObjList = node;
     }
     else
     {
-        p->lastPathObj = embPathObjectList_add(p->lastPathObj, obj);
+        p->lastPathObj->next = node;
     }
+    p->lastPathObj = node;
+}
+
+/*! Adds a path object to pattern (\a p) made of the (\a count) points at (\a points), each with the path flag of
+ *  the same index in (\a flags), building its lists directly in the pattern's arena. */
+void embPattern_addPathObjectPoints(EmbPattern* p, const EmbPoint* points, const EmbFlag* flags, int count, EmbColor color, int lineType)
+{
+    EmbPathObject* obj = 0;
+    EmbPathObjectList* node = 0;
+    EmbPointList* pointNodes = 0;
+    EmbFlagList* flagNodes = 0;
+    int i;
+
+    if(!p) { embLog_error("emb-pattern.c embPattern_addPathObjectPoints(), p argument is null\n"); return; }
+    if(!points || !flags || count <= 0) { embLog_error("emb-pattern.c embPattern_addPathObjectPoints(), the path has no points\n"); return; }
+
+    obj = (EmbPathObject*)embArena_alloc(&p->arena, sizeof(EmbPathObject));
+    node = (EmbPathObjectList*)embArena_alloc(&p->arena, sizeof(EmbPathObjectList));
+    pointNodes = (EmbPointList*)embArena_alloc(&p->arena, sizeof(EmbPointList) * (size_t)count);
+    flagNodes = (EmbFlagList*)embArena_alloc(&p->arena, sizeof(EmbFlagList) * (size_t)count);
+    if(!obj || !node || !pointNodes || !flagNodes) { embLog_error("emb-pattern.c embPattern_addPathObjectPoints(), cannot allocate memory for node\n"); return; }
+    for(i = 0; i < count; i++)
+    {
+        pointNodes[i].point = points[i];
+        pointNodes[i].next = (i + 1 < count) ? &pointNodes[i + 1] : 0;
+        flagNodes[i].flag = flags[i];
+        flagNodes[i].next = (i + 1 < count) ? &flagNodes[i + 1] : 0;
+    }
+    obj->pointList = pointNodes;
+    obj->flagList = flagNodes;
+    obj->color = color;
+    obj->lineType = lineType;
+
+    node->pathObj = obj;
+    node->next = 0;
+    if(embPathObjectList_empty(p->pathObjList))
+    {
+        p->pathObjList = node;
+    }
+    else
+    {
+        p->lastPathObj->next = node;
+    }
+    p->lastPathObj = node;
 }
 
 /*! Adds a point object to pattern (\a p) at the absolute position (\a x,\a y). Positive y is up. Units are in millimeters. */
 void embPattern_addPointObjectAbs(EmbPattern* p, double x, double y)
 {
-    EmbPointObject pointObj = embPointObject_make(x, y);
+    EmbPointObjectList* node = 0;
 
     if(!p) { embLog_error("emb-pattern.c embPattern_addPointObjectAbs(), p argument is null\n"); return; }
+    node = (EmbPointObjectList*)embArena_alloc(&p->arena, sizeof(EmbPointObjectList));
+    if(!node) { embLog_error("emb-pattern.c embPattern_addPointObjectAbs(), cannot allocate memory for node\n"); return; }
+    node->pointObj = embPointObject_make(x, y);
+    node->next = 0;
     if(embPointObjectList_empty(p->pointObjList))
     {
-        p->pointObjList = p->lastPointObj = embPointObjectList_create(pointObj);
+        p->pointObjList = node;
     }
     else
     {
-        p->lastPointObj = embPointObjectList_add(p->lastPointObj, pointObj);
+        p->lastPointObj->next = node;
     }
+    p->lastPointObj = node;
 }
 
+/*! Adds the polygon object (\a obj) to pattern (\a p). The pattern keeps a copy in its arena and frees (\a obj). */
 void embPattern_addPolygonObjectAbs(EmbPattern* p, EmbPolygonObject* obj)
 {
+    EmbPolygonObject* copy = 0;
+    EmbPolygonObjectList* node = 0;
+
     if(!p) { embLog_error("emb-pattern.c embPattern_addPolygonObjectAbs(), p argument is null\n"); return; }
     if(!obj) { embLog_error("emb-pattern.c embPattern_addPolygonObjectAbs(), obj argument is null\n"); return; }
     if(embPointList_empty(obj->pointList)) { embLog_error("emb-pattern.c embPattern_addPolygonObjectAbs(), obj->pointList is empty\n"); return; }
 
+    copy = (EmbPolygonObject*)embArena_alloc(&p->arena, sizeof(EmbPolygonObject));
+    node = (EmbPolygonObjectList*)embArena_alloc(&p->arena, sizeof(EmbPolygonObjectList));
+    if(!copy || !node) { embLog_error("emb-pattern.c embPattern_addPolygonObjectAbs(), cannot allocate memory for node\n"); return; }
+    *copy = *obj;
+    copy->pointList = embPattern_copyPointList(p, obj->pointList);
+    embPolygonObject_free(obj);
+
+    node->polygonObj = copy;
+    node->next = 0;
     if(embPolygonObjectList_empty(p->polygonObjList))
     {
-        p->polygonObjList = p->lastPolygonObj = embPolygonObjectList_create(obj);
+        p->polygonObjList = node;
     }
     else
     {
-        p->lastPolygonObj = embPolygonObjectList_add(p->lastPolygonObj, obj);
+        p->lastPolygonObj->next = node;
     }
+    p->lastPolygonObj = node;
 }
 
+/*! Adds the polyline object (\a obj) to pattern (\a p). The pattern keeps a copy in its arena and frees (\a obj). */
 void embPattern_addPolylineObjectAbs(EmbPattern* p, EmbPolylineObject* obj)
 {
+    EmbPolylineObject* copy = 0;
+    EmbPolylineObjectList* node = 0;
+
     if(!p) { embLog_error("emb-pattern.c embPattern_addPolylineObjectAbs(), p argument is null\n"); return; }
     if(!obj) { embLog_error("emb-pattern.c embPattern_addPolylineObjectAbs(), obj argument is null\n"); return; }
     if(embPointList_empty(obj->pointList)) { embLog_error("emb-pattern.c embPattern_addPolylineObjectAbs(), obj->pointList is empty\n"); return; }
 
+    copy = (EmbPolylineObject*)embArena_alloc(&p->arena, sizeof(EmbPolylineObject));
+    node = (EmbPolylineObjectList*)embArena_alloc(&p->arena, sizeof(EmbPolylineObjectList));
+    if(!copy || !node) { embLog_error("emb-pattern.c embPattern_addPolylineObjectAbs(), cannot allocate memory for node\n"); return; }
+    *copy = *obj;
+    copy->pointList = embPattern_copyPointList(p, obj->pointList);
+    embPolylineObject_free(obj);
+
+    node->polylineObj = copy;
+    node->next = 0;
     if(embPolylineObjectList_empty(p->polylineObjList))
     {
-        p->polylineObjList = p->lastPolylineObj = embPolylineObjectList_create(obj);
+        p->polylineObjList = node;
     }
     else
     {
-        p->lastPolylineObj = embPolylineObjectList_add(p->lastPolylineObj, obj);
+        p->lastPolylineObj->next = node;
     }
+    p->lastPolylineObj = node;
 }
 
 /*! Adds a rectangle object to pattern (\a p) at the absolute position (\a x,\a y) with a width of (\a w) and a height of (\a h). Positive y is up. Units are in millimeters. */
 void embPattern_addRectObjectAbs(EmbPattern* p, double x, double y, double w, double h)
 {
-    EmbRectObject rectObj = embRectObject_make(x, y, w, h);
+    EmbRectObjectList* node = 0;
 
     if(!p) { embLog_error("emb-pattern.c embPattern_addRectObjectAbs(), p argument is null\n"); return; }
+    node = (EmbRectObjectList*)embArena_alloc(&p->arena, sizeof(EmbRectObjectList));
+    if(!node) { embLog_error("emb-pattern.c embPattern_addRectObjectAbs(), cannot allocate memory for node\n"); return; }
+    node->rectObj = embRectObject_make(x, y, w, h);
+    node->next = 0;
     if(embRectObjectList_empty(p->rectObjList))
     {
-        p->rectObjList = p->lastRectObj = embRectObjectList_create(rectObj);
+        p->rectObjList = node;
     }
     else
     {
-        p->lastRectObj = embRectObjectList_add(p->lastRectObj, rectObj);
+        p->lastRectObj->next = node;
     }
+    p->lastRectObj = node;
 }
 
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
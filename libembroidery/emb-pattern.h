@@ -3,11 +3,13 @@
 #define EMB_PATTERN_H
 
 #include "emb-arc.h"
+#include "emb-arena.h"
 #include "emb-circle.h"
 #include "emb-ellipse.h"
 #include "emb-hoop.h"
 #include "emb-line.h"
 #include "emb-path.h"
+#include "emb-path-data.h"
 #include "emb-point.h"
 #include "emb-polygon.h"
 #include "emb-polyline.h"
@@ -16,12 +18,46 @@
 #include "emb-spline.h"
 #include "emb-stitch.h"
 #include "emb-thread.h"
+#include "emb-transform.h"
 
 #include "api-start.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*! Summary of the stitch list, kept up to date as stitches are added so that
+ *  writers can fill in their headers without walking the stitches.
+ *  Read it through embPattern_stats(). */
+typedef struct EmbPatternStats_
+{
+    int valid;              /* 0 once an in-place edit has made the rest stale */
+    int jumpCount;          /* stitches with JUMP set */
+    int trimCount;          /* stitches with TRIM set */
+    int stopCount;          /* stitches with STOP set */
+    int controlCount;       /* stitches with any of JUMP, TRIM or STOP set */
+    int maxColorIndex;
+    EmbRect extents;        /* bounding box of the stitches that are not TRIMs */
+    int* colorBlocks;       /* index of the first stitch of each run of one color */
+    int colorBlockCount;
+    int colorBlockCapacity;
+} EmbPatternStats;
+
+/* Answers whether the file (fileName) exists, see EmbReadOptions. */
+typedef int (*EmbFileProbe)(const char* fileName, void* data);
+
+/* How a design is read. Zeroed options read it the default way. */
+typedef struct EmbReadOptions_
+{
+    /* Asked whether each color file embPattern_loadExternalColorFile() would try exists before it is opened,
+     * so a caller converting many designs can answer from a directory listing. 0 always tries the open. */
+    EmbFileProbe colorFileProbe;
+    void* colorFileProbeData;
+    /* Given the blocks of each long path in the design to flatten, see embPathData_flatten(). 0 flattens them on the
+     * reading thread. */
+    EmbParallelFor parallelFor;
+    void* parallelForData;
+} EmbReadOptions;
+
 typedef struct EmbPattern_
 {
     EmbSettings settings;
@@ -40,9 +76,6 @@ typedef struct EmbPattern_
     EmbRectObjectList* rectObjList;
     EmbSplineObjectList* splineObjList;
 
-    EmbStitchList* lastStitch;
-    EmbThreadList* lastThread;
-
     EmbArcObjectList* lastArcObj;
     EmbCircleObjectList* lastCircleObj;
     EmbEllipseObjectList* lastEllipseObj;
@@ -54,18 +87,42 @@ typedef struct EmbPattern_
     EmbRectObjectList* lastRectObj;
     EmbSplineObjectList* lastSplineObj;
 
+    /* The object lists above, their nodes and the strings read with the
+     * pattern are allocated from here; do not free them individually. */
+    EmbArena arena;
+
     int currentColorIndex;
     double lastX;
     double lastY;
+
+    EmbPatternStats stats;
+    EmbReadOptions readOptions; /* used by the readers that read into this pattern */
 } EmbPattern;
 
+/*! A pattern as seen through a transform, for writers whose format wants
+ *  other units or axes. Reading through it leaves the pattern untouched.
+ *  Get one from embPattern_view(). */
+typedef struct EmbPatternView_
+{
+    EmbPattern* pattern;
+    EmbTransform transform;
+} EmbPatternView;
+
 extern EMB_PUBLIC EmbPattern* EMB_CALL embPattern_create(void);
 extern EMB_PUBLIC void EMB_CALL embPattern_hideStitchesOverLength(EmbPattern* p, int length);
 extern EMB_PUBLIC void EMB_CALL embPattern_fixColorCount(EmbPattern* p);
 extern EMB_PUBLIC int EMB_CALL embPattern_addThread(EmbPattern* p, EmbThread thread);
+extern EMB_PUBLIC int EMB_CALL embPattern_threadCount(const EmbPattern* p);
+extern EMB_PUBLIC void EMB_CALL embPattern_clearThreads(EmbPattern* p);
+extern EMB_PUBLIC const EmbPatternStats* EMB_CALL embPattern_stats(EmbPattern* p);
+extern EMB_PUBLIC void EMB_CALL embPattern_invalidateStats(EmbPattern* p);
 extern EMB_PUBLIC void EMB_CALL embPattern_addStitchAbs(EmbPattern* p, double x, double y, int flags, int isAutoColorIndex);
 extern EMB_PUBLIC void EMB_CALL embPattern_addStitchRel(EmbPattern* p, double dx, double dy, int flags, int isAutoColorIndex);
+extern EMB_PUBLIC void EMB_CALL embPattern_addStitchesAbs(EmbPattern* p, const EmbPoint* points, int count, int flags, int isAutoColorIndex);
+extern EMB_PUBLIC void EMB_CALL embPattern_addStitchesRel(EmbPattern* p, const EmbPoint* deltas, int count, int flags, int isAutoColorIndex);
+extern EMB_PUBLIC void EMB_CALL embPattern_appendStitches(EmbPattern* p, const EmbStitch* stitches, int count);
 extern EMB_PUBLIC void EMB_CALL embPattern_changeColor(EmbPattern* p, int index);
+extern EMB_PUBLIC void EMB_CALL embPattern_reset(EmbPattern* p);
 extern EMB_PUBLIC void EMB_CALL embPattern_free(EmbPattern* p);
 extern EMB_PUBLIC void EMB_CALL embPattern_scale(EmbPattern* p, double scale);
 extern EMB_PUBLIC EmbRect EMB_CALL embPattern_calcBoundingBox(EmbPattern* p);
@@ -75,12 +132,15 @@ extern EMB_PUBLIC void EMB_CALL embPattern_flip(EmbPattern* p, int horz, int ver
 extern EMB_PUBLIC void EMB_CALL embPattern_combineJumpStitches(EmbPattern* p);
 extern EMB_PUBLIC void EMB_CALL embPattern_correctForMaxStitchLength(EmbPattern* p, double maxStitchLength, double maxJumpLength);
 extern EMB_PUBLIC void EMB_CALL embPattern_center(EmbPattern* p);
+extern EMB_PUBLIC void EMB_CALL embPattern_transform(EmbPattern* p, EmbTransform t);
 extern EMB_PUBLIC void EMB_CALL embPattern_loadExternalColorFile(EmbPattern* p, const char* fileName);
+extern EMB_PUBLIC void EMB_CALL embPattern_setReadOptions(EmbPattern* p, const EmbReadOptions* options);
 
 extern EMB_PUBLIC void EMB_CALL embPattern_addCircleObjectAbs(EmbPattern* p, double cx, double cy, double r);
 extern EMB_PUBLIC void EMB_CALL embPattern_addEllipseObjectAbs(EmbPattern* p, double cx, double cy, double rx, double ry); /* TODO: ellipse rotation */
 extern EMB_PUBLIC void EMB_CALL embPattern_addLineObjectAbs(EmbPattern* p, double x1, double y1, double x2, double y2);
 extern EMB_PUBLIC void EMB_CALL embPattern_addPathObjectAbs(EmbPattern* p, EmbPathObject* obj);
+extern EMB_PUBLIC void EMB_CALL embPattern_addPathObjectPoints(EmbPattern* p, const EmbPoint* points, const EmbFlag* flags, int count, EmbColor color, int lineType);
 extern EMB_PUBLIC void EMB_CALL embPattern_addPointObjectAbs(EmbPattern* p, double x, double y);
 extern EMB_PUBLIC void EMB_CALL embPattern_addPolygonObjectAbs(EmbPattern* p, EmbPolygonObject* obj);
 extern EMB_PUBLIC void EMB_CALL embPattern_addPolylineObjectAbs(EmbPattern* p, EmbPolylineObject* obj);
@@ -91,8 +151,15 @@ extern EMB_PUBLIC void EMB_CALL embPattern_copyPolylinesToStitchList(EmbPattern*
 extern EMB_PUBLIC void EMB_CALL embPattern_moveStitchListToPolylines(EmbPattern* pattern);
 extern EMB_PUBLIC void EMB_CALL embPattern_movePolylinesToStitchList(EmbPattern* pattern);
 
+extern EMB_PUBLIC EmbPatternView EMB_CALL embPattern_view(EmbPattern* p, EmbTransform t);
+extern EMB_PUBLIC int EMB_CALL embPatternView_stitchCount(const EmbPatternView* view);
+extern EMB_PUBLIC EmbStitch EMB_CALL embPatternView_stitch(const EmbPatternView* view, int index);
+extern EMB_PUBLIC EmbPoint EMB_CALL embPatternView_point(const EmbPatternView* view, double x, double y);
+extern EMB_PUBLIC EmbRect EMB_CALL embPatternView_boundingBox(const EmbPatternView* view);
+
 extern EMB_PUBLIC int EMB_CALL embPattern_read(EmbPattern* pattern, const char* fileName);
 extern EMB_PUBLIC int EMB_CALL embPattern_write(EmbPattern* pattern, const char* fileName);
+extern EMB_PUBLIC int EMB_CALL embPattern_writeMemory(EmbPattern* pattern, const char* format, unsigned char** buffer, size_t* size);
 
 #ifdef __cplusplus
 }
@@ -25,6 +25,9 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
     }
     rw = (EmbReaderWriter*)malloc(sizeof(EmbReaderWriter));
     if(!rw) { embLog_error("emb-reader-writer.c embReaderWriter_getByFileName(), cannot allocate memory for rw\n"); return 0; }
+    rw->streamWriter = 0;
+    rw->sourceReader = 0;
+    rw->sourceWriter = 0;
 
     if(!strcmp(ending, ".10o"))
     {
@@ -105,6 +108,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readCsv;
         rw->writer = writeCsv;
+        rw->streamWriter = writeCsvStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".dat"))
@@ -141,6 +145,9 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readDst;
         rw->writer = writeDst;
+        rw->streamWriter = writeDstStream;
+        rw->sourceReader = readDstSource;
+        rw->sourceWriter = writeDstSource;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".dsz"))
@@ -168,6 +175,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readEdr;
         rw->writer = writeEdr;
+        rw->streamWriter = writeEdrStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".emd"))
@@ -183,6 +191,9 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
     {
         rw->reader = readExp;
         rw->writer = writeExp;
+        rw->streamWriter = writeExpStream;
+        rw->sourceReader = readExpSource;
+        rw->sourceWriter = writeExpSource;
     }
     else if(!strcmp(ending, ".exy"))
     {
@@ -254,6 +265,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readInf;
         rw->writer = writeInf;
+        rw->streamWriter = writeInfStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".jef"))
@@ -263,6 +275,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readJef;
         rw->writer = writeJef;
+        rw->streamWriter = writeJefStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".ksm"))
@@ -272,6 +285,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readKsm;
         rw->writer = writeKsm;
+        rw->streamWriter = writeKsmStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".max"))
@@ -281,6 +295,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readMax;
         rw->writer = writeMax;
+        rw->streamWriter = writeMaxStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".mit"))
@@ -290,6 +305,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readMit;
         rw->writer = writeMit;
+        rw->streamWriter = writeMitStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".new"))
@@ -317,6 +333,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readPcd;
         rw->writer = writePcd;
+        rw->streamWriter = writePcdStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".pcm"))
@@ -335,6 +352,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readPcq;
         rw->writer = writePcq;
+        rw->streamWriter = writePcqStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".pcs"))
@@ -344,6 +362,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readPcs;
         rw->writer = writePcs;
+        rw->streamWriter = writePcsStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".pec"))
@@ -353,6 +372,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readPec;
         rw->writer = writePec;
+        rw->streamWriter = writePecStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".pel"))
@@ -380,6 +400,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readPes;
         rw->writer = writePes;
+        rw->streamWriter = writePesStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".phb"))
@@ -416,6 +437,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readRgb;
         rw->writer = writeRgb;
+        rw->streamWriter = writeRgbStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".sew"))
@@ -425,6 +447,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readSew;
         rw->writer = writeSew;
+        rw->streamWriter = writeSewStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".shv"))
@@ -461,6 +484,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readSvg;
         rw->writer = writeSvg;
+        rw->streamWriter = writeSvgStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".t01"))
@@ -470,6 +494,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readT01;
         rw->writer = writeT01;
+        rw->streamWriter = writeT01Stream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".t09"))
@@ -488,6 +513,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readTap;
         rw->writer = writeTap;
+        rw->streamWriter = writeTapStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".thr"))
@@ -497,6 +523,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readThr;
         rw->writer = writeThr;
+        rw->streamWriter = writeThrStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".txt"))
@@ -506,6 +533,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readTxt;
         rw->writer = writeTxt;
+        rw->streamWriter = writeTxtStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".u00"))
@@ -533,6 +561,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readVp3;
         rw->writer = writeVp3;
+        rw->streamWriter = writeVp3Stream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".xxx"))
@@ -542,6 +571,7 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
         #else /* ARDUINO TODO: This is temporary. Remove when complete. */
         rw->reader = readXxx;
         rw->writer = writeXxx;
+        rw->streamWriter = writeXxxStream;
         #endif /* ARDUINO TODO: This is temporary. Remove when complete. */
     }
     else if(!strcmp(ending, ".zsk"))
@@ -561,4 +591,39 @@ EmbReaderWriter* embReaderWriter_getByFileName(const char* fileName)
     return rw;
 }
 
+/*! Encodes \a pattern into memory with (\a streamWriter) and, if that succeeds, writes the result to
+ *  a file with the given \a fileName in one go, opening it with the fopen() (\a mode).
+ *  Nothing is written if the encoder fails. Returns \c true if successful, otherwise returns \c false. */
+int embReaderWriter_writeFile(EmbPattern* pattern, const char* fileName, const char* mode,
+                              int (*streamWriter)(EmbPattern*, EmbFile*, const char*))
+{
+    EmbFile* file = 0;
+    int result = 0;
+
+    if(!fileName) { embLog_error("emb-reader-writer.c embReaderWriter_writeFile(), fileName argument is null\n"); return 0; }
+    if(!streamWriter) { embLog_error("emb-reader-writer.c embReaderWriter_writeFile(), streamWriter argument is null\n"); return 0; }
+
+#ifdef ARDUINO
+    file = embFile_open(fileName, mode);
+    if(!file)
+    {
+        embLog_error("emb-reader-writer.c embReaderWriter_writeFile(), cannot open %s for writing\n", fileName);
+        return 0;
+    }
+    result = streamWriter(pattern, file, fileName);
+    embFile_close(file);
+#else /* ARDUINO */
+    file = embFile_openBuffer();
+    if(!file) { embLog_error("emb-reader-writer.c embReaderWriter_writeFile(), cannot allocate memory for file\n"); return 0; }
+    result = streamWriter(pattern, file, fileName);
+    if(result && !embFile_save(file, fileName, mode))
+    {
+        embLog_error("emb-reader-writer.c embReaderWriter_writeFile(), cannot write %s\n", fileName);
+        result = 0;
+    }
+    embFile_close(file);
+#endif /* ARDUINO */
+    return result;
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -2,7 +2,9 @@
 #ifndef EMB_READER_WRITER_H
 #define EMB_READER_WRITER_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
+#include "emb-stream.h"
 
 #include "api-start.h"
 #ifdef __cplusplus
@@ -13,9 +15,14 @@ typedef struct EmbReaderWriter_
 {
     int (*reader)(EmbPattern*, const char*);
     int (*writer)(EmbPattern*, const char*);
+    int (*streamWriter)(EmbPattern*, EmbFile*, const char*); /* 0 if the format cannot be written to an EmbFile */
+    EmbStitchSource* (*sourceReader)(EmbFile*, const char*, const EmbReadOptions*); /* 0 if the format cannot be read as a stream of stitches */
+    int (*sourceWriter)(EmbStitchSource*, EmbFile*);         /* 0 if the format cannot be written from one */
 } EmbReaderWriter;
 
 extern EMB_PUBLIC EmbReaderWriter* EMB_CALL embReaderWriter_getByFileName(const char* fileName);
+extern EMB_PUBLIC int EMB_CALL embReaderWriter_writeFile(EmbPattern* pattern, const char* fileName, const char* mode,
+                                                         int (*streamWriter)(EmbPattern*, EmbFile*, const char*));
 
 #ifdef __cplusplus
 }
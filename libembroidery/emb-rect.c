@@ -78,6 +78,8 @@ EmbRectObject embRectObject_make(double x, double y, double w, double h)
     stackRectObj.rect.top = y;
     stackRectObj.rect.right = x + w;
     stackRectObj.rect.bottom = y + h;
+    stackRectObj.rotation = 0.0;
+    stackRectObj.radius = 0.0;
     return stackRectObj;
 }
 
@@ -90,6 +92,8 @@ EmbRectObject* embRectObject_create(double x, double y, double w, double h)
     heapRectObj->rect.top = y;
     heapRectObj->rect.right = x + w;
     heapRectObj->rect.bottom = y + h;
+    heapRectObj->rotation = 0.0;
+    heapRectObj->radius = 0.0;
     return heapRectObj;
 }
 
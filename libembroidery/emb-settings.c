@@ -6,6 +6,7 @@ EmbSettings embSettings_init(void)
     EmbSettings settings;
     settings.dstJumpsPerTrim = 6;
     settings.home = embPoint_make(0.0, 0.0);
+    settings.curveTolerance = 0.05;
     return settings;
 }
 
@@ -13,6 +13,7 @@ typedef struct EmbSettings_
 {
     unsigned int dstJumpsPerTrim;
     EmbPoint home;
+    double curveTolerance; /* how far a curve read from a file may stray from the lines it is flattened into */
 } EmbSettings;
 
 extern EMB_PUBLIC EmbSettings EMB_CALL embSettings_init(void);
@@ -3,69 +3,129 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-EmbStitchList* embStitchList_create(EmbStitch data)
+#define EMB_STITCHLIST_MIN_CAPACITY 256
+
+/*! Returns a pointer to an empty EmbStitchList. It is created on the heap. The caller is responsible for freeing the allocated memory with embStitchList_free(). */
+EmbStitchList* embStitchList_create(void)
 {
     EmbStitchList* heapStitchList = (EmbStitchList*)malloc(sizeof(EmbStitchList));
     if(!heapStitchList) { embLog_error("emb-stitch.c embStitchList_create(), cannot allocate memory for heapStitchList\n"); return 0; }
-    heapStitchList->stitch = data;
-    heapStitchList->next = 0;
+    heapStitchList->stitch = 0;
+    heapStitchList->count = 0;
+    heapStitchList->capacity = 0;
     return heapStitchList;
 }
 
-EmbStitchList* embStitchList_add(EmbStitchList* pointer, EmbStitch data)
+/*! Ensures (\a list) can hold at least (\a capacity) stitches without reallocating.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int embStitchList_reserve(EmbStitchList* list, int capacity)
 {
-    if(!pointer) { embLog_error("emb-stitch.c embStitchList_add(), pointer argument is null\n"); return 0; }
-    if(pointer->next) { embLog_error("emb-stitch.c embStitchList_add(), pointer->next should be null\n"); return 0; }
-    pointer->next = (EmbStitchList*)malloc(sizeof(EmbStitchList));
-    if(!pointer->next) { embLog_error("emb-stitch.c embStitchList_add(), cannot allocate memory for pointer->next\n"); return 0; }
-    pointer = pointer->next;
-    pointer->stitch = data;
-    pointer->next = 0;
-    return pointer;
+    EmbStitch* grown = 0;
+
+    if(!list) { embLog_error("emb-stitch.c embStitchList_reserve(), list argument is null\n"); return 0; }
+    if(capacity <= list->capacity)
+        return 1;
+    grown = (EmbStitch*)realloc(list->stitch, sizeof(EmbStitch) * (size_t)capacity);
+    if(!grown) { embLog_error("emb-stitch.c embStitchList_reserve(), cannot allocate memory for %d stitches\n", capacity); return 0; }
+    list->stitch = grown;
+    list->capacity = capacity;
+    return 1;
 }
 
-EmbStitch embStitchList_getAt(EmbStitchList* pointer, int num)
+/*! Appends (\a data) to the end of (\a list). The storage grows geometrically so appends are amortized O(1).
+ *  Returns \c true if successful, otherwise returns \c false. */
+int embStitchList_add(EmbStitchList* list, EmbStitch data)
 {
-    /* TODO: pointer safety */
-    int i;
-    for(i = 0; i < num; i++)
+    if(!list) { embLog_error("emb-stitch.c embStitchList_add(), list argument is null\n"); return 0; }
+    if(list->count == list->capacity)
     {
-        pointer = pointer->next;
+        int capacity = list->capacity * 2;
+        if(capacity < EMB_STITCHLIST_MIN_CAPACITY)
+            capacity = EMB_STITCHLIST_MIN_CAPACITY;
+        if(!embStitchList_reserve(list, capacity))
+            return 0;
     }
-    return pointer->stitch;
+    list->stitch[list->count++] = data;
+    return 1;
 }
 
-/* TODO: Add a default parameter to handle returning count based on stitch flags. Currently, it includes JUMP and TRIM stitches, maybe we just want NORMAL stitches only or vice versa */
-int embStitchList_count(EmbStitchList* pointer)
+void embStitchList_removeLast(EmbStitchList* list)
+{
+    if(!list || list->count == 0) { embLog_error("emb-stitch.c embStitchList_removeLast(), list is empty\n"); return; }
+    list->count--;
+}
+
+/*! Removes every stitch from (\a list) but keeps its storage for reuse. */
+void embStitchList_clear(EmbStitchList* list)
 {
-    int i = 1;
-    if(!pointer) return 0;
-    while(pointer->next)
+    if(!list) return;
+    list->count = 0;
+}
+
+EmbStitch embStitchList_getAt(EmbStitchList* list, int num)
+{
+    if(!list || num < 0 || num >= list->count)
     {
-        pointer = pointer->next;
-        i++;
+        EmbStitch empty = { 0, 0.0, 0.0, 0 };
+        embLog_error("emb-stitch.c embStitchList_getAt(), index %d is out of range\n", num);
+        return empty;
     }
-    return i;
+    return list->stitch[num];
+}
+
+/*! Returns a pointer to the last stitch in (\a list) or null if the list is empty. */
+EmbStitch* embStitchList_last(EmbStitchList* list)
+{
+    if(!list || list->count == 0)
+        return 0;
+    return &(list->stitch[list->count - 1]);
+}
+
+/* TODO: Add a default parameter to handle returning count based on stitch flags. Currently, it includes JUMP and TRIM stitches, maybe we just want NORMAL stitches only or vice versa */
+int embStitchList_count(EmbStitchList* list)
+{
+    if(!list) return 0;
+    return list->count;
 }
 
-int embStitchList_empty(EmbStitchList* pointer)
+int embStitchList_empty(EmbStitchList* list)
 {
-    if(!pointer)
+    if(!list || list->count == 0)
         return 1;
     return 0;
 }
 
-void embStitchList_free(EmbStitchList* pointer)
+void embStitchList_free(EmbStitchList* list)
 {
-    EmbStitchList* tempPointer = pointer;
-    EmbStitchList* nextPointer = 0;
-    while(tempPointer)
-    {
-        nextPointer = tempPointer->next;
-        free(tempPointer);
-        tempPointer = nextPointer;
-    }
-    pointer = 0;
+    if(!list) return;
+    free(list->stitch);
+    list->stitch = 0;
+    free(list);
+}
+
+/*! Returns an iterator positioned before the first stitch of (\a list). */
+EmbStitchIterator embStitchList_begin(EmbStitchList* list)
+{
+    EmbStitchIterator it;
+    it.list = list;
+    it.index = 0;
+    return it;
+}
+
+/*! Returns the stitch under (\a it) and advances it, or null once the end of the list is reached. */
+EmbStitch* embStitchIterator_next(EmbStitchIterator* it)
+{
+    if(!it || !it->list || it->index >= it->list->count)
+        return 0;
+    return &(it->list->stitch[it->index++]);
+}
+
+/*! Returns the stitch under (\a it) without advancing it, or null at the end of the list. */
+EmbStitch* embStitchIterator_peek(EmbStitchIterator* it)
+{
+    if(!it || !it->list || it->index >= it->list->count)
+        return 0;
+    return &(it->list->stitch[it->index]);
 }
 
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
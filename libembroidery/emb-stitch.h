@@ -23,18 +23,37 @@ typedef struct EmbStitch_
     int color; /* color number for this stitch */ /* TODO: this should be called colorIndex since it is not an EmbColor */
 } EmbStitch;
 
+/* Growable contiguous array of stitches. Stitches are stored back to back in
+ * \a stitch so indexed access is O(1) and appending is amortized O(1). */
 typedef struct EmbStitchList_
 {
-    struct EmbStitch_ stitch;
-    struct EmbStitchList_* next;
+    EmbStitch* stitch; /* stitch[0] .. stitch[count - 1] are valid */
+    int count;
+    int capacity;
 } EmbStitchList;
 
-extern EMB_PUBLIC EmbStitchList* EMB_CALL embStitchList_create(EmbStitch data);
-extern EMB_PUBLIC EmbStitchList* EMB_CALL embStitchList_add(EmbStitchList* pointer, EmbStitch data);
-extern EMB_PUBLIC int EMB_CALL embStitchList_count(EmbStitchList* pointer);
-extern EMB_PUBLIC int EMB_CALL embStitchList_empty(EmbStitchList* pointer);
-extern EMB_PUBLIC void EMB_CALL embStitchList_free(EmbStitchList* pointer);
-extern EMB_PUBLIC EmbStitch EMB_CALL embStitchList_getAt(EmbStitchList* pointer, int num);
+/* Forward cursor over an EmbStitchList. Lets code that used to walk the old
+ * linked list (pointer = pointer->next) keep its loop shape. */
+typedef struct EmbStitchIterator_
+{
+    EmbStitchList* list;
+    int index;
+} EmbStitchIterator;
+
+extern EMB_PUBLIC EmbStitchList* EMB_CALL embStitchList_create(void);
+extern EMB_PUBLIC int EMB_CALL embStitchList_reserve(EmbStitchList* list, int capacity);
+extern EMB_PUBLIC int EMB_CALL embStitchList_add(EmbStitchList* list, EmbStitch data);
+extern EMB_PUBLIC void EMB_CALL embStitchList_removeLast(EmbStitchList* list);
+extern EMB_PUBLIC void EMB_CALL embStitchList_clear(EmbStitchList* list);
+extern EMB_PUBLIC int EMB_CALL embStitchList_count(EmbStitchList* list);
+extern EMB_PUBLIC int EMB_CALL embStitchList_empty(EmbStitchList* list);
+extern EMB_PUBLIC void EMB_CALL embStitchList_free(EmbStitchList* list);
+extern EMB_PUBLIC EmbStitch EMB_CALL embStitchList_getAt(EmbStitchList* list, int num);
+extern EMB_PUBLIC EmbStitch* EMB_CALL embStitchList_last(EmbStitchList* list);
+
+extern EMB_PUBLIC EmbStitchIterator EMB_CALL embStitchList_begin(EmbStitchList* list);
+extern EMB_PUBLIC EmbStitch* EMB_CALL embStitchIterator_next(EmbStitchIterator* it);
+extern EMB_PUBLIC EmbStitch* EMB_CALL embStitchIterator_peek(EmbStitchIterator* it);
 
 #ifdef __cplusplus
 }
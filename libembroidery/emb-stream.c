@@ -0,0 +1,300 @@
+#include "emb-stream.h"
+#include "emb-reader-writer.h"
+#include "emb-logging.h"
+#include "emb-settings.h"
+#include <stdlib.h>
+
+/*! Returns a new source that decodes with (\a decode), keeping its state in (\a data). (\a close) releases (\a data)
+ *  when the source is freed. The caller is responsible for freeing the source with embStitchSource_free(). */
+EmbStitchSource* embStitchSource_create(void* data, int (*decode)(EmbStitchSource*), void (*close)(EmbStitchSource*))
+{
+    EmbStitchSource* source = 0;
+
+    if(!decode) { embLog_error("emb-stream.c embStitchSource_create(), decode argument is null\n"); return 0; }
+    source = (EmbStitchSource*)malloc(sizeof(EmbStitchSource));
+    if(!source) { embLog_error("emb-stream.c embStitchSource_create(), cannot allocate memory for source\n"); return 0; }
+    source->meta = embPattern_create();
+    if(!source->meta) { free(source); return 0; }
+    source->data = data;
+    source->decode = decode;
+    source->close = close;
+    source->head = 0;
+    source->count = 0;
+    source->lastX = 0.0;
+    source->lastY = 0.0;
+    source->lastFlags = NORMAL;
+    source->colorIndex = 0;
+    source->maxColorIndex = 0;
+    source->started = 0;
+    source->finished = 0;
+    return source;
+}
+
+void embStitchSource_free(EmbStitchSource* source)
+{
+    if(!source) return;
+    if(source->close)
+        source->close(source);
+    embPattern_free(source->meta);
+    free(source);
+}
+
+/*! Returns how many more stitches can be queued in (\a source). A decoder should stop once fewer than 2 are left,
+ *  since the first stitch it adds also brings in the HOME stitch. */
+int embStitchSource_room(const EmbStitchSource* source)
+{
+    if(!source) return 0;
+    return EMB_STITCH_SOURCE_QUEUE - source->count;
+}
+
+static void embStitchSource_push(EmbStitchSource* source, double x, double y, int flags)
+{
+    EmbStitch* s = 0;
+
+    if(source->count == EMB_STITCH_SOURCE_QUEUE)
+    {
+        embLog_error("emb-stream.c embStitchSource_push(), queue is full, the stitch has been dropped\n");
+        return;
+    }
+    s = &(source->queue[(source->head + source->count) % EMB_STITCH_SOURCE_QUEUE]);
+    s->xx = x;
+    s->yy = y;
+    s->flags = flags;
+    s->color = source->colorIndex;
+    source->count++;
+    if(source->colorIndex > source->maxColorIndex)
+        source->maxColorIndex = source->colorIndex;
+}
+
+/*! Queues a stitch in (\a source) at the relative position (\a dx,\a dy) to the previous stitch, following the
+ *  rules of embPattern_addStitchRel() with automatic color indexing. Meant to be called by decoders. */
+void embStitchSource_addStitchRel(EmbStitchSource* source, double dx, double dy, int flags)
+{
+    EmbPoint home;
+    double x, y;
+    unsigned int seed;
+
+    if(!source) { embLog_error("emb-stream.c embStitchSource_addStitchRel(), source argument is null\n"); return; }
+
+    home = embSettings_home(&(source->meta->settings));
+    x = source->started ? source->lastX + dx : home.xx + dx;
+    y = source->started ? source->lastY + dy : home.yy + dy;
+
+    if(flags & END)
+    {
+        if(!source->started)
+            return;
+        if(source->lastFlags & END)
+        {
+            embLog_error("emb-stream.c embStitchSource_addStitchRel(), found multiple END stitches\n");
+            return;
+        }
+        /* Every color that was stitched gets a thread, as embPattern_fixColorCount() does */
+        seed = (unsigned int)embPattern_threadCount(source->meta);
+        while(embPattern_threadCount(source->meta) <= source->maxColorIndex)
+        {
+            if(!embPattern_addThread(source->meta, embThread_getRandomR(&seed)))
+                break;
+        }
+    }
+
+    if(flags & STOP)
+    {
+        if(!source->started)
+            return;
+        source->colorIndex++;
+    }
+
+    if(!source->started)
+    {
+        /* NOTE: Always HOME the machine before starting any stitching */
+        embStitchSource_push(source, home.xx, home.yy, JUMP);
+        source->started = 1;
+    }
+    embStitchSource_push(source, x, y, flags);
+    source->lastX = x;
+    source->lastY = y;
+    source->lastFlags = flags;
+}
+
+/* Decodes until (source) holds (wanted) stitches or its data is used up. */
+static void embStitchSource_fill(EmbStitchSource* source, int wanted)
+{
+    while(source->count < wanted && !source->finished)
+    {
+        if(!source->decode(source))
+        {
+            source->finished = 1;
+            /* Check for an END stitch and add one if it is not present */
+            if(source->started && source->lastFlags != END)
+                embStitchSource_addStitchRel(source, 0, 0, END);
+        }
+    }
+}
+
+/*! Takes the next stitch of (\a source) and stores it in (\a stitch).
+ *  Returns \c true if successful, or \c false once the design has ended. */
+int embStitchSource_next(EmbStitchSource* source, EmbStitch* stitch)
+{
+    if(!source) { embLog_error("emb-stream.c embStitchSource_next(), source argument is null\n"); return 0; }
+    embStitchSource_fill(source, 1);
+    if(!source->count)
+        return 0;
+    if(stitch)
+        *stitch = source->queue[source->head];
+    source->head = (source->head + 1) % EMB_STITCH_SOURCE_QUEUE;
+    source->count--;
+    return 1;
+}
+
+/*! Stores the stitch (\a ahead) places after the next one of (\a source) in (\a stitch) without taking it.
+ *  (\a ahead) must be less than EMB_STITCH_SOURCE_LOOKAHEAD.
+ *  Returns \c true if successful, or \c false if the design ends before that stitch. */
+int embStitchSource_peek(EmbStitchSource* source, int ahead, EmbStitch* stitch)
+{
+    if(!source) { embLog_error("emb-stream.c embStitchSource_peek(), source argument is null\n"); return 0; }
+    if(ahead < 0 || ahead >= EMB_STITCH_SOURCE_LOOKAHEAD)
+    {
+        embLog_error("emb-stream.c embStitchSource_peek(), ahead is not in valid range [0,%d], ahead = %d\n", EMB_STITCH_SOURCE_LOOKAHEAD - 1, ahead);
+        return 0;
+    }
+    embStitchSource_fill(source, ahead + 1);
+    if(source->count <= ahead)
+        return 0;
+    if(stitch)
+        *stitch = source->queue[(source->head + ahead) % EMB_STITCH_SOURCE_QUEUE];
+    return 1;
+}
+
+/* Passes the threads of (source) from index (first) on to (sink), returning the new thread count or -1 if the sink stopped. */
+static int embStitchSource_sendThreads(EmbStitchSource* source, EmbStitchSink* sink, int first)
+{
+    int i, count = embPattern_threadCount(source->meta);
+
+    for(i = first; i < count; i++)
+    {
+        if(sink->thread && !sink->thread(sink->data, &(source->meta->threadList->thread[i])))
+            return -1;
+    }
+    return count;
+}
+
+/*! Pushes everything (\a source) still has to (\a sink): the threads known so far, every remaining stitch in
+ *  order, then any threads that were only added when the design ended.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int embStitchSource_drain(EmbStitchSource* source, EmbStitchSink* sink)
+{
+    int sent, run;
+
+    if(!source || !sink) { embLog_error("emb-stream.c embStitchSource_drain(), invalid argument\n"); return 0; }
+
+    sent = embStitchSource_sendThreads(source, sink, 0);
+    if(sent < 0) return 0;
+    for(;;)
+    {
+        embStitchSource_fill(source, 1);
+        if(!source->count)
+            break;
+        /* Hand over the queue in as few runs as its wrap-around allows */
+        run = EMB_STITCH_SOURCE_QUEUE - source->head;
+        if(run > source->count)
+            run = source->count;
+        if(sink->stitches && !sink->stitches(sink->data, &(source->queue[source->head]), run))
+            return 0;
+        source->head = (source->head + run) % EMB_STITCH_SOURCE_QUEUE;
+        source->count -= run;
+    }
+    return embStitchSource_sendThreads(source, sink, sent) >= 0;
+}
+
+static int embStitchSink_patternThread(void* data, const EmbThread* thread)
+{
+    return embPattern_addThread((EmbPattern*)data, *thread);
+}
+
+static int embStitchSink_patternStitches(void* data, const EmbStitch* stitches, int count)
+{
+    EmbPattern* pattern = (EmbPattern*)data;
+    embPattern_appendStitches(pattern, stitches, count);
+    pattern->currentColorIndex = stitches[count - 1].color;
+    return 1;
+}
+
+/*! Returns a sink that appends what it receives to (\a pattern), leaving it as reading the file directly would. */
+EmbStitchSink embStitchSink_pattern(EmbPattern* pattern)
+{
+    EmbStitchSink sink;
+    sink.data = pattern;
+    sink.thread = embStitchSink_patternThread;
+    sink.stitches = embStitchSink_patternStitches;
+    return sink;
+}
+
+/*! Converts the design in the file (\a inFileName) to the file (\a outFileName), choosing both formats by extension.
+ *  When both formats can be streamed the stitches are passed from the decoder to the encoder a few at a time and
+ *  memory use does not grow with the design; otherwise the whole design is loaded into a pattern first.
+ *  The design is read with (\a options), which may be 0.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int embStream_convert(const char* inFileName, const char* outFileName, const EmbReadOptions* options)
+{
+    EmbReaderWriter* reader = 0;
+    EmbReaderWriter* writer = 0;
+    EmbPattern* pattern = 0;
+    EmbStitchSource* source = 0;
+    EmbFile* inFile = 0;
+    EmbFile* outFile = 0;
+    int result = 0;
+
+    if(!inFileName) { embLog_error("emb-stream.c embStream_convert(), inFileName argument is null\n"); return 0; }
+    if(!outFileName) { embLog_error("emb-stream.c embStream_convert(), outFileName argument is null\n"); return 0; }
+
+    reader = embReaderWriter_getByFileName(inFileName);
+    if(!reader) { embLog_error("emb-stream.c embStream_convert(), unsupported read file type: %s\n", inFileName); return 0; }
+    writer = embReaderWriter_getByFileName(outFileName);
+    if(!writer) { embLog_error("emb-stream.c embStream_convert(), unsupported write file type: %s\n", outFileName); free(reader); return 0; }
+
+    if(!reader->sourceReader || !writer->sourceWriter)
+    {
+        pattern = embPattern_create();
+        if(pattern)
+        {
+            embPattern_setReadOptions(pattern, options);
+            result = reader->reader(pattern, inFileName) && writer->writer(pattern, outFileName);
+            embPattern_free(pattern);
+        }
+        free(reader);
+        free(writer);
+        return result;
+    }
+
+    inFile = embFile_open(inFileName, "rb");
+    if(!inFile)
+    {
+        embLog_error("emb-stream.c embStream_convert(), cannot open %s for reading\n", inFileName);
+    }
+    else
+    {
+        source = reader->sourceReader(inFile, inFileName, options);
+        /* Stitches go straight to the output, so it is written as it is encoded and not buffered in memory */
+        if(source)
+            outFile = embFile_open(outFileName, "wb");
+        if(source && !outFile)
+            embLog_error("emb-stream.c embStream_convert(), cannot open %s for writing\n", outFileName);
+        if(outFile)
+        {
+            result = writer->sourceWriter(source, outFile);
+            if(embFile_close(outFile))
+            {
+                embLog_error("emb-stream.c embStream_convert(), cannot write %s\n", outFileName);
+                result = 0;
+            }
+        }
+        embStitchSource_free(source);
+        embFile_close(inFile);
+    }
+    free(reader);
+    free(writer);
+    return result;
+}
+
+/* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
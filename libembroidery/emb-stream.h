@@ -0,0 +1,75 @@
+/*! @file emb-stream.h */
+#ifndef EMB_STREAM_H
+#define EMB_STREAM_H
+
+#include "emb-file.h"
+#include "emb-pattern.h"
+#include "emb-stitch.h"
+#include "emb-thread.h"
+
+#include "api-start.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EMB_STITCH_SOURCE_QUEUE     256 /* stitches a source holds decoded ahead of its reader */
+#define EMB_STITCH_SOURCE_LOOKAHEAD 64  /* how far ahead embStitchSource_peek() may look */
+
+/* Pulls the stitches of a design one at a time while its file is being
+ * decoded, so a design can be converted without ever holding all of it.
+ * A format's source decoder fills the queue a few records at a time through
+ * embStitchSource_addStitchRel(), which applies the same rules as
+ * embPattern_addStitchRel(): the stitches a source yields are the ones
+ * reading the file into a pattern would have stored, HOME and END included.
+ * Threads and settings from the file's header are kept in (meta), a pattern
+ * that never holds any stitches. */
+typedef struct EmbStitchSource_
+{
+    void* data;                                     /* decoder state, owned by the format */
+    int (*decode)(struct EmbStitchSource_* source); /* queues more stitches, returns 0 once the data is used up */
+    void (*close)(struct EmbStitchSource_* source); /* releases (data), may be 0 */
+
+    EmbPattern* meta;
+
+    EmbStitch queue[EMB_STITCH_SOURCE_QUEUE];
+    int head;
+    int count;
+
+    double lastX;
+    double lastY;
+    int lastFlags;
+    int colorIndex;
+    int maxColorIndex;
+    int started;
+    int finished;
+} EmbStitchSource;
+
+/* Receives a design as it is decoded. Either callback may be 0. Callbacks
+ * return \c true to continue or \c false to stop the transfer. */
+typedef struct EmbStitchSink_
+{
+    void* data;
+    int (*thread)(void* data, const EmbThread* thread);
+    int (*stitches)(void* data, const EmbStitch* stitches, int count);
+} EmbStitchSink;
+
+extern EMB_PUBLIC EmbStitchSource* EMB_CALL embStitchSource_create(void* data, int (*decode)(EmbStitchSource*), void (*close)(EmbStitchSource*));
+extern EMB_PUBLIC void EMB_CALL embStitchSource_free(EmbStitchSource* source);
+extern EMB_PUBLIC int EMB_CALL embStitchSource_room(const EmbStitchSource* source);
+extern EMB_PUBLIC void EMB_CALL embStitchSource_addStitchRel(EmbStitchSource* source, double dx, double dy, int flags);
+extern EMB_PUBLIC int EMB_CALL embStitchSource_next(EmbStitchSource* source, EmbStitch* stitch);
+extern EMB_PUBLIC int EMB_CALL embStitchSource_peek(EmbStitchSource* source, int ahead, EmbStitch* stitch);
+extern EMB_PUBLIC int EMB_CALL embStitchSource_drain(EmbStitchSource* source, EmbStitchSink* sink);
+
+extern EMB_PUBLIC EmbStitchSink EMB_CALL embStitchSink_pattern(EmbPattern* pattern);
+
+extern EMB_PUBLIC int EMB_CALL embStream_convert(const char* inFileName, const char* outFileName, const EmbReadOptions* options);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#include "api-stop.h"
+
+#endif /* EMB_STREAM_H */
+
+/* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -1,41 +1,15 @@
 #include "emb-thread.h"
+#include "emb-palette.h"
 #include "emb-logging.h"
 #include <stdio.h>
 #include <stdlib.h>
 
+#define EMB_THREADLIST_MIN_CAPACITY 16
+
 int embThread_findNearestColor(EmbColor color, EmbThreadList* colors)
 {
-    double currentClosestValue = 9999999;
-    int closestIndex = -1;
-    int red = color.r;
-    int green = color.g;
-    int blue = color.b;
-    int i = 0;
-    EmbThreadList* currentThreadItem = colors;
-
-    while(currentThreadItem != NULL)
-    {
-        int deltaRed;
-        int deltaBlue;
-        int deltaGreen;
-        double dist;
-        EmbColor c;
-        c = currentThreadItem->thread.color;
-
-        deltaRed = red - c.r;
-        deltaBlue = green - c.g;
-        deltaGreen = blue - c.b;
-
-        dist = sqrt((double)(deltaRed * deltaRed) + (deltaBlue * deltaBlue) + (deltaGreen * deltaGreen));
-        if(dist <= currentClosestValue)
-        {
-            currentClosestValue = dist;
-            closestIndex = i;
-        }
-        currentThreadItem = currentThreadItem->next;
-        i++;
-    }
-    return closestIndex;
+    if(!colors) return -1;
+    return embThread_findNearestColorInArray(color, colors->thread, colors->count);
 }
 
 int embThread_findNearestColorInArray(EmbColor color, EmbThread* colorArray, int count)
@@ -69,6 +43,8 @@ int embThread_findNearestColorInArray(EmbColor color, EmbThread* colorArray, int
     return closestIndex;
 }
 
+/*! Returns a thread of a random color. It draws on rand(), so it is not safe to call from several threads at once;
+ *  readers use embThread_getRandomR() instead. */
 EmbThread embThread_getRandom(void)
 {
     EmbThread c;
@@ -80,71 +56,141 @@ EmbThread embThread_getRandom(void)
     return c;
 }
 
-EmbThreadList* embThreadList_create(EmbThread data)
+/*! Returns a thread of a random color drawn from the caller's (\a seed), which is advanced, as rand_r() does.
+ *  The same seed always gives the same color. */
+EmbThread embThread_getRandomR(unsigned int* seed)
+{
+    EmbThread c;
+    unsigned int s = *seed;
+    s = s * 1103515245u + 12345u;
+    c.color.r = (unsigned char)((s >> 16) & 0xFF);
+    s = s * 1103515245u + 12345u;
+    c.color.g = (unsigned char)((s >> 16) & 0xFF);
+    s = s * 1103515245u + 12345u;
+    c.color.b = (unsigned char)((s >> 16) & 0xFF);
+    *seed = s;
+    c.description = "random";
+    c.catalogNumber = "";
+    return c;
+}
+
+/*! Returns a pointer to an empty EmbThreadList. It is created on the heap. The caller is responsible for freeing the allocated memory with embThreadList_free(). */
+EmbThreadList* embThreadList_create(void)
 {
     EmbThreadList* heapThreadList = (EmbThreadList*)malloc(sizeof(EmbThreadList));
     if(!heapThreadList) { embLog_error("emb-thread.c embThreadList_create(), cannot allocate memory for heapThreadList\n"); return 0; }
-    heapThreadList->thread = data;
-    heapThreadList->next = 0;
+    heapThreadList->thread = 0;
+    heapThreadList->count = 0;
+    heapThreadList->capacity = 0;
+    heapThreadList->matcher = 0;
+    heapThreadList->paletteIndex = 0;
+    heapThreadList->paletteCapacity = 0;
     return heapThreadList;
 }
 
-EmbThreadList* embThreadList_add(EmbThreadList* pointer, EmbThread data)
+/*! Appends (\a data) to the end of (\a list).
+ *  Returns \c true if successful, otherwise returns \c false. */
+int embThreadList_add(EmbThreadList* list, EmbThread data)
 {
-    if(!pointer) { embLog_error("emb-thread.c embThreadList_add(), pointer argument is null\n"); return 0; }
-    if(pointer->next) { embLog_error("emb-thread.c embThreadList_add(), pointer->next should be null\n"); return 0; }
-    pointer->next = (EmbThreadList*)malloc(sizeof(EmbThreadList));
-    if(!pointer->next) { embLog_error("emb-thread.c embThreadList_add(), cannot allocate memory for pointer->next\n"); return 0; }
-    pointer = pointer->next;
-    pointer->thread = data;
-    pointer->next = 0;
-    return pointer;
+    if(!list) { embLog_error("emb-thread.c embThreadList_add(), list argument is null\n"); return 0; }
+    if(list->count == list->capacity)
+    {
+        int capacity = list->capacity ? list->capacity * 2 : EMB_THREADLIST_MIN_CAPACITY;
+        EmbThread* grown = (EmbThread*)realloc(list->thread, sizeof(EmbThread) * (size_t)capacity);
+        if(!grown) { embLog_error("emb-thread.c embThreadList_add(), cannot allocate memory for %d threads\n", capacity); return 0; }
+        list->thread = grown;
+        list->capacity = capacity;
+    }
+    list->thread[list->count++] = data;
+    return 1;
 }
 
-EmbThread embThreadList_getAt(EmbThreadList* pointer, int num)
+/*! Removes every thread from (\a list) but keeps its storage for reuse. */
+void embThreadList_clear(EmbThreadList* list)
 {
-    /* TODO: pointer safety */
-    int i = 0;
-    for(i = 0; i < num; i++)
+    int i;
+
+    if(!list) return;
+    list->count = 0;
+    for(i = 0; i < list->paletteCapacity; i++)
     {
-        if(pointer->next)
-        {
-            pointer = pointer->next;
-        }
+        list->paletteIndex[i] = -2;
     }
-    return pointer->thread;
 }
 
-int embThreadList_count(EmbThreadList* pointer)
+/*! Returns thread (\a num) of (\a list). Indices past the end return the last thread, as the color numbers
+ *  of some formats run past the threads they define. */
+EmbThread embThreadList_getAt(EmbThreadList* list, int num)
 {
-    int i = 1;
-    if(!pointer) return 0;
-    while(pointer->next)
+    if(!list || list->count == 0)
     {
-        pointer = pointer->next;
-        i++;
+        EmbThread empty = { { 0, 0, 0 }, "", "" };
+        embLog_error("emb-thread.c embThreadList_getAt(), list is empty\n");
+        return empty;
     }
-    return i;
+    if(num < 0) num = 0;
+    if(num >= list->count) num = list->count - 1;
+    return list->thread[num];
 }
 
-int embThreadList_empty(EmbThreadList* pointer)
+/*! Returns the index of the entry of (\a palette) nearest in color to thread (\a num) of (\a list), or -1 on error.
+ *  (\a num) is clamped the same way as in embThreadList_getAt(). The result is cached per thread, so asking
+ *  again for the same palette costs O(1). Only the most recently used palette is remembered. */
+int embThreadList_paletteIndex(EmbThreadList* list, int num, const EmbThread* palette, int paletteCount)
 {
-    if(!pointer)
+    int i;
+
+    if(!list || list->count == 0 || !palette) { embLog_error("emb-thread.c embThreadList_paletteIndex(), invalid argument\n"); return -1; }
+    if(num < 0) num = 0;
+    if(num >= list->count) num = list->count - 1;
+    if(list->paletteCapacity < list->capacity)
+    {
+        int* grown = (int*)realloc(list->paletteIndex, sizeof(int) * (size_t)list->capacity);
+        if(!grown) { embLog_error("emb-thread.c embThreadList_paletteIndex(), cannot allocate memory for paletteIndex\n"); return -1; }
+        for(i = list->paletteCapacity; i < list->capacity; i++)
+        {
+            grown[i] = -2;
+        }
+        list->paletteIndex = grown;
+        list->paletteCapacity = list->capacity;
+    }
+    if(!list->matcher || list->matcher->threads != palette || list->matcher->count != paletteCount)
+    {
+        embPalette_free(list->matcher);
+        list->matcher = embPalette_create(palette, paletteCount, EMB_PALETTE_RGB);
+        if(!list->matcher) return -1;
+        for(i = 0; i < list->paletteCapacity; i++)
+        {
+            list->paletteIndex[i] = -2;
+        }
+    }
+    if(list->paletteIndex[num] == -2)
+    {
+        list->paletteIndex[num] = embPalette_nearest(list->matcher, list->thread[num].color);
+    }
+    return list->paletteIndex[num];
+}
+
+int embThreadList_count(EmbThreadList* list)
+{
+    if(!list) return 0;
+    return list->count;
+}
+
+int embThreadList_empty(EmbThreadList* list)
+{
+    if(!list || list->count == 0)
         return 1;
     return 0;
 }
 
-void embThreadList_free(EmbThreadList* pointer)
+void embThreadList_free(EmbThreadList* list)
 {
-    EmbThreadList* tempPointer = pointer;
-    EmbThreadList* nextPointer = 0;
-    while(tempPointer)
-    {
-        nextPointer = tempPointer->next;
-        free(tempPointer);
-        tempPointer = nextPointer;
-    }
-	pointer = 0;
+    if(!list) return;
+    free(list->thread);
+    free(list->paletteIndex);
+    embPalette_free(list->matcher);
+    free(list);
 }
 
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -18,22 +18,36 @@ typedef struct EmbThread_
     const char* catalogNumber;
 } EmbThread;
 
+struct EmbPalette_;
+
+/* Growable contiguous array of threads, indexed by the color number stored
+ * in each EmbStitch. It also remembers which entry of a fixed palette (such as
+ * the PEC or JEF thread charts) each thread maps to, so writers do not have to
+ * search the palette again for every stitch. */
 typedef struct EmbThreadList_
 {
-    EmbThread thread;
-    struct EmbThreadList_* next;
+    EmbThread* thread; /* thread[0] .. thread[count - 1] are valid */
+    int count;
+    int capacity;
+
+    struct EmbPalette_* matcher; /* palette that paletteIndex was computed against */
+    int* paletteIndex;           /* nearest palette entry per thread, -2 if not computed yet */
+    int paletteCapacity;
 } EmbThreadList;
 
 extern EMB_PUBLIC int EMB_CALL embThread_findNearestColor(EmbColor color, EmbThreadList* colors);
 extern EMB_PUBLIC int EMB_CALL embThread_findNearestColorInArray(EmbColor color, EmbThread* colorArray, int count);
 extern EMB_PUBLIC EmbThread EMB_CALL embThread_getRandom(void);
-
-extern EMB_PUBLIC EmbThreadList* EMB_CALL embThreadList_create(EmbThread data);
-extern EMB_PUBLIC EmbThreadList* EMB_CALL embThreadList_add(EmbThreadList* pointer, EmbThread data);
-extern EMB_PUBLIC int EMB_CALL embThreadList_count(EmbThreadList* pointer);
-extern EMB_PUBLIC int EMB_CALL embThreadList_empty(EmbThreadList* pointer);
-extern EMB_PUBLIC void EMB_CALL embThreadList_free(EmbThreadList* pointer);
-extern EMB_PUBLIC EmbThread EMB_CALL embThreadList_getAt(EmbThreadList* pointer, int num);
+extern EMB_PUBLIC EmbThread EMB_CALL embThread_getRandomR(unsigned int* seed);
+
+extern EMB_PUBLIC EmbThreadList* EMB_CALL embThreadList_create(void);
+extern EMB_PUBLIC int EMB_CALL embThreadList_add(EmbThreadList* list, EmbThread data);
+extern EMB_PUBLIC void EMB_CALL embThreadList_clear(EmbThreadList* list);
+extern EMB_PUBLIC int EMB_CALL embThreadList_count(EmbThreadList* list);
+extern EMB_PUBLIC int EMB_CALL embThreadList_empty(EmbThreadList* list);
+extern EMB_PUBLIC void EMB_CALL embThreadList_free(EmbThreadList* list);
+extern EMB_PUBLIC EmbThread EMB_CALL embThreadList_getAt(EmbThreadList* list, int num);
+extern EMB_PUBLIC int EMB_CALL embThreadList_paletteIndex(EmbThreadList* list, int num, const EmbThread* palette, int paletteCount);
 
 #ifdef __cplusplus
 }
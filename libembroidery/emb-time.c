@@ -12,16 +12,21 @@ void embTime_initNow(EmbTime* t)
 /*TODO: arduino embTime_initNow */
 #else
     time_t rawtime;
-    struct tm* timeinfo;
+    struct tm timeinfo;
     time(&rawtime);
-    timeinfo = localtime(&rawtime);
+    /* localtime() hands back a shared buffer, so use the reentrant forms */
+#ifdef _WIN32
+    localtime_s(&timeinfo, &rawtime);
+#else
+    localtime_r(&rawtime, &timeinfo);
+#endif
 
-    t->year   = timeinfo->tm_year;
-    t->month  = timeinfo->tm_mon;
-    t->day    = timeinfo->tm_mday;
-    t->hour   = timeinfo->tm_hour;
-    t->minute = timeinfo->tm_min;
-    t->second = timeinfo->tm_sec;
+    t->year   = timeinfo.tm_year;
+    t->month  = timeinfo.tm_mon;
+    t->day    = timeinfo.tm_mday;
+    t->hour   = timeinfo.tm_hour;
+    t->minute = timeinfo.tm_min;
+    t->second = timeinfo.tm_sec;
 #endif /* ARDUINO */
 }
 
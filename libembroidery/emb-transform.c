@@ -0,0 +1,146 @@
+#include "emb-transform.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*! Returns the transform that leaves every point where it is. */
+EmbTransform embTransform_identity(void)
+{
+    return embTransform_make(1.0, 0.0, 0.0, 1.0, 0.0, 0.0);
+}
+
+/*! Returns the transform with the coefficients (\a a) to (\a f), see EmbTransform. */
+EmbTransform embTransform_make(double a, double b, double c, double d, double e, double f)
+{
+    EmbTransform t;
+    t.a = a;
+    t.b = b;
+    t.c = c;
+    t.d = d;
+    t.e = e;
+    t.f = f;
+    return t;
+}
+
+/*! Returns the transform that moves every point by (\a dx, \a dy). */
+EmbTransform embTransform_translate(double dx, double dy)
+{
+    return embTransform_make(1.0, 0.0, 0.0, 1.0, dx, dy);
+}
+
+/*! Returns the transform that scales about the origin by (\a sx) along x and (\a sy) along y.
+ *  A negative factor mirrors the pattern across the other axis. */
+EmbTransform embTransform_scale(double sx, double sy)
+{
+    return embTransform_make(sx, 0.0, 0.0, sy, 0.0, 0.0);
+}
+
+/*! Returns the transform that rotates counterclockwise about the origin by (\a degrees),
+ *  counterclockwise being as seen with y up. Multiples of 90 degrees are exact. */
+EmbTransform embTransform_rotate(double degrees)
+{
+    double turns = fmod(degrees, 360.0);
+    double s, c;
+
+    if(turns < 0.0) turns += 360.0;
+    if(turns == 0.0)        { s =  0.0; c =  1.0; }
+    else if(turns == 90.0)  { s =  1.0; c =  0.0; }
+    else if(turns == 180.0) { s =  0.0; c = -1.0; }
+    else if(turns == 270.0) { s = -1.0; c =  0.0; }
+    else
+    {
+        s = sin(turns * M_PI / 180.0);
+        c = cos(turns * M_PI / 180.0);
+    }
+    return embTransform_make(c, s, -s, c, 0.0, 0.0);
+}
+
+/*! Returns the transform that applies (\a first) and then (\a then). */
+EmbTransform embTransform_multiply(EmbTransform first, EmbTransform then)
+{
+    EmbTransform t;
+    t.a = then.a * first.a + then.c * first.b;
+    t.b = then.b * first.a + then.d * first.b;
+    t.c = then.a * first.c + then.c * first.d;
+    t.d = then.b * first.c + then.d * first.d;
+    t.e = then.a * first.e + then.c * first.f + then.e;
+    t.f = then.b * first.e + then.d * first.f + then.f;
+    return t;
+}
+
+/*! Stores the inverse of (\a t) in (\a result).
+ *  Returns \c true if successful, or \c false if (\a t) collapses the plane onto a line or a point. */
+int embTransform_invert(EmbTransform t, EmbTransform* result)
+{
+    double det = embTransform_determinant(t);
+
+    if(det == 0.0 || !result) return 0;
+    result->a = t.d / det;
+    result->b = -t.b / det;
+    result->c = -t.c / det;
+    result->d = t.a / det;
+    result->e = (t.c * t.f - t.d * t.e) / det;
+    result->f = (t.b * t.e - t.a * t.f) / det;
+    return 1;
+}
+
+/*! Returns (\a point) moved by the transform (\a t).
+ *  Terms with a zero coefficient are skipped rather than added, so a flip or a
+ *  scale gives exactly the values negating or multiplying each coordinate would. */
+EmbPoint embTransform_apply(EmbTransform t, EmbPoint point)
+{
+    EmbPoint result;
+    result.xx = t.a * point.xx;
+    result.yy = t.d * point.yy;
+    if(t.c != 0.0) result.xx += t.c * point.yy;
+    if(t.b != 0.0) result.yy += t.b * point.xx;
+    if(t.e != 0.0) result.xx += t.e;
+    if(t.f != 0.0) result.yy += t.f;
+    return result;
+}
+
+/*! Returns the direction or size (\a vector) as changed by the transform (\a t), which is (\a t) without its translation. */
+EmbPoint embTransform_applyToVector(EmbTransform t, EmbPoint vector)
+{
+    EmbPoint result;
+    result.xx = t.a * vector.xx;
+    result.yy = t.d * vector.yy;
+    if(t.c != 0.0) result.xx += t.c * vector.yy;
+    if(t.b != 0.0) result.yy += t.b * vector.xx;
+    return result;
+}
+
+/*! Returns the factor by which the transform (\a t) changes areas. It is negative if (\a t) mirrors. */
+double embTransform_determinant(EmbTransform t)
+{
+    return t.a * t.d - t.b * t.c;
+}
+
+/*! Returns \c true if the transform (\a t) leaves every point where it is. */
+int embTransform_isIdentity(EmbTransform t)
+{
+    return t.a == 1.0 && t.b == 0.0 && t.c == 0.0 && t.d == 1.0 && t.e == 0.0 && t.f == 0.0;
+}
+
+/*! Returns \c true if the transform (\a t) maps horizontal and vertical lines to horizontal and vertical lines,
+ *  so an axis-aligned box stays one and the box of the moved corners is exact. */
+int embTransform_keepsAxes(EmbTransform t)
+{
+    return (t.b == 0.0 && t.c == 0.0) || (t.a == 0.0 && t.d == 0.0);
+}
+
+/*! Returns \c true if the transform (\a t) only moves, rotates, mirrors and scales uniformly,
+ *  so circles stay circles. */
+int embTransform_isSimilarity(EmbTransform t)
+{
+    double lengthX = t.a * t.a + t.b * t.b;
+    double lengthY = t.c * t.c + t.d * t.d;
+    double dot = t.a * t.c + t.b * t.d;
+    double tolerance = 1e-12 * (lengthX + lengthY);
+
+    return fabs(lengthX - lengthY) <= tolerance && fabs(dot) <= tolerance;
+}
+
+/* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -0,0 +1,46 @@
+/*! @file emb-transform.h */
+#ifndef EMB_TRANSFORM_H
+#define EMB_TRANSFORM_H
+
+#include "emb-point.h"
+
+#include "api-start.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An affine transform of the plane. The point (x, y) maps to
+ * (a*x + c*y + e, b*x + d*y + f), the same layout as SVG's matrix(a b c d e f). */
+typedef struct EmbTransform_
+{
+    double a;
+    double b;
+    double c;
+    double d;
+    double e;
+    double f;
+} EmbTransform;
+
+extern EMB_PUBLIC EmbTransform EMB_CALL embTransform_identity(void);
+extern EMB_PUBLIC EmbTransform EMB_CALL embTransform_make(double a, double b, double c, double d, double e, double f);
+extern EMB_PUBLIC EmbTransform EMB_CALL embTransform_translate(double dx, double dy);
+extern EMB_PUBLIC EmbTransform EMB_CALL embTransform_scale(double sx, double sy);
+extern EMB_PUBLIC EmbTransform EMB_CALL embTransform_rotate(double degrees);
+extern EMB_PUBLIC EmbTransform EMB_CALL embTransform_multiply(EmbTransform first, EmbTransform then);
+extern EMB_PUBLIC int EMB_CALL embTransform_invert(EmbTransform t, EmbTransform* result);
+
+extern EMB_PUBLIC EmbPoint EMB_CALL embTransform_apply(EmbTransform t, EmbPoint point);
+extern EMB_PUBLIC EmbPoint EMB_CALL embTransform_applyToVector(EmbTransform t, EmbPoint vector);
+extern EMB_PUBLIC double EMB_CALL embTransform_determinant(EmbTransform t);
+extern EMB_PUBLIC int EMB_CALL embTransform_isIdentity(EmbTransform t);
+extern EMB_PUBLIC int EMB_CALL embTransform_keepsAxes(EmbTransform t);
+extern EMB_PUBLIC int EMB_CALL embTransform_isSimilarity(EmbTransform t);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#include "api-stop.h"
+
+#endif /* EMB_TRANSFORM_H */
+
+/* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -21,9 +21,7 @@ int readCol(EmbPattern* pattern, const char* fileName)
         return 0;
     }
 
-    embThreadList_free(pattern->threadList);
-    pattern->threadList = 0;
-    pattern->lastThread = 0;
+    embPattern_clearThreads(pattern);
 
     /* TODO: replace all scanf code */
     if(fscanf(file, "%d\r", &numberOfColors) < 1) /* TODO: needs to work cross-platform - Win: \r\n Mac: \r Linux: \n */
@@ -64,7 +62,7 @@ int writeCol(EmbPattern* pattern, const char* fileName)
 {
     FILE* file = 0;
     int i, colorCount;
-    EmbThreadList *colors;
+    int t;
 
     if(!pattern) { embLog_error("format-col.c writeCol(), pattern argument is null\n"); return 0; }
     if(!fileName) { embLog_error("format-col.c writeCol(), fileName argument is null\n"); return 0; }
@@ -75,17 +73,15 @@ int writeCol(EmbPattern* pattern, const char* fileName)
         embLog_error("format-col.c writeCol(), cannot open %s for writing\n", fileName);
         return 0;
     }
-    colorCount = embThreadList_count(pattern->threadList);
+    colorCount = embPattern_threadCount(pattern);
     fprintf(file, "%d\n\r", colorCount); /* TODO: needs to be \r\n */
-    colors = pattern->threadList;
     i = 0;
-    while(colors)
+    for(t = 0; t < embThreadList_count(pattern->threadList); t++)
     {
         EmbColor c;
-        c = colors->thread.color;
+        c = pattern->threadList->thread[t].color;
         fprintf(file, "%d,%d,%d,%d\n\r", i, (int)c.r, (int)c.g, (int)c.b); /* TODO: needs to be \r\n */
         i++;
-        colors = colors->next;
     }
     fclose(file);
     return 1;
@@ -8,10 +8,15 @@
 #define CsdSubMaskSize  479
 #define CsdXorMaskSize  501
 
-static char _subMask[CsdSubMaskSize];
-static char _xorMask[CsdXorMaskSize];
+/* The decryption masks of one file, kept per read so that files can be decoded on several threads at once. */
+typedef struct CsdDecrypter_
+{
+    char subMask[CsdSubMaskSize];
+    char xorMask[CsdXorMaskSize];
+    int type;
+} CsdDecrypter;
 
-static void BuildDecryptionTable(int seed)
+static void BuildDecryptionTable(CsdDecrypter* decrypter, int seed)
 {
     int i;
     const int mul1 = 0x41C64E6D;
@@ -21,17 +26,17 @@ static void BuildDecryptionTable(int seed)
     {
         seed *= mul1;
         seed += add1;
-        _subMask[i] = (char) ((seed >> 16) & 0xFF);
+        decrypter->subMask[i] = (char) ((seed >> 16) & 0xFF);
     }
     for(i = 0; i < CsdXorMaskSize; i++)
     {
         seed *= mul1;
         seed += add1;
-        _xorMask[i] = (char) ((seed >> 16) & 0xFF);
+        decrypter->xorMask[i] = (char) ((seed >> 16) & 0xFF);
     }
 }
 
-static unsigned char DecodeCsdByte(long fileOffset, unsigned char val, int type)
+static unsigned char DecodeCsdByte(const CsdDecrypter* decrypter, long fileOffset, unsigned char val)
 {
     static const unsigned char _decryptArray[] =
     {
@@ -55,7 +60,7 @@ static unsigned char DecodeCsdByte(long fileOffset, unsigned char val, int type)
     int newOffset;
 
     fileOffset = fileOffset - 1;
-    if(type != 0)
+    if(decrypter->type != 0)
     {
         int final;
         int fileOffsetHigh = (int) (fileOffset & 0xFFFFFF00);
@@ -90,7 +95,7 @@ static unsigned char DecodeCsdByte(long fileOffset, unsigned char val, int type)
     {
         newOffset = (int) fileOffset;
     }
-    return ((unsigned char) ((unsigned char) (val ^ _xorMask[newOffset%CsdXorMaskSize]) - _subMask[newOffset%CsdSubMaskSize]));
+    return ((unsigned char) ((unsigned char) (val ^ decrypter->xorMask[newOffset%CsdXorMaskSize]) - decrypter->subMask[newOffset%CsdSubMaskSize]));
 }
 
 /*! Reads a file with the given \a fileName and loads the data into \a pattern.
@@ -98,6 +103,7 @@ static unsigned char DecodeCsdByte(long fileOffset, unsigned char val, int type)
 int readCsd(EmbPattern* pattern, const char* fileName)
 {
     int i, type = 0;
+    CsdDecrypter decrypter;
     unsigned char identifier[8];
     unsigned char unknown1, unknown2;
     char dx = 0, dy = 0;
@@ -125,36 +131,37 @@ int readCsd(EmbPattern* pattern, const char* fileName)
     }
     if(type == 0)
     {
-        BuildDecryptionTable(0xC);
+        BuildDecryptionTable(&decrypter, 0xC);
     }
     else
     {
-        BuildDecryptionTable(identifier[0]);
+        BuildDecryptionTable(&decrypter, identifier[0]);
     }
+    decrypter.type = type;
     embFile_seek(file, 8, SEEK_SET);
     for(i = 0; i < 16; i++)
     {
         EmbThread thread;
-        thread.color.r = DecodeCsdByte(embFile_tell(file), binaryReadByte(file), type);
-        thread.color.g = DecodeCsdByte(embFile_tell(file), binaryReadByte(file), type);
-        thread.color.b = DecodeCsdByte(embFile_tell(file), binaryReadByte(file), type);
+        thread.color.r = DecodeCsdByte(&decrypter, embFile_tell(file), binaryReadByte(file));
+        thread.color.g = DecodeCsdByte(&decrypter, embFile_tell(file), binaryReadByte(file));
+        thread.color.b = DecodeCsdByte(&decrypter, embFile_tell(file), binaryReadByte(file));
         thread.catalogNumber = "";
         thread.description = "";
         embPattern_addThread(pattern, thread);
     }
-    unknown1 = DecodeCsdByte(embFile_tell(file), binaryReadByte(file), type);
-    unknown2 = DecodeCsdByte(embFile_tell(file), binaryReadByte(file), type);
+    unknown1 = DecodeCsdByte(&decrypter, embFile_tell(file), binaryReadByte(file));
+    unknown2 = DecodeCsdByte(&decrypter, embFile_tell(file), binaryReadByte(file));
 
     for(i = 0; i < 14; i++)
     {
-        colorOrder[i] = (unsigned char) DecodeCsdByte(embFile_tell(file), binaryReadByte(file), type);
+        colorOrder[i] = (unsigned char) DecodeCsdByte(&decrypter, embFile_tell(file), binaryReadByte(file));
     }
     for(i = 0; !endOfStream; i++)
     {
         char negativeX, negativeY;
-        unsigned char b0 = DecodeCsdByte(embFile_tell(file), binaryReadByte(file), type);
-        unsigned char b1 = DecodeCsdByte(embFile_tell(file), binaryReadByte(file), type);
-        unsigned char b2 = DecodeCsdByte(embFile_tell(file), binaryReadByte(file), type);
+        unsigned char b0 = DecodeCsdByte(&decrypter, embFile_tell(file), binaryReadByte(file));
+        unsigned char b1 = DecodeCsdByte(&decrypter, embFile_tell(file), binaryReadByte(file));
+        unsigned char b2 = DecodeCsdByte(&decrypter, embFile_tell(file), binaryReadByte(file));
 
         if(b0 == 0xF8 || b0 == 0x87 || b0 == 0x91)
         {
@@ -187,7 +194,7 @@ int readCsd(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     return 1;
@@ -207,7 +214,7 @@ int writeCsd(EmbPattern* pattern, const char* fileName)
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch->stitch.flags != END)
+    if(embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     /* TODO: embFile_open() needs to occur here after the check for no stitches */
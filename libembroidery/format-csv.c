@@ -1,4 +1,5 @@
 #include "format-csv.h"
+#include "emb-reader-writer.h"
 #include "emb-file.h"
 #include "emb-logging.h"
 #include <stdlib.h>
@@ -69,6 +70,7 @@ int readCsv(EmbPattern* pattern, const char* fileName)
     double yy = 0.0;
     unsigned char r = 0, g = 0, b = 0;
     char* buff = 0;
+    unsigned int seed;
 
     if(!pattern) { embLog_error("format-csv.c readCsv(), pattern argument is null\n"); return 0; }
     if(!fileName) { embLog_error("format-csv.c readCsv(), fileName argument is null\n"); return 0; }
@@ -226,9 +228,10 @@ int readCsv(EmbPattern* pattern, const char* fileName)
     }
 
     /* if not enough colors defined, fill in random colors */
-    while(embThreadList_count(pattern->threadList) < numColorChanges)
+    seed = (unsigned int)embPattern_threadCount(pattern);
+    while(embPattern_threadCount(pattern) < numColorChanges)
     {
-        embPattern_addThread(pattern, embThread_getRandom());
+        embPattern_addThread(pattern, embThread_getRandomR(&seed));
     }
 
     free(buff);
@@ -237,23 +240,22 @@ int readCsv(EmbPattern* pattern, const char* fileName)
     return 1;
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeCsv(EmbPattern* pattern, const char* fileName)
+int writeCsvStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
-    EmbFile* file = 0;
-    EmbStitchList* sList = 0;
+    EmbStitch* st = 0;
+    EmbStitchIterator it;
     EmbThreadList* tList = 0;
     EmbRect boundingRect;
     int i = 0;
     int stitchCount = 0;
     int threadCount = 0;
 
-    if(!pattern) { embLog_error("format-csv.c writeCsv(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-csv.c writeCsv(), fileName argument is null\n"); return 0; }
+    if(!pattern) { embLog_error("format-csv.c writeCsvStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-csv.c writeCsvStream(), file argument is null\n"); return 0; }
 
-    sList = pattern->stitchList;
-    stitchCount = embStitchList_count(sList);
+    stitchCount = embStitchList_count(pattern->stitchList);
 
     tList = pattern->threadList;
     threadCount = embThreadList_count(tList);
@@ -262,24 +264,17 @@ int writeCsv(EmbPattern* pattern, const char* fileName)
 
     if(!stitchCount)
     {
-        embLog_error("format-csv.c writeCsv(), pattern contains no stitches\n");
+        embLog_error("format-csv.c writeCsvStream(), pattern contains no stitches\n");
         return 0;
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
     {
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
         stitchCount++;
     }
 
-    file = embFile_open(fileName, "w");
-    if(!file)
-    {
-        embLog_error("format-csv.c writeCsv(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
-
     /* write header */
     embFile_printf(file, "\"#\",\"Embroidermodder 2 CSV Embroidery File\"\n");
     embFile_printf(file, "\"#\",\"http://embroidermodder.github.io\"\n");
@@ -315,31 +310,34 @@ int writeCsv(EmbPattern* pattern, const char* fileName)
 
     /* write colors */
     embFile_printf(file, "\"#\",\"[THREAD_NUMBER]\",\"[RED]\",\"[GREEN]\",\"[BLUE]\",\"[DESCRIPTION]\",\"[CATALOG_NUMBER]\"\n");
-    i = 1;
-    while(tList)
+    for(i = 0; i < threadCount; i++)
     {
-        embFile_printf(file, "\"$\",\"%d\",\"%d\",\"%d\",\"%d\",\"%s\",\"%s\"\n", i, /* TODO: fix segfault that backtraces here when libembroidery-convert from dst to csv. */
-                (int)tList->thread.color.r,
-                (int)tList->thread.color.g,
-                (int)tList->thread.color.b,
-                tList->thread.description,
-                tList->thread.catalogNumber);
-        i++;
-        tList = tList->next;
+        EmbThread t = tList->thread[i];
+        embFile_printf(file, "\"$\",\"%d\",\"%d\",\"%d\",\"%d\",\"%s\",\"%s\"\n", i + 1, /* TODO: fix segfault that backtraces here when libembroidery-convert from dst to csv. */
+                (int)t.color.r,
+                (int)t.color.g,
+                (int)t.color.b,
+                t.description,
+                t.catalogNumber);
     }
     embFile_printf(file, "\n");
 
     /* write stitches */
     embFile_printf(file, "\"#\",\"[STITCH_TYPE]\",\"[X]\",\"[Y]\"\n");
-    while(sList)
+    it = embStitchList_begin(pattern->stitchList);
+    while((st = embStitchIterator_next(&it)))
     {
-        EmbStitch s = sList->stitch;
-        embFile_printf(file, "\"*\",\"%s\",\"%f\",\"%f\"\n", csvStitchFlagToStr(s.flags), s.xx, s.yy);
-        sList = sList->next;
+        embFile_printf(file, "\"*\",\"%s\",\"%f\",\"%f\"\n", csvStitchFlagToStr(st->flags), st->xx, st->yy);
     }
 
-    embFile_close(file);
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeCsv(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "w", writeCsvStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
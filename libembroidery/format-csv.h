@@ -2,6 +2,7 @@
 #ifndef FORMAT_CSV_H
 #define FORMAT_CSV_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -28,6 +29,7 @@ typedef enum
 
 extern EMB_PRIVATE int EMB_CALL readCsv(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeCsv(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeCsvStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
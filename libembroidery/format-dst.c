@@ -4,6 +4,7 @@
  */
 
 #include "format-dst.h"
+#include "emb-reader-writer.h"
 #include "emb-file.h"
 #include "emb-logging.h"
 #include "helpers-binary.h"
@@ -12,28 +13,148 @@
 #include <string.h>
 #include <stdlib.h>
 
-static int decode_record_flags(unsigned char b2)
+#define DST_BLOCK_RECORDS 1024 /* records decoded or encoded per block */
+#define DST_HEADER_SIZE   512
+#define DST_MAX_LENGTH    12.1 /* longest move a record can hold, in mm */
+
+/* Contribution of each byte of a record to the stitch offset, in 0.1 mm units. The offset of a
+ * record is the sum of the entries for its three bytes. */
+static const signed char dstDecodeX[3][256] =
 {
-    int returnCode = 0;
-    if(b2 == 0xF3)
     {
-        return END;
-    }
-    if(b2 & 0x80)
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0,
+          0,   1,  -1,   0,   9,  10,   8,   9,  -9,  -8, -10,  -9,   0,   1,  -1,   0
+    },
     {
-        returnCode |= JUMP;
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0,
+          0,   3,  -3,   0,  27,  30,  24,  27, -27, -24, -30, -27,   0,   3,  -3,   0
+    },
+    {
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0,
+          0,   0,   0,   0,  81,  81,  81,  81, -81, -81, -81, -81,   0,   0,   0,   0
     }
-    if(b2 & 0x40)
+};
+
+static const signed char dstDecodeY[3][256] =
+{
+    {
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+         -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,
+          9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+         -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,
+        -10, -10, -10, -10, -10, -10, -10, -10, -10, -10, -10, -10, -10, -10, -10, -10,
+          8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,
+         -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,
+          1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+         -8,  -8,  -8,  -8,  -8,  -8,  -8,  -8,  -8,  -8,  -8,  -8,  -8,  -8,  -8,  -8,
+         10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,
+          1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+         -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,  -9,
+          9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0
+    },
     {
-        returnCode |= STOP;
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27,
+         27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+         -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,
+        -30, -30, -30, -30, -30, -30, -30, -30, -30, -30, -30, -30, -30, -30, -30, -30,
+         24,  24,  24,  24,  24,  24,  24,  24,  24,  24,  24,  24,  24,  24,  24,  24,
+         -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,  -3,
+          3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
+        -24, -24, -24, -24, -24, -24, -24, -24, -24, -24, -24, -24, -24, -24, -24, -24,
+         30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,
+          3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27,
+         27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0
+    },
+    {
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81,
+         81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81,
+         81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81,
+         81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81, -81,
+         81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0
     }
-    return returnCode;
-}
+};
 
-static unsigned char setbit(int pos)
+/* Stitch flags carried by the third byte of a record. */
+static const unsigned char dstDecodeFlags[256] =
 {
-    return (unsigned char)(1 << pos);
-}
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+     4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+     4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+     4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5, 16,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5
+};
 
 /* TODO: review this then remove since emb-pattern.c has a similar function */
 /* void combineJumpStitches(EmbPattern* p, int jumpsPerTrim)
@@ -45,7 +166,7 @@ static unsigned char setbit(int pos)
     char needleDown = 0;
     while(pointer)
     {
-        if((pointer->stitch.flags & JUMP) && !(pointer->stitch.flags & STOP))
+        if((pointer->flags & JUMP) && !(pointer->flags & STOP))
         {
             if(jumpCount == 0)
             {
@@ -55,8 +176,8 @@ static unsigned char setbit(int pos)
             if(needleDown && jumpCount >= jumpsPerTrim)
             {
                 EmbStitchList* removePointer = jumpListStart->next;
-                jumpListStart->stitch.xx = pointer->stitch.xx;
-                jumpListStart->stitch.yy = pointer->stitch.yy;
+                jumpListStart->stitch.xx = pointer->xx;
+                jumpListStart->stitch.yy = pointer->yy;
                 jumpListStart->stitch.flags |= TRIM;
                 jumpListStart->next = pointer;
 
@@ -75,80 +196,139 @@ static unsigned char setbit(int pos)
         }
         else
         {
-            if(pointer->stitch.flags == NORMAL)
+            if(pointer->flags == NORMAL)
             {
                 needleDown = 1;
                 jumpCount = 0;
             }
         }
-        pointer = pointer->next;
     }
 }
 */
 
-static void encode_record(EmbFile* file, int x, int y, int flags)
+/* Record bytes that encode an offset of -121 to 121 (index 0 to 242) along each axis, in 0.1 mm units.
+ * A record is the bitwise or of the entries for its x and y offsets plus its flag bits. */
+static const unsigned char dstEncodeX[243][3] =
+{
+    {0x0A, 0x0A, 0x08}, {0x08, 0x0A, 0x08}, {0x09, 0x0A, 0x08}, {0x0A, 0x08, 0x08}, {0x08, 0x08, 0x08}, {0x09, 0x08, 0x08},
+    {0x0A, 0x09, 0x08}, {0x08, 0x09, 0x08}, {0x09, 0x09, 0x08}, {0x02, 0x0A, 0x08}, {0x00, 0x0A, 0x08}, {0x01, 0x0A, 0x08},
+    {0x02, 0x08, 0x08}, {0x00, 0x08, 0x08}, {0x01, 0x08, 0x08}, {0x02, 0x09, 0x08}, {0x00, 0x09, 0x08}, {0x01, 0x09, 0x08},
+    {0x06, 0x0A, 0x08}, {0x04, 0x0A, 0x08}, {0x05, 0x0A, 0x08}, {0x06, 0x08, 0x08}, {0x04, 0x08, 0x08}, {0x05, 0x08, 0x08},
+    {0x06, 0x09, 0x08}, {0x04, 0x09, 0x08}, {0x05, 0x09, 0x08}, {0x0A, 0x02, 0x08}, {0x08, 0x02, 0x08}, {0x09, 0x02, 0x08},
+    {0x0A, 0x00, 0x08}, {0x08, 0x00, 0x08}, {0x09, 0x00, 0x08}, {0x0A, 0x01, 0x08}, {0x08, 0x01, 0x08}, {0x09, 0x01, 0x08},
+    {0x02, 0x02, 0x08}, {0x00, 0x02, 0x08}, {0x01, 0x02, 0x08}, {0x02, 0x00, 0x08}, {0x00, 0x00, 0x08}, {0x01, 0x00, 0x08},
+    {0x02, 0x01, 0x08}, {0x00, 0x01, 0x08}, {0x01, 0x01, 0x08}, {0x06, 0x02, 0x08}, {0x04, 0x02, 0x08}, {0x05, 0x02, 0x08},
+    {0x06, 0x00, 0x08}, {0x04, 0x00, 0x08}, {0x05, 0x00, 0x08}, {0x06, 0x01, 0x08}, {0x04, 0x01, 0x08}, {0x05, 0x01, 0x08},
+    {0x0A, 0x06, 0x08}, {0x08, 0x06, 0x08}, {0x09, 0x06, 0x08}, {0x0A, 0x04, 0x08}, {0x08, 0x04, 0x08}, {0x09, 0x04, 0x08},
+    {0x0A, 0x05, 0x08}, {0x08, 0x05, 0x08}, {0x09, 0x05, 0x08}, {0x02, 0x06, 0x08}, {0x00, 0x06, 0x08}, {0x01, 0x06, 0x08},
+    {0x02, 0x04, 0x08}, {0x00, 0x04, 0x08}, {0x01, 0x04, 0x08}, {0x02, 0x05, 0x08}, {0x00, 0x05, 0x08}, {0x01, 0x05, 0x08},
+    {0x06, 0x06, 0x08}, {0x04, 0x06, 0x08}, {0x05, 0x06, 0x08}, {0x06, 0x04, 0x08}, {0x04, 0x04, 0x08}, {0x05, 0x04, 0x08},
+    {0x06, 0x05, 0x08}, {0x04, 0x05, 0x08}, {0x05, 0x05, 0x08}, {0x0A, 0x0A, 0x00}, {0x08, 0x0A, 0x00}, {0x09, 0x0A, 0x00},
+    {0x0A, 0x08, 0x00}, {0x08, 0x08, 0x00}, {0x09, 0x08, 0x00}, {0x0A, 0x09, 0x00}, {0x08, 0x09, 0x00}, {0x09, 0x09, 0x00},
+    {0x02, 0x0A, 0x00}, {0x00, 0x0A, 0x00}, {0x01, 0x0A, 0x00}, {0x02, 0x08, 0x00}, {0x00, 0x08, 0x00}, {0x01, 0x08, 0x00},
+    {0x02, 0x09, 0x00}, {0x00, 0x09, 0x00}, {0x01, 0x09, 0x00}, {0x06, 0x0A, 0x00}, {0x04, 0x0A, 0x00}, {0x05, 0x0A, 0x00},
+    {0x06, 0x08, 0x00}, {0x04, 0x08, 0x00}, {0x05, 0x08, 0x00}, {0x06, 0x09, 0x00}, {0x04, 0x09, 0x00}, {0x05, 0x09, 0x00},
+    {0x0A, 0x02, 0x00}, {0x08, 0x02, 0x00}, {0x09, 0x02, 0x00}, {0x0A, 0x00, 0x00}, {0x08, 0x00, 0x00}, {0x09, 0x00, 0x00},
+    {0x0A, 0x01, 0x00}, {0x08, 0x01, 0x00}, {0x09, 0x01, 0x00}, {0x02, 0x02, 0x00}, {0x00, 0x02, 0x00}, {0x01, 0x02, 0x00},
+    {0x02, 0x00, 0x00}, {0x00, 0x00, 0x00}, {0x01, 0x00, 0x00}, {0x02, 0x01, 0x00}, {0x00, 0x01, 0x00}, {0x01, 0x01, 0x00},
+    {0x06, 0x02, 0x00}, {0x04, 0x02, 0x00}, {0x05, 0x02, 0x00}, {0x06, 0x00, 0x00}, {0x04, 0x00, 0x00}, {0x05, 0x00, 0x00},
+    {0x06, 0x01, 0x00}, {0x04, 0x01, 0x00}, {0x05, 0x01, 0x00}, {0x0A, 0x06, 0x00}, {0x08, 0x06, 0x00}, {0x09, 0x06, 0x00},
+    {0x0A, 0x04, 0x00}, {0x08, 0x04, 0x00}, {0x09, 0x04, 0x00}, {0x0A, 0x05, 0x00}, {0x08, 0x05, 0x00}, {0x09, 0x05, 0x00},
+    {0x02, 0x06, 0x00}, {0x00, 0x06, 0x00}, {0x01, 0x06, 0x00}, {0x02, 0x04, 0x00}, {0x00, 0x04, 0x00}, {0x01, 0x04, 0x00},
+    {0x02, 0x05, 0x00}, {0x00, 0x05, 0x00}, {0x01, 0x05, 0x00}, {0x06, 0x06, 0x00}, {0x04, 0x06, 0x00}, {0x05, 0x06, 0x00},
+    {0x06, 0x04, 0x00}, {0x04, 0x04, 0x00}, {0x05, 0x04, 0x00}, {0x06, 0x05, 0x00}, {0x04, 0x05, 0x00}, {0x05, 0x05, 0x00},
+    {0x0A, 0x0A, 0x04}, {0x08, 0x0A, 0x04}, {0x09, 0x0A, 0x04}, {0x0A, 0x08, 0x04}, {0x08, 0x08, 0x04}, {0x09, 0x08, 0x04},
+    {0x0A, 0x09, 0x04}, {0x08, 0x09, 0x04}, {0x09, 0x09, 0x04}, {0x02, 0x0A, 0x04}, {0x00, 0x0A, 0x04}, {0x01, 0x0A, 0x04},
+    {0x02, 0x08, 0x04}, {0x00, 0x08, 0x04}, {0x01, 0x08, 0x04}, {0x02, 0x09, 0x04}, {0x00, 0x09, 0x04}, {0x01, 0x09, 0x04},
+    {0x06, 0x0A, 0x04}, {0x04, 0x0A, 0x04}, {0x05, 0x0A, 0x04}, {0x06, 0x08, 0x04}, {0x04, 0x08, 0x04}, {0x05, 0x08, 0x04},
+    {0x06, 0x09, 0x04}, {0x04, 0x09, 0x04}, {0x05, 0x09, 0x04}, {0x0A, 0x02, 0x04}, {0x08, 0x02, 0x04}, {0x09, 0x02, 0x04},
+    {0x0A, 0x00, 0x04}, {0x08, 0x00, 0x04}, {0x09, 0x00, 0x04}, {0x0A, 0x01, 0x04}, {0x08, 0x01, 0x04}, {0x09, 0x01, 0x04},
+    {0x02, 0x02, 0x04}, {0x00, 0x02, 0x04}, {0x01, 0x02, 0x04}, {0x02, 0x00, 0x04}, {0x00, 0x00, 0x04}, {0x01, 0x00, 0x04},
+    {0x02, 0x01, 0x04}, {0x00, 0x01, 0x04}, {0x01, 0x01, 0x04}, {0x06, 0x02, 0x04}, {0x04, 0x02, 0x04}, {0x05, 0x02, 0x04},
+    {0x06, 0x00, 0x04}, {0x04, 0x00, 0x04}, {0x05, 0x00, 0x04}, {0x06, 0x01, 0x04}, {0x04, 0x01, 0x04}, {0x05, 0x01, 0x04},
+    {0x0A, 0x06, 0x04}, {0x08, 0x06, 0x04}, {0x09, 0x06, 0x04}, {0x0A, 0x04, 0x04}, {0x08, 0x04, 0x04}, {0x09, 0x04, 0x04},
+    {0x0A, 0x05, 0x04}, {0x08, 0x05, 0x04}, {0x09, 0x05, 0x04}, {0x02, 0x06, 0x04}, {0x00, 0x06, 0x04}, {0x01, 0x06, 0x04},
+    {0x02, 0x04, 0x04}, {0x00, 0x04, 0x04}, {0x01, 0x04, 0x04}, {0x02, 0x05, 0x04}, {0x00, 0x05, 0x04}, {0x01, 0x05, 0x04},
+    {0x06, 0x06, 0x04}, {0x04, 0x06, 0x04}, {0x05, 0x06, 0x04}, {0x06, 0x04, 0x04}, {0x04, 0x04, 0x04}, {0x05, 0x04, 0x04},
+    {0x06, 0x05, 0x04}, {0x04, 0x05, 0x04}, {0x05, 0x05, 0x04}
+};
+
+static const unsigned char dstEncodeY[243][3] =
 {
-    char b0, b1, b2;
-    b0 = b1 = b2 = 0;
-
-    /* cannot encode values > +121 or < -121. */
-    if(x > 121 || x < -121) embLog_error("format-dst.c encode_record(), x is not in valid range [-121,121] , x = %d\n", x);
-    if(y > 121 || y < -121) embLog_error("format-dst.c encode_record(), y is not in valid range [-121,121] , y = %d\n", y);
-
-    if(x >= +41) { b2 += setbit(2); x -= 81; }
-    if(x <= -41) { b2 += setbit(3); x += 81; }
-    if(x >= +14) { b1 += setbit(2); x -= 27; }
-    if(x <= -14) { b1 += setbit(3); x += 27; }
-    if(x >=  +5) { b0 += setbit(2); x -= 9; }
-    if(x <=  -5) { b0 += setbit(3); x += 9; }
-    if(x >=  +2) { b1 += setbit(0); x -= 3; }
-    if(x <=  -2) { b1 += setbit(1); x += 3; }
-    if(x >=  +1) { b0 += setbit(0); x -= 1; }
-    if(x <=  -1) { b0 += setbit(1); x += 1; }
-    if(x !=   0) { embLog_error("format-dst.c encode_record(), x should be zero yet x = %d\n", x); }
-    if(y >= +41) { b2 += setbit(5); y -= 81; }
-    if(y <= -41) { b2 += setbit(4); y += 81; }
-    if(y >= +14) { b1 += setbit(5); y -= 27; }
-    if(y <= -14) { b1 += setbit(4); y += 27; }
-    if(y >=  +5) { b0 += setbit(5); y -= 9; }
-    if(y <=  -5) { b0 += setbit(4); y += 9; }
-    if(y >=  +2) { b1 += setbit(7); y -= 3; }
-    if(y <=  -2) { b1 += setbit(6); y += 3; }
-    if(y >=  +1) { b0 += setbit(7); y -= 1; }
-    if(y <=  -1) { b0 += setbit(6); y += 1; }
-    if(y !=   0) { embLog_error("format-dst.c encode_record(), y should be zero yet y = %d\n", y); }
-
-    b2 |= (char) 3;
+    {0x50, 0x50, 0x10}, {0x10, 0x50, 0x10}, {0x90, 0x50, 0x10}, {0x50, 0x10, 0x10}, {0x10, 0x10, 0x10}, {0x90, 0x10, 0x10},
+    {0x50, 0x90, 0x10}, {0x10, 0x90, 0x10}, {0x90, 0x90, 0x10}, {0x40, 0x50, 0x10}, {0x00, 0x50, 0x10}, {0x80, 0x50, 0x10},
+    {0x40, 0x10, 0x10}, {0x00, 0x10, 0x10}, {0x80, 0x10, 0x10}, {0x40, 0x90, 0x10}, {0x00, 0x90, 0x10}, {0x80, 0x90, 0x10},
+    {0x60, 0x50, 0x10}, {0x20, 0x50, 0x10}, {0xA0, 0x50, 0x10}, {0x60, 0x10, 0x10}, {0x20, 0x10, 0x10}, {0xA0, 0x10, 0x10},
+    {0x60, 0x90, 0x10}, {0x20, 0x90, 0x10}, {0xA0, 0x90, 0x10}, {0x50, 0x40, 0x10}, {0x10, 0x40, 0x10}, {0x90, 0x40, 0x10},
+    {0x50, 0x00, 0x10}, {0x10, 0x00, 0x10}, {0x90, 0x00, 0x10}, {0x50, 0x80, 0x10}, {0x10, 0x80, 0x10}, {0x90, 0x80, 0x10},
+    {0x40, 0x40, 0x10}, {0x00, 0x40, 0x10}, {0x80, 0x40, 0x10}, {0x40, 0x00, 0x10}, {0x00, 0x00, 0x10}, {0x80, 0x00, 0x10},
+    {0x40, 0x80, 0x10}, {0x00, 0x80, 0x10}, {0x80, 0x80, 0x10}, {0x60, 0x40, 0x10}, {0x20, 0x40, 0x10}, {0xA0, 0x40, 0x10},
+    {0x60, 0x00, 0x10}, {0x20, 0x00, 0x10}, {0xA0, 0x00, 0x10}, {0x60, 0x80, 0x10}, {0x20, 0x80, 0x10}, {0xA0, 0x80, 0x10},
+    {0x50, 0x60, 0x10}, {0x10, 0x60, 0x10}, {0x90, 0x60, 0x10}, {0x50, 0x20, 0x10}, {0x10, 0x20, 0x10}, {0x90, 0x20, 0x10},
+    {0x50, 0xA0, 0x10}, {0x10, 0xA0, 0x10}, {0x90, 0xA0, 0x10}, {0x40, 0x60, 0x10}, {0x00, 0x60, 0x10}, {0x80, 0x60, 0x10},
+    {0x40, 0x20, 0x10}, {0x00, 0x20, 0x10}, {0x80, 0x20, 0x10}, {0x40, 0xA0, 0x10}, {0x00, 0xA0, 0x10}, {0x80, 0xA0, 0x10},
+    {0x60, 0x60, 0x10}, {0x20, 0x60, 0x10}, {0xA0, 0x60, 0x10}, {0x60, 0x20, 0x10}, {0x20, 0x20, 0x10}, {0xA0, 0x20, 0x10},
+    {0x60, 0xA0, 0x10}, {0x20, 0xA0, 0x10}, {0xA0, 0xA0, 0x10}, {0x50, 0x50, 0x00}, {0x10, 0x50, 0x00}, {0x90, 0x50, 0x00},
+    {0x50, 0x10, 0x00}, {0x10, 0x10, 0x00}, {0x90, 0x10, 0x00}, {0x50, 0x90, 0x00}, {0x10, 0x90, 0x00}, {0x90, 0x90, 0x00},
+    {0x40, 0x50, 0x00}, {0x00, 0x50, 0x00}, {0x80, 0x50, 0x00}, {0x40, 0x10, 0x00}, {0x00, 0x10, 0x00}, {0x80, 0x10, 0x00},
+    {0x40, 0x90, 0x00}, {0x00, 0x90, 0x00}, {0x80, 0x90, 0x00}, {0x60, 0x50, 0x00}, {0x20, 0x50, 0x00}, {0xA0, 0x50, 0x00},
+    {0x60, 0x10, 0x00}, {0x20, 0x10, 0x00}, {0xA0, 0x10, 0x00}, {0x60, 0x90, 0x00}, {0x20, 0x90, 0x00}, {0xA0, 0x90, 0x00},
+    {0x50, 0x40, 0x00}, {0x10, 0x40, 0x00}, {0x90, 0x40, 0x00}, {0x50, 0x00, 0x00}, {0x10, 0x00, 0x00}, {0x90, 0x00, 0x00},
+    {0x50, 0x80, 0x00}, {0x10, 0x80, 0x00}, {0x90, 0x80, 0x00}, {0x40, 0x40, 0x00}, {0x00, 0x40, 0x00}, {0x80, 0x40, 0x00},
+    {0x40, 0x00, 0x00}, {0x00, 0x00, 0x00}, {0x80, 0x00, 0x00}, {0x40, 0x80, 0x00}, {0x00, 0x80, 0x00}, {0x80, 0x80, 0x00},
+    {0x60, 0x40, 0x00}, {0x20, 0x40, 0x00}, {0xA0, 0x40, 0x00}, {0x60, 0x00, 0x00}, {0x20, 0x00, 0x00}, {0xA0, 0x00, 0x00},
+    {0x60, 0x80, 0x00}, {0x20, 0x80, 0x00}, {0xA0, 0x80, 0x00}, {0x50, 0x60, 0x00}, {0x10, 0x60, 0x00}, {0x90, 0x60, 0x00},
+    {0x50, 0x20, 0x00}, {0x10, 0x20, 0x00}, {0x90, 0x20, 0x00}, {0x50, 0xA0, 0x00}, {0x10, 0xA0, 0x00}, {0x90, 0xA0, 0x00},
+    {0x40, 0x60, 0x00}, {0x00, 0x60, 0x00}, {0x80, 0x60, 0x00}, {0x40, 0x20, 0x00}, {0x00, 0x20, 0x00}, {0x80, 0x20, 0x00},
+    {0x40, 0xA0, 0x00}, {0x00, 0xA0, 0x00}, {0x80, 0xA0, 0x00}, {0x60, 0x60, 0x00}, {0x20, 0x60, 0x00}, {0xA0, 0x60, 0x00},
+    {0x60, 0x20, 0x00}, {0x20, 0x20, 0x00}, {0xA0, 0x20, 0x00}, {0x60, 0xA0, 0x00}, {0x20, 0xA0, 0x00}, {0xA0, 0xA0, 0x00},
+    {0x50, 0x50, 0x20}, {0x10, 0x50, 0x20}, {0x90, 0x50, 0x20}, {0x50, 0x10, 0x20}, {0x10, 0x10, 0x20}, {0x90, 0x10, 0x20},
+    {0x50, 0x90, 0x20}, {0x10, 0x90, 0x20}, {0x90, 0x90, 0x20}, {0x40, 0x50, 0x20}, {0x00, 0x50, 0x20}, {0x80, 0x50, 0x20},
+    {0x40, 0x10, 0x20}, {0x00, 0x10, 0x20}, {0x80, 0x10, 0x20}, {0x40, 0x90, 0x20}, {0x00, 0x90, 0x20}, {0x80, 0x90, 0x20},
+    {0x60, 0x50, 0x20}, {0x20, 0x50, 0x20}, {0xA0, 0x50, 0x20}, {0x60, 0x10, 0x20}, {0x20, 0x10, 0x20}, {0xA0, 0x10, 0x20},
+    {0x60, 0x90, 0x20}, {0x20, 0x90, 0x20}, {0xA0, 0x90, 0x20}, {0x50, 0x40, 0x20}, {0x10, 0x40, 0x20}, {0x90, 0x40, 0x20},
+    {0x50, 0x00, 0x20}, {0x10, 0x00, 0x20}, {0x90, 0x00, 0x20}, {0x50, 0x80, 0x20}, {0x10, 0x80, 0x20}, {0x90, 0x80, 0x20},
+    {0x40, 0x40, 0x20}, {0x00, 0x40, 0x20}, {0x80, 0x40, 0x20}, {0x40, 0x00, 0x20}, {0x00, 0x00, 0x20}, {0x80, 0x00, 0x20},
+    {0x40, 0x80, 0x20}, {0x00, 0x80, 0x20}, {0x80, 0x80, 0x20}, {0x60, 0x40, 0x20}, {0x20, 0x40, 0x20}, {0xA0, 0x40, 0x20},
+    {0x60, 0x00, 0x20}, {0x20, 0x00, 0x20}, {0xA0, 0x00, 0x20}, {0x60, 0x80, 0x20}, {0x20, 0x80, 0x20}, {0xA0, 0x80, 0x20},
+    {0x50, 0x60, 0x20}, {0x10, 0x60, 0x20}, {0x90, 0x60, 0x20}, {0x50, 0x20, 0x20}, {0x10, 0x20, 0x20}, {0x90, 0x20, 0x20},
+    {0x50, 0xA0, 0x20}, {0x10, 0xA0, 0x20}, {0x90, 0xA0, 0x20}, {0x40, 0x60, 0x20}, {0x00, 0x60, 0x20}, {0x80, 0x60, 0x20},
+    {0x40, 0x20, 0x20}, {0x00, 0x20, 0x20}, {0x80, 0x20, 0x20}, {0x40, 0xA0, 0x20}, {0x00, 0xA0, 0x20}, {0x80, 0xA0, 0x20},
+    {0x60, 0x60, 0x20}, {0x20, 0x60, 0x20}, {0xA0, 0x60, 0x20}, {0x60, 0x20, 0x20}, {0x20, 0x20, 0x20}, {0xA0, 0x20, 0x20},
+    {0x60, 0xA0, 0x20}, {0x20, 0xA0, 0x20}, {0xA0, 0xA0, 0x20}
+};
+
+/* Encodes a record for the offset (dx, dy) with (flags) into the three bytes at (b). Offsets outside
+ * [-121, 121] cannot be encoded and are clamped to the nearest one that can. Returns 1 if it had to clamp. */
+static int dstEncodeRecord(unsigned char* b, int dx, int dy, int flags)
+{
+    int clamped = 0;
+    const unsigned char* ex = 0;
+    const unsigned char* ey = 0;
+
+    if(dx > 121) { dx = 121; clamped = 1; }
+    if(dx < -121) { dx = -121; clamped = 1; }
+    if(dy > 121) { dy = 121; clamped = 1; }
+    if(dy < -121) { dy = -121; clamped = 1; }
+    ex = dstEncodeX[dx + 121];
+    ey = dstEncodeY[dy + 121];
 
     if(flags & END)
     {
-        b2 = (char) -13;
-        b0 = b1 = (char) 0;
+        b[0] = b[1] = 0;
+        b[2] = 0xF3;
     }
-
-    /* if(flags & TRIM)
-    {
-        int v = 5;
-        int dx = (int)(x/v), dy = (int)(y/v);
-        for(i = 1; i < v; i++)
-        {
-            encode_record(file, dx, dy, JUMP);
-        }
-        encode_record(file, x - (dx * (v - 1)), y - (dy * (v - 1)), JUMP);
-        return;
-    } */
-    if(flags & (JUMP | TRIM))
+    else
     {
-        b2 = (char) (b2 | 0x83);
+        b[0] = (unsigned char)(ex[0] | ey[0]);
+        b[1] = (unsigned char)(ex[1] | ey[1]);
+        b[2] = (unsigned char)(ex[2] | ey[2] | 0x03);
     }
+    if(flags & (JUMP | TRIM))
+        b[2] |= 0x83;
     if(flags & STOP)
-    {
-        b2 = (char) (b2 | 0xC3);
-    }
-
-    binaryWriteByte(file, (unsigned char)b0);
-    binaryWriteByte(file, (unsigned char)b1);
-    binaryWriteByte(file, (unsigned char)b2);
+        b[2] |= 0xC3;
+    return clamped;
 }
 
 /*convert 2 characters into 1 int for case statement */
@@ -220,18 +400,105 @@ static void set_dst_variable(EmbPattern* pattern, char* var, char* val)
     }
 }
 
-/*! Reads a file with the given \a fileName and loads the data into \a pattern.
- *  Returns \c true if successful, otherwise returns \c false. */
-int readDst(EmbPattern* pattern, const char* fileName)
+/* Reads the 512 byte header at the start of (file), adding the threads it lists to (pattern). */
+static void dstReadHeader(EmbPattern* pattern, EmbFile* file)
 {
     char var[3];   /* temporary storage variable name */
     char val[512]; /* temporary storage variable value */
     int valpos;
-    unsigned char b[3];
     char header[512 + 1];
-    EmbFile* file = 0;
     int i = 0;
-    int flags; /* for converting stitches from file encoding */
+
+    /* READ 512 BYTE HEADER INTO header[] */
+    i = (int)embFile_read(header, 1, 512, file);
+    memset(header + i, EOF, 512 - i); /* a short file reads as EOF, as embFile_getc() would */
+
+    /*TODO:It would probably be a good idea to validate file before accepting it. */
+
+    /* fill variables from header fields */
+    for(i = 0; i < 512; i++)
+    {
+        if(header[i] == ':' && i > 1)
+        {
+            var[0] = header[i - 2];
+            var[1] = header[i - 1];
+            var[2] = '\0';
+            valpos = i + 1;
+            for(i++; i < 512; i++)
+            {
+                /* don't accept : without CR because there's a bug below: i-valpos must be > 0 which is not the case if the : is before the third character. */
+                if(header[i] == 13/*||header[i]==':'*/) /* 0x0d = carriage return */
+                {
+                    if(header[i] == ':') /* : indicates another variable, CR was missing! */
+                    {
+                        i -= 2;
+                    }
+                    strncpy(val, &header[valpos], (size_t)(i - valpos));
+                    val[i - valpos] = '\0';
+                    set_dst_variable(pattern, var, val);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/* Decodes the (count) records in (data) and appends them to (pattern). Absolute positions are accumulated
+ * from the last stitch of the pattern, so (stitches) must have room for (count) entries but needs no contents.
+ * Returns 0 once the END record has been reached. */
+static int dstDecodeRecords(EmbPattern* pattern, const unsigned char* data, int count, EmbStitch* stitches)
+{
+    int i, n = 0, flags, color;
+    double x, y;
+
+    /* The first stitch of a pattern also brings in the HOME stitch, and a STOP before it is dropped */
+    while(count > 0 && embStitchList_empty(pattern->stitchList))
+    {
+        flags = dstDecodeFlags[data[2]];
+        if(flags == END)
+            return 0;
+        embPattern_addStitchRel(pattern,
+                                (dstDecodeX[0][data[0]] + dstDecodeX[1][data[1]] + dstDecodeX[2][data[2]]) / 10.0,
+                                (dstDecodeY[0][data[0]] + dstDecodeY[1][data[1]] + dstDecodeY[2][data[2]]) / 10.0,
+                                flags, 1);
+        data += 3;
+        count--;
+    }
+
+    x = pattern->lastX;
+    y = pattern->lastY;
+    color = pattern->currentColorIndex;
+    for(i = 0; i < count; i++, data += 3)
+    {
+        flags = dstDecodeFlags[data[2]];
+        if(flags == END)
+            break;
+        if(flags & STOP)
+            color++;
+        x += (dstDecodeX[0][data[0]] + dstDecodeX[1][data[1]] + dstDecodeX[2][data[2]]) / 10.0;
+        y += (dstDecodeY[0][data[0]] + dstDecodeY[1][data[1]] + dstDecodeY[2][data[2]]) / 10.0;
+        stitches[n].flags = flags;
+        stitches[n].xx = x;
+        stitches[n].yy = y;
+        stitches[n].color = color;
+        n++;
+    }
+    pattern->currentColorIndex = color;
+    embPattern_appendStitches(pattern, stitches, n);
+    return i == count;
+}
+
+/*! Reads a file with the given \a fileName and loads the data into \a pattern.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int readDst(EmbPattern* pattern, const char* fileName)
+{
+    unsigned char block[3 * DST_BLOCK_RECORDS];
+    EmbFile* file = 0;
+    EmbStitch* stitches = 0;
+    const unsigned char* view = 0;
+    const unsigned char* data = 0;
+    size_t remaining = 0;
+    int count;
 
     /*
     * The header seems to contain information about the design.
@@ -295,165 +562,229 @@ int readDst(EmbPattern* pattern, const char* fileName)
     }
 
     embPattern_loadExternalColorFile(pattern, fileName);
-    /* READ 512 BYTE HEADER INTO header[] */
-    for(i = 0; i < 512; i++)
+    dstReadHeader(pattern, file);
+
+    stitches = (EmbStitch*)malloc(sizeof(EmbStitch) * DST_BLOCK_RECORDS);
+    if(!stitches)
     {
-        header[i] = (char)embFile_getc(file);
+        embLog_error("format-dst.c readDst(), cannot allocate memory for stitches\n");
+        embFile_close(file);
+        return 0;
     }
 
-    /*TODO:It would probably be a good idea to validate file before accepting it. */
-
-    /* fill variables from header fields */
-    for(i = 0; i < 512; i++)
+    /* Decode the records a block at a time, straight from memory when the file is held there */
+    view = embFile_view(file, &remaining);
+    remaining /= 3;
+    for(;;)
     {
-        if(header[i] == ':' && i > 1)
+        if(view)
         {
-            var[0] = header[i - 2];
-            var[1] = header[i - 1];
-            var[2] = '\0';
-            valpos = i + 1;
-            for(i++; i < 512; i++)
-            {
-                /* don't accept : without CR because there's a bug below: i-valpos must be > 0 which is not the case if the : is before the third character. */
-                if(header[i] == 13/*||header[i]==':'*/) /* 0x0d = carriage return */
-                {
-                    if(header[i] == ':') /* : indicates another variable, CR was missing! */
-                    {
-                        i -= 2;
-                    }
-                    strncpy(val, &header[valpos], (size_t)(i - valpos));
-                    val[i - valpos] = '\0';
-                    set_dst_variable(pattern, var, val);
-                    break;
-                }
-            }
+            count = remaining < DST_BLOCK_RECORDS ? (int)remaining : DST_BLOCK_RECORDS;
+            data = view;
+            view += 3 * count;
+            remaining -= count;
         }
-    }
-
-    while(embFile_read(b, 1, 3, file) == 3)
-    {
-        int x = 0;
-        int y = 0;
-        if(b[0] & 0x01)
-            x += 1;
-        if(b[0] & 0x02)
-            x -= 1;
-        if(b[0] & 0x04)
-            x += 9;
-        if(b[0] & 0x08)
-            x -= 9;
-        if(b[0] & 0x80)
-            y += 1;
-        if(b[0] & 0x40)
-            y -= 1;
-        if(b[0] & 0x20)
-            y += 9;
-        if(b[0] & 0x10)
-            y -= 9;
-        if(b[1] & 0x01)
-            x += 3;
-        if(b[1] & 0x02)
-            x -= 3;
-        if(b[1] & 0x04)
-            x += 27;
-        if(b[1] & 0x08)
-            x -= 27;
-        if(b[1] & 0x80)
-            y += 3;
-        if(b[1] & 0x40)
-            y -= 3;
-        if(b[1] & 0x20)
-            y += 27;
-        if(b[1] & 0x10)
-            y -= 27;
-        if(b[2] & 0x04)
-            x += 81;
-        if(b[2] & 0x08)
-            x -= 81;
-        if(b[2] & 0x20)
-            y += 81;
-        if(b[2] & 0x10)
-            y -= 81;
-        flags = decode_record_flags(b[2]);
-        if(flags == END)
+        else
         {
-            break;
+            count = (int)embFile_read(block, 3, DST_BLOCK_RECORDS, file);
+            data = block;
         }
-        embPattern_addStitchRel(pattern, x / 10.0, y / 10.0, flags, 1);
+        if(count <= 0 || !dstDecodeRecords(pattern, data, count, stitches))
+            break;
     }
+    free(stitches);
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     /* combineJumpStitches(pattern, 5); */
     return 1;
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
- *  Returns \c true if successful, otherwise returns \c false. */
-int writeDst(EmbPattern* pattern, const char* fileName)
+/* Decoder state of a DST file read through an EmbStitchSource. */
+typedef struct DstSource_
 {
-    EmbRect boundingRect;
-    EmbFile* file = 0;
-    int xx, yy, dx, dy, flags;
-    int i;
-    int co = 1, st = 0;
-    int ax, ay, mx, my;
-    char* pd = 0;
-    EmbStitchList* pointer = 0;
+    EmbFile* file;
+    const unsigned char* view; /* unread records when the file is held in memory, otherwise 0 */
+    size_t remaining;
+    unsigned char block[3 * DST_BLOCK_RECORDS];
+    int blockUsed;
+    int blockCount;
+} DstSource;
 
-    if(!pattern) { embLog_error("format-dst.c writeDst(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-dst.c writeDst(), fileName argument is null\n"); return 0; }
+static int dstSource_decode(EmbStitchSource* source)
+{
+    DstSource* d = (DstSource*)source->data;
+    const unsigned char* b = 0;
+    int flags;
 
-    if(!embStitchList_count(pattern->stitchList))
+    while(embStitchSource_room(source) >= 2)
     {
-        embLog_error("format-dst.c writeDst(), pattern contains no stitches\n");
-        return 0;
+        if(d->view)
+        {
+            if(!d->remaining)
+                return 0;
+            b = d->view;
+            d->view += 3;
+            d->remaining--;
+        }
+        else
+        {
+            if(d->blockUsed == d->blockCount)
+            {
+                d->blockCount = (int)embFile_read(d->block, 3, DST_BLOCK_RECORDS, d->file);
+                d->blockUsed = 0;
+                if(d->blockCount <= 0)
+                    return 0;
+            }
+            b = d->block + 3 * d->blockUsed++;
+        }
+        flags = dstDecodeFlags[b[2]];
+        if(flags == END)
+            return 0;
+        embStitchSource_addStitchRel(source,
+                                     (dstDecodeX[0][b[0]] + dstDecodeX[1][b[1]] + dstDecodeX[2][b[2]]) / 10.0,
+                                     (dstDecodeY[0][b[0]] + dstDecodeY[1][b[1]] + dstDecodeY[2][b[2]]) / 10.0,
+                                     flags);
     }
+    return 1;
+}
 
-    /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
-        embPattern_addStitchRel(pattern, 0, 0, END, 1);
+static void dstSource_close(EmbStitchSource* source)
+{
+    free(source->data);
+}
 
-    file = embFile_open(fileName, "wb");
-    if(!file)
+/*! Returns a source that decodes the stitches of the DST data in \a file as they are asked for. The threads from
+ *  the header and from any external color file next to \a fileName are in the source's meta pattern, which is
+ *  read with \a options (may be 0). \a file must stay open until the source is freed with embStitchSource_free().
+ *  Returns 0 on error. */
+EmbStitchSource* readDstSource(EmbFile* file, const char* fileName, const EmbReadOptions* options)
+{
+    DstSource* d = 0;
+    EmbStitchSource* source = 0;
+
+    if(!file) { embLog_error("format-dst.c readDstSource(), file argument is null\n"); return 0; }
+
+    d = (DstSource*)malloc(sizeof(DstSource));
+    if(!d) { embLog_error("format-dst.c readDstSource(), cannot allocate memory for d\n"); return 0; }
+    source = embStitchSource_create(d, dstSource_decode, dstSource_close);
+    if(!source) { free(d); return 0; }
+
+    embPattern_setReadOptions(source->meta, options);
+    if(fileName)
+        embPattern_loadExternalColorFile(source->meta, fileName);
+    dstReadHeader(source->meta, file);
+    d->file = file;
+    d->view = embFile_view(file, &(d->remaining));
+    d->remaining /= 3;
+    d->blockUsed = d->blockCount = 0;
+    return source;
+}
+
+/* State of a DST export. Records are encoded into (block) and flushed a block at a time, while the
+ * figures the header needs are gathered along the way. */
+typedef struct DstExport_
+{
+    EmbFile* file;
+    unsigned char block[3 * DST_BLOCK_RECORDS];
+    int used;       /* records waiting in block */
+    int count;      /* records encoded so far */
+    int clamped;    /* records whose offset had to be clamped */
+    int failed;     /* set once a write to file has come up short */
+    int xx, yy;     /* position of the last record, in 0.1 mm */
+    EmbRect extents;
+
+    /* Only used when writing through a sink, see writeDstSink() */
+    EmbStitch prev;
+    int started;
+    int threadCount;
+    int maxColorIndex;
+} DstExport;
+
+static void dstExport_flush(DstExport* e)
+{
+    if(e->used && embFile_write(e->block, 3, (size_t)e->used, e->file) != (size_t)e->used)
+        e->failed = 1;
+    e->used = 0;
+}
+
+/* Encodes a record that moves to the absolute position (x, y), in mm. */
+static void dstExport_emit(DstExport* e, double x, double y, int flags)
+{
+    int xx = roundDouble(x * 10.0);
+    int yy = roundDouble(y * 10.0);
+
+    e->clamped += dstEncodeRecord(e->block + 3 * e->used, xx - e->xx, yy - e->yy, flags);
+    e->xx = xx;
+    e->yy = yy;
+    e->count++;
+    if(!(flags & TRIM))
     {
-        embLog_error("format-dst.c writeDst(), cannot open %s for writing\n", fileName);
-        return 0;
+        e->extents.left = min(e->extents.left, x);
+        e->extents.top = min(e->extents.top, y);
+        e->extents.right = max(e->extents.right, x);
+        e->extents.bottom = max(e->extents.bottom, y);
     }
+    if(++e->used == DST_BLOCK_RECORDS)
+        dstExport_flush(e);
+}
+
+/* Emits the stitch (st) that follows (prev), first splitting the move between them into equal pieces
+ * no longer than DST_MAX_LENGTH, as embPattern_correctForMaxStitchLength() would. */
+static void dstExport_stitch(DstExport* e, const EmbStitch* prev, const EmbStitch* st)
+{
+    int j, splits;
+    double dx, dy, addX, addY;
 
-    embPattern_correctForMaxStitchLength(pattern, 12.1, 12.1);
+    if(prev)
+    {
+        dx = st->xx - prev->xx;
+        dy = st->yy - prev->yy;
+        if(fabs(dx) > DST_MAX_LENGTH || fabs(dy) > DST_MAX_LENGTH)
+        {
+            splits = (int)ceil(max(fabs(dx), fabs(dy)) / DST_MAX_LENGTH);
+            addX = dx / splits;
+            addY = dy / splits;
+            for(j = 1; j < splits; j++)
+            {
+                dstExport_emit(e, prev->xx + addX * j, prev->yy + addY * j, st->flags);
+            }
+        }
+    }
+    dstExport_emit(e, st->xx, st->yy, st->flags);
+}
+
+/* Fills the DST_HEADER_SIZE bytes at (header) with the header of a design of (stitchCount) records and
+ * (colorCount) colors whose stitches cover (bounds). */
+static void dstFormatHeader(char* header, int stitchCount, int colorCount, EmbRect bounds)
+{
+    char text[DST_HEADER_SIZE + 256];
+    int length, ax, ay, mx, my;
+    char* pd = 0;
 
-    xx = yy = 0;
-    co = 1;
-    co = embThreadList_count(pattern->threadList);
-    st = 0;
-    st = embStitchList_count(pattern->stitchList);
-    flags = NORMAL;
-    boundingRect = embPattern_calcBoundingBox(pattern);
     /* TODO: review the code below
     if(pattern->get_variable("design_name") != NULL)
     {
     char *la = stralloccopy(pattern->get_variable("design_name"));
     if(strlen(la)>16) la[16]='\0';
 
-    embFile_printf(file,"LA:%-16s\x0d",la);
+    sprintf(text,"LA:%-16s\x0d",la);
     free(la);
     }
     else
     {
     */
-    embFile_printf(file, "LA:%-16s\x0d", "Untitled");
+    length = sprintf(text, "LA:%-16s\x0d", "Untitled");
     /*} */
-    embFile_printf(file, "ST:%7d\x0d", st);
-    embFile_printf(file, "CO:%3d\x0d", co - 1); /* number of color changes, not number of colors! */
-    embFile_printf(file, "+X:%5d\x0d", (int)(boundingRect.right * 10.0));
-    embFile_printf(file, "-X:%5d\x0d", (int)(fabs(boundingRect.left) * 10.0));
-    embFile_printf(file, "+Y:%5d\x0d", (int)(boundingRect.bottom * 10.0));
-    embFile_printf(file, "-Y:%5d\x0d", (int)(fabs(boundingRect.top) * 10.0));
-
+    length += sprintf(text + length, "ST:%7d\x0d", stitchCount);
+    length += sprintf(text + length, "CO:%3d\x0d", colorCount - 1); /* number of color changes, not number of colors! */
+    length += sprintf(text + length, "+X:%5d\x0d", (int)(bounds.right * 10.0));
+    length += sprintf(text + length, "-X:%5d\x0d", (int)(fabs(bounds.left) * 10.0));
+    length += sprintf(text + length, "+Y:%5d\x0d", (int)(bounds.bottom * 10.0));
+    length += sprintf(text + length, "-Y:%5d\x0d", (int)(fabs(bounds.top) * 10.0));
 
     ax = ay = mx = my = 0;
     /* TODO: review the code below */
@@ -469,37 +800,226 @@ int writeDst(EmbPattern* pattern, const char* fileName)
         /* pd is not valid, so fill in a default consisting of "******" */
         pd = "******";
     }
-    embFile_printf(file, "AX:+%5d\x0d", ax);
-    embFile_printf(file, "AY:+%5d\x0d", ay);
-    embFile_printf(file, "MX:+%5d\x0d", mx);
-    embFile_printf(file, "MY:+%5d\x0d", my);
-    embFile_printf(file, "PD:%6s\x0d", pd);
-    binaryWriteByte(file, 0x1a); /* 0x1a is the code for end of section. */
+    length += sprintf(text + length, "AX:+%5d\x0d", ax);
+    length += sprintf(text + length, "AY:+%5d\x0d", ay);
+    length += sprintf(text + length, "MX:+%5d\x0d", mx);
+    length += sprintf(text + length, "MY:+%5d\x0d", my);
+    length += sprintf(text + length, "PD:%6s\x0d", pd);
+    text[length++] = 0x1a; /* 0x1a is the code for end of section. */
 
     /* pad out header to proper length */
-    for(i = 125; i < 512; i++)
+    if(length > DST_HEADER_SIZE)
+        length = DST_HEADER_SIZE;
+    memcpy(header, text, (size_t)length);
+    memset(header + length, ' ', (size_t)(DST_HEADER_SIZE - length));
+}
+
+/* Starts an export to (file), keeping room for the header. Returns 0 on error. */
+static DstExport* dstExport_begin(EmbFile* file)
+{
+    char header[DST_HEADER_SIZE];
+    DstExport* e = (DstExport*)malloc(sizeof(DstExport));
+
+    if(!e) { embLog_error("format-dst.c dstExport_begin(), cannot allocate memory for e\n"); return 0; }
+    e->file = file;
+    e->used = e->count = e->clamped = e->failed = 0;
+    e->xx = e->yy = 0;
+    e->extents.left = e->extents.top = 99999.0;
+    e->extents.right = e->extents.bottom = -99999.0;
+    e->started = e->threadCount = e->maxColorIndex = 0;
+
+    /* The header depends on everything after it, so room is kept for it and it is filled in last */
+    memset(header, ' ', DST_HEADER_SIZE);
+    if(embFile_write(header, 1, DST_HEADER_SIZE, file) != DST_HEADER_SIZE)
     {
-        embFile_printf(file, " ");
+        embLog_error("format-dst.c dstExport_begin(), cannot write to file\n");
+        free(e);
+        return 0;
     }
+    return e;
+}
 
-    /* write stitches */
-    xx = yy = 0;
-    pointer = pattern->stitchList;
-    while(pointer)
+/* Writes out the remaining records and the terminator, fills in the header of a design of (colorCount)
+ * colors covering (bounds) as well as the records, and frees (e). Returns 0 if any write to the file failed. */
+static int dstExport_finish(DstExport* e, int colorCount, EmbRect bounds)
+{
+    static const unsigned char terminator[3] = { 0xA1, 0, 0 }; /* finish file with a terminator character */
+    char header[DST_HEADER_SIZE];
+    EmbFile* file = e->file;
+    int ok;
+
+    dstExport_flush(e);
+    if(embFile_write(terminator, 1, 3, file) != 3)
+        e->failed = 1;
+
+    bounds.left = min(bounds.left, e->extents.left);
+    bounds.top = min(bounds.top, e->extents.top);
+    bounds.right = max(bounds.right, e->extents.right);
+    bounds.bottom = max(bounds.bottom, e->extents.bottom);
+    dstFormatHeader(header, e->count, colorCount, bounds);
+    if(embFile_seek(file, 0, SEEK_SET) || embFile_write(header, 1, DST_HEADER_SIZE, file) != DST_HEADER_SIZE)
+        e->failed = 1;
+    if(embFile_seek(file, 0, SEEK_END))
+        e->failed = 1;
+
+    if(e->clamped)
+        embLog_error("format-dst.c dstExport_finish(), %d stitches were outside the valid range [-121,121] and have been clamped\n", e->clamped);
+    if(e->failed)
+        embLog_error("format-dst.c dstExport_finish(), cannot write to file\n");
+    ok = !e->failed;
+    free(e);
+    return ok;
+}
+
+/*! Writes the data from \a pattern to the stream \a file.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeDstStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
+{
+    DstExport* e = 0;
+    EmbStitch end;
+    const EmbStitch* prev = 0;
+    const EmbStitch* last = 0;
+    int i, colorCount, stitchCount;
+
+    if(!pattern) { embLog_error("format-dst.c writeDstStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-dst.c writeDstStream(), file argument is null\n"); return 0; }
+
+    stitchCount = embStitchList_count(pattern->stitchList);
+    if(!stitchCount)
     {
-        /* convert from mm to 0.1mm for file format */
-        dx = roundDouble(pointer->stitch.xx * 10.0) - xx;
-        dy = roundDouble(pointer->stitch.yy * 10.0) - yy;
-        xx = roundDouble(pointer->stitch.xx * 10.0);
-        yy = roundDouble(pointer->stitch.yy * 10.0);
-        flags = pointer->stitch.flags;
-        encode_record(file, dx, dy, flags);
-        pointer = pointer->next;
+        embLog_error("format-dst.c writeDstStream(), pattern contains no stitches\n");
+        return 0;
     }
-    binaryWriteByte(file, 0xA1); /* finish file with a terminator character */
-    binaryWriteShort(file, 0);
-    embFile_close(file);
+
+    e = dstExport_begin(file);
+    if(!e) return 0;
+
+    /* The pattern is left untouched: long moves are split and the END record
+     * is added as the records are encoded, in a single pass over the stitches. */
+    for(i = 0; i < stitchCount; i++)
+    {
+        dstExport_stitch(e, prev, &(pattern->stitchList->stitch[i]));
+        prev = &(pattern->stitchList->stitch[i]);
+    }
+    last = prev;
+    colorCount = embPattern_threadCount(pattern);
+    if(!(last->flags & END))
+    {
+        end.xx = pattern->lastX;
+        end.yy = pattern->lastY;
+        end.flags = END;
+        end.color = pattern->currentColorIndex;
+        dstExport_stitch(e, last, &end);
+        /* The colors a pattern is given when it is ended, as embPattern_fixColorCount() does */
+        colorCount = max(colorCount, embPattern_stats(pattern)->maxColorIndex + 1);
+    }
+
+    /* The header extents also cover the design's objects */
+    return dstExport_finish(e, colorCount, embPattern_calcBoundingBox(pattern));
+}
+
+/*! Writes the stitches pulled from \a source to the stream \a file as they are decoded.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeDstSource(EmbStitchSource* source, EmbFile* file)
+{
+    DstExport* e = 0;
+    EmbStitch prev, st;
+    EmbRect bounds;
+
+    if(!source) { embLog_error("format-dst.c writeDstSource(), source argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-dst.c writeDstSource(), file argument is null\n"); return 0; }
+
+    if(!embStitchSource_next(source, &prev))
+    {
+        embLog_error("format-dst.c writeDstSource(), source contains no stitches\n");
+        return 0;
+    }
+
+    e = dstExport_begin(file);
+    if(!e) return 0;
+
+    /* A source always ends with an END stitch, so the records can be passed straight through */
+    dstExport_stitch(e, 0, &prev);
+    while(embStitchSource_next(source, &st))
+    {
+        dstExport_stitch(e, &prev, &st);
+        prev = st;
+    }
+
+    bounds = e->extents;
+    return dstExport_finish(e, embPattern_threadCount(source->meta), bounds);
+}
+
+static int dstSink_thread(void* data, const EmbThread* thread)
+{
+    (void)thread;
+    ((DstExport*)data)->threadCount++;
     return 1;
 }
 
+static int dstSink_stitches(void* data, const EmbStitch* stitches, int count)
+{
+    DstExport* e = (DstExport*)data;
+    int i;
+
+    for(i = 0; i < count; i++)
+    {
+        dstExport_stitch(e, e->started ? &(e->prev) : 0, &(stitches[i]));
+        e->prev = stitches[i];
+        e->started = 1;
+        e->maxColorIndex = max(e->maxColorIndex, stitches[i].color);
+    }
+    return !e->failed;
+}
+
+/*! Returns a sink that encodes the stitches it is given into DST records in \a file as they arrive, so a design
+ *  that is being generated never has to be held whole. The stitches must be the ones a pattern would store,
+ *  HOME stitch included. Only the extents, counts and the block of records not yet written are kept; the
+ *  header is filled in by closeDstSink(), so \a file must be seekable. On error the sink's data is 0. */
+EmbStitchSink writeDstSink(EmbFile* file)
+{
+    EmbStitchSink sink;
+
+    sink.data = 0;
+    sink.thread = dstSink_thread;
+    sink.stitches = dstSink_stitches;
+    if(!file) { embLog_error("format-dst.c writeDstSink(), file argument is null\n"); return sink; }
+    sink.data = dstExport_begin(file);
+    return sink;
+}
+
+/*! Finishes the DST data written through \a sink: ends it with an END record if the last stitch was not one,
+ *  then goes back and writes the header. The sink cannot be used afterwards, and its file is left open.
+ *  Returns \c true if successful, or \c false if no stitches were written or writing to the file failed. */
+int closeDstSink(EmbStitchSink* sink)
+{
+    DstExport* e = 0;
+    EmbStitch end;
+    int started, written;
+
+    if(!sink) { embLog_error("format-dst.c closeDstSink(), sink argument is null\n"); return 0; }
+    if(!sink->data) { embLog_error("format-dst.c closeDstSink(), sink is not open\n"); return 0; }
+
+    e = (DstExport*)sink->data;
+    sink->data = 0;
+    if(e->started && !(e->prev.flags & END))
+    {
+        end = e->prev;
+        end.flags = END;
+        dstExport_stitch(e, &(e->prev), &end);
+    }
+    started = e->started;
+    if(!started)
+        embLog_error("format-dst.c closeDstSink(), no stitches were written\n");
+    written = dstExport_finish(e, max(e->threadCount, e->maxColorIndex + 1), e->extents);
+    return started && written;
+}
+
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeDst(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writeDstStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
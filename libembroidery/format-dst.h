@@ -2,7 +2,9 @@
 #ifndef FORMAT_DST_H
 #define FORMAT_DST_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
+#include "emb-stream.h"
 
 #include "api-start.h"
 #ifdef __cplusplus
@@ -11,6 +13,11 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readDst(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeDst(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeDstStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
+extern EMB_PRIVATE EmbStitchSource* EMB_CALL readDstSource(EmbFile* file, const char* fileName, const EmbReadOptions* options);
+extern EMB_PRIVATE int EMB_CALL writeDstSource(EmbStitchSource* source, EmbFile* file);
+extern EMB_PRIVATE EmbStitchSink EMB_CALL writeDstSink(EmbFile* file);
+extern EMB_PRIVATE int EMB_CALL closeDstSink(EmbStitchSink* sink);
 
 #ifdef __cplusplus
 }
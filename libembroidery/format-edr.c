@@ -1,4 +1,5 @@
 #include "format-edr.h"
+#include "emb-reader-writer.h"
 #include "helpers-binary.h"
 #include "emb-file.h"
 #include "emb-logging.h"
@@ -25,9 +26,7 @@ int readEdr(EmbPattern* pattern, const char* fileName)
     numberOfColors = embFile_tell(file) / 4;
     embFile_seek(file, 0x00, SEEK_SET);
 
-    embThreadList_free(pattern->threadList);
-    pattern->threadList = 0;
-    pattern->lastThread = 0;
+    embPattern_clearThreads(pattern);
 
     for(i = 0; i < numberOfColors; i++)
     {
@@ -44,35 +43,32 @@ int readEdr(EmbPattern* pattern, const char* fileName)
     return 1;
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeEdr(EmbPattern* pattern, const char* fileName)
+int writeEdrStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
-    EmbThreadList* pointer = 0;
-    EmbFile* file = 0;
+    int t;
 
-    if(!pattern) { embLog_error("format-edr.c writeEdr(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-edr.c writeEdr(), fileName argument is null\n"); return 0; }
+    if(!pattern) { embLog_error("format-edr.c writeEdrStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-edr.c writeEdrStream(), file argument is null\n"); return 0; }
 
-    file = embFile_open(fileName, "wb");
-    if(!file)
-    {
-        embLog_error("format-edr.c writeEdr(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
-    pointer = pattern->threadList;
-    while(pointer)
+    for(t = 0; t < embThreadList_count(pattern->threadList); t++)
     {
         EmbColor c;
-        c = pointer->thread.color;
+        c = pattern->threadList->thread[t].color;
         binaryWriteByte(file, c.r);
         binaryWriteByte(file, c.g);
         binaryWriteByte(file, c.b);
         binaryWriteByte(file, 0);
-        pointer = pointer->next;
     }
-    embFile_close(file);
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeEdr(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writeEdrStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
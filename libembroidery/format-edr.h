@@ -2,6 +2,7 @@
 #ifndef FORMAT_EDR_H
 #define FORMAT_EDR_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readEdr(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeEdr(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeEdrStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
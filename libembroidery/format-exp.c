@@ -1,4 +1,5 @@
 #include "format-exp.h"
+#include "emb-reader-writer.h"
 #include "emb-file.h"
 #include "emb-logging.h"
 #include "emb-stitch.h"
@@ -47,14 +48,69 @@ static void expEncode(unsigned char* b, char dx, char dy, int flags)
     }
 }
 
+/* Reads the next record from (file), storing its offset in mm and its flags.
+ * Returns 0 once the end of the file is reached. */
+static int expReadRecord(EmbFile* file, double* dx, double* dy, int* flags)
+{
+    unsigned char b0 = 0, b1 = 0;
+    int f = NORMAL;
+
+    b0 = (unsigned char)embFile_getc(file);
+    if(embFile_eof(file))
+        return 0;
+    b1 = (unsigned char)embFile_getc(file);
+    if(embFile_eof(file))
+        return 0;
+    if(b0 == 0x80)
+    {
+        if(b1 & 1)
+        {
+            b0 = (unsigned char)embFile_getc(file);
+            if(embFile_eof(file))
+                return 0;
+            b1 = (unsigned char)embFile_getc(file);
+            if(embFile_eof(file))
+                return 0;
+            f = STOP;
+        }
+        else if((b1 == 2) || (b1 == 4) || b1 == 6)
+        {
+            f = TRIM;
+            if(b1 == 2) f = NORMAL;
+            b0 = (unsigned char)embFile_getc(file);
+            if(embFile_eof(file))
+                return 0;
+            b1 = (unsigned char)embFile_getc(file);
+            if(embFile_eof(file))
+                return 0;
+        }
+        else if(b1 == 0x80)
+        {
+            b0 = (unsigned char)embFile_getc(file);
+            if(embFile_eof(file))
+                return 0;
+            b1 = (unsigned char)embFile_getc(file);
+            if(embFile_eof(file))
+                return 0;
+            /* Seems to be b0=0x07 and b1=0x00
+             * Maybe used as extension functions */
+            b0 = 0;
+            b1 = 0;
+            f = TRIM;
+        }
+    }
+    *dx = expDecode(b0) / 10.0;
+    *dy = expDecode(b1) / 10.0;
+    *flags = f;
+    return 1;
+}
+
 /*! Reads a file with the given \a fileName and loads the data into \a pattern.
  *  Returns \c true if successful, otherwise returns \c false. */
 int readExp(EmbPattern* pattern, const char* fileName)
 {
     EmbFile* file = 0;
-    int i = 0;
-    unsigned char b0 = 0, b1 = 0;
-    char dx = 0, dy = 0;
+    double dx = 0.0, dy = 0.0;
     int flags = 0;
 
     if(!pattern) { embLog_error("format-exp.c readExp(), pattern argument is null\n"); return 0; }
@@ -68,125 +124,133 @@ int readExp(EmbPattern* pattern, const char* fileName)
     }
     embPattern_loadExternalColorFile(pattern, fileName);
 
-    for(i = 0; !embFile_eof(file); i++)
+    while(expReadRecord(file, &dx, &dy, &flags))
     {
-        flags = NORMAL;
-        b0 = (unsigned char)embFile_getc(file);
-        if(embFile_eof(file))
-            break;
-        b1 = (unsigned char)embFile_getc(file);
-        if(embFile_eof(file))
-            break;
-        if(b0 == 0x80)
-        {
-            if(b1 & 1)
-            {
-                b0 = (unsigned char)embFile_getc(file);
-                if(embFile_eof(file))
-                    break;
-                b1 = (unsigned char)embFile_getc(file);
-                if(embFile_eof(file))
-                    break;
-                flags = STOP;
-            }
-            else if((b1 == 2) || (b1 == 4) || b1 == 6)
-            {
-                flags = TRIM;
-                if(b1 == 2) flags = NORMAL;
-                b0 = (unsigned char)embFile_getc(file);
-                if(embFile_eof(file))
-                    break;
-                b1 = (unsigned char)embFile_getc(file);
-                if(embFile_eof(file))
-                    break;
-            }
-            else if(b1 == 0x80)
-            {
-                b0 = (unsigned char)embFile_getc(file);
-                if(embFile_eof(file))
-                    break;
-                b1 = (unsigned char)embFile_getc(file);
-                if(embFile_eof(file))
-                    break;
-                /* Seems to be b0=0x07 and b1=0x00
-                 * Maybe used as extension functions */
-                b0 = 0;
-                b1 = 0;
-                flags = TRIM;
-            }
-        }
-        dx = expDecode(b0);
-        dy = expDecode(b1);
-        embPattern_addStitchRel(pattern, dx / 10.0, dy / 10.0, flags, 1);
+        embPattern_addStitchRel(pattern, dx, dy, flags, 1);
     }
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     return 1;
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+static int expSource_decode(EmbStitchSource* source)
+{
+    double dx, dy;
+    int flags;
+
+    while(embStitchSource_room(source) >= 2)
+    {
+        if(!expReadRecord((EmbFile*)source->data, &dx, &dy, &flags))
+            return 0;
+        embStitchSource_addStitchRel(source, dx, dy, flags);
+    }
+    return 1;
+}
+
+/*! Returns a source that decodes the stitches of the EXP data in \a file as they are asked for, with the threads of
+ *  any external color file next to \a fileName, read with \a options (may be 0), in its meta pattern. \a file must
+ *  stay open until the source is freed with embStitchSource_free(). Returns 0 on error. */
+EmbStitchSource* readExpSource(EmbFile* file, const char* fileName, const EmbReadOptions* options)
+{
+    EmbStitchSource* source = 0;
+
+    if(!file) { embLog_error("format-exp.c readExpSource(), file argument is null\n"); return 0; }
+    source = embStitchSource_create(file, expSource_decode, 0);
+    if(source)
+        embPattern_setReadOptions(source->meta, options);
+    if(source && fileName)
+        embPattern_loadExternalColorFile(source->meta, fileName);
+    return source;
+}
+
+/* Writes the record that moves from (*xx, *yy), in 0.1 mm, to (st) and advances (*xx, *yy) to it. */
+static void expWriteStitch(EmbFile* file, const EmbStitch* st, double* xx, double* yy)
+{
+    double dx = st->xx * 10.0 - *xx;
+    double dy = st->yy * 10.0 - *yy;
+    unsigned char b[4] = {0, 0, 0, 0}; /* a NORMAL record only sets the first two */
+
+    *xx = st->xx * 10.0;
+    *yy = st->yy * 10.0;
+    expEncode(b, (char)roundDouble(dx), (char)roundDouble(dy), st->flags);
+    if((b[0] == 0x80) && ((b[1] == 1) || (b[1] == 2) || (b[1] == 4) || (b[1] == 0x10)))
+    {
+        embFile_printf(file, "%c%c%c%c", b[0], b[1], b[2], b[3]);
+    }
+    else
+    {
+        embFile_printf(file, "%c%c", b[0], b[1]);
+    }
+}
+
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeExp(EmbPattern* pattern, const char* fileName)
+int writeExpStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
 #ifdef ARDUINO /* ARDUINO TODO: This is temporary. Remove when complete. */
 return 0; /* ARDUINO TODO: This is temporary. Remove when complete. */
 #else /* ARDUINO TODO: This is temporary. Remove when complete. */
 
-    EmbFile* file = 0;
-    EmbStitchList* stitches = 0;
-    double dx = 0.0, dy = 0.0;
+    EmbStitch* stitches = 0;
+    EmbStitchIterator it;
     double xx = 0.0, yy = 0.0;
-    int flags = 0;
-    unsigned char b[4];
 
-    if(!pattern) { embLog_error("format-exp.c writeExp(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-exp.c writeExp(), fileName argument is null\n"); return 0; }
+    if(!pattern) { embLog_error("format-exp.c writeExpStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-exp.c writeExpStream(), file argument is null\n"); return 0; }
 
     if(!embStitchList_count(pattern->stitchList))
     {
-        embLog_error("format-exp.c writeExp(), pattern contains no stitches\n");
+        embLog_error("format-exp.c writeExpStream(), pattern contains no stitches\n");
         return 0;
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
-    file = embFile_open(fileName, "wb");
-    if(!file)
+    /* write stitches */
+    it = embStitchList_begin(pattern->stitchList);
+    while((stitches = embStitchIterator_next(&it)))
     {
-        embLog_error("format-exp.c writeExp(), cannot open %s for writing\n", fileName);
-        return 0;
+        expWriteStitch(file, stitches, &xx, &yy);
     }
+    embFile_printf(file, "\x1a");
+    return 1;
+#endif /* ARDUINO TODO: This is temporary. Remove when complete. */
+}
 
-    /* write stitches */
-    stitches = pattern->stitchList;
-    while(stitches)
+/*! Writes the stitches pulled from \a source to the stream \a file as they are decoded.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeExpSource(EmbStitchSource* source, EmbFile* file)
+{
+    EmbStitch st;
+    double xx = 0.0, yy = 0.0;
+
+    if(!source) { embLog_error("format-exp.c writeExpSource(), source argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-exp.c writeExpSource(), file argument is null\n"); return 0; }
+
+    if(!embStitchSource_peek(source, 0, 0))
     {
-        dx = stitches->stitch.xx * 10.0 - xx;
-        dy = stitches->stitch.yy * 10.0 - yy;
-        xx = stitches->stitch.xx * 10.0;
-        yy = stitches->stitch.yy * 10.0;
-        flags = stitches->stitch.flags;
-        expEncode(b, (char)roundDouble(dx), (char)roundDouble(dy), flags);
-        if((b[0] == 0x80) && ((b[1] == 1) || (b[1] == 2) || (b[1] == 4) || (b[1] == 0x10)))
-        {
-            embFile_printf(file, "%c%c%c%c", b[0], b[1], b[2], b[3]);
-        }
-        else
-        {
-            embFile_printf(file, "%c%c", b[0], b[1]);
-        }
-        stitches = stitches->next;
+        embLog_error("format-exp.c writeExpSource(), source contains no stitches\n");
+        return 0;
+    }
+    while(embStitchSource_next(source, &st))
+    {
+        expWriteStitch(file, &st, &xx, &yy);
     }
     embFile_printf(file, "\x1a");
-    embFile_close(file);
     return 1;
-#endif /* ARDUINO TODO: This is temporary. Remove when complete. */
+}
+
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeExp(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writeExpStream);
 }
 
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -2,7 +2,9 @@
 #ifndef FORMAT_EXP_H
 #define FORMAT_EXP_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
+#include "emb-stream.h"
 
 #include "api-start.h"
 #ifdef __cplusplus
@@ -11,6 +13,9 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readExp(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeExp(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeExpStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
+extern EMB_PRIVATE EmbStitchSource* EMB_CALL readExpSource(EmbFile* file, const char* fileName, const EmbReadOptions* options);
+extern EMB_PRIVATE int EMB_CALL writeExpSource(EmbStitchSource* source, EmbFile* file);
 
 #ifdef __cplusplus
 }
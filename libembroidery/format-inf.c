@@ -1,4 +1,5 @@
 #include "format-inf.h"
+#include "emb-reader-writer.h"
 #include "emb-file.h"
 #include "emb-logging.h"
 #include "helpers-binary.h"
@@ -28,9 +29,7 @@ int readInf(EmbPattern* pattern, const char* fileName)
     binaryReadUInt32BE(file);
     numberOfColors = binaryReadUInt32BE(file);
 
-    embThreadList_free(pattern->threadList);
-    pattern->threadList = 0;
-    pattern->lastThread = 0;
+    embPattern_clearThreads(pattern);
 
     for(i = 0; i < numberOfColors; i++)
     {
@@ -53,35 +52,26 @@ int readInf(EmbPattern* pattern, const char* fileName)
     return 1;
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeInf(EmbPattern* pattern, const char* fileName)
+int writeInfStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
-    EmbThreadList* pointer = 0;
+    int t;
     int i = 1, bytesRemaining;
-    EmbFile* file = 0;
 
-    if(!pattern) { embLog_error("format-inf.c writeInf(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-inf.c writeInf(), fileName argument is null\n"); return 0; }
+    if(!pattern) { embLog_error("format-inf.c writeInfStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-inf.c writeInfStream(), file argument is null\n"); return 0; }
 
-    file = embFile_open(fileName, "wb");
-    if(!file)
-    {
-        embLog_error("format-inf.c writeInf(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
     binaryWriteUIntBE(file, 0x01);
     binaryWriteUIntBE(file, 0x08);
     /* write place holder offset */
     binaryWriteUIntBE(file, 0x00);
-    binaryWriteUIntBE(file, embThreadList_count(pattern->threadList));
-
-    pointer = pattern->threadList;
-    while(pointer)
+    binaryWriteUIntBE(file, embPattern_threadCount(pattern));
+    for(t = 0; t < embThreadList_count(pattern->threadList); t++)
     {
         char buffer[50];
         EmbColor c;
-        c = pointer->thread.color;
+        c = pattern->threadList->thread[t].color;
         sprintf(buffer, "RGB(%d,%d,%d)", (int)c.r, (int)c.g, (int)c.b);
         binaryWriteUShortBE(file, (unsigned short)(14 + strlen(buffer))); /* record length */
         binaryWriteUShortBE(file, (unsigned short)i); /* record number */
@@ -92,15 +82,20 @@ int writeInf(EmbPattern* pattern, const char* fileName)
         binaryWriteBytes(file, "RGB\0", 4);
         embFile_printf(file, buffer);
         binaryWriteByte(file, 0);
-        pointer = pointer->next;
         i++;
     }
     embFile_seek(file, -8, SEEK_END);
     bytesRemaining = embFile_tell(file);
     embFile_seek(file, 8, SEEK_SET);
     binaryWriteUIntBE(file, bytesRemaining);
-    embFile_close(file);
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeInf(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writeInfStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -2,6 +2,7 @@
 #ifndef FORMAT_INF_H
 #define FORMAT_INF_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readInf(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeInf(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeInfStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
@@ -1,4 +1,5 @@
 #include "format-jef.h"
+#include "emb-reader-writer.h"
 #include "emb-file.h"
 #include "emb-logging.h"
 #include "emb-time.h"
@@ -190,7 +191,7 @@ int readJef(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if (pattern->lastStitch->stitch.flags != END)
+    if (embStitchList_last(pattern->stitchList)->flags != END)
     {
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
     }
@@ -239,45 +240,38 @@ static void jefEncode(unsigned char* b, char dx, char dy, int flags)
     }
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeJef(EmbPattern* pattern, const char* fileName)
+int writeJefStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
     int colorlistSize, designWidth, designHeight, i, jumpAndStopCount;
     EmbRect boundingRect;
-    EmbFile* file = 0;
     EmbTime time;
-    EmbThreadList* threadPointer = 0;
-    EmbStitchList* stitches = 0;
+    int t;
+    EmbStitch* stitches = 0;
+    EmbStitchIterator it;
     double dx = 0.0, dy = 0.0;
     double xx = 0.0, yy = 0.0;
     int flags = 0;
     unsigned char b[4];
 
-    if(!pattern) { embLog_error("format-jef.c writeJef(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-jef.c writeJef(), fileName argument is null\n"); return 0; }
+    if(!pattern) { embLog_error("format-jef.c writeJefStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-jef.c writeJefStream(), file argument is null\n"); return 0; }
 
     if(!embStitchList_count(pattern->stitchList))
     {
-        embLog_error("format-jef.c writeJef(), pattern contains no stitches\n");
+        embLog_error("format-jef.c writeJefStream(), pattern contains no stitches\n");
         return 0;
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if (pattern->lastStitch->stitch.flags != END)
+    if (embStitchList_last(pattern->stitchList)->flags != END)
     {
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
     }
-    file = embFile_open(fileName, "wb");
-    if(!file)
-    {
-        embLog_error("format-jef.c writeJef(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
-
     embPattern_correctForMaxStitchLength(pattern, 12.7, 12.7);
 
-    colorlistSize = embThreadList_count(pattern->threadList);
+    colorlistSize = embPattern_threadCount(pattern);
     binaryWriteInt(file, 0x74 + (colorlistSize * 8));
     binaryWriteInt(file, 0x14);
 
@@ -288,18 +282,9 @@ int writeJef(EmbPattern* pattern, const char* fileName)
             (int)(time.minute), (int)(time.second));
     binaryWriteByte(file, 0x00);
     binaryWriteByte(file, 0x00);
-    binaryWriteInt(file, embThreadList_count(pattern->threadList));
+    binaryWriteInt(file, embPattern_threadCount(pattern));
 
-	stitches = pattern->stitchList;
-	jumpAndStopCount = 0;
-	while (stitches)
-	{
-		flags = stitches->stitch.flags;
-		if ((flags & (STOP | TRIM | JUMP)) > 0) {
-			jumpAndStopCount++;
-		}
-		stitches = stitches->next;
-	}
+    jumpAndStopCount = embPattern_stats(pattern)->controlCount;
 	binaryWriteInt(file, embStitchList_count(pattern->stitchList) + jumpAndStopCount);
 
     boundingRect = embPattern_calcBoundingBox(pattern);
@@ -360,25 +345,22 @@ int writeJef(EmbPattern* pattern, const char* fileName)
 	binaryWriteInt(file, (int)max(-1, ((1400 - designWidth) / 2)));  /* right */
     binaryWriteInt(file, (int)max(-1, ((2000 - designHeight) / 2))); /* bottom */
 
-    threadPointer = pattern->threadList;
-
-    while(threadPointer)
+    for(t = 0; t < embThreadList_count(pattern->threadList); t++)
     {
-        binaryWriteInt(file, embThread_findNearestColorInArray(threadPointer->thread.color, (EmbThread*)jefThreads, 79));
-        threadPointer = threadPointer->next;
+        binaryWriteInt(file, embThreadList_paletteIndex(pattern->threadList, t, jefThreads, 79));
     }
     for(i = 0; i < colorlistSize; i++)
     {
         binaryWriteInt(file, 0x0D);
     }
-    stitches = pattern->stitchList;
-    while(stitches)
+    it = embStitchList_begin(pattern->stitchList);
+    while((stitches = embStitchIterator_next(&it)))
     {
-        dx = stitches->stitch.xx * 10.0 - xx;
-        dy = stitches->stitch.yy * 10.0 - yy;
-        xx = stitches->stitch.xx * 10.0;
-        yy = stitches->stitch.yy * 10.0;
-        flags = stitches->stitch.flags;
+        dx = stitches->xx * 10.0 - xx;
+        dy = stitches->yy * 10.0 - yy;
+        xx = stitches->xx * 10.0;
+        yy = stitches->yy * 10.0;
+        flags = stitches->flags;
         jefEncode(b, (char)roundDouble(dx), (char)roundDouble(dy), flags);
         if((b[0] == 0x80) && ((b[1] == 1) || (b[1] == 2) || (b[1] == 4)))
         {
@@ -391,10 +373,15 @@ int writeJef(EmbPattern* pattern, const char* fileName)
 		if (flags & END) {
 			break;
 		}
-        stitches = stitches->next;
     }
-    embFile_close(file);
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeJef(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writeJefStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
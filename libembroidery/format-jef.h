@@ -2,6 +2,7 @@
 #ifndef FORMAT_JEF_H
 #define FORMAT_JEF_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readJef(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeJef(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeJefStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 static const EmbThread jefThreads[] = {
     {{0, 0 ,0}, "Black", ""},
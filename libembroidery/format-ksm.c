@@ -1,4 +1,5 @@
 #include "format-ksm.h"
+#include "emb-reader-writer.h"
 #include "emb-file.h"
 #include "emb-logging.h"
 #include "helpers-binary.h"
@@ -74,63 +75,62 @@ int readKsm(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     return 1;
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeKsm(EmbPattern* pattern, const char* fileName)
+int writeKsmStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
-    EmbFile* file = 0;
-    EmbStitchList* pointer = 0;
+    EmbStitch* pointer = 0;
+    EmbStitchIterator it;
     double xx = 0, yy = 0, dx = 0, dy = 0;
     int flags = 0;
     int i = 0;
     unsigned char b[4];
 
-    if(!pattern) { embLog_error("format-ksm.c writeKsm(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-ksm.c writeKsm(), fileName argument is null\n"); return 0; }
+    if(!pattern) { embLog_error("format-ksm.c writeKsmStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-ksm.c writeKsmStream(), file argument is null\n"); return 0; }
 
     if(!embStitchList_count(pattern->stitchList))
     {
-        embLog_error("format-ksm.c writeKsm(), pattern contains no stitches\n");
+        embLog_error("format-ksm.c writeKsmStream(), pattern contains no stitches\n");
         return 0;
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
-    file = embFile_open(fileName, "wb");
-    if(!file)
-    {
-        embLog_error("format-ksm.c writeKsm(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
     for(i = 0; i < 0x80; i++)
     {
         binaryWriteInt(file, 0);
     }
     /* write stitches */
     xx = yy = 0;
-    pointer = pattern->stitchList;
-    while(pointer)
+    it = embStitchList_begin(pattern->stitchList);
+    while((pointer = embStitchIterator_next(&it)))
     {
-        dx = pointer->stitch.xx - xx;
-        dy = pointer->stitch.yy - yy;
-        xx = pointer->stitch.xx;
-        yy = pointer->stitch.yy;
-        flags = pointer->stitch.flags;
+        dx = pointer->xx - xx;
+        dy = pointer->yy - yy;
+        xx = pointer->xx;
+        yy = pointer->yy;
+        flags = pointer->flags;
         ksmEncode(b, (char)(dx * 10.0), (char)(dy * 10.0), flags);
         embFile_printf(file, "%c%c", b[0], b[1]);
-        pointer = pointer->next;
     }
     embFile_printf(file, "\x1a");
-    embFile_close(file);
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeKsm(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writeKsmStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
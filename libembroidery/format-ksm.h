@@ -2,6 +2,7 @@
 #ifndef FORMAT_KSM_H
 #define FORMAT_KSM_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readKsm(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeKsm(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeKsmStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
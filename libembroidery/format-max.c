@@ -1,4 +1,5 @@
 #include "format-max.h"
+#include "emb-reader-writer.h"
 #include "format-pcd.h"
 #include "emb-file.h"
 #include "emb-logging.h"
@@ -70,7 +71,7 @@ int readMax(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     embPattern_flipVertical(pattern);
@@ -78,12 +79,12 @@ int readMax(EmbPattern* pattern, const char* fileName)
     return 1;
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeMax(EmbPattern* pattern, const char* fileName)
+int writeMaxStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
-    EmbFile* file = 0;
-    EmbStitchList* pointer = 0;
+    EmbStitch* pointer = 0;
+    EmbStitchIterator it;
     char header[] = {
         0x56,0x43,0x53,0x4D,0xFC,0x03,0x00,0x00,0x01,0x00,0x00,0x00,0x01,0x00,0x00,0x00,
         0xF6,0x25,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
@@ -100,35 +101,33 @@ int writeMax(EmbPattern* pattern, const char* fileName)
         0x01,0x38,0x09,0x31,0x33,0x30,0x2F,0x37,0x30,0x35,0x20,0x48,0xFA,0x00,0x00,0x00,
         0x00,0x00,0x00,0x00,0x00 };
 
-    if(!pattern) { embLog_error("format-max.c writeMax(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-max.c writeMax(), fileName argument is null\n"); return 0; }
+    if(!pattern) { embLog_error("format-max.c writeMaxStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-max.c writeMaxStream(), file argument is null\n"); return 0; }
 
     if(!embStitchList_count(pattern->stitchList))
     {
-        embLog_error("format-max.c writeMax(), pattern contains no stitches\n");
+        embLog_error("format-max.c writeMaxStream(), pattern contains no stitches\n");
         return 0;
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
-    file = embFile_open(fileName, "wb");
-    if(!file)
-    {
-        embLog_error("format-max.c writeMax(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
-
     binaryWriteBytes(file, header, 0xD5);
-    pointer = pattern->stitchList;
-    while(pointer)
+    it = embStitchList_begin(pattern->stitchList);
+    while((pointer = embStitchIterator_next(&it)))
     {
-        maxEncode(file, roundDouble(pointer->stitch.xx * 10.0), roundDouble(pointer->stitch.yy * 10.0));
-        pointer = pointer->next;
+        maxEncode(file, roundDouble(pointer->xx * 10.0), roundDouble(pointer->yy * 10.0));
     }
-    embFile_close(file);
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeMax(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writeMaxStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -2,6 +2,7 @@
 #ifndef FORMAT_MAX_H
 #define FORMAT_MAX_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readMax(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeMax(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeMaxStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
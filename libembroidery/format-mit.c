@@ -1,4 +1,5 @@
 #include "format-mit.h"
+#include "emb-reader-writer.h"
 #include "emb-file.h"
 #include "emb-logging.h"
 #include "helpers-binary.h"
@@ -39,7 +40,7 @@ int readMit(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     return 1;
@@ -54,51 +55,50 @@ static unsigned char mitEncodeStitch(double value)
 	return (unsigned char)value;
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeMit(EmbPattern* pattern, const char* fileName)
+int writeMitStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
-	EmbFile* file = 0;
-	EmbStitchList* pointer = 0;
+	EmbStitch* pointer = 0;
+	EmbStitchIterator it;
 	double xx = 0, yy = 0, dx = 0, dy = 0;
 	int flags = 0;
 
-    if(!pattern) { embLog_error("format-mit.c writeMit(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-mit.c writeMit(), fileName argument is null\n"); return 0; }
+    if(!pattern) { embLog_error("format-mit.c writeMitStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-mit.c writeMitStream(), file argument is null\n"); return 0; }
 
     if(!embStitchList_count(pattern->stitchList))
     {
-        embLog_error("format-mit.c writeMit(), pattern contains no stitches\n");
+        embLog_error("format-mit.c writeMitStream(), pattern contains no stitches\n");
         return 0;
     }
 
     /* Check for an END stitch and add one if it is not present */
-	if (pattern->lastStitch->stitch.flags != END)
+	if (embStitchList_last(pattern->stitchList)->flags != END)
 	{
 		embPattern_addStitchRel(pattern, 0, 0, END, 1);
 	}
-	file = embFile_open(fileName, "wb");
-	if (!file)
-	{
-		embLog_error("format-mit.c writeMit(), cannot open %s for writing\n", fileName);
-		return 0;
-	}
 	embPattern_correctForMaxStitchLength(pattern, 0x1F, 0x1F);
 	xx = yy = 0;
-	pointer = pattern->stitchList;
-	while (pointer)
+	it = embStitchList_begin(pattern->stitchList);
+	while((pointer = embStitchIterator_next(&it)))
 	{
-		dx = pointer->stitch.xx - xx;
-		dy = pointer->stitch.yy - yy;
-		xx = pointer->stitch.xx;
-		yy = pointer->stitch.yy;
-		flags = pointer->stitch.flags;
+		dx = pointer->xx - xx;
+		dy = pointer->yy - yy;
+		xx = pointer->xx;
+		yy = pointer->yy;
+		flags = pointer->flags;
 		embFile_putc(mitEncodeStitch(dx), file);
 		embFile_putc(mitEncodeStitch(dy), file);
-		pointer = pointer->next;
 	}
-	embFile_close(file);
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeMit(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writeMitStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -2,6 +2,7 @@
 #ifndef FORMAT_MIT_H
 #define FORMAT_MIT_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readMit(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeMit(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeMitStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
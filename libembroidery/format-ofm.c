@@ -3,6 +3,7 @@
 #include "emb-file.h"
 #include "emb-logging.h"
 #include "helpers-binary.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -112,7 +113,7 @@ static void ofmReadThreads(EmbFile* file, EmbPattern* p)
     for(i = 0; i < numberOfColors; i++)
     {
         EmbThread thread;
-        char colorNumberText[10];
+        char colorNumberText[12];
         int threadLibrary = 0, colorNameLength, colorNumber;
         char* colorName = 0;
         int r = binaryReadByte(file);
@@ -125,15 +126,15 @@ static void ofmReadThreads(EmbFile* file, EmbPattern* p)
         binaryReadByte(file);
         binaryReadInt16(file);
         colorNameLength = binaryReadByte(file);
-        colorName = (char*)malloc(colorNameLength * 2);
+        colorName = (char*)embArena_alloc(&p->arena, colorNameLength * 2);
         if(!colorName) { embLog_error("format-ofm.c ofmReadThreads(), unable to allocate memory for colorName\n"); return; }
         binaryReadBytes(file, (unsigned char*)colorName, colorNameLength*2); /* TODO: check return value */
         binaryReadInt16(file);
-     /* itoa(colorNumber, colorNumberText, 10); TODO: never use itoa, it's non-standard, use sprintf: http://stackoverflow.com/questions/5242524/converting-int-to-string-in-c */
+        sprintf(colorNumberText, "%d", colorNumber);
         thread.color.r = (unsigned char)r;
         thread.color.g = (unsigned char)g;
         thread.color.b = (unsigned char)b;
-        thread.catalogNumber = colorNumberText;
+        thread.catalogNumber = embArena_strdup(&p->arena, colorNumberText);
         thread.description = colorName;
         embPattern_addThread(p, thread);
     }
@@ -244,7 +245,7 @@ int readOfm(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(!pattern ->lastStitch || pattern->lastStitch->stitch.flags != END)
+    if(embStitchList_empty(pattern->stitchList) || embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     embPattern_flip(pattern, 1, 1);
@@ -266,7 +267,7 @@ int writeOfm(EmbPattern* pattern, const char* fileName)
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     /* TODO: embFile_open() needs to occur here after the check for no stitches */
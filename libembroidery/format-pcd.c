@@ -1,4 +1,5 @@
 #include "format-pcd.h"
+#include "emb-reader-writer.h"
 #include "emb-file.h"
 #include "emb-logging.h"
 #include "helpers-binary.h"
@@ -112,57 +113,48 @@ int readPcd(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     return 1;
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writePcd(EmbPattern* pattern, const char* fileName)
+int writePcdStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
-    EmbStitchList* pointer = 0;
-    EmbThreadList* threadPointer = 0;
-    EmbFile* file = 0;
+    EmbStitch* pointer = 0;
+    EmbStitchIterator it;
+    int t;
     int i;
     unsigned char colorCount;
     double xx = 0.0, yy = 0.0;
 
-    if(!pattern) { embLog_error("format-pcd.c writePcd(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-pcd.c writePcd(), fileName argument is null\n"); return 0; }
+    if(!pattern) { embLog_error("format-pcd.c writePcdStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-pcd.c writePcdStream(), file argument is null\n"); return 0; }
 
     if(!embStitchList_count(pattern->stitchList))
     {
-        embLog_error("format-pcd.c writePcd(), pattern contains no stitches\n");
+        embLog_error("format-pcd.c writePcdStream(), pattern contains no stitches\n");
         return 0;
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
-    file = embFile_open(fileName, "wb");
-    if(!file)
-    {
-        embLog_error("format-pcd.c writePcd(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
-
     binaryWriteByte(file, (unsigned char)'2');
     binaryWriteByte(file, 3); /* TODO: select hoop size defaulting to Large PCS hoop */
-    colorCount = (unsigned char)embThreadList_count(pattern->threadList);
+    colorCount = (unsigned char)embPattern_threadCount(pattern);
     binaryWriteUShort(file, (unsigned short)colorCount);
-    threadPointer = pattern->threadList;
     i = 0;
-    while(threadPointer)
+    for(t = 0; t < embThreadList_count(pattern->threadList); t++)
     {
-        EmbColor color = threadPointer->thread.color;
+        EmbColor color = pattern->threadList->thread[t].color;
         binaryWriteByte(file, color.r);
         binaryWriteByte(file, color.g);
         binaryWriteByte(file, color.b);
         binaryWriteByte(file, 0);
-        threadPointer = threadPointer->next;
         i++;
     }
 
@@ -174,14 +166,19 @@ int writePcd(EmbPattern* pattern, const char* fileName)
     binaryWriteUShort(file, (unsigned short)embStitchList_count(pattern->stitchList));
     /* write stitches */
     xx = yy = 0;
-    pointer = pattern->stitchList;
-    while(pointer)
+    it = embStitchList_begin(pattern->stitchList);
+    while((pointer = embStitchIterator_next(&it)))
     {
-        pcdEncode(file, roundDouble(pointer->stitch.xx * 10.0), roundDouble(pointer->stitch.yy * 10.0), pointer->stitch.flags);
-        pointer = pointer->next;
+        pcdEncode(file, roundDouble(pointer->xx * 10.0), roundDouble(pointer->yy * 10.0), pointer->flags);
     }
-    embFile_close(file);
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writePcd(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writePcdStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -2,6 +2,7 @@
 #ifndef FORMAT_PCD_H
 #define FORMAT_PCD_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readPcd(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writePcd(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writePcdStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
@@ -2,6 +2,7 @@
 #ifndef FORMAT_PCQ_H
 #define FORMAT_PCQ_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readPcq(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writePcq(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writePcqStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
@@ -2,6 +2,7 @@
 #ifndef FORMAT_PCS_H
 #define FORMAT_PCS_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readPcs(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writePcs(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writePcsStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
@@ -1,4 +1,5 @@
 #include "format-pec.h"
+#include "emb-reader-writer.h"
 #include "emb-file.h"
 #include "emb-logging.h"
 #include "helpers-binary.h"
@@ -158,7 +159,7 @@ int readPec(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     embPattern_flipVertical(pattern);
@@ -166,21 +167,21 @@ int readPec(EmbPattern* pattern, const char* fileName)
     return 1;
 }
 
-static void pecEncode(EmbFile* file, EmbPattern* p)
+static void pecEncode(EmbFile* file, const EmbPatternView* view)
 {
     double thisX = 0.0;
     double thisY = 0.0;
     unsigned char stopCode = 2;
-    EmbStitchList* list = 0;
+    int i, stitchCount;
 
     if(!file) { embLog_error("format-pec.c pecEncode(), file argument is null\n"); return; }
-    if(!p) { embLog_error("format-pec.c pecEncode(), p argument is null\n"); return; }
+    if(!view) { embLog_error("format-pec.c pecEncode(), view argument is null\n"); return; }
 
-    list = p->stitchList;
-    while(list)
+    stitchCount = embPatternView_stitchCount(view);
+    for(i = 0; i < stitchCount; i++)
     {
         int deltaX, deltaY;
-        EmbStitch s = list->stitch;
+        EmbStitch s = embPatternView_stitch(view, i);
 
         deltaX = roundDouble(s.xx - thisX);
         deltaY = roundDouble(s.yy - thisY);
@@ -214,7 +215,6 @@ static void pecEncode(EmbFile* file, EmbPattern* p)
             pecEncodeJump(file, deltaX, s.flags);
             pecEncodeJump(file, deltaY, s.flags);
         }
-        list = list->next;
     }
 }
 
@@ -248,21 +248,23 @@ static void writeImage(EmbFile* file, unsigned char image[][48])
     }
 }
 
-void writePecStitches(EmbPattern* pattern, EmbFile* file, const char* fileName)
+/*! Writes the PEC section for the pattern seen through (\a view), which must already be in PEC units and axes. */
+void writePecStitches(const EmbPatternView* view, EmbFile* file, const char* fileName)
 {
-    EmbStitchList* tempStitches = 0;
+    EmbPattern* pattern = 0;
     EmbRect bounds;
     unsigned char image[38][48];
-    int i, flen, currentThreadCount, graphicsOffsetLocation, graphicsOffsetValue, height, width;
+    int i, j, stitchCount, flen, currentThreadCount, graphicsOffsetLocation, graphicsOffsetValue, height, width;
     double xFactor, yFactor;
     const char* forwardSlashPos = strrchr(fileName, '/');
     const char* backSlashPos = strrchr(fileName, '\\');
     const char* dotPos = strrchr(fileName, '.');
     const char* start = 0;
 
-    if(!pattern) { embLog_error("format-pec.c writePecStitches(), pattern argument is null\n"); return; }
+    if(!view) { embLog_error("format-pec.c writePecStitches(), view argument is null\n"); return; }
     if(!file) { embLog_error("format-pec.c writePecStitches(), file argument is null\n"); return; }
     if(!fileName) { embLog_error("format-pec.c writePecStitches(), fileName argument is null\n"); return; }
+    pattern = view->pattern;
 
     if(forwardSlashPos)
     {
@@ -305,12 +307,12 @@ void writePecStitches(EmbPattern* pattern, EmbFile* file, const char* fileName)
     {
         binaryWriteByte(file, (unsigned char)0x20);
     }
-    currentThreadCount = embThreadList_count(pattern->threadList);
+    currentThreadCount = embPattern_threadCount(pattern);
     binaryWriteByte(file, (unsigned char)(currentThreadCount-1));
 
     for(i = 0; i < currentThreadCount; i++)
     {
-        binaryWriteByte(file, (unsigned char)embThread_findNearestColorInArray(embThreadList_getAt(pattern->threadList, i).color, (EmbThread*)pecThreads, pecThreadCount));
+        binaryWriteByte(file, (unsigned char)embThreadList_paletteIndex(pattern->threadList, i, pecThreads, pecThreadCount));
     }
     for(i = 0; i < (int)(0x1CF - currentThreadCount); i++)
     {
@@ -328,7 +330,7 @@ void writePecStitches(EmbPattern* pattern, EmbFile* file, const char* fileName)
     binaryWriteByte(file, (unsigned char)0xFF);
     binaryWriteByte(file, (unsigned char)0xF0);
 
-    bounds = embPattern_calcBoundingBox(pattern);
+    bounds = embPatternView_boundingBox(view);
 
     height = roundDouble(embRect_height(bounds));
     width = roundDouble(embRect_width(bounds));
@@ -344,7 +346,7 @@ void writePecStitches(EmbPattern* pattern, EmbFile* file, const char* fileName)
     binaryWriteUShortBE(file, (unsigned short)(0x9000 | -roundDouble(bounds.left)));
     binaryWriteUShortBE(file, (unsigned short)(0x9000 | -roundDouble(bounds.top)));
 
-    pecEncode(file, pattern);
+    pecEncode(file, view);
     graphicsOffsetValue = embFile_tell(file) - graphicsOffsetLocation + 2;
     embFile_seek(file, graphicsOffsetLocation, SEEK_SET);
 
@@ -356,74 +358,75 @@ void writePecStitches(EmbPattern* pattern, EmbFile* file, const char* fileName)
 
     /* Writing all colors */
     clearImage(image);
-    tempStitches = pattern->stitchList;
+    stitchCount = embPatternView_stitchCount(view);
 
     yFactor = 32.0 / height;
     xFactor = 42.0 / width;
-    while(tempStitches->next)
+    /* the final (END) stitch is not drawn */
+    for(j = 0; j < stitchCount - 1; j++)
     {
-        int x = roundDouble((tempStitches->stitch.xx - bounds.left) * xFactor) + 3;
-        int y = roundDouble((tempStitches->stitch.yy - bounds.top) * yFactor) + 3;
+        EmbStitch s = embPatternView_stitch(view, j);
+        int x = roundDouble((s.xx - bounds.left) * xFactor) + 3;
+        int y = roundDouble((s.yy - bounds.top) * yFactor) + 3;
         image[y][x] = 1;
-        tempStitches = tempStitches->next;
     }
     writeImage(file, image);
 
     /* Writing each individual color */
-    tempStitches = pattern->stitchList;
+    j = 0;
     for(i = 0; i < currentThreadCount; i++)
     {
         clearImage(image);
-        while(tempStitches->next)
+        for(; j < stitchCount - 1; j++)
         {
-            int x = roundDouble((tempStitches->stitch.xx - bounds.left) * xFactor) + 3;
-            int y = roundDouble((tempStitches->stitch.yy - bounds.top) * yFactor) + 3;
-            if(tempStitches->stitch.flags & STOP)
+            EmbStitch s = embPatternView_stitch(view, j);
+            int x = roundDouble((s.xx - bounds.left) * xFactor) + 3;
+            int y = roundDouble((s.yy - bounds.top) * yFactor) + 3;
+            if(s.flags & STOP)
             {
-                tempStitches = tempStitches->next;
+                j++;
                 break;
             }
             image[y][x] = 1;
-            tempStitches = tempStitches->next;
         }
         writeImage(file, image);
     }
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file, labelling the design with the base name of \a fileName.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writePec(EmbPattern* pattern, const char* fileName)
+int writePecStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
-    EmbFile* file = 0;
+    EmbPatternView view;
 
+    if(!pattern) { embLog_error("format-pec.c writePecStream(), pattern argument is null\n"); return 0; }
     if(!embStitchList_count(pattern->stitchList))
     {
-        embLog_error("format-pec.c writePec(), pattern contains no stitches\n");
+        embLog_error("format-pec.c writePecStream(), pattern contains no stitches\n");
         return 0;
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
-    file = embFile_open(fileName, "wb");
-    if(!file)
-    {
-        embLog_error("format-pec.c writePec(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
-
-    embPattern_flipVertical(pattern); /* TODO: There needs to be a matching flipVertical() call after the write to ensure multiple writes from the same pattern work properly */
     embPattern_fixColorCount(pattern);
     embPattern_correctForMaxStitchLength(pattern,12.7, 204.7);
-    embPattern_scale(pattern, 10.0);
+    /* PEC is in 0.1 mm with y down; the design itself is left in mm with y up */
+    view = embPattern_view(pattern, embTransform_scale(10.0, -10.0));
 
     binaryWriteBytes(file, "#PEC0001", 8);
 
-    writePecStitches(pattern, file, fileName);
+    writePecStitches(&view, file, fileName);
 
-    embFile_close(file);
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writePec(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writePecStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -12,8 +12,9 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readPec(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writePec(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writePecStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 extern EMB_PRIVATE void EMB_CALL readPecStitches(EmbPattern* pattern, EmbFile* file);
-extern EMB_PRIVATE void EMB_CALL writePecStitches(EmbPattern* pattern, EmbFile* file, const char* filename);
+extern EMB_PRIVATE void EMB_CALL writePecStitches(const EmbPatternView* view, EmbFile* file, const char* filename);
 
 static const int pecThreadCount = 65;
 static const EmbThread pecThreads[] = {
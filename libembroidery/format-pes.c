@@ -1,4 +1,5 @@
 #include "format-pes.h"
+#include "emb-reader-writer.h"
 #include "format-pec.h"
 #include "emb-file.h"
 #include "emb-logging.h"
@@ -38,7 +39,7 @@ int readPes(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     embPattern_flipVertical(pattern);
@@ -46,11 +47,14 @@ int readPes(EmbPattern* pattern, const char* fileName)
     return 1;
 }
 
-static void pesWriteSewSegSection(EmbPattern* pattern, EmbFile* file)
+static void pesWriteSewSegSection(const EmbPatternView* view, EmbFile* file)
 {
     /* TODO: pointer safety */
-    EmbStitchList* pointer = 0;
-    EmbStitchList* mainPointer = 0;
+    EmbPattern* pattern = view->pattern;
+    EmbStitch* stitches = pattern->stitchList->stitch;
+    int stitchCount = embStitchList_count(pattern->stitchList);
+    int pointer = 0;
+    int mainPointer = 0;
     short* colorInfo = 0;
     int flag = 0;
     int count = 0;
@@ -61,25 +65,23 @@ static void pesWriteSewSegSection(EmbPattern* pattern, EmbFile* file)
     int newColorCode = 0;
     int colorInfoIndex = 0;
     int i;
-    EmbRect bounds = embPattern_calcBoundingBox(pattern);
-    EmbColor color;
+    EmbRect bounds = embPatternView_boundingBox(view);
 
-    mainPointer = pattern->stitchList;
-    while(mainPointer)
+    mainPointer = 0;
+    while(mainPointer < stitchCount)
     {
         pointer = mainPointer;
-        flag = pointer->stitch.flags;
-        color = embThreadList_getAt(pattern->threadList, pointer->stitch.color).color;
-        newColorCode = embThread_findNearestColorInArray(color, (EmbThread*)pecThreads, pecThreadCount);
+        flag = stitches[pointer].flags;
+        newColorCode = embThreadList_paletteIndex(pattern->threadList, stitches[pointer].color, pecThreads, pecThreadCount);
         if(newColorCode != colorCode)
         {
             colorCount++;
             colorCode = newColorCode;
         }
-        while(pointer && (flag == pointer->stitch.flags))
+        while(pointer < stitchCount && (flag == stitches[pointer].flags))
         {
             count++;
-            pointer = pointer->next;
+            pointer++;
         }
         blockCount++;
         mainPointer = pointer;
@@ -93,15 +95,14 @@ static void pesWriteSewSegSection(EmbPattern* pattern, EmbFile* file)
     binaryWriteBytes(file, "CSewSeg", 7);
 
     colorInfo = (short *) calloc(colorCount * 2, sizeof(short));
-    mainPointer = pattern->stitchList;
+    mainPointer = 0;
     colorCode = -1;
     blockCount = 0;
-    while(mainPointer)
+    while(mainPointer < stitchCount)
     {
         pointer = mainPointer;
-        flag = pointer->stitch.flags;
-        color = embThreadList_getAt(pattern->threadList, pointer->stitch.color).color;
-        newColorCode = embThread_findNearestColorInArray(color, (EmbThread*)pecThreads, pecThreadCount);
+        flag = stitches[pointer].flags;
+        newColorCode = embThreadList_paletteIndex(pattern->threadList, stitches[pointer].color, pecThreads, pecThreadCount);
         if(newColorCode != colorCode)
         {
             colorInfo[colorInfoIndex++] = (short)blockCount;
@@ -109,10 +110,10 @@ static void pesWriteSewSegSection(EmbPattern* pattern, EmbFile* file)
             colorCode = newColorCode;
         }
         count = 0;
-        while(pointer && (flag == pointer->stitch.flags))
+        while(pointer < stitchCount && (flag == stitches[pointer].flags))
         {
             count++;
-            pointer = pointer->next;
+            pointer++;
         }
         if(flag & JUMP)
         {
@@ -127,14 +128,14 @@ static void pesWriteSewSegSection(EmbPattern* pattern, EmbFile* file)
         binaryWriteShort(file, (short)colorCode); /* color code */
         binaryWriteShort(file, (short)count); /* stitches in block */
         pointer = mainPointer;
-        while(pointer && (flag == pointer->stitch.flags))
+        while(pointer < stitchCount && (flag == stitches[pointer].flags))
         {
-            EmbStitch s = pointer->stitch;
+            EmbStitch s = embPatternView_stitch(view, pointer);
             binaryWriteShort(file, (short)(s.xx - bounds.left));
             binaryWriteShort(file, (short)(s.yy + bounds.top));
-            pointer = pointer->next;
+            pointer++;
         }
-        if(pointer)
+        if(pointer < stitchCount)
         {
             binaryWriteShort(file, 0x8003);
         }
@@ -155,7 +156,7 @@ static void pesWriteSewSegSection(EmbPattern* pattern, EmbFile* file)
     }
 }
 
-static void pesWriteEmbOneSection(EmbPattern* pattern, EmbFile* file)
+static void pesWriteEmbOneSection(const EmbPatternView* view, EmbFile* file)
 {
     /* TODO: pointer safety */
     int i;
@@ -163,7 +164,7 @@ static void pesWriteEmbOneSection(EmbPattern* pattern, EmbFile* file)
     EmbRect bounds;
     binaryWriteShort(file, 0x07); /* string length */
     binaryWriteBytes(file, "CEmbOne", 7);
-    bounds = embPattern_calcBoundingBox(pattern);
+    bounds = embPatternView_boundingBox(view);
 
     binaryWriteShort(file, 0);
     binaryWriteShort(file, 0);
@@ -197,35 +198,29 @@ static void pesWriteEmbOneSection(EmbPattern* pattern, EmbFile* file)
     /*WriteSubObjects(br, pes, SubBlocks); */
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file, labelling the design with the base name of \a fileName.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writePes(EmbPattern* pattern, const char* fileName)
+int writePesStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
     int pecLocation;
-    EmbFile* file = 0;
-
-    if(!pattern) { embLog_error("format-pes.c writePes(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-pes.c writePes(), fileName argument is null\n"); return 0; }
+    EmbPatternView view;
 
-    file = embFile_open(fileName, "wb");
-    if(!file)
-    {
-        embLog_error("format-pes.c writePes(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
+    if(!pattern) { embLog_error("format-pes.c writePesStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-pes.c writePesStream(), file argument is null\n"); return 0; }
+    if(!fileName) { embLog_error("format-pes.c writePesStream(), fileName argument is null\n"); return 0; }
 
-    if(!pattern->stitchList || embStitchList_count(pattern->stitchList) == 0) /* TODO: review this. seems like only embStitchList_count should be needed. */
+    if(!embStitchList_count(pattern->stitchList))
     {
-        embLog_error("format-pes.c writePes(), pattern contains no stitches\n");
+        embLog_error("format-pes.c writePesStream(), pattern contains no stitches\n");
         return 0;
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
-    embPattern_flipVertical(pattern);
-    embPattern_scale(pattern, 10.0);
+    /* Both the PES sections and the PEC block below it read the stitches in 0.1 mm, y down */
+    view = embPattern_view(pattern, embTransform_scale(10.0, -10.0));
     binaryWriteBytes(file, "#PES0001", 8);
     /* WRITE PECPointer 32 bit int */
     binaryWriteInt(file, 0x00);
@@ -238,8 +233,8 @@ int writePes(EmbPattern* pattern, const char* fileName)
     binaryWriteShort(file, 0xFFFF); /* command */
     binaryWriteShort(file, 0x00); /* unknown */
 
-    pesWriteEmbOneSection(pattern, file);
-    pesWriteSewSegSection(pattern, file);
+    pesWriteEmbOneSection(&view, file);
+    pesWriteSewSegSection(&view, file);
 
     pecLocation = embFile_tell(file);
     embFile_seek(file, 0x08, SEEK_SET);
@@ -247,9 +242,15 @@ int writePes(EmbPattern* pattern, const char* fileName)
     binaryWriteByte(file, (unsigned char)(pecLocation >> 8) & 0xFF);
     binaryWriteByte(file, (unsigned char)(pecLocation >> 16) & 0xFF);
     embFile_seek(file, 0x00, SEEK_END);
-    writePecStitches(pattern, file, fileName);
-    embFile_close(file);
+    writePecStitches(&view, file, fileName);
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writePes(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writePesStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
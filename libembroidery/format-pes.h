@@ -2,6 +2,7 @@
 #ifndef FORMAT_PES_H
 #define FORMAT_PES_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readPes(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writePes(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writePesStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
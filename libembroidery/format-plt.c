@@ -26,7 +26,8 @@ int readPlt(EmbPattern* pattern, const char* fileName)
 
     embPattern_loadExternalColorFile(pattern, fileName);
     /* TODO: replace all scanf code */
-    while(fscanf(file, "%s", input) >= 0)
+    /* Commands end with ';' and need not be separated by whitespace, as writePlt() writes them */
+    while(fscanf(file, " %511[^;];", input) == 1)
     {
         if(startsWith("PD", input))
         {
@@ -50,7 +51,7 @@ int readPlt(EmbPattern* pattern, const char* fileName)
     fclose(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     return 1;
@@ -63,7 +64,8 @@ int writePlt(EmbPattern* pattern, const char* fileName)
     /* TODO: pointer safety */
     double scalingFactor = 40;
     EmbStitch stitch;
-    EmbStitchList* pointer = 0;
+    EmbStitch* pointer = 0;
+    EmbStitchIterator it;
     char firstStitchOfBlock = 1;
     FILE* file = 0;
 
@@ -80,10 +82,10 @@ int writePlt(EmbPattern* pattern, const char* fileName)
     fprintf(file, "IN;");
     fprintf(file, "ND;");
 
-    pointer = pattern->stitchList;
-    while(pointer)
+    it = embStitchList_begin(pattern->stitchList);
+    while((pointer = embStitchIterator_next(&it)))
     {
-        stitch = pointer->stitch;
+        stitch = *pointer;
         if(stitch.flags & STOP)
         {
             firstStitchOfBlock = 1;
@@ -103,8 +105,6 @@ int writePlt(EmbPattern* pattern, const char* fileName)
         {
             fprintf(file, "PD%f,%f;", stitch.xx * scalingFactor, stitch.yy * scalingFactor);
         }
-
-        pointer = pointer->next;
     }
     fprintf(file, "PU0.0,0.0;");
     fprintf(file, "PU0.0,0.0;");
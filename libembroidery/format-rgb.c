@@ -1,4 +1,5 @@
 #include "format-rgb.h"
+#include "emb-reader-writer.h"
 #include "emb-file.h"
 #include "emb-logging.h"
 #include "helpers-binary.h"
@@ -23,9 +24,7 @@ int readRgb(EmbPattern* pattern, const char* fileName)
     embFile_seek(file, 0x00, SEEK_END);
     numberOfColors = embFile_tell(file) / 4;
 
-    embThreadList_free(pattern->threadList);
-    pattern->threadList = 0;
-    pattern->lastThread = 0;
+    embPattern_clearThreads(pattern);
 
     embFile_seek(file, 0x00, SEEK_SET);
     for(i = 0; i < numberOfColors; i++)
@@ -43,34 +42,31 @@ int readRgb(EmbPattern* pattern, const char* fileName)
     return 1;
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeRgb(EmbPattern* pattern, const char* fileName)
+int writeRgbStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
-    EmbThreadList* colors = pattern->threadList;
-    EmbFile* file = 0;
-
-    if(!pattern) { embLog_error("format-rgb.c writeRgb(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-rgb.c writeRgb(), fileName argument is null\n"); return 0; }
+    int t;
 
-    file = embFile_open(fileName, "wb");
-    if(!file)
-    {
-        embLog_error("format-rgb.c writeRgb(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
+    if(!pattern) { embLog_error("format-rgb.c writeRgbStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-rgb.c writeRgbStream(), file argument is null\n"); return 0; }
 
-    while(colors)
+    for(t = 0; t < embThreadList_count(pattern->threadList); t++)
     {
-        EmbColor c = colors->thread.color;
+        EmbColor c = pattern->threadList->thread[t].color;
         binaryWriteByte(file, c.r);
         binaryWriteByte(file, c.g);
         binaryWriteByte(file, c.b);
         binaryWriteByte(file, 0);
-        colors = colors->next;
     }
-    embFile_close(file);
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeRgb(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writeRgbStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
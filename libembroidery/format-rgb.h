@@ -2,6 +2,7 @@
 #ifndef FORMAT_RGB_H
 #define FORMAT_RGB_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readRgb(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeRgb(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeRgbStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
@@ -1,4 +1,5 @@
 #include "format-jef.h"
+#include "emb-reader-writer.h"
 #include "emb-file.h"
 #include "emb-logging.h"
 #include "emb-time.h"
@@ -92,7 +93,7 @@ int readSew(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     return 1;
@@ -132,48 +133,40 @@ static void sewEncode(unsigned char* b, char dx, char dy, int flags)
         b[1] = dy;
     }
 }
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeSew(EmbPattern* pattern, const char* fileName)
+int writeSewStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
     int colorlistSize, minColors, i;
-    EmbFile* file = 0;
-    EmbThreadList* threadPointer = 0;
-    EmbStitchList* stitches = 0;
+    int t;
+    EmbStitch* stitches = 0;
+    EmbStitchIterator it;
     double dx = 0.0, dy = 0.0;
     double xx = 0.0, yy = 0.0;
     int flags = 0;
     unsigned char b[4];
-    if(!pattern) { embLog_error("format-sew.c writeSew(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-sew.c writeSew(), fileName argument is null\n"); return 0; }
+    if(!pattern) { embLog_error("format-sew.c writeSewStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-sew.c writeSewStream(), file argument is null\n"); return 0; }
 
     if(!embStitchList_count(pattern->stitchList))
     {
-        embLog_error("format-sew.c writeSew(), pattern contains no stitches\n");
+        embLog_error("format-sew.c writeSewStream(), pattern contains no stitches\n");
         return 0;
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if (pattern->lastStitch->stitch.flags != END)
+    if (embStitchList_last(pattern->stitchList)->flags != END)
     {
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
     }
-    file = embFile_open(fileName, "wb");
-    if(!file)
-    {
-        embLog_error("format-sew.c writeJef(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
-
-    colorlistSize = embThreadList_count(pattern->threadList);
+    colorlistSize = embPattern_threadCount(pattern);
     minColors = max(colorlistSize, 6);
     binaryWriteInt(file, 0x74 + (minColors * 4));
     binaryWriteInt(file, 0x0A);
 
-    while(threadPointer)
+    for(t = 0; t < embThreadList_count(pattern->threadList); t++)
     {
-        binaryWriteInt(file, embThread_findNearestColorInArray(threadPointer->thread.color, (EmbThread*)jefThreads, 79));
-        threadPointer = threadPointer->next;
+        binaryWriteInt(file, embThreadList_paletteIndex(pattern->threadList, t, jefThreads, 79));
     }
     for(i = 0; i < (minColors - colorlistSize); i++)
     {
@@ -183,14 +176,14 @@ int writeSew(EmbPattern* pattern, const char* fileName)
     {
         embFile_printf(file, " ");
     }
-    stitches = pattern->stitchList;
-    while(stitches)
+    it = embStitchList_begin(pattern->stitchList);
+    while((stitches = embStitchIterator_next(&it)))
     {
-        dx = stitches->stitch.xx * 10.0 - xx;
-        dy = stitches->stitch.yy * 10.0 - yy;
-        xx = stitches->stitch.xx * 10.0;
-        yy = stitches->stitch.yy * 10.0;
-        flags = stitches->stitch.flags;
+        dx = stitches->xx * 10.0 - xx;
+        dy = stitches->yy * 10.0 - yy;
+        xx = stitches->xx * 10.0;
+        yy = stitches->yy * 10.0;
+        flags = stitches->flags;
         sewEncode(b, (char)roundDouble(dx), (char)roundDouble(dy), flags);
         if((b[0] == 0x80) && ((b[1] == 1) || (b[1] == 2) || (b[1] == 4) || (b[1] == 0x10)))
         {
@@ -201,10 +194,15 @@ int writeSew(EmbPattern* pattern, const char* fileName)
             binaryWriteByte(file, b[0]);
             binaryWriteByte(file, b[1]);
         }
-        stitches = stitches->next;
     }
-    embFile_close(file);
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeSew(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writeSewStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
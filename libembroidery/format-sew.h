@@ -2,6 +2,7 @@
 #ifndef FORMAT_SEW_H
 #define FORMAT_SEW_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readSew(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeSew(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeSewStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
@@ -25,14 +25,22 @@ typedef struct StxThread_
     EmbColor stxColor;
 } StxThread;
 
-static int stxReadThread(StxThread* thread, EmbFile* file)
+/* Reads a string of (\a length) bytes from (\a file) into memory allocated from (\a arena), adding a terminating null. */
+static char* stxReadString(EmbFile* file, EmbArena* arena, int length)
+{
+    char* str = (char*)embArena_alloc(arena, (size_t)length + 1);
+    if(!str) return 0;
+    binaryReadBytes(file, (unsigned char*)str, length); /* TODO: check return value */
+    str[length] = 0;
+    return str;
+}
+
+/* Reads one thread description from (\a file); its strings are allocated from (\a arena). */
+static int stxReadThread(StxThread* thread, EmbFile* file, EmbArena* arena)
 {
     int j, colorNameLength, sectionNameLength;
     int somethingSomething, somethingSomething2, somethingElse, numberOfOtherDescriptors; /* TODO: determine what these represent */
     int codeLength = 0;
-    char* codeBuff = 0;
-    char* codeNameBuff = 0;
-    char* sectionNameBuff = 0;
     EmbColor col;
     unsigned char whatIsthis; /* TODO: determine what this represents */
 
@@ -40,15 +48,11 @@ static int stxReadThread(StxThread* thread, EmbFile* file)
     if(!file) { embLog_error("format-stx.c stxReadThread(), file argument is null\n"); return 0; }
 
     codeLength = binaryReadUInt8(file);
-    codeBuff = (char*)malloc(codeLength);
-    if(!codeBuff) { embLog_error("format-stx.c stxReadThread(), unable to allocate memory for codeBuff\n"); return 0; }
-    binaryReadBytes(file, (unsigned char*)codeBuff, codeLength); /* TODO: check return value */
-    thread->colorCode = codeBuff;
+    thread->colorCode = stxReadString(file, arena, codeLength);
+    if(!thread->colorCode) { embLog_error("format-stx.c stxReadThread(), unable to allocate memory for thread->colorCode\n"); return 0; }
     colorNameLength = binaryReadUInt8(file);
-    codeNameBuff = (char*)malloc(colorNameLength);
-    if(!codeNameBuff) { embLog_error("format-stx.c stxReadThread(), unable to allocate memory for codeNameBuff\n"); return 0; }
-    binaryReadBytes(file, (unsigned char*)codeNameBuff, colorNameLength); /* TODO: check return value */
-    thread->colorName = codeNameBuff;
+    thread->colorName = stxReadString(file, arena, colorNameLength);
+    if(!thread->colorName) { embLog_error("format-stx.c stxReadThread(), unable to allocate memory for thread->colorName\n"); return 0; }
 
     col.r = binaryReadUInt8(file);
     col.b = binaryReadUInt8(file);
@@ -57,37 +61,30 @@ static int stxReadThread(StxThread* thread, EmbFile* file)
     whatIsthis = binaryReadUInt8(file);
 
     sectionNameLength = binaryReadUInt8(file);
-    sectionNameBuff = (char*)malloc(sectionNameLength);
-    if(!sectionNameBuff) { embLog_error("format-stx.c stxReadThread(), unable to allocate memory for sectionNameBuff\n"); return 0; }
-    binaryReadBytes(file, (unsigned char*)sectionNameBuff, sectionNameLength); /* TODO: check return value */
-    thread->sectionName = sectionNameBuff;
+    thread->sectionName = stxReadString(file, arena, sectionNameLength);
+    if(!thread->sectionName) { embLog_error("format-stx.c stxReadThread(), unable to allocate memory for thread->sectionName\n"); return 0; }
 
     somethingSomething = binaryReadInt32(file);
     somethingSomething2 = binaryReadInt32(file);
     somethingElse = binaryReadInt32(file);
     numberOfOtherDescriptors = binaryReadInt16(file);
 
-    thread->subDescriptors = (SubDescriptor*)malloc(sizeof(SubDescriptor) * numberOfOtherDescriptors);
+    thread->subDescriptors = (SubDescriptor*)embArena_alloc(arena, sizeof(SubDescriptor) * numberOfOtherDescriptors);
     if(!thread->subDescriptors) { embLog_error("format-stx.c stxReadThread(), unable to allocate memory for thread->subDescriptors\n"); return 0; }
     for(j = 0; j < numberOfOtherDescriptors; j++)
     {
         SubDescriptor sd;
-        char* subCodeBuff, *subColorNameBuff;
         int subCodeLength, subColorNameLength;
 
         sd.someNum = binaryReadInt16(file);
         /* Debug.Assert(sd.someNum == 1); TODO: review */
         sd.someInt = binaryReadInt32(file);
         subCodeLength = binaryReadUInt8(file);
-        subCodeBuff = (char*)malloc(subCodeLength);
-        if(!subCodeBuff) { embLog_error("format-stx.c stxReadThread(), unable to allocate memory for subCodeBuff\n"); return 0; }
-        binaryReadBytes(file, (unsigned char*)subCodeBuff, subCodeLength); /* TODO: check return value */
-        sd.colorCode = subCodeBuff;
+        sd.colorCode = stxReadString(file, arena, subCodeLength);
+        if(!sd.colorCode) { embLog_error("format-stx.c stxReadThread(), unable to allocate memory for sd.colorCode\n"); return 0; }
         subColorNameLength = binaryReadUInt8(file);
-        subColorNameBuff = (char*)malloc(subColorNameLength);
-        if(!subColorNameBuff) { embLog_error("format-stx.c stxReadThread(), unable to allocate memory for subColorNameBuff\n"); return 0; }
-        binaryReadBytes(file, (unsigned char*)subColorNameBuff, subColorNameLength); /* TODO: check return value */
-        sd.colorName = subColorNameBuff;
+        sd.colorName = stxReadString(file, arena, subColorNameLength);
+        if(!sd.colorName) { embLog_error("format-stx.c stxReadThread(), unable to allocate memory for sd.colorName\n"); return 0; }
         sd.someOtherInt = binaryReadInt32(file);
         thread->subDescriptors[j] = sd;
     }
@@ -150,13 +147,13 @@ int readStx(EmbPattern* pattern, const char* fileName)
     /*Image = new Bitmap(s2); TODO: review */
 
     threadCount = binaryReadInt16(file);
-    stxThreads = (StxThread*)malloc(sizeof(StxThread) * threadCount);
+    stxThreads = (StxThread*)embArena_alloc(&pattern->arena, sizeof(StxThread) * threadCount);
     if(!stxThreads) { embLog_error("format-stx.c readStx(), unable to allocate memory for stxThreads\n"); return 0; }
     for(i = 0; i < threadCount; i++)
     {
         EmbThread t;
         StxThread st;
-        stxReadThread(&st, file);
+        stxReadThread(&st, file, &pattern->arena);
 
         t.color.r = st.stxColor.r;
         t.color.g = st.stxColor.g;
@@ -230,7 +227,7 @@ int readStx(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     embPattern_flipVertical(pattern);
@@ -251,7 +248,7 @@ int writeStx(EmbPattern* pattern, const char* fileName)
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     /* TODO: embFile_open() needs to occur here after the check for no stitches */
@@ -1,11 +1,193 @@
 #include "format-svg.h"
+#include "emb-reader-writer.h"
 #include "emb-file.h"
 #include "emb-logging.h"
+#include "emb-path-data.h"
 #include "helpers-misc.h"
 #include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
 
+/* Everything readSvg() keeps while it walks a file. Each read has its own, so files can be read on several threads at once. */
+typedef struct SvgReader_
+{
+    int creator;
+    SvgElement* element;
+
+    EmbArena arena; /* Scratch memory for the element being parsed; reset once the element has been added to the pattern */
+    EmbPathData pathData; /* Segments and points of the path being added, kept for the next one */
+    EmbFlatPath flatPath;
+} SvgReader;
+
+/* Element and attribute names are found with perfect hash tables, see svgLookup(). The names are those of SVG Tiny 1.2,
+ * and svgTagAttributes lists which attributes each element takes. Adding a name means searching for bucket seeds
+ * again, so that every name still hashes to a slot of its own. */
+
+static const char* const svgTagNames[SVG_TAG_COUNT] =
+{
+    "a", "animate", "animateColor", "animateMotion", "animateTransform", "animation",
+    "audio", "circle", "defs", "desc", "discard", "ellipse",
+    "font", "font-face", "font-face-src", "font-face-uri", "foreignObject", "g",
+    "glyph", "handler", "hkern", "image", "line", "linearGradient",
+    "listener", "metadata", "missing-glyph", "mpath", "path", "polygon",
+    "polyline", "prefetch", "radialGradient", "rect", "script", "set",
+    "solidColor", "stop", "svg", "switch", "tbreak", "text",
+    "textArea", "title", "tspan", "use", "video"
+};
+
+#define SVG_TAG_BUCKETS 16
+#define SVG_TAG_SLOTS   64
+
+static const unsigned short svgTagSeeds[SVG_TAG_BUCKETS] =
+{
+    2, 2, 1, 4, 5, 1, 16, 4, 1, 9, 4, 9, 3, 3, 19, 2
+};
+
+/* SVG_TAG + 1 for each slot, 0 for an empty slot */
+static const unsigned char svgTagSlots[SVG_TAG_SLOTS] =
+{
+     0, 38,  0,  0,  0, 44,  1,  0, 12,  0, 40, 33, 14,  8, 25, 37,
+    45, 22,  3, 13, 42, 18,  0, 26,  0, 19, 27,  6, 17,  0, 47, 24,
+    21,  0,  0, 10, 11,  0,  5,  0, 20, 15,  0, 41, 36, 30,  4, 43,
+     0,  2, 34,  9, 46,  0, 23, 29, 39, 31,  0, 32, 16,  7, 28, 35
+};
+
+#define SVG_ATTRIBUTE_COUNT   195
+#define SVG_ATTRIBUTE_BUCKETS 64
+#define SVG_ATTRIBUTE_SLOTS   256
+
+static const char* const svgAttributeNames[SVG_ATTRIBUTE_COUNT] =
+{
+    "about", "accent-height", "accumulate", "additive", "alphabetic",
+    "arabic-form", "ascent", "attributeName", "attributeType", "audio-level",
+    "bandwidth", "baseProfile", "bbox", "begin", "buffered-rendering",
+    "by", "calcMode", "cap-height", "class", "color",
+    "color-rendering", "content", "contentScriptType", "cx", "cy",
+    "d", "datatype", "defaultAction", "descent", "direction",
+    "display", "display-align", "dur", "editable", "encoding",
+    "end", "ev:event", "event", "externalResourcesRequired", "fill",
+    "fill-opacity", "fill-rule", "focusHighlight", "focusable", "font-family",
+    "font-size", "font-stretch", "font-style", "font-variant", "font-weight",
+    "from", "g1", "g2", "glyph-name", "gradientUnits",
+    "handler", "hanging", "height", "horiz-adv-x", "horiz-origin-x",
+    "id", "ideographic", "image-rendering", "initialVisibility", "k",
+    "keyPoints", "keySplines", "keyTimes", "lang", "line-increment",
+    "mathematical", "max", "mediaCharacterEncoding", "mediaContentEncodings", "mediaSize",
+    "mediaTime", "min", "nav-down", "nav-down-left", "nav-down-right",
+    "nav-left", "nav-next", "nav-prev", "nav-right", "nav-up",
+    "nav-up-left", "nav-up-right", "observer", "offset", "opacity",
+    "origin", "overlay", "overline-position", "overline-thickness", "panose-1",
+    "path", "pathLength", "phase", "playbackOrder", "pointer-events",
+    "points", "preserveAspectRatio", "propagate", "property", "r",
+    "rel", "repeatCount", "repeatDur", "requiredExtensions", "requiredFeatures",
+    "requiredFonts", "requiredFormats", "resource", "restart", "rev",
+    "role", "rotate", "rx", "ry", "shape-rendering",
+    "slope", "snapshotTime", "solid-color", "solid-opacity", "standalone",
+    "stemh", "stemv", "stop-color", "stop-opacity", "strikethrough-position",
+    "strikethrough-thickness", "stroke", "stroke-dasharray", "stroke-linecap", "stroke-linejoin",
+    "stroke-miterlimit", "stroke-opacity", "stroke-width", "syncBehavior", "syncBehaviorDefault",
+    "syncMaster", "syncTolerance", "syncToleranceDefault", "systemLanguage", "target",
+    "text-align", "text-anchor", "text-rendering", "timelineBegin", "to",
+    "transform", "transformBehavior", "type", "typeof", "u1",
+    "u2", "underline-position", "underline-thickness", "unicode", "unicode-bidi",
+    "unicode-range", "units-per-em", "values", "vector-effect", "version",
+    "viewBox", "viewport-fill", "viewport-fill-opacity", "visibility", "width",
+    "widths", "x", "x-height", "x1", "x2",
+    "xlink:actuate", "xlink:arcrole", "xlink:href", "xlink:role", "xlink:show",
+    "xlink:title", "xlink:type", "xml:base", "xml:id", "xml:lang",
+    "xml:space", "xmlns", "xmlns:cc", "xmlns:dc", "xmlns:rdf",
+    "xmlns:svg", "y", "y1", "y2", "zoomAndPan"
+};
+
+static const unsigned short svgAttributeSeeds[SVG_ATTRIBUTE_BUCKETS] =
+{
+    4, 2, 2, 4, 1, 12, 1, 7, 2, 0, 1, 6, 4, 2, 0, 5,
+    4, 2, 3, 20, 4, 1, 1, 4, 3, 11, 0, 7, 15, 3, 7, 8,
+    8, 5, 4, 13, 2, 4, 16, 0, 6, 4, 15, 1, 3, 9, 0, 10,
+    3, 4, 38, 10, 41, 6, 12, 6, 6, 9, 4, 16, 10, 22, 8, 11
+};
+
+/* Index + 1 into svgAttributeNames for each slot, 0 for an empty slot */
+static const unsigned char svgAttributeSlots[SVG_ATTRIBUTE_SLOTS] =
+{
+      4,   0,  54,  10,  50,  41, 117, 143, 184, 105,   0,  15, 175, 186,  88,  44,
+      0, 108, 164,   0,   0, 123,   0,   0, 169,  69,   0,  81,  94,  19,  37,   0,
+    128,   0,  34,   0,  95,  90, 137,   0,  66, 188,  26,  96,   0, 174,  55, 141,
+      0,  58,  74,  12,  13, 121, 163,   0,  77, 146,  82,  63, 166,  14,  53,   0,
+    106,  76,  86,   0, 167,  64,   0,   0, 179,  32,   0,  59,   0,   0,   0, 148,
+    119,   0, 153,   0, 155,  67, 129, 150,  87,  75,  18, 185,  80, 176,   0,   0,
+      0,  23,  60,  72, 170,   0,  73,   0, 102, 151, 114, 190,  65,   0, 142, 126,
+     93,  45, 183, 130,  39,  61, 157,   0,   0,  31, 112,  22,  24,   1, 162,   0,
+      0,   0,   9, 138,   0, 110,   0,  33, 171, 134, 101,  68,  92,  98,   6,  91,
+     42, 173,  35, 103, 177,   0, 193,   0,   0,  52, 122, 181,  36,   0,  89,   0,
+    127, 154,  51, 145, 140,   0,  78, 182,  30,   0,   3, 125,   0, 194,  79,  85,
+     38, 111, 180, 178,  84, 133,   0,  11, 165,  97,   0,  28,  21,   0, 113,  40,
+    160,   0, 168,   0,   0,   7,  62, 149,  46, 152,   2, 139, 115,  57, 118, 116,
+      5,  27,  56, 158,  25,  43,  70,  47, 136,   0, 191, 159, 107,   0,   0,   8,
+    100, 187,  20, 109,  29, 135,   0, 144,   0,   0, 156,   0, 120, 172,  83,   0,
+    192,  16,  71, 124, 195,   0,  48, 104,  99, 189, 132, 161,  17, 147, 131,  49
+};
+
+#define SVG_ATTRIBUTE_SET_SIZE 25
+
+/* The attributes each element accepts, one bit per entry of svgAttributeNames */
+static const unsigned char svgTagAttributes[SVG_TAG_COUNT][SVG_ATTRIBUTE_SET_SIZE] =
+{
+    { 0x01, 0x42, 0x3C, 0xE4, 0xC0, 0xBF, 0x03, 0x50, 0x20, 0xE0, 0x7F, 0x02, 0x88, 0xF2, 0x8D, 0x8C, 0xF9, 0x83, 0x4F, 0x82, 0xC8, 0x81, 0xFF, 0x03, 0x00 }, /* a */
+    { 0x8D, 0xA1, 0x25, 0x04, 0x89, 0x00, 0x04, 0x10, 0x8C, 0x10, 0x00, 0x00, 0x80, 0xFE, 0x0F, 0x00, 0x00, 0x80, 0x20, 0x02, 0x04, 0x80, 0xFF, 0x03, 0x00 }, /* animate */
+    { 0x8D, 0xA1, 0x25, 0x04, 0x89, 0x00, 0x04, 0x10, 0x8C, 0x10, 0x00, 0x00, 0x80, 0xFE, 0x0F, 0x00, 0x00, 0x80, 0x20, 0x02, 0x04, 0x80, 0xFF, 0x03, 0x00 }, /* animateColor */
+    { 0x0D, 0xA0, 0x25, 0x04, 0x89, 0x00, 0x04, 0x10, 0x8E, 0x10, 0x00, 0x84, 0x80, 0xFE, 0x1F, 0x00, 0x00, 0x80, 0x20, 0x02, 0x04, 0x80, 0xFF, 0x03, 0x00 }, /* animateMotion */
+    { 0x8D, 0xA1, 0x25, 0x04, 0x89, 0x00, 0x04, 0x10, 0x8C, 0x10, 0x00, 0x00, 0x80, 0xFE, 0x0F, 0x00, 0x00, 0x80, 0x20, 0x03, 0x04, 0x80, 0xFF, 0x03, 0x00 }, /* animateTransform */
+    { 0x01, 0x62, 0x24, 0x44, 0xC9, 0x0C, 0x00, 0xD2, 0x80, 0xF0, 0x7F, 0x00, 0xA8, 0xFE, 0x8F, 0x00, 0x00, 0xB4, 0x48, 0x02, 0xC0, 0x8B, 0xFF, 0x83, 0x00 }, /* animation */
+    { 0x01, 0x62, 0x24, 0x44, 0xC9, 0x00, 0x00, 0x50, 0x80, 0x10, 0x00, 0x00, 0x88, 0xFE, 0x8F, 0x00, 0x00, 0xB4, 0x08, 0x03, 0xC0, 0x81, 0xFF, 0x03, 0x00 }, /* audio */
+    { 0x01, 0x42, 0xBC, 0xE5, 0x80, 0xBF, 0x03, 0x50, 0x20, 0xE0, 0x7F, 0x02, 0x88, 0xF3, 0x8D, 0x8C, 0xF9, 0x83, 0x4E, 0x82, 0xC8, 0x01, 0xC0, 0x03, 0x00 }, /* circle */
+    { 0x01, 0x42, 0x3C, 0xE4, 0x80, 0xB3, 0x03, 0x50, 0x20, 0x00, 0x00, 0x02, 0x88, 0x02, 0x8D, 0x8C, 0xF9, 0x03, 0x0E, 0x82, 0xC8, 0x01, 0xC0, 0x03, 0x00 }, /* defs */
+    { 0x01, 0x42, 0x24, 0x44, 0x00, 0x00, 0x00, 0x50, 0x00, 0x00, 0x00, 0x00, 0x88, 0xF2, 0x8D, 0x00, 0x00, 0x80, 0x08, 0x02, 0xC0, 0x01, 0xC0, 0x03, 0x00 }, /* desc */
+    { 0x01, 0x20, 0x24, 0x04, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x80, 0xF2, 0x0D, 0x00, 0x00, 0x80, 0x00, 0x02, 0x00, 0x80, 0xFF, 0x03, 0x00 }, /* discard */
+    { 0x01, 0x42, 0xBC, 0xE5, 0x80, 0xBF, 0x03, 0x50, 0x20, 0xE0, 0x7F, 0x02, 0x88, 0xF2, 0xED, 0x8C, 0xF9, 0x83, 0x4E, 0x82, 0xC8, 0x01, 0xC0, 0x03, 0x00 }, /* ellipse */
+    { 0x01, 0x00, 0x24, 0x04, 0x40, 0x00, 0x00, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x80, 0x02, 0x0D, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0xC0, 0x03, 0x00 }, /* font */
+    { 0x53, 0x10, 0x26, 0x14, 0x40, 0xD0, 0x03, 0x31, 0x40, 0x00, 0x00, 0x70, 0x80, 0x02, 0x0D, 0x61, 0x06, 0x00, 0x00, 0x32, 0x03, 0x14, 0xC0, 0x03, 0x00 }, /* font-face */
+    { 0x01, 0x00, 0x24, 0x04, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x80, 0x02, 0x0D, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0xC0, 0x03, 0x00 }, /* font-face-src */
+    { 0x01, 0x00, 0x24, 0x04, 0x40, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x80, 0x02, 0x0D, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x80, 0xFF, 0x03, 0x00 }, /* font-face-uri */
+    { 0x01, 0x42, 0x3C, 0xE4, 0xC0, 0xBF, 0x03, 0x52, 0x20, 0xE0, 0x7F, 0x02, 0x88, 0xF2, 0x8D, 0x8C, 0xF9, 0x83, 0x4E, 0x82, 0xC8, 0x8B, 0xFF, 0x83, 0x00 }, /* foreignObject */
+    { 0x01, 0x42, 0x3C, 0xE4, 0xC0, 0xBF, 0x03, 0x50, 0x20, 0xE0, 0x7F, 0x02, 0x88, 0xF2, 0x8D, 0x8C, 0xF9, 0x83, 0x4E, 0x82, 0xC8, 0x01, 0xC0, 0x03, 0x00 }, /* g */
+    { 0x21, 0x00, 0x24, 0x06, 0x00, 0x00, 0x20, 0x14, 0x10, 0x00, 0x00, 0x00, 0x80, 0x02, 0x0D, 0x00, 0x00, 0x00, 0x00, 0x42, 0x00, 0x00, 0xC0, 0x03, 0x00 }, /* glyph */
+    { 0x01, 0x00, 0x24, 0x04, 0x50, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x80, 0x02, 0x0D, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x80, 0xFF, 0x03, 0x00 }, /* handler */
+    { 0x01, 0x00, 0x24, 0x04, 0x00, 0x00, 0x18, 0x10, 0x01, 0x00, 0x00, 0x00, 0x80, 0x02, 0x0D, 0x00, 0x00, 0x00, 0x00, 0x0E, 0x00, 0x00, 0xC0, 0x03, 0x00 }, /* hkern */
+    { 0x01, 0x42, 0x24, 0x44, 0x40, 0x0C, 0x00, 0x52, 0x00, 0xE0, 0x7F, 0x02, 0xA8, 0xF2, 0x8D, 0x00, 0x00, 0x80, 0x48, 0x03, 0xC0, 0x8B, 0xFF, 0x83, 0x00 }, /* image */
+    { 0x01, 0x42, 0x3C, 0xE4, 0x80, 0xBF, 0x03, 0x50, 0x20, 0xE0, 0x7F, 0x02, 0x88, 0xF2, 0x8D, 0x8C, 0xF9, 0x83, 0x4E, 0x82, 0xC8, 0x61, 0xC0, 0x03, 0x03 }, /* line */
+    { 0x01, 0x42, 0x3C, 0xE4, 0x80, 0xB3, 0x43, 0x50, 0x20, 0x00, 0x00, 0x02, 0x88, 0x02, 0x8D, 0x8C, 0xF9, 0x03, 0x0E, 0x82, 0xC8, 0x61, 0xC0, 0x03, 0x03 }, /* linearGradient */
+    { 0x01, 0x00, 0x24, 0x0C, 0x20, 0x00, 0x80, 0x10, 0x00, 0x00, 0x80, 0x00, 0xC2, 0x02, 0x0D, 0x00, 0x00, 0x00, 0x01, 0x02, 0x00, 0x00, 0xC0, 0x03, 0x00 }, /* listener */
+    { 0x01, 0x42, 0x24, 0x44, 0x00, 0x00, 0x00, 0x50, 0x00, 0x00, 0x00, 0x00, 0x88, 0xF2, 0x8D, 0x00, 0x00, 0x80, 0x08, 0x02, 0xC0, 0x01, 0xC0, 0x03, 0x00 }, /* metadata */
+    { 0x01, 0x00, 0x24, 0x06, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x80, 0x02, 0x0D, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0xC0, 0x03, 0x00 }, /* missing-glyph */
+    { 0x01, 0x00, 0x24, 0x04, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x80, 0x02, 0x0D, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x80, 0xFF, 0x03, 0x00 }, /* mpath */
+    { 0x01, 0x42, 0x3C, 0xE6, 0x80, 0xBF, 0x03, 0x50, 0x20, 0xE0, 0x7F, 0x02, 0x89, 0xF2, 0x8D, 0x8C, 0xF9, 0x83, 0x4E, 0x82, 0xC8, 0x01, 0xC0, 0x03, 0x00 }, /* path */
+    { 0x01, 0x42, 0x3C, 0xE4, 0x80, 0xBF, 0x03, 0x50, 0x20, 0xE0, 0x7F, 0x02, 0x98, 0xF2, 0x8D, 0x8C, 0xF9, 0x83, 0x4E, 0x82, 0xC8, 0x01, 0xC0, 0x03, 0x00 }, /* polygon */
+    { 0x01, 0x42, 0x3C, 0xE4, 0x80, 0xBF, 0x03, 0x50, 0x20, 0xE0, 0x7F, 0x02, 0x98, 0xF2, 0x8D, 0x8C, 0xF9, 0x83, 0x4E, 0x82, 0xC8, 0x01, 0xC0, 0x03, 0x00 }, /* polyline */
+    { 0x01, 0x04, 0x24, 0x04, 0x00, 0x00, 0x00, 0x10, 0x00, 0x0F, 0x00, 0x00, 0x80, 0x02, 0x0D, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x80, 0xFF, 0x03, 0x00 }, /* prefetch */
+    { 0x01, 0x42, 0xBC, 0xE5, 0x80, 0xB3, 0x43, 0x50, 0x20, 0x00, 0x00, 0x02, 0x88, 0x03, 0x8D, 0x8C, 0xF9, 0x03, 0x0E, 0x82, 0xC8, 0x01, 0xC0, 0x03, 0x00 }, /* radialGradient */
+    { 0x01, 0x42, 0x3C, 0xE4, 0x80, 0xBF, 0x03, 0x52, 0x20, 0xE0, 0x7F, 0x02, 0x88, 0xF2, 0xED, 0x8C, 0xF9, 0x83, 0x4E, 0x82, 0xC8, 0x0B, 0xC0, 0x83, 0x00 }, /* rect */
+    { 0x01, 0x00, 0x24, 0x04, 0x40, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x80, 0x02, 0x0D, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x80, 0xFF, 0x03, 0x00 }, /* script */
+    { 0x81, 0x21, 0x24, 0x04, 0x89, 0x00, 0x00, 0x10, 0x80, 0x10, 0x00, 0x00, 0x80, 0xFE, 0x0D, 0x00, 0x00, 0x80, 0x20, 0x02, 0x00, 0x80, 0xFF, 0x03, 0x00 }, /* set */
+    { 0x01, 0x42, 0x3C, 0xE4, 0x80, 0xB3, 0x03, 0x50, 0x20, 0x00, 0x00, 0x02, 0x88, 0x02, 0x8D, 0x8C, 0xF9, 0x03, 0x0E, 0x82, 0xC8, 0x01, 0xC0, 0x03, 0x00 }, /* solidColor */
+    { 0x01, 0x42, 0x3C, 0xE4, 0x80, 0xB3, 0x03, 0x50, 0x20, 0x00, 0x00, 0x03, 0x88, 0x02, 0x8D, 0x8C, 0xF9, 0x03, 0x0E, 0x82, 0xC8, 0x01, 0xC0, 0x03, 0x00 }, /* stop */
+    { 0x01, 0x4A, 0x7C, 0xE4, 0xC0, 0xBF, 0x03, 0x52, 0x20, 0xE0, 0x7F, 0x02, 0xAC, 0x02, 0x8D, 0x8E, 0xF9, 0x4B, 0x1E, 0x82, 0xF8, 0x03, 0xC0, 0x03, 0x04 }, /* svg */
+    { 0x01, 0x42, 0x3C, 0xE4, 0xC0, 0xBF, 0x03, 0x50, 0x20, 0xE0, 0x7F, 0x02, 0x88, 0xF2, 0x8D, 0x8C, 0xF9, 0x83, 0x4E, 0x82, 0xC8, 0x01, 0xC0, 0x03, 0x00 }, /* switch */
+    { 0x01, 0x00, 0x24, 0x04, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x80, 0xF2, 0x0D, 0x00, 0x00, 0x80, 0x00, 0x02, 0x00, 0x00, 0xC0, 0x03, 0x00 }, /* tbreak */
+    { 0x01, 0x42, 0x3C, 0xE4, 0x82, 0xBF, 0x03, 0x50, 0x20, 0xE0, 0x7F, 0x02, 0x88, 0xF2, 0x9D, 0x8C, 0xF9, 0x83, 0x4E, 0x82, 0xC8, 0x09, 0xC0, 0x83, 0x00 }, /* text */
+    { 0x01, 0x42, 0x3C, 0xE4, 0x82, 0xBF, 0x03, 0x52, 0x20, 0xE0, 0x7F, 0x02, 0x88, 0xF2, 0x8D, 0x8C, 0xF9, 0x83, 0x4E, 0x82, 0xC8, 0x0B, 0xC0, 0x83, 0x00 }, /* textArea */
+    { 0x01, 0x42, 0x24, 0x44, 0x00, 0x00, 0x00, 0x50, 0x00, 0x00, 0x00, 0x00, 0x88, 0xF2, 0x8D, 0x00, 0x00, 0x80, 0x08, 0x02, 0xC0, 0x01, 0xC0, 0x03, 0x00 }, /* title */
+    { 0x01, 0x42, 0x3C, 0xE4, 0x80, 0xBF, 0x03, 0x50, 0x20, 0xE0, 0x7F, 0x02, 0x88, 0xF2, 0x8D, 0x8C, 0xF9, 0x83, 0x0E, 0x82, 0xC8, 0x01, 0xC0, 0x03, 0x00 }, /* tspan */
+    { 0x01, 0x42, 0x3C, 0xE4, 0xC0, 0xBF, 0x03, 0x50, 0x20, 0xE0, 0x7F, 0x02, 0x88, 0xF2, 0x8D, 0x8C, 0xF9, 0x83, 0x4E, 0x82, 0xC8, 0x89, 0xFF, 0x83, 0x00 }, /* use */
+    { 0x01, 0x62, 0x24, 0x44, 0xC9, 0x0C, 0x00, 0xD2, 0x80, 0xF0, 0x7F, 0x08, 0xA8, 0xFE, 0x8F, 0x00, 0x00, 0xB4, 0xC8, 0x03, 0xC0, 0x8B, 0xFF, 0x83, 0x00 }  /* video */
+};
+
+/* Accepted on the svg element only when the file was made by Inkscape */
+static const unsigned char svgInkscapeAttributes[SVG_ATTRIBUTE_SET_SIZE] =
+{
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7C, 0x00
+};
+
 EmbColor svgColorToEmbColor(char* colorString)
 {
     unsigned char r = 0;
@@ -98,40 +280,45 @@ EmbColor svgColorToEmbColor(char* colorString)
     return embColor_make(r, g, b);
 }
 
-EmbFlag svgPathCmdToEmbPathFlag(char cmd)
-{
-
-    return LINETO;
-}
-
-SvgAttribute svgAttribute_create(const char* name, const char* value)
+/* Makes an attribute from the (length) characters of its value at (value), quotes included, as they appear in the file.
+ * The value is copied into the scratch arena with its quotes, commas, slashes and line breaks turned into spaces,
+ * which are the separators the shapes below split their values on. */
+SvgAttribute svgAttribute_create(SvgReader* reader, const char* name, const char* value, size_t length)
 {
     SvgAttribute attribute;
     char* modValue = 0;
-    int last = 0;
-    int i = 0;
+    size_t i = 0;
 
-    modValue = emb_strdup(value);
-    last = strlen(modValue);
-    for(i = 0; i < last; i++)
+    modValue = embArena_strndup(&reader->arena, value, length);
+    if(!modValue) { attribute.name = attribute.value = 0; return attribute; }
+    for(i = 0; i < length; i++)
     {
-        if(modValue[i] == '"') modValue[i] = ' ';
-        if(modValue[i] == '\'') modValue[i] = ' ';
-        if(modValue[i] == '/') modValue[i] = ' ';
-        if(modValue[i] == ',') modValue[i] = ' ';
+        switch(modValue[i])
+        {
+            case '"':
+            case '\'':
+            case '/':
+            case ',':
+            case '\t':
+            case '\r':
+            case '\n':
+                modValue[i] = ' ';
+                break;
+        }
     }
-    attribute.name = emb_strdup(name);
+    attribute.name = name;
     attribute.value = modValue;
     return attribute;
 }
 
-void svgElement_addAttribute(SvgElement* element, SvgAttribute data)
+void svgElement_addAttribute(SvgReader* reader, SvgElement* element, SvgAttribute data)
 {
     if(!element) { embLog_error("format-svg.c svgElement_addAttribute(), element argument is null\n"); return; }
+    if(!data.name || !data.value) { embLog_error("format-svg.c svgElement_addAttribute(), data is incomplete\n"); return; }
 
     if(!(element->attributeList))
     {
-        element->attributeList = (SvgAttributeList*)malloc(sizeof(SvgAttributeList));
+        element->attributeList = (SvgAttributeList*)embArena_alloc(&reader->arena, sizeof(SvgAttributeList));
         if(!(element->attributeList)) { embLog_error("format-svg.c svgElement_addAttribute(), cannot allocate memory for element->attributeList\n"); return; }
         element->attributeList->attribute = data;
         element->attributeList->next = 0;
@@ -141,7 +328,7 @@ void svgElement_addAttribute(SvgElement* element, SvgAttribute data)
     else
     {
         SvgAttributeList* pointerLast = element->lastAttribute;
-        SvgAttributeList* list = (SvgAttributeList*)malloc(sizeof(SvgAttributeList));
+        SvgAttributeList* list = (SvgAttributeList*)embArena_alloc(&reader->arena, sizeof(SvgAttributeList));
         if(!list) { embLog_error("format-svg.c svgElement_addAttribute(), cannot allocate memory for list\n"); return; }
         list->attribute = data;
         list->next = 0;
@@ -150,41 +337,21 @@ void svgElement_addAttribute(SvgElement* element, SvgAttribute data)
     }
 }
 
-void svgElement_free(SvgElement* element)
+/* The element, its name and its attributes all live in the scratch arena, so they are released together. */
+void svgElement_free(SvgReader* reader, SvgElement* element)
 {
-    SvgAttributeList* list = 0;
-    SvgAttributeList* nextList = 0;
     if(!element) return;
-
-    list = element->attributeList;
-
-    while(list)
-    {
-        free(list->attribute.name);
-        list->attribute.name = 0;
-        free(list->attribute.value);
-        list->attribute.value = 0;
-        nextList = list->next;
-        free(list);
-        list = 0;
-        list = nextList;
-    }
-
-    element->lastAttribute = 0;
-    free(element->name);
-    element->name = 0;
-    free(element);
-    element = 0;
+    embArena_reset(&reader->arena);
 }
 
-SvgElement* svgElement_create(const char* name)
+SvgElement* svgElement_create(SvgReader* reader, int tag)
 {
     SvgElement* element = 0;
 
-    element = (SvgElement*)malloc(sizeof(SvgElement));
+    element = (SvgElement*)embArena_alloc(&reader->arena, sizeof(SvgElement));
     if(!element) { embLog_error("format-svg.c svgElement_create(), cannot allocate memory for element\n"); return 0; }
-    element->name = emb_strdup(name);
-    if(!element->name) { embLog_error("format-svg.c svgElement_create(), element->name is null\n"); return 0; }
+    element->name = svgTagNames[tag];
+    element->tag = tag;
     element->attributeList = 0;
     element->lastAttribute = 0;
     return element;
@@ -208,3014 +375,304 @@ char* svgAttribute_getValue(SvgElement* element, const char* name)
     return "none";
 }
 
-void svgAddToPattern(EmbPattern* p)
-{
-    const char* buff = 0;
-
-    if(!p) { embLog_error("format-svg.c svgAddToPattern(), p argument is null\n"); return; }
-    if(!currentElement) { return; }
-
-    buff = currentElement->name;
-    if(!buff) { return; }
-
-    if     (!strcmp(buff, "?xml"))             {  }
-    else if(!strcmp(buff, "a"))                {  }
-    else if(!strcmp(buff, "animate"))          {  }
-    else if(!strcmp(buff, "animateColor"))     {  }
-    else if(!strcmp(buff, "animateMotion"))    {  }
-    else if(!strcmp(buff, "animateTransform")) {  }
-    else if(!strcmp(buff, "animation"))        {  }
-    else if(!strcmp(buff, "audio"))            {  }
-    else if(!strcmp(buff, "circle"))
-    {
-        embPattern_addCircleObjectAbs(p, atof(svgAttribute_getValue(currentElement, "cx")),
-                                         atof(svgAttribute_getValue(currentElement, "cy")),
-                                         atof(svgAttribute_getValue(currentElement, "r")));
-    }
-    else if(!strcmp(buff, "defs"))             {  }
-    else if(!strcmp(buff, "desc"))             {  }
-    else if(!strcmp(buff, "discard"))          {  }
-    else if(!strcmp(buff, "ellipse"))
-    {
-        embPattern_addEllipseObjectAbs(p, atof(svgAttribute_getValue(currentElement, "cx")),
-                                          atof(svgAttribute_getValue(currentElement, "cy")),
-                                          atof(svgAttribute_getValue(currentElement, "rx")),
-                                          atof(svgAttribute_getValue(currentElement, "ry")));
-    }
-    else if(!strcmp(buff, "font"))             {  }
-    else if(!strcmp(buff, "font-face"))        {  }
-    else if(!strcmp(buff, "font-face-src"))    {  }
-    else if(!strcmp(buff, "font-face-uri"))    {  }
-    else if(!strcmp(buff, "foreignObject"))    {  }
-    else if(!strcmp(buff, "g"))                {  }
-    else if(!strcmp(buff, "glyph"))            {  }
-    else if(!strcmp(buff, "handler"))          {  }
-    else if(!strcmp(buff, "hkern"))            {  }
-    else if(!strcmp(buff, "image"))            {  }
-    else if(!strcmp(buff, "line"))
-    {
-        char* x1 = svgAttribute_getValue(currentElement, "x1");
-        char* y1 = svgAttribute_getValue(currentElement, "y1");
-        char* x2 = svgAttribute_getValue(currentElement, "x2");
-        char* y2 = svgAttribute_getValue(currentElement, "y2");
-
-        /* If the starting and ending points are the same, it is a point */
-        if(!strcmp(x1, x2) && !strcmp(y1, y2))
-            embPattern_addPointObjectAbs(p, atof(x1), atof(y1));
-        else
-            embPattern_addLineObjectAbs(p, atof(x1), atof(y1), atof(x2), atof(y2));
-    }
-    else if(!strcmp(buff, "linearGradient"))   {  }
-    else if(!strcmp(buff, "listener"))         {  }
-    else if(!strcmp(buff, "metadata"))         {  }
-    else if(!strcmp(buff, "missing-glyph"))    {  }
-    else if(!strcmp(buff, "mpath"))            {  }
-    else if(!strcmp(buff, "path"))
-    {
-        /* TODO: finish */
-
-        char* pointStr = svgAttribute_getValue(currentElement, "d");
-        char* mystrok = svgAttribute_getValue(currentElement, "stroke");
-
-        int last = strlen(pointStr);
-        int size = 32;
-        int i = 0;
-        int j = 0;
-        int pos = 0;
-        /* An odometer aka 'tripometer' used for stepping thru the pathData */
-        int trip = -1; /* count of float[] that has been filled. 0=first item of array, -1=not filled = empty array */
-        int reset = -1;
-        double xx = 0.0;
-        double yy = 0.0;
-        double fx = 0.0;
-        double fy = 0.0;
-        double lx = 0.0;
-        double ly = 0.0;
-        double cx1 = 0.0, cx2 = 0.0;
-        double cy1 = 0.0, cy2 = 0.0;
-        int cmd = 0;
-        double pathData[7];
-        unsigned int numMoves = 0;
-        int pendingTask = 0;
-        int relative = 0;
-
-        EmbPointList* startOfPointList = 0;
-        EmbPointList* pathObjPointList = 0;
-        EmbFlagList* startOfFlagList = 0;
-        EmbFlagList* pathObjFlagList = 0;
-
-        char* pathbuff = 0;
-        pathbuff = (char*)malloc(size);
-        if(!pathbuff) { embLog_error("format-svg.c svgAddToPattern(), cannot allocate memory for pathbuff\n"); return; }
-
-        printf("stroke:%s\n", mystrok);
-
-        /* M44.219,26.365c0,10.306-8.354,18.659-18.652,18.659c-10.299,0-18.663-8.354-18.663-18.659c0-10.305,8.354-18.659,18.659-18.659C35.867,7.707,44.219,16.06,44.219,26.365z */
-        for(i = 0; i < last; i++)
-        {
-            char c = pointStr[i];
-            switch(c)
-            {
-                case '0':
-                case '1':
-                case '2':
-                case '3':
-                case '4':
-                case '5':
-                case '6':
-                case '7':
-                case '8':
-                case '9':
-                case '.':
-                    pathbuff[pos++] = (char)c;                  /* add a more char */
-                    break;
+#define SVG_IS_SPACE(c) ((c) == ' ' || (c) == '\t' || (c) == '\r' || (c) == '\n')
 
-                case ' ':
-                case ',':
+static const char* svgSkipSpace(const char* p, const char* end)
+{
+    while(p < end && SVG_IS_SPACE(*p))
+        p++;
+    return p;
+}
 
-                    /*printf("    ,'%s'    ~POS=%d  ~TRIP=%d  ~[pos]=%d\n", pathbuff,pos,trip, pathbuff[pos]);*/
-                    if(pos > 0) {         /* append float to array, if it not yet stored */
-                        pathbuff[pos] = 0;
-                        pos = 0;
-                        printf("    ,val:%s\n", pathbuff);
-                        pathData[++trip] = atof(pathbuff);
-                    }
-                    break;
+/* Returns the number an attribute value starts with, or 0 if it does not start with one, as atof() did. */
+static double svgNumber(const char* value)
+{
+    double number = 0.0;
+    const char* end = value + strlen(value);
+    emb_fromChars(svgSkipSpace(value, end), end, &number);
+    return number;
+}
 
-                case '-':
+/* SVG has y down and libembroidery has y up, so every y is negated as it is added. */
+void svgAddToPattern(SvgReader* reader, EmbPattern* p)
+{
+    SvgElement* element = reader->element;
 
-                    if(pos > 0) {         /* append float to array, if it not yet stored */
-                        pathbuff[pos] = 0;
-                        pos = 0;
-                        printf("    -val:%s\n", pathbuff);
-                        pathData[++trip] = atof(pathbuff);
-                    }
-                    pathbuff[pos++] = (char)c;                  /* add a more char */
+    if(!p) { embLog_error("format-svg.c svgAddToPattern(), p argument is null\n"); return; }
+    if(!element) { return; }
+
+    switch(element->tag)
+    {
+        case SVG_TAG_CIRCLE:
+            embPattern_addCircleObjectAbs(p, svgNumber(svgAttribute_getValue(reader->element, "cx")),
+                                            -svgNumber(svgAttribute_getValue(reader->element, "cy")),
+                                             svgNumber(svgAttribute_getValue(reader->element, "r")));
+            break;
+        case SVG_TAG_ELLIPSE:
+            embPattern_addEllipseObjectAbs(p, svgNumber(svgAttribute_getValue(reader->element, "cx")),
+                                             -svgNumber(svgAttribute_getValue(reader->element, "cy")),
+                                              svgNumber(svgAttribute_getValue(reader->element, "rx")),
+                                              svgNumber(svgAttribute_getValue(reader->element, "ry")));
+            break;
+        case SVG_TAG_LINE:
+        {
+            char* x1 = svgAttribute_getValue(reader->element, "x1");
+            char* y1 = svgAttribute_getValue(reader->element, "y1");
+            char* x2 = svgAttribute_getValue(reader->element, "x2");
+            char* y2 = svgAttribute_getValue(reader->element, "y2");
+
+            /* If the starting and ending points are the same, it is a point */
+            if(!strcmp(x1, x2) && !strcmp(y1, y2))
+                embPattern_addPointObjectAbs(p, svgNumber(x1), -svgNumber(y1));
+            else
+                embPattern_addLineObjectAbs(p, svgNumber(x1), -svgNumber(y1), svgNumber(x2), -svgNumber(y2));
+            break;
+        }
+        case SVG_TAG_PATH:
+        {
+            char* pathData = svgAttribute_getValue(reader->element, "d");
+            int i;
+
+            if(!strcmp(pathData, "none"))
+                break;
+            embPathData_clear(&reader->pathData);
+            embFlatPath_clear(&reader->flatPath);
+            /* Whatever parsed before an error in the path data is still drawn */
+            embPathData_parse(&reader->pathData, pathData, strlen(pathData));
+            if(!embPathData_flatten(&reader->pathData, p->settings.curveTolerance,
+                                    p->readOptions.parallelFor, p->readOptions.parallelForData, &reader->flatPath) || !reader->flatPath.count)
+                break;
+            for(i = 0; i < reader->flatPath.count; i++)
+                reader->flatPath.points[i].yy = -reader->flatPath.points[i].yy;
+            embPattern_addPathObjectPoints(p, reader->flatPath.points, reader->flatPath.flags, reader->flatPath.count,
+                                           svgColorToEmbColor(svgAttribute_getValue(reader->element, "stroke")), 1); /* TODO: use lineType enum */
+            break;
+        }
+        case SVG_TAG_POLYGON:
+        case SVG_TAG_POLYLINE:
+        {
+            const char* pointStr = svgAttribute_getValue(reader->element, "points");
+            const char* end = pointStr + strlen(pointStr);
+            const char* next = 0;
+            double xx = 0.0;
+            double yy = 0.0;
+
+            EmbPointList* startOfPointList = 0;
+            EmbPointList* polyObjPointList = 0;
+
+            /* Pairs of coordinates up to the first thing that is not a number */
+            for(;;)
+            {
+                pointStr = svgSkipSpace(pointStr, end);
+                next = emb_fromChars(pointStr, end, &xx);
+                if(next == pointStr)
                     break;
-
-                default:
-                    /*** ASSUMED ANY COMMAND FOUND ***/
-
-
-                    if(pos > 0) {         /* just make sure: append float to array, if it not yet stored */
-                        pathbuff[pos] = 0;
-                        pos = 0;
-                        printf("    >val:%s\n", pathbuff);
-                        pathData[++trip] = atof(pathbuff);
-                    }
-
-                    /**** Compose Point List ****/
-
-                    /* below "while" is for avoid loosing last 'z' command that maybe never accomodated. */
-                    pendingTask = 1; if (i==last-1) {pendingTask = 2;}
-
-                    while (pendingTask > 0)
-                    {
-                        pendingTask -= 1;
-
-                    /* Check wether prior command need to be saved */
-                    if(trip>=0)
-                    {
-                            trip = -1;
-                            reset = -1;
-
-                            relative = 0; /* relative to prior coordinate point or absolute coordinate? */
-
-                            if     (cmd == 'M') { xx = pathData[0]; yy = pathData[1]; fx = xx; fy = yy; }
-                            else if(cmd == 'm') { xx = pathData[0]; yy = pathData[1]; fx = xx; fy = yy; relative=1; }
-                            else if(cmd == 'L') { xx = pathData[0]; yy = pathData[1]; }
-                            else if(cmd == 'l') { xx = pathData[0]; yy = pathData[1]; relative=1;}
-                            else if(cmd == 'H') { xx = pathData[0]; yy = ly; }
-                            else if(cmd == 'h') { xx = pathData[0]; yy = ly; relative=1;}
-                            else if(cmd == 'V') { xx = lx;          yy = pathData[1]; }
-                            else if(cmd == 'v') { xx = lx;          yy = pathData[1]; relative=1;}
-                            else if(cmd == 'C') { xx = pathData[4]; yy = pathData[5]; cx1 = pathData[0]; cy1 = pathData[1]; cx2 = pathData[2]; cy2 = pathData[3]; }
-                            else if(cmd == 'c') { xx = pathData[4]; yy = pathData[5]; cx1 = pathData[0]; cy1 = pathData[1]; cx2 = pathData[2]; cy2 = pathData[3]; relative=1;}
-                            /*
-                            else if(cmd == 'S') { xx = pathData[0]; yy = pathData[1]; }
-                            else if(cmd == 's') { xx = pathData[0]; yy = pathData[1]; }
-                            else if(cmd == 'Q') { xx = pathData[0]; yy = pathData[1]; }
-                            else if(cmd == 'q') { xx = pathData[0]; yy = pathData[1]; }
-                            else if(cmd == 'T') { xx = pathData[0]; yy = pathData[1]; }
-                            else if(cmd == 't') { xx = pathData[0]; yy = pathData[1]; }
-                            else if(cmd == 'A') { xx = pathData[0]; yy = pathData[1]; }
-                            else if(cmd == 'a') { xx = pathData[0]; yy = pathData[1]; }
-                            */
-                            else if(cmd == 'Z') { xx = fx;          yy = fy; }
-                            else if(cmd == 'z') { xx = fx;          yy = fy; }
-
-                            if(!pathObjPointList && !pathObjFlagList)
-                            {
-                                pathObjPointList = embPointList_create(xx, yy);
-                                startOfPointList = pathObjPointList;
-                                pathObjFlagList = embFlagList_create(svgPathCmdToEmbPathFlag(cmd));
-                                startOfFlagList = pathObjFlagList;
-                            }
-                            else
-                            {
-                                pathObjPointList = embPointList_add(pathObjPointList, embPoint_make(xx, yy));
-                                pathObjFlagList = embFlagList_add(pathObjFlagList, svgPathCmdToEmbPathFlag(cmd));
-                            }
-                            lx = xx; ly = yy;
-
-                            pathbuff[0] = (char)cmd;                  /* set the command for compare */
-                            pathbuff[1] = 0;
-                            pos = 0;
-
-                            printf("*prior:%s (%f, %f,  %f, %f,     %f,%f,  %f) \n", pathbuff,
-                                   pathData[0],
-                                   pathData[1],
-                                   pathData[2],
-                                   pathData[3],
-                                   pathData[4],
-                                   pathData[5],
-                                   pathData[6]
-                                   );
-
-                    }
-
-                    /* assign new command */
-                    if(trip == -1 && reset == -1)
-                    {
-                        pathbuff[0] = (char)c;                  /* set the command for compare */
-                        pathbuff[1] = 0;
-
-                        printf("cmd:%s\n", pathbuff);
-                        if     (!strcmp(pathbuff, "M")) { cmd = 'M'; reset = 2; numMoves++; }
-                        else if(!strcmp(pathbuff, "m")) { cmd = 'm'; reset = 2; numMoves++; }
-                        else if(!strcmp(pathbuff, "L")) { cmd = 'L'; reset = 2; }
-                        else if(!strcmp(pathbuff, "l")) { cmd = 'l'; reset = 2; }
-                        else if(!strcmp(pathbuff, "C")) { cmd = 'C'; reset = 6; }
-                        else if(!strcmp(pathbuff, "c")) { cmd = 'c'; reset = 6; }
-                        else if(!strcmp(pathbuff, "H")) { cmd = 'H'; reset = 1; }
-                        else if(!strcmp(pathbuff, "h")) { cmd = 'h'; reset = 1; }
-                        else if(!strcmp(pathbuff, "V")) { cmd = 'V'; reset = 1; }
-                        else if(!strcmp(pathbuff, "v")) { cmd = 'v'; reset = 1; }
-                        else if(!strcmp(pathbuff, "S")) { cmd = 'S'; reset = 4; }
-                        else if(!strcmp(pathbuff, "s")) { cmd = 's'; reset = 4; }
-                        else if(!strcmp(pathbuff, "Q")) { cmd = 'Q'; reset = 4; }
-                        else if(!strcmp(pathbuff, "q")) { cmd = 'q'; reset = 4; }
-                        else if(!strcmp(pathbuff, "T")) { cmd = 'T'; reset = 2; }
-                        else if(!strcmp(pathbuff, "t")) { cmd = 't'; reset = 2; }
-                        else if(!strcmp(pathbuff, "A")) { cmd = 'A'; reset = 7; }
-                        else if(!strcmp(pathbuff, "a")) { cmd = 'a'; reset = 7; }
-                        else if(!strcmp(pathbuff, "Z")) { cmd = 'Z'; reset = 0; }
-                        else if(!strcmp(pathbuff, "z")) { cmd = 'z'; reset = 0; }
-                        else {
-                            embLog_error("format-svg.c svgAddToPattern(), %s is not a valid svg path command, skipping...\n", pathbuff);
-                            trip = -1;
-                            reset = -1;
-                        }
-                    }
-                    /* avoid loosing 'z' command that maybe never accomodated. */
-                        if (i==last-1) {
-                            trip = 2;
-                        }
-                    } /* while pendingTask */
-
-
+                pointStr = svgSkipSpace(next, end);
+                next = emb_fromChars(pointStr, end, &yy);
+                if(next == pointStr)
                     break;
+                pointStr = next;
+
+                if(!polyObjPointList)
+                {
+                    polyObjPointList = embPointList_create(xx, -yy);
+                    startOfPointList = polyObjPointList;
+                }
+                else
+                {
+                    polyObjPointList = embPointList_add(polyObjPointList, embPoint_make(xx, -yy));
+                }
             }
-            if(pos >= size - 1)
-            {
-                /* increase pathbuff length - leave room for 0 */
-                size *= 2;
-                pathbuff = (char*)realloc(pathbuff, size);
-                if(!pathbuff) { embLog_error("format-svg.c svgAddToPattern(), cannot re-allocate memory for pathbuff\n"); return; }
-            }
-        }
-        free(pathbuff);
-        pathbuff = 0;
-
-        /* TODO: subdivide numMoves > 1 */
 
-        embPattern_addPathObjectAbs(p, embPathObject_create(startOfPointList, startOfFlagList, svgColorToEmbColor(svgAttribute_getValue(currentElement, "stroke")), 1));
-    }
-    else if(!strcmp(buff, "polygon") ||
-            !strcmp(buff, "polyline"))
-    {
-        char* pointStr = svgAttribute_getValue(currentElement, "points");
-        int last = strlen(pointStr);
-        int size = 32;
-        int i = 0;
-        int c = 0;
-        int pos = 0;
-        unsigned char odd = 1;
-        double xx = 0.0;
-        double yy = 0.0;
-
-        EmbPointList* startOfPointList = 0;
-        EmbPointList* polyObjPointList = 0;
-
-        char* polybuff = 0;
-        polybuff = (char*)malloc(size);
-        if(!polybuff) { embLog_error("format-svg.c svgAddToPattern(), cannot allocate memory for polybuff\n"); return; }
-
-        for(i = 0; i < last; i++)
-        {
-            char c = pointStr[i];
-            switch(c)
+            if(element->tag == SVG_TAG_POLYGON)
             {
-                case ' ':
-                    if(pos == 0)
-                        break;
-                    polybuff[pos] = 0;
-                    pos = 0;
-                    /*Compose Point List */
-                    if(odd)
-                    {
-                        odd = 0;
-                        xx = atof(polybuff);
-                    }
-                    else
-                    {
-                        odd = 1;
-                        yy = atof(polybuff);
-
-                        if(!polyObjPointList)
-                        {
-                            polyObjPointList = embPointList_create(xx, yy);
-                            startOfPointList = polyObjPointList;
-                        }
-                        else
-                        {
-                            polyObjPointList = embPointList_add(polyObjPointList, embPoint_make(xx, yy));
-                        }
-                    }
-
-                    break;
-                default:
-                    polybuff[pos++] = (char)c;
-                    break;
+                EmbPolygonObject* polygonObj = embPolygonObject_create(startOfPointList, svgColorToEmbColor(svgAttribute_getValue(reader->element, "stroke")), 1); /* TODO: use lineType enum */
+                embPattern_addPolygonObjectAbs(p, polygonObj);
             }
-            if(pos >= size - 1)
+            else /* polyline */
             {
-                /* increase polybuff length - leave room for 0 */
-                size *= 2;
-                polybuff = (char*)realloc(polybuff, size);
-                if(!polybuff) { embLog_error("format-svg.c svgAddToPattern(), cannot re-allocate memory for polybuff\n"); return; }
+                EmbPolylineObject* polylineObj = embPolylineObject_create(startOfPointList, svgColorToEmbColor(svgAttribute_getValue(reader->element, "stroke")), 1); /* TODO: use lineType enum */
+                embPattern_addPolylineObjectAbs(p, polylineObj);
             }
+            break;
         }
-        free(polybuff);
-        polybuff = 0;
-
-        if(!strcmp(buff, "polygon"))
-        {
-            EmbPolygonObject* polygonObj = embPolygonObject_create(startOfPointList, svgColorToEmbColor(svgAttribute_getValue(currentElement, "stroke")), 1); /* TODO: use lineType enum */
-            embPattern_addPolygonObjectAbs(p, polygonObj);
-        }
-        else /* polyline */
-        {
-            EmbPolylineObject* polylineObj = embPolylineObject_create(startOfPointList, svgColorToEmbColor(svgAttribute_getValue(currentElement, "stroke")), 1); /* TODO: use lineType enum */
-            embPattern_addPolylineObjectAbs(p, polylineObj);
-        }
+        case SVG_TAG_RECT:
+            embPattern_addRectObjectAbs(p, svgNumber(svgAttribute_getValue(reader->element, "x")),
+                                          -svgNumber(svgAttribute_getValue(reader->element, "y")),
+                                           svgNumber(svgAttribute_getValue(reader->element, "width")),
+                                          -svgNumber(svgAttribute_getValue(reader->element, "height")));
+            break;
+        default: /* The other elements do not add anything to the design yet */
+            break;
     }
-    else if(!strcmp(buff, "prefetch"))         {  }
-    else if(!strcmp(buff, "radialGradient"))   {  }
-    else if(!strcmp(buff, "rect"))
-    {
-        embPattern_addRectObjectAbs(p, atof(svgAttribute_getValue(currentElement, "x")),
-                                       atof(svgAttribute_getValue(currentElement, "y")),
-                                       atof(svgAttribute_getValue(currentElement, "width")),
-                                       atof(svgAttribute_getValue(currentElement, "height")));
-    }
-    else if(!strcmp(buff, "script"))           {  }
-    else if(!strcmp(buff, "set"))              {  }
-    else if(!strcmp(buff, "solidColor"))       {  }
-    else if(!strcmp(buff, "stop"))             {  }
-    else if(!strcmp(buff, "svg"))              {  }
-    else if(!strcmp(buff, "switch"))           {  }
-    else if(!strcmp(buff, "tbreak"))           {  }
-    else if(!strcmp(buff, "text"))             {  }
-    else if(!strcmp(buff, "textArea"))         {  }
-    else if(!strcmp(buff, "title"))            {  }
-    else if(!strcmp(buff, "tspan"))            {  }
-    else if(!strcmp(buff, "use"))              {  }
-    else if(!strcmp(buff, "video"))            {  }
-
-    svgElement_free(currentElement);
-    currentElement = 0;
-}
-
-
-int svgIsElement(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "?xml"))                { type = SVG_NULL; } /* TODO: Fix the xml version ? messing with svg version */
-    else if(!strcmp(buff, "a"))                   { type = SVG_ELEMENT; }
- /* else if(!strcmp(buff, "altGlyph"))            { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "altGlyphDef"))         { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "altGlyphItem"))        { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
-    else if(!strcmp(buff, "animate"))             { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "animateColor"))        { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "animateMotion"))       { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "animateTransform"))    { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "animation"))           { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "audio"))               { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "circle"))              { type = SVG_ELEMENT; }
- /* else if(!strcmp(buff, "clipPath"))            { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "color-profile"))       { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "cursor"))              { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
-    else if(!strcmp(buff, "defs"))                { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "desc"))                { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "discard"))             { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "ellipse"))             { type = SVG_ELEMENT; }
- /* else if(!strcmp(buff, "feBlend"))             { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feColorMatrix"))       { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feComponentTransfer")) { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feComposite"))         { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feConvolveMatrix"))    { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feDiffuseLighting"))   { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feDisplacementMap"))   { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feDistantLight"))      { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feFlood"))             { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feFuncA"))             { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feFuncB"))             { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feFuncG"))             { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feFuncR"))             { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feGaussianBlur"))      { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feImage"))             { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feMerge"))             { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feMergeNode"))         { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feMorphology"))        { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feOffset"))            { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "fePointLight"))        { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feSpecularLighting"))  { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feSpotLight"))         { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feTile"))              { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "feTurbulence"))        { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "filter"))              { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
-    else if(!strcmp(buff, "font"))                { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "font-face"))           { type = SVG_ELEMENT; }
- /* else if(!strcmp(buff, "font-face-format"))    { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "font-face-name"))      { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
-    else if(!strcmp(buff, "font-face-src"))       { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "font-face-uri"))       { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "foreignObject"))       { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "g"))                   { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "glyph"))               { type = SVG_ELEMENT; }
- /* else if(!strcmp(buff, "glyphRef"))            { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
-    else if(!strcmp(buff, "handler"))             { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "hkern"))               { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "image"))               { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "line"))                { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "linearGradient"))      { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "listener"))            { type = SVG_ELEMENT; }
- /* else if(!strcmp(buff, "marker"))              { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "mask"))                { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
-    else if(!strcmp(buff, "metadata"))            { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "missing-glyph"))       { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "mpath"))               { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "path"))                { type = SVG_ELEMENT; }
- /* else if(!strcmp(buff, "pattern"))             { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
-    else if(!strcmp(buff, "polygon"))             { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "polyline"))            { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "prefetch"))            { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "radialGradient"))      { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "rect"))                { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "script"))              { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "set"))                 { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "solidColor"))          { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "stop"))                { type = SVG_ELEMENT; }
- /* else if(!strcmp(buff, "style"))               { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
-    else if(!strcmp(buff, "svg"))                 { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "switch"))              { type = SVG_ELEMENT; }
- /* else if(!strcmp(buff, "symbol"))              { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
-    else if(!strcmp(buff, "tbreak"))              { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "text"))                { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "textArea"))            { type = SVG_ELEMENT; }
- /* else if(!strcmp(buff, "textPath"))            { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
-    else if(!strcmp(buff, "title"))               { type = SVG_ELEMENT; }
- /* else if(!strcmp(buff, "tref"))                { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
-    else if(!strcmp(buff, "tspan"))               { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "use"))                 { type = SVG_ELEMENT; }
-    else if(!strcmp(buff, "video"))               { type = SVG_ELEMENT; }
- /* else if(!strcmp(buff, "view"))                { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
- /* else if(!strcmp(buff, "vkern"))               { type = SVG_ELEMENT; } TODO: SVG Full 1.1 Spec Element */
-
-    /* Attempt to identify the program that created the SVG file. This should be in a comment at that occurs before the svg element. */
-    else if(!strcmp(buff, "Embroidermodder"))     { type = SVG_NULL; svgCreator = SVG_CREATOR_EMBROIDERMODDER; }
-    else if(!strcmp(buff, "Illustrator"))         { type = SVG_NULL; svgCreator = SVG_CREATOR_ILLUSTRATOR; }
-    else if(!strcmp(buff, "Inkscape"))            { type = SVG_NULL; svgCreator = SVG_CREATOR_INKSCAPE; }
-
-    else                                          { type = SVG_NULL; }
-    return type;
-}
-
-int svgIsMediaProperty(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "audio-level"))           { type = SVG_MEDIA_PROPERTY; }
-    else if(!strcmp(buff, "buffered-rendering"))    { type = SVG_MEDIA_PROPERTY; }
-    else if(!strcmp(buff, "display"))               { type = SVG_MEDIA_PROPERTY; }
-    else if(!strcmp(buff, "image-rendering"))       { type = SVG_MEDIA_PROPERTY; }
-    else if(!strcmp(buff, "pointer-events"))        { type = SVG_MEDIA_PROPERTY; }
-    else if(!strcmp(buff, "shape-rendering"))       { type = SVG_MEDIA_PROPERTY; }
-    else if(!strcmp(buff, "text-rendering"))        { type = SVG_MEDIA_PROPERTY; }
-    else if(!strcmp(buff, "viewport-fill"))         { type = SVG_MEDIA_PROPERTY; }
-    else if(!strcmp(buff, "viewport-fill-opacity")) { type = SVG_MEDIA_PROPERTY; }
-    else if(!strcmp(buff, "visibility"))            { type = SVG_MEDIA_PROPERTY; }
-    return type;
-}
-
-int svgIsProperty(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "audio-level"))           { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "buffered-rendering"))    { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "color"))                 { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "color-rendering"))       { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "direction"))             { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "display"))               { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "display-align"))         { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "fill"))                  { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "fill-opacity"))          { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "fill-rule"))             { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "font-family"))           { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "font-size"))             { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "font-style"))            { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "font-variant"))          { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "font-weight"))           { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "image-rendering"))       { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "line-increment"))        { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "opacity"))               { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "pointer-events"))        { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "shape-rendering"))       { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "solid-color"))           { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "solid-opacity"))         { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "stop-color"))            { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "stop-opacity"))          { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "stroke"))                { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "stroke-dasharray"))      { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "stroke-linecap"))        { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "stroke-linejoin"))       { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "stroke-miterlimit"))     { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "stroke-opacity"))        { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "stroke-width"))          { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "text-align"))            { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "text-anchor"))           { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "text-rendering"))        { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "unicode-bidi"))          { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "vector-effect"))         { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "viewport-fill"))         { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "viewport-fill-opacity")) { type = SVG_PROPERTY; }
-    else if(!strcmp(buff, "visibility"))            { type = SVG_PROPERTY; }
-    return type;
-}
-
-int svgIsXmlAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "encoding"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "standalone")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "version"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))          { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsXmlAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsLinkAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "target"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsLinkAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsAnimateAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "accumulate"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "additive"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "attributeName"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "attributeType"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "begin"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "by"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "calcMode"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "dur"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "end"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "fill"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "from"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "keySplines"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "keyTimes"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "max"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "min"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatCount"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatDur"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "restart"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "to"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "values"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsAnimateAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsAnimateColorAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "accumulate"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "additive"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "attributeName"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "attributeType"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "begin"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "by"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "calcMode"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "dur"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "end"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "fill"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "from"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "keySplines"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "keyTimes"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "max"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "min"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatCount"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatDur"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "restart"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "to"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "values"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsAnimateColorAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsAnimateMotionAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "accumulate"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "additive"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "begin"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "by"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "calcMode"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "dur"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "end"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "fill"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "from"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "keyPoints"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "keySplines"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "keyTimes"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "max"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "min"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "origin"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "path"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatCount"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatDur"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "restart"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rotate"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "to"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "values"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsAnimateMotionAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsAnimateTransformAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "accumulate"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "additive"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "attributeName"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "attributeType"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "begin"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "by"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "calcMode"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "dur"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "end"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "fill"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "from"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "keySplines"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "keyTimes"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "max"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "min"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatCount"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatDur"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "restart"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "to"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "type"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "values"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsAnimateTransformAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsAnimationAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "begin"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "dur"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "end"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "fill"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "height"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "initialVisibility"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "max"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "min"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "preserveAspectRatio"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatCount"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatDur"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "restart"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "syncBehavior"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "syncMaster"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "syncTolerance"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "width"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "x"))                         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "y"))                         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsAnimationAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsAudioAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "begin"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "dur"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "end"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "fill"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "max"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "min"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatCount"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatDur"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "restart"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "syncBehavior"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "syncMaster"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "syncTolerance"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "type"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsAudioAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsCircleAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "cx"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "cy"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "r"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsCircleAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsDefsAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsDefsAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsDescAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsDescAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsDiscardAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "begin"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsDiscardAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsEllipseAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "cx"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "cy"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rx"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "ry"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsEllipseAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsFontAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "horiz-adv-x"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "horiz-origin-x"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsFontAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsFontFaceAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "accent-height"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "alphabetic"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "ascent"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "bbox"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "cap-height"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "descent"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "font-family"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "font-stretch"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "font-style"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "font-variant"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "font-weight"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "hanging"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "ideographic"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "mathematical"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "overline-position"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "overline-thickness"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "panose-1"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "slope"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "stemh"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "stemv"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "strikethrough-position"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "strikethrough-thickness"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "underline-position"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "underline-thickness"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "unicode-range"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "units-per-em"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "widths"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "x-height"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsFontFaceAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsFontFaceSrcAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsFontFaceSrcAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsFontFaceUriAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsFontFaceUriAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsForeignObjectAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "height"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "width"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "x"))                         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "y"))                         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsForeignObjectAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsGroupAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsGroupAttribute(), unknown: %s\n", buff); }
-    return type;
-}
 
-int svgIsGlyphAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "arabic-form")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "d"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "glyph-name"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "horiz-adv-x")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "lang"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "unicode"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))           { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsGlyphAttribute(), unknown: %s\n", buff); }
-    return type;
+    svgElement_free(reader, element);
+    reader->element = 0;
 }
 
-int svgIsHandlerAttribute(const char* buff)
+/* FNV-1a over the (length) characters at (s), starting from (seed) instead of the usual offset basis when it is not 0. */
+static unsigned int svgHash(unsigned int seed, const char* s, size_t length)
 {
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "ev:event"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "type"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsHandlerAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsHKernAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "g1"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "g2"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "k"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "u1"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "u2"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsHKernAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsImageAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "height"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "opacity"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "preserveAspectRatio"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "type"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "width"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "x"))                         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "y"))                         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsImageAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsLineAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "x1"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "x2"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "y1"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "y2"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsLineAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsLinearGradientAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "gradientUnits")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "x1"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "x2"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "y1"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "y2"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))             { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsLinearGradientAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsListenerAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "defaultAction")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "event"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "handler"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "observer"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "phase"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "propagate"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "target"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))             { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsListenerAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsMetadataAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsMetadataAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsMissingGlyphAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "d"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "horiz-adv-x")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))           { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsMissingGlyphAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsMPathAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))             { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsMPathAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsPathAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "d"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "pathLength"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsPathAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsPolygonAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "points"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsPolygonAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsPolylineAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "points"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsPolylineAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsPrefetchAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "bandwidth"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "mediaCharacterEncoding")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "mediaContentEncodings"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "mediaSize"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "mediaTime"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                      { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsPrefetchAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsRadialGradientAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "cx"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "cy"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "gradientUnits")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "r"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))             { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsRadialGradientAttribute(), unknown: %s\n", buff); }
-    return type;
+    unsigned int h = seed ? seed : 2166136261u;
+    size_t i;
+    for(i = 0; i < length; i++)
+    {
+        h ^= (unsigned char)s[i];
+        h = (h * 16777619u) & 0xFFFFFFFFu;
+    }
+    return h;
 }
 
-int svgIsRectAttribute(const char* buff)
+/* Looks up a name in a perfect hash table: the plain hash picks a bucket, whose seed gives the one slot the name
+ * can be in. Returns the index of the name in (names), or -1 if it is not there. */
+static int svgLookup(const char* name, size_t length, const unsigned short* seeds, unsigned int buckets,
+                     const unsigned char* slots, unsigned int slotCount, const char* const* names)
 {
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "height"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rx"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "ry"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "width"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "x"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "y"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsRectAttribute(), unknown: %s\n", buff); }
-    return type;
-}
+    unsigned int seed = seeds[svgHash(0, name, length) % buckets];
+    int slot = slots[svgHash(seed, name, length) % slotCount];
+    const char* candidate = 0;
 
-int svgIsScriptAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "type"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsScriptAttribute(), unknown: %s\n", buff); }
-    return type;
+    if(!slot) return -1;
+    candidate = names[slot - 1];
+    if(strncmp(candidate, name, length) || candidate[length]) return -1;
+    return slot - 1;
 }
 
-int svgIsSetAttribute(const char* buff)
+/* Returns the SVG_TAG of the element called (name), or -1 if it is not an SVG Tiny element. */
+static int svgTagLookup(const char* name, size_t length)
 {
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "attributeName"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "attributeType"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "begin"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "dur"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "end"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "fill"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "max"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "min"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatCount"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatDur"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "to"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsSetAttribute(), unknown: %s\n", buff); }
-    return type;
+    return svgLookup(name, length, svgTagSeeds, SVG_TAG_BUCKETS, svgTagSlots, SVG_TAG_SLOTS, svgTagNames);
 }
 
-int svgIsSolidColorAttribute(const char* buff)
+/* Returns the index in svgAttributeNames of the attribute called (name), or -1 if no element takes it. */
+static int svgAttributeLookup(const char* name, size_t length)
 {
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsSolidColorAttribute(), unknown: %s\n", buff); }
-    return type;
+    return svgLookup(name, length, svgAttributeSeeds, SVG_ATTRIBUTE_BUCKETS, svgAttributeSlots, SVG_ATTRIBUTE_SLOTS, svgAttributeNames);
 }
 
-int svgIsStopAttribute(const char* buff)
+static int svgTagAccepts(const SvgReader* reader, int tag, int attribute)
 {
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "offset"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsStopAttribute(), unknown: %s\n", buff); }
-    return type;
+    unsigned char bit = (unsigned char)(1 << (attribute % 8));
+    if(svgTagAttributes[tag][attribute / 8] & bit)
+        return 1;
+    return tag == SVG_TAG_SVG && reader->creator == SVG_CREATOR_INKSCAPE && (svgInkscapeAttributes[attribute / 8] & bit);
 }
 
-int svgIsSvgAttribute(const char* buff)
+/* Returns where (token) first occurs in [p, end), or (end) if it does not. */
+static const char* svgFind(const char* p, const char* end, const char* token)
 {
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "baseProfile"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "contentScriptType"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "height"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "playbackOrder"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "preserveAspectRatio"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "snapshotTime"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "syncBehaviorDefault"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "syncToleranceDefault"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "timelineBegin"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "version"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "viewBox"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "width"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "zoomAndPan"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-    else if(svgCreator == SVG_CREATOR_INKSCAPE)
+    size_t length = strlen(token);
+    while((size_t)(end - p) >= length)
     {
-        if     (!strcmp(buff, "xmlns:dc"))              { type = SVG_ATTRIBUTE; }
-        else if(!strcmp(buff, "xmlns:cc"))              { type = SVG_ATTRIBUTE; }
-        else if(!strcmp(buff, "xmlns:rdf"))             { type = SVG_ATTRIBUTE; }
-        else if(!strcmp(buff, "xmlns:svg"))             { type = SVG_ATTRIBUTE; }
-        else if(!strcmp(buff, "xmlns"))                 { type = SVG_ATTRIBUTE; }
+        p = (const char*)memchr(p, token[0], (size_t)(end - p) - length + 1);
+        if(!p) return end;
+        if(!memcmp(p, token, length)) return p;
+        p++;
     }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsSvgAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsSwitchAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsSwitchAttribute(), unknown: %s\n", buff); }
-    return type;
-}
-
-int svgIsTBreakAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsTBreakAttribute(), unknown: %s\n", buff); }
-    return type;
+    return end;
 }
 
-int svgIsTextAttribute(const char* buff)
+/* Attempts to identify the program that created the SVG file from the words of a comment, which should occur before the svg element. */
+static void svgDetectCreator(SvgReader* reader, const char* p, const char* end)
 {
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "editable"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rotate"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "x"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "y"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsTextAttribute(), unknown: %s\n", buff); }
-    return type;
-}
+    while(p < end)
+    {
+        const char* word = 0;
+        size_t length = 0;
 
-int svgIsTextAreaAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "editable"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "height"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "width"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "x"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "y"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsTextAreaAttribute(), unknown: %s\n", buff); }
-    return type;
-}
+        while(p < end && SVG_IS_SPACE(*p)) p++;
+        word = p;
+        while(p < end && !SVG_IS_SPACE(*p)) p++;
+        length = (size_t)(p - word);
 
-int svgIsTitleAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsTitleAttribute(), unknown: %s\n", buff); }
-    return type;
+        if     (length == 15 && !memcmp(word, "Embroidermodder", 15)) { reader->creator = SVG_CREATOR_EMBROIDERMODDER; }
+        else if(length == 11 && !memcmp(word, "Illustrator", 11))     { reader->creator = SVG_CREATOR_ILLUSTRATOR; }
+        else if(length == 8  && !memcmp(word, "Inkscape", 8))         { reader->creator = SVG_CREATOR_INKSCAPE; }
+    }
 }
 
-int svgIsTSpanAttribute(const char* buff)
+/* Reads the attributes of a start tag from (p) up to and including its closing '>', adding those the current element
+ * accepts to it. Returns where the tag ends. */
+static const char* svgParseAttributes(SvgReader* reader, const char* p, const char* end)
 {
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                  { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsTSpanAttribute(), unknown: %s\n", buff); }
-    return type;
-}
+    for(;;)
+    {
+        const char* name = 0;
+        const char* value = 0;
+        size_t nameLength = 0;
+        int attribute = 0;
 
-int svgIsUseAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "x"))                         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "y"))                         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsUseAttribute(), unknown: %s\n", buff); }
-    return type;
-}
+        while(p < end && SVG_IS_SPACE(*p)) p++;
+        if(p >= end) return end;
+        if(*p == '>') return p + 1;
+        if(*p == '/') { p++; continue; }
 
-int svgIsVideoAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    if     (!strcmp(buff, "about"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "begin"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "dur"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "end"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "fill"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusHighlight"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "focusable"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "height"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "initialVisibility"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "max"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "min"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-left"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-down-right"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-left"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-next"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-prev"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-right"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-left"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "nav-up-right"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "overlay"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "preserveAspectRatio"))       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatCount"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "repeatDur"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredExtensions"))        { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFeatures"))          { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFonts"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "requiredFormats"))           { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "restart"))                   { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "syncBehavior"))              { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "syncMaster"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "syncTolerance"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "systemLanguage"))            { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transform"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "transformBehavior"))         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "type"))                      { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "width"))                     { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "x"))                         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:actuate"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:arcrole"))             { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:href"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:role"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:show"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:title"))               { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xlink:type"))                { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "y"))                         { type = SVG_ATTRIBUTE; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_ATTRIBUTE; }
-
-    if(type == SVG_NULL) { embLog_print("format-svg.c svgIsVideoAttribute(), unknown: %s\n", buff); }
-    return type;
-}
+        name = p;
+        while(p < end && !SVG_IS_SPACE(*p) && *p != '=' && *p != '>' && *p != '/') p++;
+        nameLength = (size_t)(p - name);
+        while(p < end && SVG_IS_SPACE(*p)) p++;
+        if(p >= end || *p != '=') continue; /* an attribute without a value */
+        p++;
+        while(p < end && SVG_IS_SPACE(*p)) p++;
 
+        value = p;
+        if(p < end && (*p == '"' || *p == '\''))
+        {
+            const char* close = (const char*)memchr(p + 1, *p, (size_t)(end - p - 1));
+            p = close ? close + 1 : end;
+        }
+        else
+        {
+            while(p < end && !SVG_IS_SPACE(*p) && *p != '>') p++;
+        }
 
-int svgIsCatchAllAttribute(const char* buff)
-{
-    int type = SVG_NULL;
-    /* Catch All Properties */
-    if     (!strcmp(buff, "audio-level"))               { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "buffered-rendering"))        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "color"))                     { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "color-rendering"))           { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "direction"))                 { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "display"))                   { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "display-align"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "fill"))                      { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "fill-opacity"))              { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "fill-rule"))                 { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "font-family"))               { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "font-size"))                 { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "font-style"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "font-variant"))              { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "font-weight"))               { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "image-rendering"))           { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "line-increment"))            { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "opacity"))                   { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "pointer-events"))            { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "shape-rendering"))           { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "solid-color"))               { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "solid-opacity"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "stop-color"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "stop-opacity"))              { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "stroke"))                    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "stroke-dasharray"))          { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "stroke-linecap"))            { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "stroke-linejoin"))           { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "stroke-miterlimit"))         { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "stroke-opacity"))            { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "stroke-width"))              { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "text-align"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "text-anchor"))               { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "text-rendering"))            { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "unicode-bidi"))              { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "vector-effect"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "viewport-fill"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "viewport-fill-opacity"))     { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "visibility"))                { type = SVG_CATCH_ALL; }
-    /* Catch All Attributes */
-    else if(!strcmp(buff, "about"))                     { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "accent-height"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "accumulate"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "additive"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "alphabetic"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "arabic-form"))               { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "ascent"))                    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "attributeName"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "attributeType"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "bandwidth"))                 { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "baseProfile"))               { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "bbox"))                      { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "begin"))                     { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "by"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "calcMode"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "cap-height"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "class"))                     { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "content"))                   { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "contentScriptType"))         { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "cx"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "cy"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "d"))                         { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "datatype"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "defaultAction"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "descent"))                   { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "dur"))                       { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "editable"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "end"))                       { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "ev:event"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "event"))                     { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "externalResourcesRequired")) { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "focusHighlight"))            { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "focusable"))                 { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "font-family"))               { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "font-stretch"))              { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "font-style"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "font-variant"))              { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "font-weight"))               { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "from"))                      { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "g1"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "g2"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "glyph-name"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "gradientUnits"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "handler"))                   { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "hanging"))                   { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "height"))                    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "horiz-adv-x"))               { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "horiz-origin-x"))            { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "id"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "ideographic"))               { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "initialVisibility"))         { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "k"))                         { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "keyPoints"))                 { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "keySplines"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "keyTimes"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "lang"))                      { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "mathematical"))              { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "max"))                       { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "mediaCharacterEncoding"))    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "mediaContentEncodings"))     { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "mediaSize"))                 { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "mediaTime"))                 { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "min"))                       { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "nav-down"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "nav-down-left"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "nav-down-right"))            { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "nav-left"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "nav-next"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "nav-prev"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "nav-right"))                 { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "nav-up"))                    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "nav-up-left"))               { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "nav-up-right"))              { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "observer"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "offset"))                    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "origin"))                    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "overlay"))                   { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "overline-position"))         { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "overline-thickness"))        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "panose-1"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "path"))                      { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "pathLength"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "phase"))                     { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "playbackOrder"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "points"))                    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "preserveAspectRatio"))       { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "propagate"))                 { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "property"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "r"))                         { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "rel"))                       { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "repeatCount"))               { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "repeatDur"))                 { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "requiredExtensions"))        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "requiredFeatures"))          { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "requiredFonts"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "requiredFormats"))           { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "resource"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "restart"))                   { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "rev"))                       { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "role"))                      { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "rotate"))                    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "rx"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "ry"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "slope"))                     { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "snapshotTime"))              { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "stemh"))                     { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "stemv"))                     { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "strikethrough-position"))    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "strikethrough-thickness"))   { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "syncBehavior"))              { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "syncBehaviorDefault"))       { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "syncMaster"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "syncTolerance"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "syncToleranceDefault"))      { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "systemLanguage"))            { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "target"))                    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "timelineBegin"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "to"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "transform"))                 { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "transformBehavior"))         { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "type"))                      { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "typeof"))                    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "u1"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "u2"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "underline-position"))        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "underline-thickness"))       { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "unicode"))                   { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "unicode-range"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "units-per-em"))              { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "values"))                    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "version"))                   { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "viewBox"))                   { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "width"))                     { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "widths"))                    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "x"))                         { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "x-height"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "x1"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "x2"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "xlink:actuate"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "xlink:arcrole"))             { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "xlink:href"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "xlink:role"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "xlink:show"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "xlink:title"))               { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "xlink:type"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "xml:base"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "xml:id"))                    { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "xml:lang"))                  { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "xml:space"))                 { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "y"))                         { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "y1"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "y2"))                        { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "zoomAndPan"))                { type = SVG_CATCH_ALL; }
-    else if(!strcmp(buff, "/"))                         { type = SVG_CATCH_ALL; }
-    return type;
+        if(!reader->element) continue;
+        attribute = svgAttributeLookup(name, nameLength);
+        if(attribute >= 0 && svgTagAccepts(reader, reader->element->tag, attribute))
+            svgElement_addAttribute(reader, reader->element, svgAttribute_create(reader, svgAttributeNames[attribute], value, (size_t)(p - value)));
+    }
 }
 
-void svgProcess(int c, const char* buff)
+/* Walks the markup in [p, end), adding each element to (pattern) as soon as its start tag has been read.
+ * Names are matched in place and only accepted attribute values are copied. */
+static void svgParse(SvgReader* reader, EmbPattern* pattern, const char* p, const char* end)
 {
-    if(svgExpect == SVG_EXPECT_ELEMENT)
-    {
-        char advance = 0;
-        if(buff[0] == '/') { return; }
-
-        advance = (char)svgIsElement(buff);
-
-        if(advance) { printf("ELEMENT:\n"); svgExpect = SVG_EXPECT_ATTRIBUTE; currentElement = svgElement_create(buff); }
-        else        { return; }
-    }
-    else if(svgExpect == SVG_EXPECT_ATTRIBUTE)
+    while(p < end)
     {
-        char advance = 0;
         const char* name = 0;
-        if(!currentElement) { /* TODO: error */ return; }
-        name = currentElement->name;
+        int tag = 0;
 
-        if(!strcmp(name, "?xml"))
-        {
-            if(!advance) { advance = (char)svgIsXmlAttribute(buff); }
-        }
-        else if(!strcmp(name, "a"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsLinkAttribute(buff); }
-        }
-        else if(!strcmp(name, "animate"))
-        {
-            if(!advance) { advance = (char)svgIsAnimateAttribute(buff); }
-        }
-        else if(!strcmp(name, "animateColor"))
-        {
-            if(!advance) { advance = (char)svgIsAnimateColorAttribute(buff); }
-        }
-        else if(!strcmp(name, "animateMotion"))
-        {
-            if(!advance) { advance = (char)svgIsAnimateMotionAttribute(buff); }
-        }
-        else if(!strcmp(name, "animateTransform"))
-        {
-            if(!advance) { advance = (char)svgIsAnimateTransformAttribute(buff); }
-        }
-        else if(!strcmp(name, "animation"))
-        {
-            if(!advance) { advance = (char)svgIsMediaProperty(buff); }
-            if(!advance) { advance = (char)svgIsAnimationAttribute(buff); }
-        }
-        else if(!strcmp(name, "audio"))
-        {
-            if(!advance) { advance = (char)svgIsMediaProperty(buff); }
-            if(!advance) { advance = (char)svgIsAudioAttribute(buff); }
-        }
-        else if(!strcmp(name, "circle"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsCircleAttribute(buff); }
-        }
-        else if(!strcmp(name, "defs"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsDefsAttribute(buff); }
-        }
-        else if(!strcmp(name, "desc"))
-        {
-            if(!advance) { advance = (char)svgIsMediaProperty(buff); }
-            if(!advance) { advance = (char)svgIsDescAttribute(buff); }
-        }
-        else if(!strcmp(name, "discard"))
-        {
-            if(!advance) { advance = (char)svgIsDiscardAttribute(buff); }
-        }
-        else if(!strcmp(name, "ellipse"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsEllipseAttribute(buff); }
-        }
-        else if(!strcmp(name, "font"))
-        {
-            if(!advance) { advance = (char)svgIsFontAttribute(buff); }
-        }
-        else if(!strcmp(name, "font-face"))
-        {
-            if(!advance) { advance = (char)svgIsFontFaceAttribute(buff); }
-        }
-        else if(!strcmp(name, "font-face-src"))
-        {
-            if(!advance) { advance = (char)svgIsFontFaceSrcAttribute(buff); }
-        }
-        else if(!strcmp(name, "font-face-uri"))
-        {
-            if(!advance) { advance = (char)svgIsFontFaceUriAttribute(buff); }
-        }
-        else if(!strcmp(name, "foreignObject"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsForeignObjectAttribute(buff); }
-        }
-        else if(!strcmp(name, "g"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsGroupAttribute(buff); }
-        }
-        else if(!strcmp(name, "glyph"))
-        {
-            if(!advance) { advance = (char)svgIsGlyphAttribute(buff); }
-        }
-        else if(!strcmp(name, "handler"))
-        {
-            if(!advance) { advance = (char)svgIsHandlerAttribute(buff); }
-        }
-        else if(!strcmp(name, "hkern"))
-        {
-            if(!advance) { advance = (char)svgIsHKernAttribute(buff); }
-        }
-        else if(!strcmp(name, "image"))
-        {
-            if(!advance) { advance = (char)svgIsMediaProperty(buff); }
-            if(!advance) { advance = (char)svgIsImageAttribute(buff); }
-        }
-        else if(!strcmp(name, "line"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsLineAttribute(buff); }
-        }
-        else if(!strcmp(name, "linearGradient"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsLinearGradientAttribute(buff); }
-        }
-        else if(!strcmp(name, "listener"))
-        {
-            if(!advance) { advance = (char)svgIsListenerAttribute(buff); }
-        }
-        else if(!strcmp(name, "metadata"))
-        {
-            if(!advance) { advance = (char)svgIsMediaProperty(buff); }
-            if(!advance) { advance = (char)svgIsMetadataAttribute(buff); }
-        }
-        else if(!strcmp(name, "missing-glyph"))
-        {
-            if(!advance) { advance = (char)svgIsMissingGlyphAttribute(buff); }
-        }
-        else if(!strcmp(name, "mpath"))
-        {
-            if(!advance) { advance = (char)svgIsMPathAttribute(buff); }
-        }
-        else if(!strcmp(name, "path"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsPathAttribute(buff); }
-        }
-        else if(!strcmp(name, "polygon"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsPolygonAttribute(buff); }
-        }
-        else if(!strcmp(name, "polyline"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsPolylineAttribute(buff); }
-        }
-        else if(!strcmp(name, "prefetch"))
-        {
-            if(!advance) { advance = (char)svgIsPrefetchAttribute(buff); }
-        }
-        else if(!strcmp(name, "radialGradient"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsRadialGradientAttribute(buff); }
-        }
-        else if(!strcmp(name, "rect"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsRectAttribute(buff); }
-        }
-        else if(!strcmp(name, "script"))
-        {
-            if(!advance) { advance = (char)svgIsScriptAttribute(buff); }
-        }
-        else if(!strcmp(name, "set"))
-        {
-            if(!advance) { advance = (char)svgIsSetAttribute(buff); }
-        }
-        else if(!strcmp(name, "solidColor"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsSolidColorAttribute(buff); }
-        }
-        else if(!strcmp(name, "stop"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsStopAttribute(buff); }
-        }
-        else if(!strcmp(name, "svg"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsSvgAttribute(buff); }
-        }
-        else if(!strcmp(name, "switch"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsSwitchAttribute(buff); }
-        }
-        else if(!strcmp(name, "tbreak"))
-        {
-            if(!advance) { advance = (char)svgIsTBreakAttribute(buff); }
-        }
-        else if(!strcmp(name, "text"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsTextAttribute(buff); }
-        }
-        else if(!strcmp(name, "textArea"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsTextAreaAttribute(buff); }
-        }
-        else if(!strcmp(name, "title"))
-        {
-            if(!advance) { advance = (char)svgIsMediaProperty(buff); }
-            if(!advance) { advance = (char)svgIsTitleAttribute(buff); }
-        }
-        else if(!strcmp(name, "tspan"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsTSpanAttribute(buff); }
-        }
-        else if(!strcmp(name, "use"))
-        {
-            if(!advance) { advance = (char)svgIsProperty(buff); }
-            if(!advance) { advance = (char)svgIsUseAttribute(buff); }
-        }
-        else if(!strcmp(name, "video"))
-        {
-            if(!advance) { advance = (char)svgIsMediaProperty(buff); }
-            if(!advance) { advance = (char)svgIsVideoAttribute(buff); }
-        }
+        p = (const char*)memchr(p, '<', (size_t)(end - p));
+        if(!p) break;
+        p++;
 
-        if(advance)
+        if(end - p >= 3 && !memcmp(p, "!--", 3))
         {
-            printf("ATTRIBUTE:\n");
-            svgExpect = SVG_EXPECT_VALUE;
-            free(currentAttribute);
-            currentAttribute = 0;
-            currentAttribute = emb_strdup(buff);
+            const char* close = svgFind(p + 3, end, "-->");
+            svgDetectCreator(reader, p + 3, close);
+            p = close;
+            continue;
         }
-    }
-    else if(svgExpect == SVG_EXPECT_VALUE)
-    {
-        int last = strlen(buff) - 1;
-        printf("VALUE:\n");
-
-        /* single-value */
-        if((buff[0] == '"' || buff[0] == '\'') && (buff[last] == '/' || buff[last] == '"' || buff[last] == '\'') && !svgMultiValue)
+        if(end - p >= 8 && !memcmp(p, "![CDATA[", 8))
         {
-            svgExpect = SVG_EXPECT_ATTRIBUTE;
-            svgElement_addAttribute(currentElement, svgAttribute_create(currentAttribute, buff));
+            p = svgFind(p + 8, end, "]]>");
+            continue;
         }
-        else /* multi-value */
+        if(p < end && (*p == '!' || *p == '?' || *p == '/'))
         {
-            svgMultiValue = 1;
-            if(!currentValue)
-            {
-                currentValue = emb_strdup(buff);
-                if(!currentValue) { /*TODO: error */ return; }
-            }
-            else
-            {
-                char* tmp = 0;
-                tmp = emb_strdup(currentValue);
-                free(currentValue);
-                currentValue = 0;
-                currentValue = (char*)malloc(strlen(buff) + strlen(tmp) + 2);
-                if(!currentValue) { embLog_error("format-svg.c svgProcess(), cannot allocate memory for currentValue\n"); return; }
-                if(currentValue) memset(currentValue, 0, strlen(buff) + strlen(tmp) + 2);
-                strcat(currentValue, tmp);
-                strcat(currentValue, " ");
-                strcat(currentValue, buff);
-                free(tmp);
-                tmp = 0;
-            }
-
-            if(buff[last] == '/' || buff[last] == '"' || buff[last] == '\'')
-            {
-                svgMultiValue = 0;
-                svgExpect = SVG_EXPECT_ATTRIBUTE;
-                svgElement_addAttribute(currentElement, svgAttribute_create(currentAttribute, currentValue));
-                free(currentValue);
-                currentValue = 0;
-            }
+            /* Declarations, processing instructions and end tags add nothing to the design */
+            p = svgParseAttributes(reader, p + 1, end);
+            continue;
         }
-    }
-
-    if(svgExpect != SVG_EXPECT_NULL)
-        printf("%s\n", buff);
 
-    if(c == '>')
-        svgExpect = SVG_EXPECT_NULL;
+        name = p;
+        while(p < end && !SVG_IS_SPACE(*p) && *p != '>' && *p != '/') p++;
+        tag = svgTagLookup(name, (size_t)(p - name));
+        if(tag >= 0)
+            reader->element = svgElement_create(reader, tag);
+        p = svgParseAttributes(reader, p, end);
+        svgAddToPattern(reader, pattern);
+    }
 }
 
 /*! Reads a file with the given \a fileName and loads the data into \a pattern.
@@ -3223,156 +680,58 @@ void svgProcess(int c, const char* buff)
 int readSvg(EmbPattern* pattern, const char* fileName)
 {
     EmbFile* file = 0;
-    int size = 1024;
-    int pos;
-    int c = 0;
-    EmbRectObjectList* rList = 0;
-    EmbCircleObjectList* cList = 0;
-    EmbEllipseObjectList* eList = 0;
-    EmbLineObjectList* liList = 0;
-    EmbPointObjectList* poList = 0;
-    EmbPolygonObjectList* pogList = 0;
-    EmbPolylineObjectList* polList = 0;
-    char* buff = 0;
+    const unsigned char* data = 0;
+    unsigned char* buff = 0;
+    size_t length = 0;
+    SvgReader reader;
 
     if(!pattern) { embLog_error("format-svg.c readSvg(), pattern argument is null\n"); return 0; }
     if(!fileName) { embLog_error("format-svg.c readSvg(), fileName argument is null\n"); return 0; }
 
-    buff = (char*)malloc(size);
-    if(!buff) { embLog_error("format-svg.c readSvg(), cannot allocate memory for buff\n"); return 0; }
-
-    svgCreator = SVG_CREATOR_NULL;
-
-    svgExpect = SVG_EXPECT_NULL;
-    svgMultiValue = 0;
-
-    currentElement = 0;
-    currentAttribute = 0;
-    currentValue = 0;
-
-    /* Pre-flip incase of multiple reads on the same pattern */
-    embPattern_flipVertical(pattern);
-
-    file = embFile_open(fileName, "r");
-    if(file)
-    {
-        pos = 0;
-        do
-        {
-            c = embFile_getc(file);
-            switch(c)
-            {
-                case '<':
-                    if(svgExpect == SVG_EXPECT_NULL)
-                    {
-                        svgAddToPattern(pattern);
-                        svgExpect = SVG_EXPECT_ELEMENT;
-                    }
-                case '>':
-                    if(pos == 0) /* abnormal case that may occur in svg element where '>' is all by itself */
-                    {
-                        /*TODO: log a warning about this absurdity! */
-                        svgExpect = SVG_EXPECT_ELEMENT;
-                        break;
-                    }
-                case ' ':
-                case '\t':
-                case '\r':
-                case '\n':
-                case '=':
-                    if(pos == 0)
-                        break;
-                    buff[pos] = 0;
-                    pos = 0;
-                    svgProcess(c, buff);
-                    break;
-                default:
-                    buff[pos++] = (char)c;
-                    break;
-            }
-            if(pos >= size - 1)
-            {
-                /* increase buff length - leave room for 0 */
-                size *= 2;
-                buff = (char*)realloc(buff, size);
-                if(!buff) { embLog_error("format-svg.c readSvg(), cannot re-allocate memory for buff\n"); return 0; }
-            }
-        }
-        while(c != EOF);
-        embFile_close(file);
-    }
-    free(buff);
-    buff = 0;
-    free(currentAttribute);
-    currentAttribute = 0;
-    free(currentValue);
-    currentValue = 0;
-
-    /*TODO: remove this summary after testing is complete */
-    printf("OBJECT SUMMARY:\n");
-    cList = pattern->circleObjList;
-    while(cList)
-    {
-        EmbCircle c = cList->circleObj.circle;
-        printf("circle %f %f %f\n", c.centerX, c.centerY, c.radius);
-        cList = cList->next;
-    }
-    eList = pattern->ellipseObjList;
-    while(eList)
-    {
-        EmbEllipse e = eList->ellipseObj.ellipse;
-        printf("ellipse %f %f %f %f\n", embEllipse_centerX(e), embEllipse_centerY(e), embEllipse_radiusX(e), embEllipse_radiusY(e));
-        eList = eList->next;
-    }
-    liList = pattern->lineObjList;
-    while(liList)
-    {
-        EmbLine li = liList->lineObj.line;
-        printf("line %f %f %f %f\n", embLine_x1(li), embLine_y1(li), embLine_x2(li), embLine_y2(li));
-        liList = liList->next;
-    }
-    poList = pattern->pointObjList;
-    while(poList)
-    {
-        EmbPoint po = poList->pointObj.point;
-        printf("point %f %f\n", embPoint_x(po), embPoint_y(po));
-        poList = poList->next;
-    }
-    pogList = pattern->polygonObjList;
-    while(pogList)
-    {
-        int vertices = embPointList_count(pogList->polygonObj->pointList);
-        printf("polygon %d\n", vertices);
-        pogList = pogList->next;
-    }
-    polList = pattern->polylineObjList;
-    while(polList)
+    file = embFile_open(fileName, "rb");
+    if(!file)
     {
-        int vertices = embPointList_count(polList->polylineObj->pointList);
-        printf("polyline %d\n", vertices);
-        polList = polList->next;
+        embLog_error("format-svg.c readSvg(), cannot open %s for reading\n", fileName);
+        return 0;
     }
-    rList = pattern->rectObjList;
-    while(rList)
+    /* The tokenizer works on the whole file in memory, mapped when possible */
+    data = embFile_view(file, &length);
+    if(!data)
     {
-        EmbRect r = rList->rectObj.rect;
-        printf("rect %f %f %f %f\n", embRect_x(r), embRect_y(r), embRect_width(r), embRect_height(r));
-        rList = rList->next;
+        embFile_seek(file, 0, SEEK_END);
+        length = (size_t)embFile_tell(file);
+        embFile_seek(file, 0, SEEK_SET);
+        buff = (unsigned char*)malloc(length ? length : 1);
+        if(!buff) { embLog_error("format-svg.c readSvg(), cannot allocate memory for buff\n"); embFile_close(file); return 0; }
+        length = embFile_read(buff, 1, length, file);
+        data = buff;
     }
 
-    /* Flip the pattern since SVG Y+ is down and libembroidery Y+ is up. */
-    embPattern_flipVertical(pattern);
+    reader.creator = SVG_CREATOR_NULL;
+    reader.element = 0;
+    embArena_init(&reader.arena, 0);
+    embPathData_init(&reader.pathData);
+    embFlatPath_init(&reader.flatPath);
+
+    svgParse(&reader, pattern, (const char*)data, (const char*)data + length);
+
+    embArena_free(&reader.arena);
+    embPathData_free(&reader.pathData);
+    embFlatPath_free(&reader.flatPath);
+    free(buff);
+    embFile_close(file);
 
     return 1; /*TODO: finish readSvg */
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeSvg(EmbPattern* pattern, const char* fileName)
+int writeSvgStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
-    EmbFile* file = 0;
     EmbRect boundingRect;
-    EmbStitchList* stList;
+    EmbPatternView view;
+    EmbStitch st;
+    int i, stitchCount;
     EmbCircleObjectList* cObjList = 0;
     EmbCircle circle;
     EmbEllipseObjectList* eObjList = 0;
@@ -3387,25 +746,19 @@ int writeSvg(EmbPattern* pattern, const char* fileName)
     EmbPointList* polPointList = 0;
     EmbRectObjectList* rObjList = 0;
     EmbRect rect;
+    EmbPoint corner1, corner2;
     EmbColor color;
 
     char tmpX[32];
     char tmpY[32];
 
-    if(!pattern) { embLog_error("format-svg.c writeSvg(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-svg.c writeSvg(), fileName argument is null\n"); return 0; }
+    if(!pattern) { embLog_error("format-svg.c writeSvgStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-svg.c writeSvgStream(), file argument is null\n"); return 0; }
 
-    file = embFile_open(fileName, "w");
-    if(!file)
-    {
-        embLog_error("format-svg.c writeSvg(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
-
-    /* Pre-flip the pattern since SVG Y+ is down and libembroidery Y+ is up. */
-    embPattern_flipVertical(pattern);
+    /* SVG Y+ is down and libembroidery Y+ is up, so everything is written through a flipped view. */
+    view = embPattern_view(pattern, embTransform_scale(1.0, -1.0));
 
-    boundingRect = embPattern_calcBoundingBox(pattern);
+    boundingRect = embPatternView_boundingBox(&view);
     embFile_printf(file, "<?xml version=\"1.0\"?>\n");
     embFile_printf(file, "<!-- Embroidermodder 2 SVG Embroidery File -->\n");
     embFile_printf(file, "<!-- http://embroidermodder.github.io -->\n");
@@ -3438,14 +791,15 @@ int writeSvg(EmbPattern* pattern, const char* fileName)
     while(cObjList)
     {
         circle = cObjList->circleObj.circle;
+        point = embPatternView_point(&view, circle.centerX, circle.centerY);
         color = cObjList->circleObj.color;
         /* TODO: use proper thread width for stoke-width rather than just 0.2 */
         embFile_printf(file, "\n<circle stroke-width=\"0.2\" stroke=\"#%02x%02x%02x\" fill=\"none\" cx=\"%f\" cy=\"%f\" r=\"%f\" />",
                         color.r,
                         color.g,
                         color.b,
-                        circle.centerX,
-                        circle.centerY,
+                        point.xx,
+                        point.yy,
                         circle.radius);
         cObjList = cObjList->next;
     }
@@ -3455,14 +809,15 @@ int writeSvg(EmbPattern* pattern, const char* fileName)
     while(eObjList)
     {
         ellipse = eObjList->ellipseObj.ellipse;
+        point = embPatternView_point(&view, ellipse.centerX, ellipse.centerY);
         color = eObjList->ellipseObj.color;
         /* TODO: use proper thread width for stoke-width rather than just 0.2 */
         embFile_printf(file, "\n<ellipse stroke-width=\"0.2\" stroke=\"#%02x%02x%02x\" fill=\"none\" cx=\"%f\" cy=\"%f\" rx=\"%f\" ry=\"%f\" />",
                         color.r,
                         color.g,
                         color.b,
-                        ellipse.centerX,
-                        ellipse.centerY,
+                        point.xx,
+                        point.yy,
                         ellipse.radiusX,
                         ellipse.radiusY);
         eObjList = eObjList->next;
@@ -3473,16 +828,18 @@ int writeSvg(EmbPattern* pattern, const char* fileName)
     while(liObjList)
     {
         line = liObjList->lineObj.line;
+        corner1 = embPatternView_point(&view, line.x1, line.y1);
+        corner2 = embPatternView_point(&view, line.x2, line.y2);
         color = liObjList->lineObj.color;
         /* TODO: use proper thread width for stoke-width rather than just 0.2 */
         embFile_printf(file, "\n<line stroke-width=\"0.2\" stroke=\"#%02x%02x%02x\" fill=\"none\" x1=\"%f\" y1=\"%f\" x2=\"%f\" y2=\"%f\" />",
                         color.r,
                         color.g,
                         color.b,
-                        line.x1,
-                        line.y1,
-                        line.x2,
-                        line.y2);
+                        corner1.xx,
+                        corner1.yy,
+                        corner2.xx,
+                        corner2.yy);
         liObjList = liObjList->next;
     }
 
@@ -3490,7 +847,7 @@ int writeSvg(EmbPattern* pattern, const char* fileName)
     poObjList = pattern->pointObjList;
     while(poObjList)
     {
-        point = poObjList->pointObj.point;
+        point = embPatternView_point(&view, poObjList->pointObj.point.xx, poObjList->pointObj.point.yy);
         color = poObjList->pointObj.color;
         /* See SVG Tiny 1.2 Spec:
         * Section 9.5 The 'line' element
@@ -3514,18 +871,20 @@ int writeSvg(EmbPattern* pattern, const char* fileName)
         pogPointList = pogObjList->polygonObj->pointList;
         if(pogPointList)
         {
+            point = embPatternView_point(&view, pogPointList->point.xx, pogPointList->point.yy);
             color = pogObjList->polygonObj->color;
             /* TODO: use proper thread width for stoke-width rather than just 0.2 */
             embFile_printf(file, "\n<polygon stroke-linejoin=\"round\" stroke-linecap=\"round\" stroke-width=\"0.2\" stroke=\"#%02x%02x%02x\" fill=\"none\" points=\"%s,%s",
                     color.r,
                     color.g,
                     color.b,
-                    emb_optOut(pogPointList->point.xx, tmpX),
-                    emb_optOut(pogPointList->point.yy, tmpY));
+                    emb_optOut(point.xx, tmpX),
+                    emb_optOut(point.yy, tmpY));
             pogPointList = pogPointList->next;
             while(pogPointList)
             {
-                embFile_printf(file, " %s,%s", emb_optOut(pogPointList->point.xx, tmpX), emb_optOut(pogPointList->point.yy, tmpY));
+                point = embPatternView_point(&view, pogPointList->point.xx, pogPointList->point.yy);
+                embFile_printf(file, " %s,%s", emb_optOut(point.xx, tmpX), emb_optOut(point.yy, tmpY));
                 pogPointList = pogPointList->next;
             }
             embFile_printf(file, "\"/>");
@@ -3540,18 +899,20 @@ int writeSvg(EmbPattern* pattern, const char* fileName)
         polPointList = polObjList->polylineObj->pointList;
         if(polPointList)
         {
+            point = embPatternView_point(&view, polPointList->point.xx, polPointList->point.yy);
             color = polObjList->polylineObj->color;
             /* TODO: use proper thread width for stoke-width rather than just 0.2 */
             embFile_printf(file, "\n<polyline stroke-linejoin=\"round\" stroke-linecap=\"round\" stroke-width=\"0.2\" stroke=\"#%02x%02x%02x\" fill=\"none\" points=\"%s,%s",
                     color.r,
                     color.g,
                     color.b,
-                    emb_optOut(polPointList->point.xx, tmpX),
-                    emb_optOut(polPointList->point.yy, tmpY));
+                    emb_optOut(point.xx, tmpX),
+                    emb_optOut(point.yy, tmpY));
             polPointList = polPointList->next;
             while(polPointList)
             {
-                embFile_printf(file, " %s,%s", emb_optOut(polPointList->point.xx, tmpX), emb_optOut(polPointList->point.yy, tmpY));
+                point = embPatternView_point(&view, polPointList->point.xx, polPointList->point.yy);
+                embFile_printf(file, " %s,%s", emb_optOut(point.xx, tmpX), emb_optOut(point.yy, tmpY));
                 polPointList = polPointList->next;
             }
             embFile_printf(file, "\"/>");
@@ -3563,7 +924,12 @@ int writeSvg(EmbPattern* pattern, const char* fileName)
     rObjList = pattern->rectObjList;
     while(rObjList)
     {
-        rect = rObjList->rectObj.rect;
+        corner1 = embPatternView_point(&view, rObjList->rectObj.rect.left, rObjList->rectObj.rect.top);
+        corner2 = embPatternView_point(&view, rObjList->rectObj.rect.right, rObjList->rectObj.rect.bottom);
+        rect.left = corner1.xx;
+        rect.top = corner1.yy;
+        rect.right = corner2.xx;
+        rect.bottom = corner2.yy;
         color = rObjList->rectObj.color;
         /* TODO: use proper thread width for stoke-width rather than just 0.2 */
         embFile_printf(file, "\n<rect stroke-width=\"0.2\" stroke=\"#%02x%02x%02x\" fill=\"none\" x=\"%f\" y=\"%f\" width=\"%f\" height=\"%f\" />",
@@ -3577,45 +943,47 @@ int writeSvg(EmbPattern* pattern, const char* fileName)
         rObjList = rObjList->next;
     }
 
-    stList = pattern->stitchList;
-    if(stList)
+    if(!embStitchList_empty(pattern->stitchList))
     {
         /*TODO: #ifdef SVG_DEBUG for Josh which outputs JUMPS/TRIMS instead of chopping them out */
         char isNormal = 0;
-        while(stList)
+        stitchCount = embPatternView_stitchCount(&view);
+        for(i = 0; i < stitchCount; i++)
         {
-            if(stList->stitch.flags == NORMAL && !isNormal)
+            st = embPatternView_stitch(&view, i);
+            if(st.flags == NORMAL && !isNormal)
             {
                     isNormal = 1;
-                    color = embThreadList_getAt(pattern->threadList, stList->stitch.color).color;
+                    color = embThreadList_getAt(pattern->threadList, st.color).color;
                     /* TODO: use proper thread width for stoke-width rather than just 0.2 */
                     embFile_printf(file, "\n<polyline stroke-linejoin=\"round\" stroke-linecap=\"round\" stroke-width=\"0.2\" stroke=\"#%02x%02x%02x\" fill=\"none\" points=\"%s,%s",
                                 color.r,
                                 color.g,
                                 color.b,
-                                emb_optOut(stList->stitch.xx, tmpX),
-                                emb_optOut(stList->stitch.yy, tmpY));
+                                emb_optOut(st.xx, tmpX),
+                                emb_optOut(st.yy, tmpY));
             }
-            else if(stList->stitch.flags == NORMAL && isNormal)
+            else if(st.flags == NORMAL && isNormal)
             {
-                embFile_printf(file, " %s,%s", emb_optOut(stList->stitch.xx, tmpX), emb_optOut(stList->stitch.yy, tmpY));
+                embFile_printf(file, " %s,%s", emb_optOut(st.xx, tmpX), emb_optOut(st.yy, tmpY));
             }
-            else if(stList->stitch.flags != NORMAL && isNormal)
+            else if(st.flags != NORMAL && isNormal)
             {
                 isNormal = 0;
                 embFile_printf(file, "\"/>");
             }
-
-            stList = stList->next;
         }
     }
     embFile_printf(file, "\n</svg>\n");
-    embFile_close(file);
-
-    /* Reset the pattern so future writes(regardless of format) are not flipped */
-    embPattern_flipVertical(pattern);
 
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeSvg(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "w", writeSvgStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
@@ -2,6 +2,7 @@
 #ifndef FORMAT_SVG_H
 #define FORMAT_SVG_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -15,7 +16,7 @@ typedef struct SvgElement_       SvgElement;
 
 struct SvgAttribute_
 {
-    char* name;
+    const char* name;
     char* value;
 };
 
@@ -27,7 +28,8 @@ struct SvgAttributeList_
 
 struct SvgElement_
 {
-    char* name;
+    const char* name;
+    int tag; /* SVG_TAG of name */
     SvgAttributeList* attributeList;
     SvgAttributeList* lastAttribute;
 };
@@ -42,33 +44,59 @@ typedef enum
 
 typedef enum
 {
-    SVG_EXPECT_NULL,
-    SVG_EXPECT_ELEMENT,
-    SVG_EXPECT_ATTRIBUTE,
-    SVG_EXPECT_VALUE
-} SVG_EXPECT;
-
-typedef enum
-{
-    SVG_NULL,
-    SVG_ELEMENT,
-    SVG_PROPERTY,
-    SVG_MEDIA_PROPERTY,
-    SVG_ATTRIBUTE,
-    SVG_CATCH_ALL
-} SVG_TYPES;
+    SVG_TAG_A = 0,
+    SVG_TAG_ANIMATE,
+    SVG_TAG_ANIMATE_COLOR,
+    SVG_TAG_ANIMATE_MOTION,
+    SVG_TAG_ANIMATE_TRANSFORM,
+    SVG_TAG_ANIMATION,
+    SVG_TAG_AUDIO,
+    SVG_TAG_CIRCLE,
+    SVG_TAG_DEFS,
+    SVG_TAG_DESC,
+    SVG_TAG_DISCARD,
+    SVG_TAG_ELLIPSE,
+    SVG_TAG_FONT,
+    SVG_TAG_FONT_FACE,
+    SVG_TAG_FONT_FACE_SRC,
+    SVG_TAG_FONT_FACE_URI,
+    SVG_TAG_FOREIGN_OBJECT,
+    SVG_TAG_G,
+    SVG_TAG_GLYPH,
+    SVG_TAG_HANDLER,
+    SVG_TAG_HKERN,
+    SVG_TAG_IMAGE,
+    SVG_TAG_LINE,
+    SVG_TAG_LINEAR_GRADIENT,
+    SVG_TAG_LISTENER,
+    SVG_TAG_METADATA,
+    SVG_TAG_MISSING_GLYPH,
+    SVG_TAG_MPATH,
+    SVG_TAG_PATH,
+    SVG_TAG_POLYGON,
+    SVG_TAG_POLYLINE,
+    SVG_TAG_PREFETCH,
+    SVG_TAG_RADIAL_GRADIENT,
+    SVG_TAG_RECT,
+    SVG_TAG_SCRIPT,
+    SVG_TAG_SET,
+    SVG_TAG_SOLID_COLOR,
+    SVG_TAG_STOP,
+    SVG_TAG_SVG,
+    SVG_TAG_SWITCH,
+    SVG_TAG_TBREAK,
+    SVG_TAG_TEXT,
+    SVG_TAG_TEXT_AREA,
+    SVG_TAG_TITLE,
+    SVG_TAG_TSPAN,
+    SVG_TAG_USE,
+    SVG_TAG_VIDEO,
+    SVG_TAG_COUNT
+} SVG_TAG;
 
 extern EMB_PRIVATE int EMB_CALL readSvg(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeSvg(EmbPattern* pattern, const char* fileName);
-
-int svgCreator;
-
-int svgExpect;
-int svgMultiValue;
-
-SvgElement* currentElement;
-char* currentAttribute;
-char* currentValue;
+extern EMB_PRIVATE int EMB_CALL writeSvgStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
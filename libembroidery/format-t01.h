@@ -2,6 +2,7 @@
 #ifndef FORMAT_T01_H
 #define FORMAT_T01_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readT01(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeT01(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeT01Stream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
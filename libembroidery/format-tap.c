@@ -1,4 +1,5 @@
 #include "format-tap.h"
+#include "emb-reader-writer.h"
 #include "emb-file.h"
 #include "emb-logging.h"
 #include "helpers-binary.h"
@@ -96,7 +97,7 @@ int readTap(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     return 1;
@@ -161,16 +162,16 @@ static void encode_record(EmbFile* file, int x, int y, int flags)
 	binaryWriteByte(file, (unsigned char)b2);
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeTap(EmbPattern* pattern, const char* fileName)
+int writeTapStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
 	EmbRect boundingRect;
-	EmbFile* file = 0;
 	int xx, yy, dx, dy, flags;
 	int co = 1, st = 0;
 	int ax, ay, mx, my;
-	EmbStitchList* pointer = 0;
+	EmbStitch* pointer = 0;
+	EmbStitchIterator it;
 	
 	if (!embStitchList_count(pattern->stitchList))
 	{
@@ -179,42 +180,40 @@ int writeTap(EmbPattern* pattern, const char* fileName)
 	}
 
 	/* Check for an END stitch and add one if it is not present */
-	if (pattern->lastStitch->stitch.flags != END)
+	if (embStitchList_last(pattern->stitchList)->flags != END)
 		embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
-	file = embFile_open(fileName, "wb");
-	if (!file)
-	{
-		embLog_error("format-tap.c writeDst(), cannot open %s for writing\n", fileName);
-		return 0;
-	}
-
 	embPattern_correctForMaxStitchLength(pattern, 12.1, 12.1);
 
 	xx = yy = 0;
 	co = 1;
-	co = embThreadList_count(pattern->threadList);
+	co = embPattern_threadCount(pattern);
 	st = 0;
 	st = embStitchList_count(pattern->stitchList);
 	flags = NORMAL;
 	boundingRect = embPattern_calcBoundingBox(pattern);
 	ax = ay = mx = my = 0;
 	xx = yy = 0;
-	pointer = pattern->stitchList;
-	while (pointer)
+	it = embStitchList_begin(pattern->stitchList);
+	while((pointer = embStitchIterator_next(&it)))
 	{
 		/* convert from mm to 0.1mm for file format */
-		dx = roundDouble(pointer->stitch.xx * 10.0) - xx;
-		dy = roundDouble(pointer->stitch.yy * 10.0) - yy;
-		xx = roundDouble(pointer->stitch.xx * 10.0);
-		yy = roundDouble(pointer->stitch.yy * 10.0);
-		flags = pointer->stitch.flags;
+		dx = roundDouble(pointer->xx * 10.0) - xx;
+		dy = roundDouble(pointer->yy * 10.0) - yy;
+		xx = roundDouble(pointer->xx * 10.0);
+		yy = roundDouble(pointer->yy * 10.0);
+		flags = pointer->flags;
 		encode_record(file, dx, dy, flags);
-		pointer = pointer->next;
 	}
-	embFile_close(file);
 	return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeTap(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writeTapStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
 
@@ -2,6 +2,7 @@
 #ifndef FORMAT_TAP_H
 #define FORMAT_TAP_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readTap(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeTap(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeTapStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
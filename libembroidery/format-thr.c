@@ -1,4 +1,5 @@
 #include "format-thr.h"
+#include "emb-reader-writer.h"
 #include "helpers-binary.h"
 #include "emb-file.h"
 #include "emb-logging.h"
@@ -131,49 +132,42 @@ int readThr(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     return 1;
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeThr(EmbPattern* pattern, const char* fileName)
+int writeThrStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
     int i, stitchCount;
     unsigned char version = 0;
     ThredHeader header;
     ThredExtension extension;
-    char bitmapName[16];
-    EmbStitchList* pointer = 0;
-    EmbThreadList* colorpointer = 0;
-    EmbFile* file = 0;
+    char bitmapName[16] = { 0 }; /* no bitmap */
+    EmbStitch* pointer = 0;
+    EmbStitchIterator it;
+    int t;
 
-    if(!pattern) { embLog_error("format-thr.c writeThr(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-thr.c writeThr(), fileName argument is null\n"); return 0; }
+    if(!pattern) { embLog_error("format-thr.c writeThrStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-thr.c writeThrStream(), file argument is null\n"); return 0; }
 
     stitchCount = embStitchList_count(pattern->stitchList);
     if(!stitchCount)
     {
-        embLog_error("format-thr.c writeThr(), pattern contains no stitches\n");
+        embLog_error("format-thr.c writeThrStream(), pattern contains no stitches\n");
         return 0;
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
     {
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
         stitchCount++;
     }
 
-    file = embFile_open(fileName, "wb");
-    if(!file)
-    {
-        embLog_error("format-thr.c writeThr(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
-
     memset(&header, 0, sizeof(ThredHeader));
     header.sigVersion = 0x746872 | (version << 24);
     header.length = stitchCount * 12 + 16;
@@ -214,13 +208,12 @@ int writeThr(EmbPattern* pattern, const char* fileName)
 
     /* write stitches */
     i = 0;
-    pointer = pattern->stitchList;
-    while(pointer)
+    it = embStitchList_begin(pattern->stitchList);
+    while((pointer = embStitchIterator_next(&it)))
     {
-        binaryWriteFloat(file, (float)(pointer->stitch.xx * 10.0));
-        binaryWriteFloat(file, (float)(pointer->stitch.yy * 10.0));
-        binaryWriteUInt(file, NOTFRM | (pointer->stitch.color & 0x0F));
-        pointer = pointer->next;
+        binaryWriteFloat(file, (float)(pointer->xx * 10.0));
+        binaryWriteFloat(file, (float)(pointer->yy * 10.0));
+        binaryWriteUInt(file, NOTFRM | (pointer->color & 0x0F));
         i++;
         if(i >= stitchCount) break;
     }
@@ -232,14 +225,12 @@ int writeThr(EmbPattern* pattern, const char* fileName)
     binaryWriteByte(file, 0x00);
 
     i = 0;
-    colorpointer = pattern->threadList;
-    while(colorpointer)
+    for(t = 0; t < embThreadList_count(pattern->threadList); t++)
     {
-        binaryWriteByte(file, colorpointer->thread.color.r);
-        binaryWriteByte(file, colorpointer->thread.color.g);
-        binaryWriteByte(file, colorpointer->thread.color.b);
+        binaryWriteByte(file, pattern->threadList->thread[t].color.r);
+        binaryWriteByte(file, pattern->threadList->thread[t].color.g);
+        binaryWriteByte(file, pattern->threadList->thread[t].color.b);
         binaryWriteByte(file, 0);
-        colorpointer = colorpointer->next;
         i++;
         if(i >= 16) break;
     }
@@ -252,14 +243,12 @@ int writeThr(EmbPattern* pattern, const char* fileName)
 
     /* write custom colors */
     i = 0;
-    colorpointer = pattern->threadList;
-    while(colorpointer)
+    for(t = 0; t < embThreadList_count(pattern->threadList); t++)
     {
-        binaryWriteByte(file, colorpointer->thread.color.r);
-        binaryWriteByte(file, colorpointer->thread.color.g);
-        binaryWriteByte(file, colorpointer->thread.color.b);
+        binaryWriteByte(file, pattern->threadList->thread[t].color.r);
+        binaryWriteByte(file, pattern->threadList->thread[t].color.g);
+        binaryWriteByte(file, pattern->threadList->thread[t].color.b);
         binaryWriteByte(file, 0);
-        colorpointer = colorpointer->next;
         i++;
         if(i >= 16) break;
     }
@@ -275,8 +264,14 @@ int writeThr(EmbPattern* pattern, const char* fileName)
         binaryWriteByte(file, '4');
     }
 
-    embFile_close(file);
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeThr(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writeThrStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
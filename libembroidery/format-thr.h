@@ -2,6 +2,7 @@
 #ifndef FORMAT_THR_H
 #define FORMAT_THR_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readThr(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeThr(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeThrStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
@@ -2,6 +2,7 @@
 #ifndef FORMAT_TXT_H
 #define FORMAT_TXT_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readTxt(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeTxt(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeTxtStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
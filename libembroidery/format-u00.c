@@ -32,6 +32,8 @@ int readU00(EmbPattern* pattern, const char* fileName)
         t.color.r = binaryReadUInt8(file);
         t.color.g = binaryReadUInt8(file);
         t.color.b = binaryReadUInt8(file);
+        t.catalogNumber = "";
+        t.description = "";
         embPattern_addThread(pattern, t);
     }
 
@@ -71,7 +73,7 @@ int readU00(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     return 1;
@@ -85,7 +87,7 @@ int writeU00(EmbPattern* pattern, const char* fileName)
     if(!fileName) { embLog_error("format-u00.c writeU00(), fileName argument is null\n"); return 0; }
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     /* TODO: embFile_open() needs to occur here after the check for no stitches */
@@ -1,4 +1,5 @@
 #include "format-vp3.h"
+#include "emb-reader-writer.h"
 #include "helpers-binary.h"
 #include "emb-file.h"
 #include "emb-logging.h"
@@ -205,6 +206,8 @@ int readVp3(EmbPattern* pattern, const char* fileName)
         t.color.r = binaryReadByte(file);
         t.color.g = binaryReadByte(file);
         t.color.b = binaryReadByte(file);
+        t.catalogNumber = "";
+        t.description = "";
         embPattern_addThread(pattern, t);
         embFile_seek(file, 6*tableSize - 1, SEEK_CUR);
 
@@ -259,7 +262,7 @@ int readVp3(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     embPattern_flipVertical(pattern);
@@ -287,40 +290,35 @@ void vp3PatchByteCount(EmbFile* file, int offset, int adjustment)
   embFile_seek(file, currentPos, SEEK_SET);
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeVp3(EmbPattern* pattern, const char* fileName)
+int writeVp3Stream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
-    EmbFile *file = 0;
     EmbRect bounds;
     int remainingBytesPos, remainingBytesPos2;
     int colorSectionStitchBytes;
     int first = 1;
     int numberOfColors = 0;
 	EmbColor color = embColor_make(0xFE, 0xFE, 0xFE);
-    EmbStitchList *mainPointer = 0, *pointer = 0;
+    EmbStitch* stitches = 0;
+    int stitchCount = 0, mainPointer = 0, pointer = 0;
+    EmbPatternView view;
 
-    if(!pattern) { embLog_error("format-vp3.c writeVp3(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-vp3.c writeVp3(), fileName argument is null\n"); return 0; }
+    if(!pattern) { embLog_error("format-vp3.c writeVp3Stream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-vp3.c writeVp3Stream(), file argument is null\n"); return 0; }
 
     if(!embStitchList_count(pattern->stitchList))
     {
-        embLog_error("format-vp3.c writeVp3(), pattern contains no stitches\n");
+        embLog_error("format-vp3.c writeVp3Stream(), pattern contains no stitches\n");
         return 0;
     }
 
     bounds = embPattern_calcBoundingBox(pattern);
 
-    file = embFile_open(fileName, "wb");
-    if(!file)
-    {
-        embLog_error("format-vp3.c writeVp3(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
-
     embPattern_correctForMaxStitchLength(pattern, 3200.0, 3200.0); /* VP3 can encode signed 16bit deltas */
 
-    embPattern_flipVertical(pattern);
+    /* The stitches are written with y down */
+    view = embPattern_view(pattern, embTransform_scale(1.0, -1.0));
 
     binaryWriteBytes(file, "%vsm%", 5);
     binaryWriteByte(file, 0);
@@ -341,15 +339,17 @@ int writeVp3(EmbPattern* pattern, const char* fileName)
 
     numberOfColors = 0;
 
-    mainPointer = pattern->stitchList;
-    while(mainPointer)
+    stitches = pattern->stitchList->stitch;
+    stitchCount = embStitchList_count(pattern->stitchList);
+    mainPointer = 0;
+    while(mainPointer < stitchCount)
     {
         int flag;
         EmbColor newColor;
 
         pointer = mainPointer;
-        flag = pointer->stitch.flags;
-        newColor = embThreadList_getAt(pattern->threadList, pointer->stitch.color).color;
+        flag = stitches[pointer].flags;
+        newColor = embThreadList_getAt(pattern->threadList, stitches[pointer].color).color;
         if(newColor.r != color.r || newColor.g != color.g || newColor.b != color.b)
         {
             numberOfColors++;
@@ -362,9 +362,9 @@ int writeVp3(EmbPattern* pattern, const char* fileName)
             numberOfColors++;
         }
 
-        while(pointer && (flag == pointer->stitch.flags))
+        while(pointer < stitchCount && (flag == stitches[pointer].flags))
         {
-            pointer = pointer->next;
+            pointer++;
         }
         mainPointer = pointer;
     }
@@ -405,8 +405,8 @@ int writeVp3(EmbPattern* pattern, const char* fileName)
     vp3WriteString(file, "");
     binaryWriteShortBE(file, numberOfColors);
 
-    mainPointer = pattern->stitchList;
-    while(mainPointer)
+    mainPointer = 0;
+    while(mainPointer < stitchCount)
     {
         char colorName[8] = { 0 };
         double lastX, lastY;
@@ -426,18 +426,18 @@ int writeVp3(EmbPattern* pattern, const char* fileName)
         binaryWriteInt(file, 0); /* placeholder */
 
         pointer = mainPointer;
-        color = embThreadList_getAt(pattern->threadList, pointer->stitch.color).color;
+        color = embThreadList_getAt(pattern->threadList, stitches[pointer].color).color;
 
-		if (first && pointer->stitch.flags & JUMP && pointer->next->stitch.flags & JUMP)
+		if (first && stitches[pointer].flags & JUMP && pointer + 1 < stitchCount && stitches[pointer + 1].flags & JUMP)
 		{
-			pointer = pointer->next;
+			pointer++;
 		}
 
-        s = pointer->stitch;
+        s = embPatternView_stitch(&view, pointer);
         embLog_print("format-vp3.c DEBUG %d, %lf, %lf\n", s.flags, s.xx, s.yy);
         binaryWriteIntBE(file, s.xx * 1000);
         binaryWriteIntBE(file, -s.yy * 1000);
-        pointer = pointer->next;
+        pointer++;
 
         first = 0;
 
@@ -448,7 +448,7 @@ int writeVp3(EmbPattern* pattern, const char* fileName)
         binaryWriteByte(file, 1);
         binaryWriteByte(file, 0);
 
-        embLog_print("format-vp3.c writeVp3(), switching to color (%d, %d, %d)\n", color.r, color.g, color.b);
+        embLog_print("format-vp3.c writeVp3Stream(), switching to color (%d, %d, %d)\n", color.r, color.g, color.b);
         binaryWriteByte(file, color.r);
         binaryWriteByte(file, color.g);
         binaryWriteByte(file, color.b);
@@ -478,11 +478,11 @@ int writeVp3(EmbPattern* pattern, const char* fileName)
         binaryWriteByte(file, 246);
         binaryWriteByte(file, 0);
 
-        while(pointer)
+        while(pointer < stitchCount)
         {
             int dx, dy;
 
-            EmbStitch s = pointer->stitch;
+            EmbStitch s = embPatternView_stitch(&view, pointer);
 			if (s.color != lastColor)
 			{
 				break;
@@ -511,7 +511,7 @@ int writeVp3(EmbPattern* pattern, const char* fileName)
                 binaryWriteByte(file, dy);
             }
 
-            pointer = pointer->next;
+            pointer++;
         }
 
         vp3PatchByteCount(file, colorSectionStitchBytes, -4);
@@ -523,11 +523,14 @@ int writeVp3(EmbPattern* pattern, const char* fileName)
     vp3PatchByteCount(file, remainingBytesPos2, -4);
     vp3PatchByteCount(file, remainingBytesPos, -4);
 
-    embFile_close(file);
-
-    embPattern_flipVertical(pattern);
-
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeVp3(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writeVp3Stream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
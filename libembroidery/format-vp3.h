@@ -2,6 +2,7 @@
 #ifndef FORMAT_VP3_H
 #define FORMAT_VP3_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readVp3(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeVp3(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeVp3Stream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
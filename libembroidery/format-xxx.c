@@ -1,4 +1,5 @@
 #include "format-xxx.h"
+#include "emb-reader-writer.h"
 #include "helpers-binary.h"
 #include "helpers-misc.h"
 #include "emb-file.h"
@@ -26,8 +27,6 @@ int readXxx(EmbPattern* pattern, const char* fileName)
     int paletteOffset;
     int i;
     char thisStitchJump = 0;
-    EmbStitchList* lastStitch = 0;
-    EmbStitchList* secondLast = 0;
 
     if(!pattern) { embLog_error("format-xxx.c readXxx(), pattern argument is null\n"); return 0; }
     if(!fileName) { embLog_error("format-xxx.c readXxx(), fileName argument is null\n"); return 0; }
@@ -52,6 +51,8 @@ int readXxx(EmbPattern* pattern, const char* fileName)
         thread.color.r = binaryReadByte(file);
         thread.color.g = binaryReadByte(file);
         thread.color.b = binaryReadByte(file);
+        thread.catalogNumber = "";
+        thread.description = "";
         embPattern_addThread(pattern, thread);
     }
     embFile_seek(file, 0x100, SEEK_SET);
@@ -100,27 +101,10 @@ int readXxx(EmbPattern* pattern, const char* fileName)
         }
         embPattern_addStitchRel(pattern, dx / 10.0, dy / 10.0, flags, 1);
     }
-    lastStitch = pattern->stitchList;
-    secondLast = 0;
-    if(lastStitch)
-    {
-        while(lastStitch->next)
-        {
-            secondLast = lastStitch;
-            lastStitch = lastStitch->next;
-        }
-        if((!pattern->stitchList) && lastStitch->stitch.flags == STOP && secondLast)
-        {
-            free(lastStitch);
-            lastStitch = 0;
-            secondLast->next = NULL;
-            embPattern_changeColor(pattern, pattern->currentColorIndex - 1);
-        }
-    }
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     return 1;
@@ -152,17 +136,18 @@ static void xxxEncodeDesign(EmbFile* file, EmbPattern* p)
 {
     double thisX = 0.0f;
     double thisY = 0.0f;
-    EmbStitchList* stitches = 0;
+    EmbStitch* stitches = 0;
+    EmbStitchIterator it;
 
     if(!embStitchList_empty(p->stitchList))
     {
-        thisX = (float)p->stitchList->stitch.xx;
-        thisY = (float)p->stitchList->stitch.yy;
+        thisX = (float)p->stitchList->stitch[0].xx;
+        thisY = (float)p->stitchList->stitch[0].yy;
     }
-    stitches = p->stitchList;
-    while(stitches)
+    it = embStitchList_begin(p->stitchList);
+    while((stitches = embStitchIterator_next(&it)))
     {
-        EmbStitch s = stitches->stitch;
+        EmbStitch s = *stitches;
         double deltaX, deltaY;
         double previousX = thisX;
         double previousY = thisY;
@@ -181,41 +166,32 @@ static void xxxEncodeDesign(EmbFile* file, EmbPattern* p)
         {
             xxxEncodeStitch(file, deltaX * 10.0f, deltaY * 10.0f, s.flags);
         }
-        stitches = stitches->next;
     }
 }
 
-/*! Writes the data from \a pattern to a file with the given \a fileName.
+/*! Writes the data from \a pattern to the stream \a file.
  *  Returns \c true if successful, otherwise returns \c false. */
-int writeXxx(EmbPattern* pattern, const char* fileName)
+int writeXxxStream(EmbPattern* pattern, EmbFile* file, const char* fileName)
 {
-    EmbFile* file = 0;
     int i;
     EmbRect rect;
     int endOfStitches;
-    EmbThreadList* colors = 0;
+    int t;
     int curColor = 0;
 
-    if(!pattern) { embLog_error("format-xxx.c writeXxx(), pattern argument is null\n"); return 0; }
-    if(!fileName) { embLog_error("format-xxx.c writeXxx(), fileName argument is null\n"); return 0; }
+    if(!pattern) { embLog_error("format-xxx.c writeXxxStream(), pattern argument is null\n"); return 0; }
+    if(!file) { embLog_error("format-xxx.c writeXxxStream(), file argument is null\n"); return 0; }
 
     if(!embStitchList_count(pattern->stitchList))
     {
-        embLog_error("format-xxx.c writeXxx(), pattern contains no stitches\n");
+        embLog_error("format-xxx.c writeXxxStream(), pattern contains no stitches\n");
         return 0;
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
-    file = embFile_open(fileName, "wb");
-    if(!file)
-    {
-        embLog_error("format-xxx.c writeXxx(), cannot open %s for writing\n", fileName);
-        return 0;
-    }
-
     embPattern_correctForMaxStitchLength(pattern, 124, 127);
 
     for(i = 0; i < 0x17; i++)
@@ -227,7 +203,7 @@ int writeXxx(EmbPattern* pattern, const char* fileName)
     {
         binaryWriteByte(file, 0x00);
     }
-    binaryWriteUShort(file, (unsigned short)embThreadList_count(pattern->threadList));
+    binaryWriteUShort(file, (unsigned short)embPattern_threadCount(pattern));
     binaryWriteShort(file, 0x0000);
 
     rect = embPattern_calcBoundingBox(pattern);
@@ -260,15 +236,13 @@ int writeXxx(EmbPattern* pattern, const char* fileName)
     binaryWriteByte(file, 0x14);
     binaryWriteByte(file, 0x00);
     binaryWriteByte(file, 0x00);
-    colors = pattern->threadList;
-    while(colors)
+    for(t = 0; t < embThreadList_count(pattern->threadList); t++)
     {
         binaryWriteByte(file, 0x00);
-        binaryWriteByte(file, colors->thread.color.r);
-        binaryWriteByte(file, colors->thread.color.g);
-        binaryWriteByte(file, colors->thread.color.b);
+        binaryWriteByte(file, pattern->threadList->thread[t].color.r);
+        binaryWriteByte(file, pattern->threadList->thread[t].color.g);
+        binaryWriteByte(file, pattern->threadList->thread[t].color.b);
         curColor++;
-        colors = colors->next;
     }
     for(i = 0; i < (22 - curColor); i++)
     {
@@ -276,8 +250,14 @@ int writeXxx(EmbPattern* pattern, const char* fileName)
     }
     binaryWriteByte(file, 0x00);
     binaryWriteByte(file, 0x01);
-    embFile_close(file);
     return 1;
 }
 
+/*! Writes the data from \a pattern to a file with the given \a fileName.
+ *  Returns \c true if successful, otherwise returns \c false. */
+int writeXxx(EmbPattern* pattern, const char* fileName)
+{
+    return embReaderWriter_writeFile(pattern, fileName, "wb", writeXxxStream);
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
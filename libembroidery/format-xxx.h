@@ -2,6 +2,7 @@
 #ifndef FORMAT_XXX_H
 #define FORMAT_XXX_H
 
+#include "emb-file.h"
 #include "emb-pattern.h"
 
 #include "api-start.h"
@@ -11,6 +12,7 @@ extern "C" {
 
 extern EMB_PRIVATE int EMB_CALL readXxx(EmbPattern* pattern, const char* fileName);
 extern EMB_PRIVATE int EMB_CALL writeXxx(EmbPattern* pattern, const char* fileName);
+extern EMB_PRIVATE int EMB_CALL writeXxxStream(EmbPattern* pattern, EmbFile* file, const char* fileName);
 
 #ifdef __cplusplus
 }
@@ -80,7 +80,7 @@ int readZsk(EmbPattern* pattern, const char* fileName)
     embFile_close(file);
 
     /* Check for an END stitch and add one if it is not present */
-	if (pattern->lastStitch->stitch.flags != END)
+	if (embStitchList_last(pattern->stitchList)->flags != END)
 	{
 		embPattern_addStitchRel(pattern, 0, 0, END, 1);
 	}
@@ -101,7 +101,7 @@ int writeZsk(EmbPattern* pattern, const char* fileName)
     }
 
     /* Check for an END stitch and add one if it is not present */
-    if(pattern->lastStitch && pattern->lastStitch->stitch.flags != END)
+    if(!embStitchList_empty(pattern->stitchList) && embStitchList_last(pattern->stitchList)->flags != END)
         embPattern_addStitchRel(pattern, 0, 0, END, 1);
 
     /* TODO: embFile_open() needs to occur here after the check for no stitches */
@@ -128,4 +128,98 @@ char* emb_strdup(const char* src)
     return dest;
 }
 
+static const double emb_powersOfTen[23] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/*! Parses the decimal number at the start of the characters [\a first, \a last) into (\a value), like C++17's
+ *  std::from_chars(): nothing is skipped before the number, the locale is ignored and the string need not be
+ *  terminated. A leading '+' is accepted, as SVG allows one. Returns the end of the number, or (\a first) if there
+ *  is none, in which case (\a value) is left alone. Numbers of up to 15 significant digits with a small exponent are
+ *  converted exactly without strtod(). */
+const char* emb_fromChars(const char* first, const char* last, double* value)
+{
+    const char* p = first;
+    const char* q = 0;
+    double mantissa = 0.0;
+    int negative = 0;
+    int digits = 0;       /* significant digits in mantissa */
+    int exactDigits = 1;
+    int anyDigits = 0;
+    int exponent = 0;
+    int e = 0;
+    int eNegative = 0;
+
+    if(!first || !last || !value) { embLog_error("helpers-misc.c emb_fromChars(), invalid argument\n"); return first; }
+
+    if(p < last && (*p == '+' || *p == '-'))
+        negative = (*p++ == '-');
+    for(; p < last && *p >= '0' && *p <= '9'; p++)
+    {
+        anyDigits = 1;
+        if(mantissa == 0.0 && *p == '0')
+            continue;
+        if(digits < 15) { mantissa = mantissa * 10.0 + (*p - '0'); digits++; }
+        else { exponent++; exactDigits = 0; }
+    }
+    if(p < last && *p == '.')
+    {
+        for(p++; p < last && *p >= '0' && *p <= '9'; p++)
+        {
+            anyDigits = 1;
+            if(mantissa == 0.0 && *p == '0') { exponent--; continue; }
+            if(digits < 15) { mantissa = mantissa * 10.0 + (*p - '0'); digits++; exponent--; }
+            else exactDigits = 0;
+        }
+    }
+    if(!anyDigits)
+        return first;
+
+    /* An exponent only counts if at least one digit follows the 'e' */
+    if(p < last && (*p == 'e' || *p == 'E'))
+    {
+        q = p + 1;
+        if(q < last && (*q == '+' || *q == '-'))
+            eNegative = (*q++ == '-');
+        if(q < last && *q >= '0' && *q <= '9')
+        {
+            for(; q < last && *q >= '0' && *q <= '9'; q++)
+            {
+                if(e < 10000)
+                    e = e * 10 + (*q - '0');
+            }
+            exponent += eNegative ? -e : e;
+            p = q;
+        }
+    }
+
+    if(exactDigits && exponent >= -22 && exponent <= 22)
+    {
+        /* Both operands are exact, so the one rounding gives the correctly rounded result */
+        *value = exponent < 0 ? mantissa / emb_powersOfTen[-exponent] : mantissa * emb_powersOfTen[exponent];
+    }
+    else
+    {
+        char buffer[64];
+        char* copy = buffer;
+        size_t length = (size_t)(p - first);
+        if(length >= sizeof(buffer))
+        {
+            copy = (char*)malloc(length + 1);
+            if(!copy) { embLog_error("helpers-misc.c emb_fromChars(), cannot allocate memory\n"); return first; }
+        }
+        memcpy(copy, first, length);
+        copy[length] = 0;
+        *value = strtod(copy, 0);
+        if(copy != buffer)
+            free(copy);
+        return p;
+    }
+    if(negative)
+        *value = -*value;
+    return p;
+}
+
 /* kate: bom off; indent-mode cstyle; indent-width 4; replace-trailing-space-save on; */
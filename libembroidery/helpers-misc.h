@@ -27,6 +27,7 @@ char *copy_trim(char const *s);
 void inplace_trim(char *s);
 char* emb_optOut(double num, char* str);
 char* emb_strdup(const char* src);
+const char* emb_fromChars(const char* first, const char* last, double* value);
 
 #ifdef __cplusplus
 }
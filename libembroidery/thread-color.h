@@ -32,6 +32,14 @@ typedef enum
     Z102_Isacord_Polyester
 } ThreadBrand;
 
+/* One entry of a thread catalog. */
+typedef struct ThreadColor_
+{
+    unsigned int color; /* #AARRGGBB */
+    int num;            /* catalog number, -1 if the catalog does not give one */
+    const char* name;   /* "" if the catalog does not give one */
+} ThreadColor;
+
 /* NOTE:
  * colors must be passed in #AARRGGBB format with
  * the alpha value always being FF, i.e. opaque
@@ -39,6 +47,11 @@ typedef enum
 
 int threadColorNum(unsigned int color, ThreadBrand brand);
 const char* threadColorName(unsigned int color, ThreadBrand brand);
+unsigned int threadColorFromNum(int num, ThreadBrand brand);
+const char* threadColorNameFromNum(int num, ThreadBrand brand);
+unsigned int threadColorNearest(unsigned int color, ThreadBrand brand);
+int threadColorTranslateNum(int num, ThreadBrand from, ThreadBrand to);
+const ThreadColor* threadColorCatalog(ThreadBrand brand, int* count);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,134 @@
+#include <math.h>
+#include <algorithm>
+#include "density.hpp"
+
+using namespace std;
+
+static const size_t INITIAL_SLOTS = 1024;
+
+static inline size_t hashCell(int32_t cx, int32_t cy) {
+    uint64_t h = (uint64_t(uint32_t(cx)) << 32) | uint32_t(cy);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return size_t(h);
+}
+
+/** Constructor: `cell_size` is the edge length of a cell in millimetres and
+ * `radius` is how many cells around a stitch also count towards its density
+ * (0 counts only the stitch's own cell).
+ */
+DensityGrid::DensityGrid(float cell_size, int radius)
+    : cell_size_{1}, inv_cell_size_{1}, radius_{0}, used_{0}, mask_{0} {
+    configure(cell_size, radius);
+}
+
+/** Changes the cell size and neighbourhood radius.
+ * Any stitches recorded so far are forgotten, since they were binned for the
+ * old cell size.
+ */
+void DensityGrid::configure(float cell_size, int radius) {
+    cell_size_ = cell_size > 0 ? cell_size : 1;
+    inv_cell_size_ = 1 / cell_size_;
+    radius_ = radius > 0 ? radius : 0;
+    clear();
+}
+
+/** Forgets every recorded stitch. */
+void DensityGrid::clear() {
+    slots_.assign(INITIAL_SLOTS, Cell{EMPTY, EMPTY, 0, 0});
+    mask_ = INITIAL_SLOTS - 1;
+    used_ = 0;
+}
+
+float DensityGrid::cellSize() const {
+    return cell_size_;
+}
+
+int DensityGrid::radius() const {
+    return radius_;
+}
+
+/** Returns the number of occupied cells. */
+size_t DensityGrid::size() const {
+    return used_;
+}
+
+/** Records a stitch at `(x, y)`.
+ * Returns the number of stitches within the configured radius of the
+ * stitch's cell, including this one.
+ */
+int DensityGrid::add(float x, float y) {
+    // nearbyint rounds the same way the old "%.0f" position keys did
+    int32_t cx = int32_t(nearbyint(x * inv_cell_size_));
+    int32_t cy = int32_t(nearbyint(y * inv_cell_size_));
+
+    if ((used_ + 1) * 2 > slots_.size()) {
+        grow();
+    }
+    size_t i = find(cx, cy);
+    Cell& cell = slots_[i];
+    if (cell.cx == EMPTY) {
+        cell = Cell{cx, cy, 0, 0};
+        ++used_;
+    }
+    ++cell.count;
+
+    int total = cell.count;
+    for (int dx = -radius_; dx <= radius_; ++dx) {
+        for (int dy = -radius_; dy <= radius_; ++dy) {
+            if (dx != 0 || dy != 0) {
+                total += countAt(cx + dx, cy + dy);
+            }
+        }
+    }
+    // find() is not called again before this write, so `cell` is still valid
+    cell.peak = max(cell.peak, total);
+    return total;
+}
+
+/** Returns the cells whose peak density exceeded `limit`, ordered by
+ * position, for reporting.
+ */
+vector<DensityGrid::Cell> DensityGrid::cellsOver(int limit) const {
+    vector<Cell> over;
+    for (const Cell& cell : slots_) {
+        if (cell.cx != EMPTY && cell.peak > limit) {
+            over.push_back(cell);
+        }
+    }
+    sort(over.begin(), over.end(), [](const Cell& a, const Cell& b) {
+        return a.cx != b.cx ? a.cx < b.cx : a.cy < b.cy;
+    });
+    return over;
+}
+
+// Linear probing: returns the slot holding (cx, cy), or the empty slot where
+// it would go.
+size_t DensityGrid::find(int32_t cx, int32_t cy) const {
+    size_t i = hashCell(cx, cy) & mask_;
+    while (slots_[i].cx != EMPTY &&
+           (slots_[i].cx != cx || slots_[i].cy != cy)) {
+        i = (i + 1) & mask_;
+    }
+    return i;
+}
+
+int DensityGrid::countAt(int32_t cx, int32_t cy) const {
+    const Cell& cell = slots_[find(cx, cy)];
+    return cell.cx == EMPTY ? 0 : cell.count;
+}
+
+void DensityGrid::grow() {
+    vector<Cell> old;
+    old.swap(slots_);
+    slots_.assign(old.size() * 2, Cell{EMPTY, EMPTY, 0, 0});
+    mask_ = slots_.size() - 1;
+    for (const Cell& cell : old) {
+        if (cell.cx != EMPTY) {
+            slots_[find(cell.cx, cell.cy)] = cell;
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef densityhppincluded
+#define densityhppincluded
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Counts needle drops per grid cell so the Turtle can spot places where too
+ * many stitches pile up. Positions are snapped to integer cells of a
+ * configurable size and kept in an open-addressing hash table, so recording a
+ * stitch costs a handful of integer operations and no allocation once the
+ * table has grown to fit the design.
+ */
+class DensityGrid {
+ public:
+    struct Cell {
+        int32_t cx;
+        int32_t cy;
+        int count;  // stitches that landed in this cell
+        int peak;   // largest neighbourhood count seen when adding to it
+    };
+
+    DensityGrid(float cell_size, int radius);
+
+    void configure(float cell_size, int radius);
+    int add(float x, float y);
+    void clear();
+
+    float cellSize() const;
+    int radius() const;
+    size_t size() const;
+
+    std::vector<Cell> cellsOver(int limit) const;
+
+ private:
+    static constexpr int32_t EMPTY = INT32_MIN;
+
+    size_t find(int32_t cx, int32_t cy) const;
+    int countAt(int32_t cx, int32_t cy) const;
+    void grow();
+
+    float cell_size_;
+    float inv_cell_size_;
+    int radius_;
+    size_t used_;
+    size_t mask_;
+    std::vector<Cell> slots_;
+};
+
+#endif
@@ -1,10 +1,17 @@
+#include <cstdio>
 #include <iostream>
 #include <math.h>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
 #include <string>
+#include <thread>
+#include <tuple>
 
 #include "format-dst.h"
 #include "emb-pattern.h"
+#include "emb-settings.h"
 #include "turtle.hpp"
 #include "alphabet.hpp"
 
@@ -22,6 +29,18 @@ Turtle::Turtle()
       satin_delta_{.5},
       dir_{Point(1, 0)},
       position_{Point(0, 0)},
+      transform_{embTransform_identity()},
+      inverse_{embTransform_identity()},
+      transformed_{false},
+      needle_left_behind_{false},
+      tape_{nullptr},
+      capture_{nullptr},
+      stream_{nullptr},
+      last_x_{0},
+      last_y_{0},
+      streamed_any_{false},
+      density_{DENSITY_CELL_SIZE, DENSITY_RADIUS},
+      density_check_{true},
       density_error_{false},
       density_warning_{false} {
     embPattern_addThread(
@@ -31,6 +50,9 @@ Turtle::Turtle()
 
 /** Destructor: The destructor calls the appropriate libembroidery cleanup. */
 Turtle::~Turtle() {
+    if (stream_) {
+        end();
+    }
     embPattern_free(emb_);
 }
 
@@ -43,6 +65,7 @@ Turtle::~Turtle() {
  * When satin sttich is on, this sets the *width* of the satin stitch.
 */
 void Turtle::setStepSize(float step) {
+    if (recorded(TurtleTape::STEPSIZE, step)) return;
     stepsize_ = step;
 }
 
@@ -51,6 +74,7 @@ void Turtle::setStepSize(float step) {
  * creating the effect of a wider line of thread.
  */
 void Turtle::satinon(float delta) {
+    if (recorded(TurtleTape::SATINON, delta)) return;
     satin_is_on_ = true;
     satin_delta_ = delta;
 }
@@ -60,6 +84,7 @@ void Turtle::satinon(float delta) {
  * stitch line, using the current step size.
  */
 void Turtle::satinoff() {
+    if (recorded(TurtleTape::SATINOFF)) return;
     satin_is_on_ = false;
 }
 
@@ -68,6 +93,7 @@ void Turtle::satinoff() {
  * path it follows.
  */
 void Turtle::pendown() {
+    if (recorded(TurtleTape::PENDOWN)) return;
     pen_is_down_ = true;
 }
 
@@ -76,14 +102,36 @@ void Turtle::pendown() {
  * to another without adding any stitches.
  */
 void Turtle::penup() {
+    if (recorded(TurtleTape::PENUP)) return;
     pen_is_down_ = false;
 }
 
+/** Configures the stitch density check.
+ * Stitch positions are binned into square cells `cellsize` millimetres wide.
+ * A stitch counts every stitch in its own cell and in the cells up to
+ * `radius` cells away, so a radius of 1 also catches stitches that overlap
+ * across a cell boundary. Stitches checked before the call are forgotten.
+ * A `cellsize` of 0 turns the check off. The check remembers every cell the
+ * design covers, so streaming a very large design (see stream()) only runs in
+ * constant memory with it off.
+ */
+void Turtle::setDensityCheck(float cellsize, int radius) {
+    density_check_ = cellsize > 0;
+    density_.configure(cellsize, radius);
+    density_error_ = false;
+    density_warning_ = false;
+}
+
 /** Returns the Turtle's current position.
- * The position is returned as a Point object.
+ * The position is returned as a Point object, in the Turtle's own
+ * coordinates as set up by translate(), rotate() and scale().
  */
 Point Turtle::position() {
-    return position_;
+    if (!transformed_) {
+        return position_;
+    }
+    EmbPoint p = embTransform_apply(inverse_, embPoint_make(position_.x_, position_.y_));
+    return Point(p.xx, p.yy);
 }
 
 // Functions for turning the Turtle
@@ -93,7 +141,8 @@ Point Turtle::position() {
  * the Point `pos`. The turtle's location is not changed.
  */
 void Turtle::turntoward(const Point& pos) {
-    Point delta = pos - position_;
+    if (recorded(TurtleTape::TURNTOWARD, pos.x_, pos.y_)) return;
+    Point delta = pos - position();
     dir_ = delta.normalize(1);
 }
 
@@ -111,6 +160,7 @@ void Turtle::turntoward(const float x, const float y) {
  * the point `pos`.
  */
 void Turtle::setdir(const Point& pos) {
+    if (recorded(TurtleTape::SETDIR, pos.x_, pos.y_)) return;
     dir_ = pos.normalize(1);
 }
 
@@ -124,9 +174,8 @@ void Turtle::setdir(const float x, const float y) {
 
 /** Turns the Turle `degreesccw` degrees. */
 void Turtle::turn(const float degreesccw) {
-    float radcw = -degreesccw / 180.0 * 3.141592653589;
-    dir_ = Point(cos(radcw) * dir_.x_ - sin(radcw) * dir_.y_,
-                 sin(radcw) * dir_.x_ + cos(radcw) * dir_.y_);
+    if (recorded(TurtleTape::TURN, degreesccw)) return;
+    dir_ = rotated(dir_, degreesccw);
 }
 
 /** Turns the turtle right `degreesccw`.
@@ -150,7 +199,8 @@ void Turtle::left(float degreesccw) {
  * using the Turtle's current move settings.
  */
 void Turtle::move(const Point& delta) {
-    gotopoint(position_ + delta);
+    if (recorded(TurtleTape::MOVE, delta.x_, delta.y_)) return;
+    go(position_ + toPatternVector(delta));
 }
 
 /** Relative move from Turtle's current position
@@ -177,18 +227,8 @@ void Turtle::gotopoint(const float x, const float y) {
  * current move settings.
  */
 void Turtle::gotopoint(const Point& pos) {
-    // if (pos == position_) {
-    //    return;
-    //}
-    if (pen_is_down_) {
-        if (satin_is_on_) {
-            satin_stitch_to(pos);
-        } else {
-            stitch_to(pos);
-        }
-    } else {
-        jump_to(pos);
-    }
+    if (recorded(TurtleTape::GOTO, pos.x_, pos.y_)) return;
+    go(toPattern(pos));
 }
 
 /** Relative move forward
@@ -196,7 +236,12 @@ void Turtle::gotopoint(const Point& pos) {
  * is currently facing.
  */
 void Turtle::forward(const float dist) {
-    move(dir_ * dist);
+    if (recorded(TurtleTape::FORWARD, dist)) return;
+    if (transformed_) {
+        go(position_ + toPatternVector(dir_ * dist));
+    } else {
+        go(Point(position_.x_ + dir_.x_ * dist, position_.y_ + dir_.y_ * dist));
+    }
 }
 
 /** Relative move backward
@@ -204,7 +249,109 @@ void Turtle::forward(const float dist) {
  * is currently facing.
  */
 void Turtle::backward(const float dist) {
-    move(dir_ * dist * -1);
+    forward(-dist);
+}
+
+/** Absolute moves through every point of `points`, in order.
+ * Equivalent to calling `gotopoint` on each point, using the Turtle's
+ * current move settings.
+ */
+void Turtle::polyline(const std::vector<Point>& points) {
+    polyline(points.data(), points.size());
+}
+
+/** Absolute moves through the `count` points starting at `points`.
+ * Equivalent to calling `gotopoint` on each point, using the Turtle's
+ * current move settings.
+ */
+void Turtle::polyline(const Point* points, size_t count) {
+    if (tape_) {
+        for (size_t i = 0; i < count; ++i) {
+            gotopoint(points[i]);
+        }
+        return;
+    }
+    // The stitches of every segment go to the pattern in one run
+    for (size_t i = 0; i < count; ++i) {
+        go(toPattern(points[i]), false);
+    }
+    flush_stitches();
+}
+
+// Functions for saving state and changing coordinates
+
+/** Saves the Turtle's state.
+ * Position, heading, pen and satin settings, step size and the transform
+ * set up by translate(), rotate() and scale() are pushed on a stack, to be
+ * restored by the matching pop().
+ */
+void Turtle::push() {
+    if (recorded(TurtleTape::PUSH)) return;
+    stack_.push_back(State{position_, dir_, stepsize_, satin_delta_,
+                           pen_is_down_, satin_is_on_, transform_});
+}
+
+/** Restores the state saved by the last push().
+ * The Turtle goes back to where it was without adding a stitch. If it
+ * stitches again from there, a single jump is added first; if it moves
+ * with the pen up, the jump goes straight to the new position. Recursive
+ * designs can return from a branch this way instead of backing up over it.
+ */
+void Turtle::pop() {
+    if (recorded(TurtleTape::POP)) return;
+    if (stack_.empty()) {
+        cerr << "Turtle::pop(): no state was pushed" << endl;
+        return;
+    }
+    const State& state = stack_.back();
+    if (!(state.position == position_)) {
+        needle_left_behind_ = true;
+    }
+    position_ = state.position;
+    dir_ = state.dir;
+    stepsize_ = state.stepsize;
+    satin_delta_ = state.satin_delta;
+    pen_is_down_ = state.pen_is_down;
+    satin_is_on_ = state.satin_is_on;
+    setTransform(state.transform);
+    stack_.pop_back();
+}
+
+/** Moves the origin of the Turtle's coordinates to `(x, y)`.
+ * Like rotate() and scale(), this changes how later positions, directions
+ * and distances are read, not where the Turtle is. Step size and satin
+ * width stay in millimetres.
+ */
+void Turtle::translate(const float x, const float y) {
+    if (recorded(TurtleTape::TRANSLATE, x, y)) return;
+    setTransform(embTransform_multiply(embTransform_translate(x, y), transform_));
+}
+
+/** Rotates the Turtle's coordinates `degreesccw` degrees about their origin,
+ * the same way turn() turns the Turtle. The heading turns with them.
+ */
+void Turtle::rotate(const float degreesccw) {
+    if (recorded(TurtleTape::ROTATE, degreesccw)) return;
+    const Point x = rotated(Point(1, 0), degreesccw);
+    setTransform(embTransform_multiply(
+        embTransform_make(x.x_, x.y_, -x.y_, x.x_, 0, 0), transform_));
+}
+
+/** Scales the Turtle's coordinates by `factor` about their origin. */
+void Turtle::scale(const float factor) {
+    scale(factor, factor);
+}
+
+/** Scales the Turtle's coordinates by `x` along their x axis and `y` along
+ * their y axis. A factor of 0 is ignored.
+ */
+void Turtle::scale(const float x, const float y) {
+    if (recorded(TurtleTape::SCALE, x, y)) return;
+    if (x == 0 || y == 0) {
+        cerr << "Turtle::scale(): cannot scale by 0" << endl;
+        return;
+    }
+    setTransform(embTransform_multiply(embTransform_scale(x, y), transform_));
 }
 
 // Functions for drawing text
@@ -221,28 +368,305 @@ bool notInAlphabet(char c) {
 }
 
 void Turtle::displayMessage(string message, float scale) {
+    if (tape_) {
+        recorded(TurtleTape::MESSAGE, scale, 0, unsigned(tape_->messages_.size()));
+        tape_->messages_.push_back(message);
+        return;
+    }
     transform(message.begin(), message.end(), message.begin(), ::toupper);
     message.erase(remove_if(message.begin(), message.end(), notInAlphabet),
                   message.end());
 
     bool pen_was_down = pen_is_down_;
-    float start_y = position_.y_;
-    float max_x = position_.x_;
+    float start_y = position().y_;
+    float max_x = position().x_;
+    const Point heading = dir_;
 
     for (char& nextChar : message) {
-        penup();
-        for (const Point& p : Alphabet[nextChar]) {
-            move(p * scale);
-            if (position_.x_ > max_x)
-                max_x = position_.x_;
-            pen_is_down_ = pen_was_down;
-        }
+        shared_ptr<const Glyph> letter = glyph(nextChar, scale, pen_was_down);
+        float left = position().x_;
+        place(letter->stitches);
+        dir_ = heading;
+        if (left + letter->right > max_x)
+            max_x = left + letter->right;
         penup();  // raise pen to jump to next letter
         gotopoint(max_x + 3 * scale, start_y);
         pen_is_down_ = pen_was_down;
     }
 }
 
+bool Turtle::GlyphKey::operator<(const GlyphKey& other) const {
+    return std::tie(letter, scale, stepsize, satin_delta, pen_is_down, satin_is_on, a, b, c, d) <
+           std::tie(other.letter, other.scale, other.stepsize, other.satin_delta, other.pen_is_down,
+                    other.satin_is_on, other.a, other.b, other.c, other.d);
+}
+
+std::map<Turtle::GlyphKey, std::shared_ptr<const Turtle::Glyph>> Turtle::glyphs_;
+std::mutex Turtle::glyphs_mutex_;
+std::mutex TurtleTape::expansions_mutex_;
+
+// Functions for recording and replaying
+
+bool TurtleTape::Key::operator<(const Key& other) const {
+    return std::tie(a, b, c, d, stepsize, satin_delta, pen_is_down, satin_is_on) <
+           std::tie(other.a, other.b, other.c, other.d, other.stepsize, other.satin_delta,
+                    other.pen_is_down, other.satin_is_on);
+}
+
+/** Forgets every recorded call, along with the stitches they expanded to. */
+void TurtleTape::clear() {
+    commands_.clear();
+    tapes_.clear();
+    messages_.clear();
+    lock_guard<mutex> lock(expansions_mutex_);
+    expansions_.clear();
+}
+
+/** Returns the number of recorded calls. */
+size_t TurtleTape::size() const {
+    return commands_.size();
+}
+
+/** Starts recording into `tape`.
+ * Until stopRecording() is called, the calls that move or turn the Turtle or
+ * change its pen, satin or step size settings are appended to `tape` instead
+ * of being carried out, and the Turtle stays where it is. Whatever `tape` held
+ * before is cleared, so do not re-record a tape that another tape plays.
+ */
+void Turtle::record(TurtleTape& tape) {
+    tape.clear();
+    tape_ = &tape;
+}
+
+/** Stops recording; calls are carried out again. */
+void Turtle::stopRecording() {
+    tape_ = nullptr;
+}
+
+/** Plays `tape` from the Turtle's current position and heading.
+ * This is the same as making the recorded calls again with every distance
+ * multiplied by `scale`, which must be positive, and with the positions and
+ * directions on the tape turned to the current heading. Step size and satin
+ * width are not scaled. Whatever the tape pushes it must pop, and the
+ * coordinates it sets up with translate(), rotate() and scale() only last
+ * until it ends.
+ * The first time a tape is played at a given scale and with given pen
+ * settings its stitches are worked out and kept; after that they are only
+ * turned and moved into place. While recording, playing a tape records it, so
+ * motifs can be built from smaller ones. A tape must not play itself.
+ */
+void Turtle::play(const TurtleTape& tape, float scale) {
+    if (tape_) {
+        if (&tape == tape_) {
+            cerr << "Turtle::play(): a tape cannot play itself" << endl;
+            return;
+        }
+        recorded(TurtleTape::PLAY, scale, 0, unsigned(tape_->tapes_.size()));
+        tape_->tapes_.push_back(&tape);
+        return;
+    }
+
+    // Split the tape's frame into a turn and what is left once the turn is
+    // taken out, which is all the stitches depend on
+    EmbTransform base;
+    Point turn(1, 0);
+    const EmbTransform t = transform_;
+    const double size = t.a * t.a + t.b * t.b;
+    if (size > 0 && fabs(t.a * t.c + t.b * t.d) <= 1e-9 * size &&
+        fabs(t.c * t.c + t.d * t.d - size) <= 1e-9 * size) {
+        const double s = sqrt(size);
+        const float flip = t.a * t.d - t.b * t.c < 0 ? -1 : 1;
+        const Point heading = dir_.normalize(1);
+        const Point axis(t.a / s, t.b / s);
+        base = embTransform_make(s * scale, 0, 0, flip * s * scale, 0, 0);
+        turn = Point(axis.x_ * heading.x_ - flip * axis.y_ * heading.y_,
+                     axis.y_ * heading.x_ + flip * axis.x_ * heading.y_);
+    } else {
+        base = embTransform_multiply(
+            embTransform_make(dir_.x_ * scale, dir_.y_ * scale, -dir_.y_ * scale, dir_.x_ * scale, 0, 0), t);
+    }
+
+    TurtleTape::Key key{base.a, base.b, base.c, base.d, stepsize_, satin_delta_, pen_is_down_, satin_is_on_};
+    shared_ptr<const TurtleTape::Expansion> found;
+    {
+        lock_guard<mutex> lock(TurtleTape::expansions_mutex_);
+        auto cached = tape.expansions_.find(key);
+        if (cached != tape.expansions_.end()) {
+            found = cached->second;
+        }
+    }
+    if (!found) {
+        // Worked out without the lock, as the tape may play others; if
+        // another Turtle expands it meanwhile, the first one kept is used
+        auto expansion = make_shared<TurtleTape::Expansion>();
+        TurtleTape::Expansion* outer = capture_;
+        const Point start = position_;
+        const Point heading = dir_;
+        bool left_behind = needle_left_behind_;
+
+        capture_ = expansion.get();
+        position_ = Point(0, 0);
+        dir_ = Point(1, 0);
+        setTransform(base);
+        needle_left_behind_ = false;
+        run(tape, 1);
+        expansion->end_x = position_.x_;
+        expansion->end_y = position_.y_;
+        expansion->dir_x = dir_.x_;
+        expansion->dir_y = dir_.y_;
+        expansion->stepsize = stepsize_;
+        expansion->satin_delta = satin_delta_;
+        expansion->pen_is_down = pen_is_down_;
+        expansion->satin_is_on = satin_is_on_;
+        expansion->needle_left_behind = needle_left_behind_;
+        capture_ = outer;
+        position_ = start;
+        dir_ = heading;
+        setTransform(t);
+        needle_left_behind_ = left_behind;
+        lock_guard<mutex> lock(TurtleTape::expansions_mutex_);
+        if (tape.expansions_.size() >= TurtleTape::MAX_EXPANSIONS) {
+            tape.expansions_.clear();
+        }
+        found = tape.expansions_.emplace(key, expansion).first->second;
+    }
+
+    // The heading the tape ends at is relative to the one it started at
+    const Point heading = dir_;
+    place(*found, turn);
+    if (!(heading == Point(1, 0))) {
+        dir_ = Point(heading.x_ * dir_.x_ - heading.y_ * dir_.y_,
+                     heading.y_ * dir_.x_ + heading.x_ * dir_.y_).normalize(1);
+    }
+}
+
+// Functions for drawing parts of a design at the same time
+
+TurtleComposition::TurtleComposition() : new_color_{false} {}
+
+/** Adds a part, drawn by calling `part` on a Turtle of its own. */
+void TurtleComposition::add(std::function<void(Turtle&)> part) {
+    parts_.push_back(Part{part, new_color_});
+    new_color_ = false;
+}
+
+/** Sews the parts added after this in the next thread color. */
+void TurtleComposition::changeColor() {
+    new_color_ = true;
+}
+
+/** Forgets every part. */
+void TurtleComposition::clear() {
+    parts_.clear();
+    new_color_ = false;
+}
+
+/** Returns the number of parts. */
+size_t TurtleComposition::size() const {
+    return parts_.size();
+}
+
+/** Draws the parts of `composition` and sews them one after the other.
+ * Each part is drawn by a Turtle of its own, on one of `threads` threads
+ * (by default one per core). That Turtle starts where this one stands,
+ * facing the same way, with the same coordinates and settings, and keeps
+ * its stitches until every part is done. They are then sewn in the order the
+ * parts were added, whichever finished first, with a trim between parts, or
+ * a color change where TurtleComposition::changeColor() asked for one.
+ * Afterwards this Turtle is back where it started, as after pop().
+ * Parts run at the same time; they may play the same tapes, but must not
+ * record into a tape or change anything else they share, and they must not
+ * stream(), save() or end(). If a part throws, the exception is rethrown here once every part is
+ * done and nothing is sewn. A composition cannot be recorded.
+ */
+void Turtle::compose(const TurtleComposition& composition, unsigned threads) {
+    if (tape_) {
+        cerr << "Turtle::compose(): a composition cannot be recorded" << endl;
+        return;
+    }
+    const size_t count = composition.parts_.size();
+    vector<TurtleTape::Expansion> drawn(count);
+    vector<exception_ptr> failed(count);
+    atomic<size_t> next{0};
+
+    // Parts stitch relative to this Turtle's position, as tapes do
+    EmbTransform frame = transform_;
+    frame.e -= position_.x_;
+    frame.f -= position_.y_;
+
+    auto work = [&]() {
+        for (size_t i = next++; i < count; i = next++) {
+            Turtle part;
+            part.setTransform(frame);
+            part.dir_ = dir_;
+            part.stepsize_ = stepsize_;
+            part.satin_delta_ = satin_delta_;
+            part.pen_is_down_ = pen_is_down_;
+            part.satin_is_on_ = satin_is_on_;
+            part.density_check_ = false;  // the stitches are checked once sewn here
+            part.capture_ = &drawn[i];
+            try {
+                composition.parts_[i].draw(part);
+            } catch (...) {
+                failed[i] = current_exception();
+            }
+            part.capture_ = nullptr;
+
+            // Placing the part moves this Turtle but changes nothing else
+            TurtleTape::Expansion& e = drawn[i];
+            e.end_x = part.position_.x_;
+            e.end_y = part.position_.y_;
+            e.dir_x = dir_.x_;
+            e.dir_y = dir_.y_;
+            e.stepsize = stepsize_;
+            e.satin_delta = satin_delta_;
+            e.pen_is_down = pen_is_down_;
+            e.satin_is_on = satin_is_on_;
+            e.needle_left_behind = part.needle_left_behind_;
+        }
+    };
+
+    if (threads == 0) {
+        threads = thread::hardware_concurrency();
+    }
+    vector<thread> pool;
+    for (size_t t = 1; t < threads && t < count; ++t) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (thread& t : pool) {
+        t.join();
+    }
+    for (const exception_ptr& e : failed) {
+        if (e) {
+            rethrow_exception(e);
+        }
+    }
+
+    const Point start = position_;
+    bool left_behind = needle_left_behind_;
+    bool new_color = false;
+    bool placed = false;
+    for (size_t i = 0; i < count; ++i) {
+        new_color = new_color || composition.parts_[i].new_color;
+        if (drawn[i].points.empty()) {
+            continue;
+        }
+        EmbPoint at;
+        if (needle(at)) {
+            control_stitch(new_color ? STOP : TRIM, at);
+        }
+        new_color = false;
+        position_ = start;
+        needle_left_behind_ = placed || left_behind;
+        place(drawn[i]);
+        left_behind = needle_left_behind_ || !(position_ == start);
+        placed = true;
+    }
+    position_ = start;
+    needle_left_behind_ = left_behind;
+}
+
 // Utility functions for pringint, ending and saving embroidery files
 
 /** Print a Turtle object.
@@ -258,56 +682,457 @@ std::ostream& operator<<(std::ostream& os, const Turtle& t) {
  * doesn't read the file correctly.
  */
 void Turtle::end() {
+    if (stream_) {
+        const EmbPoint here{0, 0};
+        stream_stitches(&here, 1, END, true);
+        close_stream();
+        return;
+    }
     embPattern_addStitchRel(emb_, 0, 0, END, color_);
 }
 
+/** Write to the DST file `fname` while the design is being made.
+ * Each stitch is encoded as soon as it is produced instead of being kept,
+ * so memory use does not grow with the length of the design. Call this
+ * before the first stitch. end() finishes the file and save() is not needed;
+ * if density errors occurred or the file could not be written, end()
+ * removes it again.
+ * Returns false if the file cannot be opened.
+ */
+bool Turtle::stream(std::string fname) {
+    if (stream_ || !embStitchList_empty(emb_->stitchList)) {
+        cerr << "Turtle::stream(): must be called before the first stitch" << endl;
+        return false;
+    }
+    stream_ = embFile_open(fname.c_str(), "wb");
+    if (!stream_) {
+        cerr << "Turtle::stream(): cannot open " << fname << endl;
+        return false;
+    }
+    sink_ = writeDstSink(stream_);
+    if (!sink_.data) {
+        embFile_close(stream_);
+        stream_ = nullptr;
+        return false;
+    }
+    for (int i = 0; i < embThreadList_count(emb_->threadList); ++i) {
+        sink_.thread(sink_.data, &emb_->threadList->thread[i]);
+    }
+    stream_name_ = fname;
+    return true;
+}
+
 /** Save to `fname`.
  * Writes the Turtle's moves to an embroidery file called `fname`.
  * The extension on `fname` determines the embroidery format that is used.
  * For CS70, we will always use the `.dst` extension.
  */
 void Turtle::save(std::string fname) {
+    if (stream_) {
+        cerr << "Turtle::save(): the design is already being written to "
+             << stream_name_ << endl;
+        return;
+    }
+    if (density_ok("Not writing output file because density errors occurred:")) {
+        writeDst(emb_, fname.c_str());
+    }
+}
+
+// Lower-level functions, set to private
+
+// Prints the cells where too many stitches landed. Returns false if any
+// went over the error limit, after printing `error_heading` and those cells.
+bool Turtle::density_ok(const char* error_heading) {
     if (density_error_) {
-        cerr << "Not writing output file because density errors occurred:"
-             << endl;
-        for (const auto& entry : density_) {
-            if (entry.second > DENSITY_ERROR_LIMIT) {
-                cerr << "    " << entry.second << " stitches at " << entry.first
-                     << endl;
-            }
+        cerr << error_heading << endl;
+        for (const auto& cell : density_.cellsOver(DENSITY_ERROR_LIMIT)) {
+            cerr << "    " << cell.peak << " stitches at "
+                 << cell.cx * density_.cellSize() << "x"
+                 << cell.cy * density_.cellSize() << endl;
         }
-        return;
+        return false;
     }
 
     if (density_warning_) {
         cerr << "Use caution with output file; density warnings occurred:"
              << endl;
-        for (const auto& entry : density_) {
-            if (entry.second > DENSITY_WARN_LIMIT) {
-                cerr << "    * " << entry.second << " stitches at "
-                     << entry.first << endl;
+        for (const auto& cell : density_.cellsOver(DENSITY_WARN_LIMIT)) {
+            cerr << "    * " << cell.peak << " stitches at "
+                 << cell.cx * density_.cellSize() << "x"
+                 << cell.cy * density_.cellSize() << endl;
+        }
+    }
+    return true;
+}
+
+// Hands stitches to the DST sink instead of the pattern, by the rules
+// embPattern_addStitchAbs() and embPattern_addStitchRel() follow: the first
+// stitch is preceded by a jump from HOME, and a design with no stitches gets
+// no END. Positions are kept in double as the pattern keeps them, so the file
+// is the one save() would have written.
+void Turtle::stream_stitches(const EmbPoint* points, size_t count, int flags, bool relative) {
+    if (count == 0 || ((flags & END) && !streamed_any_)) {
+        return;
+    }
+    const int color = emb_->currentColorIndex;
+    outgoing_.clear();
+    if (!streamed_any_) {
+        EmbPoint home = embSettings_home(&emb_->settings);
+        outgoing_.push_back(EmbStitch{JUMP, home.xx, home.yy, color});
+        streamed_any_ = true;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        last_x_ = relative ? last_x_ + points[i].xx : points[i].xx;
+        last_y_ = relative ? last_y_ + points[i].yy : points[i].yy;
+        outgoing_.push_back(EmbStitch{flags, last_x_, last_y_, color});
+    }
+    sink_.stitches(sink_.data, outgoing_.data(), int(outgoing_.size()));
+}
+
+void Turtle::close_stream() {
+    const bool written = closeDstSink(&sink_) != 0;
+    const bool closed = embFile_close(stream_) == 0;
+    stream_ = nullptr;
+    if (!written || !closed) {
+        cerr << "Turtle::end(): cannot write " << stream_name_
+             << ", removing it" << endl;
+        remove(stream_name_.c_str());
+    } else if (!density_ok("Removing output file because density errors occurred:")) {
+        remove(stream_name_.c_str());
+    }
+}
+
+// Appends a call to the tape being recorded, if any. Returns true if the call
+// was recorded and should not be carried out.
+bool Turtle::recorded(TurtleTape::Op op, float a, float b, unsigned index) {
+    if (!tape_) {
+        return false;
+    }
+    tape_->commands_.push_back(TurtleTape::Command{op, index, a, b});
+    return true;
+}
+
+// Makes the calls on `tape` in coordinates whose origin is the current
+// position and whose x axis is the current heading, `factor` long.
+void Turtle::run(const TurtleTape& tape, float factor) {
+    const EmbTransform outer = transform_;
+    const size_t depth = stack_.size();
+    EmbTransform frame = embTransform_multiply(
+        embTransform_make(dir_.x_ * factor, dir_.y_ * factor,
+                          -dir_.y_ * factor, dir_.x_ * factor, 0, 0),
+        outer);
+    frame.e = position_.x_;
+    frame.f = position_.y_;
+    setTransform(frame);
+    dir_ = Point(1, 0);
+
+    for (const TurtleTape::Command& c : tape.commands_) {
+        switch (c.op) {
+            case TurtleTape::FORWARD: forward(c.a); break;
+            case TurtleTape::TURN: turn(c.a); break;
+            case TurtleTape::MOVE: move(Point(c.a, c.b)); break;
+            case TurtleTape::GOTO: gotopoint(Point(c.a, c.b)); break;
+            case TurtleTape::TURNTOWARD: turntoward(Point(c.a, c.b)); break;
+            case TurtleTape::SETDIR: setdir(Point(c.a, c.b)); break;
+            case TurtleTape::PENUP: penup(); break;
+            case TurtleTape::PENDOWN: pendown(); break;
+            case TurtleTape::SATINON: satinon(c.a); break;
+            case TurtleTape::SATINOFF: satinoff(); break;
+            case TurtleTape::STEPSIZE: setStepSize(c.a); break;
+            case TurtleTape::PLAY: play(*tape.tapes_[c.index], c.a); break;
+            case TurtleTape::MESSAGE: displayMessage(tape.messages_[c.index], c.a); break;
+            case TurtleTape::PUSH: push(); break;
+            case TurtleTape::POP: pop(); break;
+            case TurtleTape::TRANSLATE: translate(c.a, c.b); break;
+            case TurtleTape::ROTATE: rotate(c.a); break;
+            case TurtleTape::SCALE: scale(c.a, c.b); break;
+        }
+    }
+
+    // Hand the heading back in the coordinates the tape was played in
+    EmbPoint heading = embTransform_applyToVector(transform_, embPoint_make(dir_.x_, dir_.y_));
+    if (stack_.size() > depth) {
+        stack_.erase(stack_.begin() + depth, stack_.end());
+    }
+    setTransform(outer);
+    heading = embTransform_applyToVector(inverse_, heading);
+    dir_ = Point(heading.xx, heading.yy).normalize(1);
+}
+
+// Adds the stitches of `expansion` at the current position, turned by the
+// angle of `turn`, a run of equal flags at a time, and leaves the Turtle
+// where and as playing it did.
+void Turtle::place(const TurtleTape::Expansion& expansion, const Point& turn) {
+    const size_t count = expansion.points.size();
+    const Point start = position_;
+    const bool turned = !(turn == Point(1, 0));
+
+    if (needle_left_behind_ && count > 0) {
+        if (!(expansion.flags[0] & JUMP)) {
+            jump_to(position_);
+        }
+        needle_left_behind_ = false;
+    }
+    for (size_t i = 0; i < count;) {
+        size_t j = i;
+        placed_.clear();
+        while (j < count && expansion.flags[j] == expansion.flags[i]) {
+            EmbPoint p = expansion.points[j];
+            if (turned) {
+                p = EmbPoint{turn.x_ * p.xx - turn.y_ * p.yy, turn.y_ * p.xx + turn.x_ * p.yy};
             }
+            placed_.push_back(EmbPoint{start.x_ + p.xx, start.y_ + p.yy});
+            if (!capture_ && !(expansion.flags[j] & (JUMP | TRIM | STOP))) {
+                check_density(Point(placed_.back().xx, placed_.back().yy));
+            }
+            j++;
+        }
+        if (expansion.flags[i] & (TRIM | STOP)) {
+            for (const EmbPoint& p : placed_) {
+                control_stitch(expansion.flags[i], p);
+            }
+        } else if (capture_) {
+            for (const EmbPoint& p : placed_) {
+                capture_->points.push_back(p);
+                capture_->flags.push_back(expansion.flags[i]);
+            }
+        } else if (stream_) {
+            stream_stitches(placed_.data(), placed_.size(), expansion.flags[i], false);
+        } else {
+            embPattern_addStitchesAbs(emb_, placed_.data(), int(placed_.size()),
+                                      expansion.flags[i], color_);
         }
+        i = j;
     }
-    writeDst(emb_, fname.c_str());
+    if (turned) {
+        position_ = start + Point(turn.x_ * expansion.end_x - turn.y_ * expansion.end_y,
+                                  turn.y_ * expansion.end_x + turn.x_ * expansion.end_y);
+    } else {
+        position_ = start + Point(expansion.end_x, expansion.end_y);
+    }
+    dir_ = Point(expansion.dir_x, expansion.dir_y);
+    stepsize_ = expansion.stepsize;
+    satin_delta_ = expansion.satin_delta;
+    pen_is_down_ = expansion.pen_is_down;
+    satin_is_on_ = expansion.satin_is_on;
+    needle_left_behind_ = needle_left_behind_ || expansion.needle_left_behind;
 }
 
-// Lower-level functions, set to private
+// Finds where the needle is, which is not where the Turtle is after pop().
+// Returns false if nothing has been stitched yet.
+bool Turtle::needle(EmbPoint& at) const {
+    if (capture_) {
+        if (capture_->points.empty()) {
+            return false;
+        }
+        at = capture_->points.back();
+        return true;
+    }
+    if (stream_) {
+        at = EmbPoint{last_x_, last_y_};
+        return streamed_any_;
+    }
+    at = EmbPoint{emb_->lastX, emb_->lastY};
+    return !embStitchList_empty(emb_->stitchList);
+}
+
+// Adds a TRIM, or a STOP that moves on to the next thread color, at `at`.
+void Turtle::control_stitch(int flags, const EmbPoint& at) {
+    if (capture_) {
+        capture_->points.push_back(at);
+        capture_->flags.push_back(flags);
+        return;
+    }
+    if (flags & STOP) {
+        emb_->currentColorIndex++;
+    }
+    if (stream_) {
+        stream_stitches(&at, 1, flags, false);
+    } else {
+        embPattern_addStitchAbs(emb_, at.xx, at.yy, flags, color_);
+    }
+}
 
+// Returns the stitches of the letter `letter` drawn at `scale` with the
+// current coordinates and settings, starting with a jump and then with the
+// pen down if `pen_down`. Each is worked out once and shared by every Turtle,
+// so a name that has been drawn before only has to be moved into place.
+shared_ptr<const Turtle::Glyph> Turtle::glyph(char letter, float scale, bool pen_down) {
+    const GlyphKey key{transform_.a, transform_.b, transform_.c, transform_.d,
+                       scale, stepsize_, satin_delta_, letter, pen_down, satin_is_on_};
+    {
+        lock_guard<mutex> lock(glyphs_mutex_);
+        auto found = glyphs_.find(key);
+        if (found != glyphs_.end()) {
+            return found->second;
+        }
+    }
+
+    auto made = make_shared<Glyph>();
+    TurtleTape::Expansion* outer = capture_;
+    const Point start = position_;
+    const bool left_behind = needle_left_behind_;
+
+    capture_ = &made->stitches;
+    position_ = Point(0, 0);
+    needle_left_behind_ = false;
+    made->right = numeric_limits<float>::lowest();
+    pen_is_down_ = false;
+    for (const Point& p : Alphabet.at(letter)) {
+        move(p * scale);
+        EmbPoint user = embTransform_applyToVector(inverse_, embPoint_make(position_.x_, position_.y_));
+        if (user.xx > made->right)
+            made->right = user.xx;
+        pen_is_down_ = pen_down;
+    }
+    made->stitches.end_x = position_.x_;
+    made->stitches.end_y = position_.y_;
+    made->stitches.dir_x = dir_.x_;
+    made->stitches.dir_y = dir_.y_;
+    made->stitches.stepsize = stepsize_;
+    made->stitches.satin_delta = satin_delta_;
+    made->stitches.pen_is_down = pen_down;
+    made->stitches.satin_is_on = satin_is_on_;
+    made->stitches.needle_left_behind = false;
+    capture_ = outer;
+    position_ = start;
+    needle_left_behind_ = left_behind;
+
+    lock_guard<mutex> lock(glyphs_mutex_);
+    if (glyphs_.size() >= MAX_GLYPHS) {
+        glyphs_.clear();
+    }
+    return glyphs_.emplace(key, made).first->second;
+}
+
+// Moves to `pos`, in the pattern's coordinates, with the current pen
+// settings. Stitching starts with a jump if pop() left the needle elsewhere.
+// Unless `flush` is set the stitches stay queued, for the caller to hand
+// over with flush_stitches() along with those of later moves.
+void Turtle::go(const Point& pos, bool flush) {
+    if (pen_is_down_) {
+        if (needle_left_behind_) {
+            jump_to(position_);
+        }
+        if (satin_is_on_) {
+            satin_stitch_to(pos);
+        } else {
+            stitch_to(pos);
+        }
+        if (flush) {
+            flush_stitches();
+        }
+    } else {
+        jump_to(pos);
+    }
+}
+
+// Returns `v` turned `degreesccw` degrees the way turn() turns it. Each angle's
+// sine and cosine are worked out once, so recursive designs that keep turning
+// by the same few angles do no trigonometry after the first turn.
+Point Turtle::rotated(const Point& v, const float degreesccw) {
+    auto found = rotations_.find(degreesccw);
+    if (found == rotations_.end()) {
+        if (rotations_.size() >= MAX_ROTATIONS) {
+            rotations_.clear();
+        }
+        float radcw = -degreesccw / 180.0 * 3.141592653589;
+        found = rotations_.emplace(degreesccw, Rotation{cos(radcw), sin(radcw)}).first;
+    }
+    const Rotation& r = found->second;
+    return Point(r.c * v.x_ - r.s * v.y_, r.s * v.x_ + r.c * v.y_);
+}
+
+void Turtle::setTransform(const EmbTransform& transform) {
+    transform_ = transform;
+    transformed_ = !embTransform_isIdentity(transform);
+    embTransform_invert(transform, &inverse_);
+}
+
+// Maps the point `p` from the Turtle's coordinates to the pattern's.
+Point Turtle::toPattern(const Point& p) const {
+    if (!transformed_) {
+        return p;
+    }
+    EmbPoint q = embTransform_apply(transform_, embPoint_make(p.x_, p.y_));
+    return Point(q.xx, q.yy);
+}
+
+// Maps the direction or distance `v` from the Turtle's coordinates to the
+// pattern's.
+Point Turtle::toPatternVector(const Point& v) const {
+    if (!transformed_) {
+        return v;
+    }
+    EmbPoint q = embTransform_applyToVector(transform_, embPoint_make(v.x_, v.y_));
+    return Point(q.xx, q.yy);
+}
+
+// Queues a stitch `pos` away from the previous one. Queued stitches are
+// handed to the pattern in one go by flush_stitches(). Their positions are
+// summed in double from the last stitch, as embPattern_addStitchRel() would.
 void Turtle::stitch(const Point& pos) {
-    embPattern_addStitchRel(emb_, pos.x_, pos.y_, 0, color_);
+    if (capture_) {
+        position_ += pos;
+        capture_->points.push_back(EmbPoint{position_.x_, position_.y_});
+        capture_->flags.push_back(NORMAL);
+        return;
+    }
+    EmbPoint from;
+    if (!run_.empty()) {
+        from = run_.back();
+    } else if (stream_) {
+        from = EmbPoint{last_x_, last_y_};
+    } else if (embStitchList_empty(emb_->stitchList)) {
+        from = embSettings_home(&emb_->settings);
+    } else {
+        from = EmbPoint{emb_->lastX, emb_->lastY};
+    }
+    run_.push_back(EmbPoint{from.xx + pos.x_, from.yy + pos.y_});
     check_density(position_ + pos);
     position_ += pos;
 }
 
+void Turtle::flush_stitches() {
+    if (run_.empty()) {
+        return;
+    }
+    if (stream_) {
+        stream_stitches(run_.data(), run_.size(), NORMAL, false);
+    } else {
+        embPattern_addStitchesAbs(emb_, run_.data(), int(run_.size()), 0, color_);
+    }
+    run_.clear();
+}
+
+// Queues a stitch at `pos`, like stitch().
 void Turtle::stitch_abs(const Point& pos) {
-    embPattern_addStitchAbs(emb_, pos.x_, pos.y_, 0, color_);
+    if (capture_) {
+        capture_->points.push_back(EmbPoint{pos.x_, pos.y_});
+        capture_->flags.push_back(NORMAL);
+        position_ = pos;
+        return;
+    }
+    run_.push_back(EmbPoint{pos.x_, pos.y_});
     check_density(pos);
     position_ = pos;
 }
 
 void Turtle::jump_to(const Point& pos) {
-    embPattern_addStitchAbs(emb_, pos.x_, pos.y_, JUMP, color_);
+    flush_stitches();
+    needle_left_behind_ = false;
+    if (capture_) {
+        capture_->points.push_back(EmbPoint{pos.x_, pos.y_});
+        capture_->flags.push_back(JUMP);
+        position_ = pos;
+        return;
+    }
+    if (stream_) {
+        const EmbPoint p{pos.x_, pos.y_};
+        stream_stitches(&p, 1, JUMP, false);
+    } else {
+        embPattern_addStitchAbs(emb_, pos.x_, pos.y_, JUMP, color_);
+    }
     // check_density(pos);
     position_ = pos;
 }
@@ -318,6 +1143,7 @@ void Turtle::stitch_to(const Point& pos) {
 
     Point step = (pos - position_) / num_stitches;
 
+    run_.reserve(run_.size() + num_stitches + 1);
     for (size_t i = 0; i < num_stitches; ++i) {
         stitch(step);
     }
@@ -329,35 +1155,28 @@ void Turtle::satin_stitch_to(const Point& pos) {
     size_t num_stitches = abs(int(total_length / satin_delta_));
 
     Point step = (pos - position_) / num_stitches;
-    Point old_dir = dir_;
+    Point across = dir_;  // a quarter turn left of the way to `pos`
 
+    run_.reserve(run_.size() + 2 * num_stitches + 2);
     if (num_stitches > 0) {
-        turntoward(pos);
-        left(90);
-        stitch(dir_ * -stepsize_ / 2);
+        across = rotated((pos - position_).normalize(1), -90);
+        stitch(across * -stepsize_ / 2);
     }
 
     for (size_t i = 0; i < num_stitches; ++i) {
-        stitch(dir_ * stepsize_);
-        stitch(step + dir_ * -stepsize_);
+        stitch(across * stepsize_);
+        stitch(step + across * -stepsize_);
     }
     stitch_abs(pos);
-
-    dir_ = old_dir;
 }
 
 void Turtle::check_density(const Point& pos) {
-    string key = pos.tostr(DENSITY_PRECISION);
-    auto entry = density_.find(key);
-
-    if (entry == density_.end()) {
-        density_[key] = 1;
-        entry = density_.find(key);
-    } else {
-        entry->second++;
+    if (!density_check_) {
+        return;
     }
-    density_warning_ |= (entry->second > DENSITY_WARN_LIMIT);
-    density_error_ |= (entry->second > DENSITY_ERROR_LIMIT);
+    int count = density_.add(pos.x_, pos.y_);
+    density_warning_ |= (count > DENSITY_WARN_LIMIT);
+    density_error_ |= (count > DENSITY_ERROR_LIMIT);
 }
 
 /* Disabled functions -- we could use these at some point, but they feel too
@@ -526,16 +1345,14 @@ void Turtle::halfCircle(const Point& center, float radius, bool clockwise) {
     gotopoint(startPoint);
     pendown();
 
+    // sew the whole arc as one polyline
+    std::vector<Point> arc;
+    arc.reserve(numStitches > 0 ? numStitches : 0);
     for (int i = 1; i <= numStitches; ++i) {
         float angle = startAngle + angleIncrement * i;
-        Point stitchPoint(center.x_ + radius * cos(angle), center.y_ + radius * sin(angle));
-
-        if (satin_is_on_) {
-            satin_stitch_to(stitchPoint);
-        } else {
-            stitch_to(stitchPoint);
-        }
+        arc.push_back(Point(center.x_ + radius * cos(angle), center.y_ + radius * sin(angle)));
     }
+    polyline(arc);
 
     penup();
 }
@@ -1,10 +1,97 @@
 #ifndef turtlehincluded
 #define turtlehincluded
 
+#include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "emb-pattern.h"
+#include "emb-stream.h"
 #include "point.hpp"
-#include <map>
+#include "density.hpp"
+
+/*
+ * A recorded sequence of Turtle calls, see Turtle::record() and Turtle::play().
+ * Positions and directions on the tape are relative to where the Turtle stood
+ * when it started playing it: the origin is its position and the x axis its
+ * heading. The stitches a tape expands to are kept per scale and starting pen
+ * settings, so playing it again at any heading only has to turn and translate
+ * them. That takes the Turtle's coordinates to be turned, evenly scaled or
+ * flipped; under other transforms the stitches are kept per transform and
+ * heading as well.
+ */
+class TurtleTape {
+ public:
+    void clear();
+    size_t size() const;
+
+ private:
+    friend class Turtle;
+
+    enum Op : unsigned char {
+        FORWARD, TURN, MOVE, GOTO, TURNTOWARD, SETDIR,
+        PENUP, PENDOWN, SATINON, SATINOFF, STEPSIZE, PLAY, MESSAGE,
+        PUSH, POP, TRANSLATE, ROTATE, SCALE
+    };
+    struct Command {
+        Op op;
+        unsigned index;  // into tapes_ for PLAY, into messages_ for MESSAGE
+        float a;
+        float b;
+    };
+    static const size_t MAX_EXPANSIONS = 256;  // expansions kept per tape
+    struct Key {
+        double a, b, c, d;  // linear part of the transform the tape is expanded under
+        float stepsize, satin_delta;
+        bool pen_is_down, satin_is_on;
+        bool operator<(const Key& other) const;
+    };
+    struct Expansion {
+        std::vector<EmbPoint> points;  // relative to the starting position
+        std::vector<int> flags;
+        float end_x, end_y, dir_x, dir_y;
+        float stepsize, satin_delta;
+        bool pen_is_down, satin_is_on, needle_left_behind;
+    };
+
+    std::vector<Command> commands_;
+    std::vector<const TurtleTape*> tapes_;
+    std::vector<std::string> messages_;
+    mutable std::map<Key, std::shared_ptr<const Expansion>> expansions_;
+    static std::mutex expansions_mutex_;  // guards expansions_ of every tape
+};
+
+class Turtle;
+
+/*
+ * Parts of a design that can be drawn at the same time, each by a Turtle of
+ * its own, see Turtle::compose(). However they are drawn, the parts are sewn
+ * in the order they were added.
+ */
+class TurtleComposition {
+ public:
+    TurtleComposition();
+
+    void add(std::function<void(Turtle&)> part);
+    void changeColor();
+    void clear();
+    size_t size() const;
+
+ private:
+    friend class Turtle;
+
+    struct Part {
+        std::function<void(Turtle&)> draw;
+        bool new_color;  // sewn in the next thread color
+    };
+
+    std::vector<Part> parts_;
+    bool new_color_;
+};
 
 class Turtle {
  public:
@@ -16,6 +103,7 @@ class Turtle {
     void satinoff();
     void pendown();
     void penup();
+    void setDensityCheck(float cellsize, int radius);
     Point position();
 
     void turntoward(const Point& pos);
@@ -32,9 +120,25 @@ class Turtle {
     void gotopoint(const float x, const float y);
     void forward(const float dist);
     void backward(const float dist);
+    void polyline(const std::vector<Point>& points);
+    void polyline(const Point* points, size_t count);
+
+    void push();
+    void pop();
+    void translate(const float x, const float y);
+    void rotate(const float degreesccw);
+    void scale(const float factor);
+    void scale(const float x, const float y);
 
     void displayMessage(std::string message, float scale);
 
+    void record(TurtleTape& tape);
+    void stopRecording();
+    void play(const TurtleTape& tape, float scale = 1);
+
+    void compose(const TurtleComposition& composition, unsigned threads = 0);
+
+    bool stream(std::string fname);
     void save(std::string fname);
     void end();
 
@@ -45,15 +149,31 @@ class Turtle {
 
  private:
     void stitch(const Point& pos);
+    void flush_stitches();
     void stitch_abs(const Point& pos);
     void jump_to(const Point& pos);
     void stitch_to(const Point& pos);
     void satin_stitch_to(const Point& pos);
     void check_density(const Point& pos);
+    bool density_ok(const char* error_heading);
+    void stream_stitches(const EmbPoint* points, size_t count, int flags, bool relative);
+    void close_stream();
     void set_x(const float x);
     void set_y(const float y);
     void increment_x(const float x);
     void increment_y(const float y);
+    void go(const Point& pos, bool flush = true);
+    Point rotated(const Point& v, const float degreesccw);
+    void setTransform(const EmbTransform& transform);
+    Point toPattern(const Point& p) const;
+    Point toPatternVector(const Point& v) const;
+    bool recorded(TurtleTape::Op op, float a = 0, float b = 0, unsigned index = 0);
+    void run(const TurtleTape& tape, float factor);
+    void place(const TurtleTape::Expansion& expansion, const Point& turn = Point(1, 0));
+    struct Glyph;
+    std::shared_ptr<const Glyph> glyph(char letter, float scale, bool pen_down);
+    bool needle(EmbPoint& at) const;
+    void control_stitch(int flags, const EmbPoint& at);
     // void rectangle(float w, float h);
     // void circle(float radius);
     // void snowflake(float sidelength, int levels);
@@ -62,18 +182,67 @@ class Turtle {
     // void tree(int branch);
     // void svtree(float trunklength, int levels, float trunkwidth);
  private:
-    static const int DENSITY_PRECISION = 0;
+    static constexpr float DENSITY_CELL_SIZE = 1;
+    static const int DENSITY_RADIUS = 0;
     static const int DENSITY_WARN_LIMIT = 15;
     static const int DENSITY_ERROR_LIMIT = 20;
+
+    struct State {
+        Point position;
+        Point dir;
+        float stepsize;
+        float satin_delta;
+        bool pen_is_down;
+        bool satin_is_on;
+        EmbTransform transform;
+    };
+    static const size_t MAX_ROTATIONS = 4096;  // distinct angles remembered by rotated()
+    static const size_t MAX_GLYPHS = 4096;     // glyphs remembered by glyph()
+    struct Rotation {
+        float c;
+        float s;
+    };
+
+    struct GlyphKey {
+        double a, b, c, d;  // linear part of the Turtle's transform
+        float scale, stepsize, satin_delta;
+        char letter;
+        bool pen_is_down, satin_is_on;
+        bool operator<(const GlyphKey& other) const;
+    };
+    struct Glyph {
+        TurtleTape::Expansion stitches;  // relative to where the glyph starts
+        float right;  // farthest x reached, relative to the start, in the Turtle's coordinates
+    };
+    static std::map<GlyphKey, std::shared_ptr<const Glyph>> glyphs_;  // shared by every Turtle
+    static std::mutex glyphs_mutex_;
+
     EmbPattern* emb_;
     float stepsize_;
     int color_;
     bool pen_is_down_;
     bool satin_is_on_;
     float satin_delta_;
-    Point dir_;
-    Point position_;
-    std::map<std::string, int> density_;
+    Point dir_;            // in the Turtle's own coordinates
+    Point position_;       // in the pattern's coordinates
+    EmbTransform transform_;  // from the Turtle's coordinates to the pattern's
+    EmbTransform inverse_;
+    bool transformed_;     // transform_ is not the identity
+    bool needle_left_behind_;  // pop() moved the Turtle away from the last stitch
+    std::vector<State> stack_;
+    std::unordered_map<float, Rotation> rotations_;
+    std::vector<EmbPoint> run_;
+    TurtleTape* tape_;                    // being recorded, or null
+    TurtleTape::Expansion* capture_;      // stitches go here instead of emb_ while a tape is expanded
+    std::vector<EmbPoint> placed_;
+    EmbFile* stream_;                     // DST file written as stitches are made, or null
+    std::string stream_name_;
+    EmbStitchSink sink_;
+    std::vector<EmbStitch> outgoing_;
+    double last_x_, last_y_;              // last stitch handed to sink_
+    bool streamed_any_;
+    DensityGrid density_;
+    bool density_check_;
     bool density_error_;
     bool density_warning_;
 };
@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "emb-analysis.h"
+
+using namespace std;
+
+// Analysis test: embPattern_analyze() must count a pattern it was shown by
+// hand, and give the same answer whether its blocks are run on one thread,
+// on several, or out of order, even where ties and first violations fall on
+// either side of a block edge. Lengths it cannot measure must not turn into
+// JSON that does not parse.
+//
+// Exits 0 if every check passed.
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    fprintf(stderr, "FAILED %s\n", what);
+    failures++;
+  }
+}
+
+static bool near(double a, double b) {
+  return fabs(a - b) < 1e-6 * (1 + fabs(a));
+}
+
+/** Runs the work items on a few threads, as a caller of the library would. */
+static void inThreads(int count, void (*work)(void*, int), void* arg, void* data) {
+  (*static_cast<int*>(data))++;
+  atomic<int> next{0};
+  auto run = [&] {
+    for (int i; (i = next++) < count;) {
+      work(arg, i);
+    }
+  };
+  vector<thread> helpers;
+  for (int t = 1; t < 8; t++) {
+    helpers.emplace_back(run);
+  }
+  run();
+  for (auto& helper : helpers) {
+    helper.join();
+  }
+}
+
+/** Runs the work items last to first, so no block can lean on the one before. */
+static void backwards(int count, void (*work)(void*, int), void* arg, void* data) {
+  (*static_cast<int*>(data))++;
+  for (int i = count - 1; i >= 0; i--) {
+    work(arg, i);
+  }
+}
+
+/** Returns the line embPatternAnalysis_writeJson() writes for a. */
+static string json(const EmbPatternAnalysis& a) {
+  EmbFile* file = embFile_openBuffer();
+  embPatternAnalysis_writeJson(&a, file);
+  string text(reinterpret_cast<const char*>(file->data), file->size);
+  embFile_close(file);
+  return text;
+}
+
+/** Returns true if a and b agree on everything, lengths to the last bit. */
+static bool same(const EmbPatternAnalysis& a, const EmbPatternAnalysis& b) {
+  if (a.colorCount != b.colorCount) {
+    return false;
+  }
+  for (int c = 0; c < a.colorCount; c++) {
+    if (a.colors[c].stitchCount != b.colors[c].stitchCount ||
+        a.colors[c].threadLength != b.colors[c].threadLength) {
+      return false;
+    }
+  }
+  return a.stitchCount == b.stitchCount && a.sewnCount == b.sewnCount && a.jumpCount == b.jumpCount &&
+         a.trimCount == b.trimCount && a.stopCount == b.stopCount && a.colorChangeCount == b.colorChangeCount &&
+         a.extents.left == b.extents.left && a.extents.top == b.extents.top &&
+         a.extents.right == b.extents.right && a.extents.bottom == b.extents.bottom &&
+         a.sewLength == b.sewLength && a.jumpLength == b.jumpLength &&
+         a.longestStitch == b.longestStitch && a.longestStitchIndex == b.longestStitchIndex &&
+         a.longestJump == b.longestJump && a.longestJumpIndex == b.longestJumpIndex &&
+         a.longStitchCount == b.longStitchCount && a.firstLongStitch == b.firstLongStitch &&
+         a.longJumpCount == b.longJumpCount && a.firstLongJump == b.firstLongJump &&
+         a.tooManyStitches == b.tooManyStitches;
+}
+
+/** Checks a small pattern whose every figure was worked out by hand. */
+static void handBuilt() {
+  EmbPattern* p = embPattern_create();
+  embPattern_addThread(p, EmbThread{embColor_make(255, 0, 0), "Red", "1"});
+  embPattern_addThread(p, EmbThread{embColor_make(0, 128, 0), "Green", "2"});
+  const EmbStitch stitches[] = {
+    {JUMP, 0, 0, 0},
+    {NORMAL, 3, 4, 0},   // sewn 5
+    {NORMAL, 3, 0, 0},   // sewn 4
+    {TRIM, -7, 0, 0},    // a move of 10, left out of the extents
+    {JUMP, 13, 0, 0},    // a move of 20
+    {STOP, 13, 0, 1},
+    {NORMAL, 13, 6, 1},  // sewn 6
+    {NORMAL, 16, 10, 2}, // sewn 5, in a color with no thread
+    {END, 16, 10, 2},
+  };
+  embPattern_appendStitches(p, stitches, 9);
+
+  const EmbMachineLimits limits{5.5, 12, 8};
+  EmbPatternAnalysis a;
+  check(embPattern_analyze(p, &limits, 0, 0, &a), "hand-built pattern analyzed");
+  check(a.stitchCount == 9 && a.sewnCount == 4 && a.jumpCount == 2 && a.trimCount == 1 && a.stopCount == 1,
+        "hand-built stitch counts");
+  check(a.colorChangeCount == 2, "hand-built color changes");
+  check(a.extents.left == 0 && a.extents.top == 0 && a.extents.right == 16 && a.extents.bottom == 10,
+        "hand-built extents");
+  check(near(a.sewLength, 20) && near(a.jumpLength, 30), "hand-built lengths");
+  check(near(a.longestStitch, 6) && a.longestStitchIndex == 6, "hand-built longest stitch");
+  check(near(a.longestJump, 20) && a.longestJumpIndex == 4, "hand-built longest jump");
+  check(a.colorCount == 3, "hand-built color count");
+  if (a.colorCount == 3) {
+    check(a.colors[0].stitchCount == 2 && near(a.colors[0].threadLength, 9) && a.colors[0].hasThread,
+          "hand-built first color");
+    check(a.colors[1].stitchCount == 1 && near(a.colors[1].threadLength, 6) && a.colors[1].hasThread,
+          "hand-built second color");
+    check(a.colors[2].stitchCount == 1 && near(a.colors[2].threadLength, 5) && !a.colors[2].hasThread,
+          "hand-built color with no thread");
+  }
+  check(a.longStitchCount == 1 && a.firstLongStitch == 6, "hand-built long stitches");
+  check(a.longJumpCount == 1 && a.firstLongJump == 4, "hand-built long jumps");
+  check(a.tooManyStitches && embPatternAnalysis_violationCount(&a) == 3, "hand-built violations");
+  check(json(a) ==
+        "{\"stitchCount\":9,\"sewnCount\":4,\"jumpCount\":2,\"trimCount\":1,\"stopCount\":1,\"colorChangeCount\":2,"
+        "\"extents\":{\"left\":0.000,\"top\":0.000,\"right\":16.000,\"bottom\":10.000},"
+        "\"sewLength\":20.000,\"jumpLength\":30.000,"
+        "\"longestStitch\":{\"length\":6.000,\"index\":6},\"longestJump\":{\"length\":20.000,\"index\":4},"
+        "\"colors\":[{\"index\":0,\"stitchCount\":2,\"threadLength\":9.000,\"thread\":\"#ff0000\"},"
+        "{\"index\":1,\"stitchCount\":1,\"threadLength\":6.000,\"thread\":\"#008000\"},"
+        "{\"index\":2,\"stitchCount\":1,\"threadLength\":5.000,\"thread\":null}],"
+        "\"limits\":{\"maxStitchLength\":5.500,\"maxJumpLength\":12.000,\"maxStitchCount\":8},"
+        "\"violations\":{\"longStitches\":{\"count\":1,\"first\":6},\"longJumps\":{\"count\":1,\"first\":4},"
+        "\"tooManyStitches\":true}}\n",
+        "hand-built JSON");
+  embPatternAnalysis_free(&a);
+  embPattern_free(p);
+}
+
+/** Checks that lengths that are not finite are written as null. */
+static void notFinite() {
+  EmbPattern* p = embPattern_create();
+  const EmbStitch stitches[] = {
+    {JUMP, 0, 0, 0},
+    {NORMAL, INFINITY, 0, 0},
+    {NORMAL, NAN, 0, 0},
+  };
+  embPattern_appendStitches(p, stitches, 3);
+  EmbPatternAnalysis a;
+  check(embPattern_analyze(p, 0, 0, 0, &a), "pattern at infinity analyzed");
+  string text = json(a);
+  check(text.find("inf") == string::npos && text.find("nan") == string::npos, "no inf or nan in JSON");
+  check(text.find("\"sewLength\":null") != string::npos, "infinite sewn length written as null");
+  check(text.find("\"threadLength\":null") != string::npos, "infinite thread length written as null");
+  embPatternAnalysis_free(&a);
+  embPattern_free(p);
+}
+
+/** Checks a pattern large enough to be analyzed in parallel against its
+ *  serial analysis and against figures counted here in one plain walk. */
+static void parallel() {
+  const int B = EMB_ANALYSIS_BLOCK;
+  const int count = EMB_ANALYSIS_PARALLEL_STITCHES + 2 * B + 100;
+  // Equally long stitches and moves on both sides of block edges: the first
+  // of each must win, and be the first violation of the limits below
+  const vector<int> longStitches{B, 2 * B - 1, 3 * B, 4 * B + 5};
+  const vector<int> longJumps{B - 1, 2 * B, 4 * B, 5 * B - 1};
+
+  vector<EmbStitch> stitches;
+  double x = 0;
+  int color = 0;
+  vector<int> colorStitches(3);
+  vector<double> colorLengths(3);
+  for (int i = 0; i < count; i++) {
+    double step = 1 + (i % 7) * 0.125;
+    int flags = NORMAL;
+    if (find(longStitches.begin(), longStitches.end(), i) != longStitches.end()) {
+      step = 3;
+    } else if (find(longJumps.begin(), longJumps.end(), i) != longJumps.end() || i == 0) {
+      step = i ? 9 : 0;
+      flags = JUMP;
+    } else if (i % 1000 == 999) {
+      flags = TRIM;
+    }
+    if (i % 5000 == 0) {
+      color = (color + 1) % 3;  // changes land inside blocks and next to their edges
+    }
+    if (i == B || i == 3 * B) {
+      color = (color + 1) % 3;
+    }
+    x += step;
+    stitches.push_back(EmbStitch{flags, x, (i % 2) * 0.5, color});
+    if (flags == NORMAL) {
+      colorStitches[color]++;
+      colorLengths[color] += sqrt(step * step + 0.25);
+    }
+  }
+  stitches.push_back(EmbStitch{END, x, 0, color});
+  EmbPattern* p = embPattern_create();
+  embPattern_appendStitches(p, stitches.data(), int(stitches.size()));
+
+  const EmbMachineLimits limits{2.5, 8, 0};
+  EmbPatternAnalysis serial, threaded, reversed;
+  int calls = 0;
+  check(embPattern_analyze(p, &limits, 0, 0, &serial), "large pattern analyzed serially");
+  check(embPattern_analyze(p, &limits, inThreads, &calls, &threaded), "large pattern analyzed in threads");
+  check(embPattern_analyze(p, &limits, backwards, &calls, &reversed), "large pattern analyzed backwards");
+  check(calls == 2, "parallel-for used for a large pattern");
+
+  check(same(serial, threaded), "threaded analysis matches the serial one");
+  check(same(serial, reversed), "backwards analysis matches the serial one");
+  check(json(serial) == json(threaded), "threaded JSON matches the serial one");
+
+  check(serial.longestStitchIndex == longStitches[0] && near(serial.longestStitch, sqrt(9.25)),
+        "tied longest stitch keeps the first, across a block edge");
+  check(serial.longestJumpIndex == longJumps[0] && near(serial.longestJump, sqrt(81.25)),
+        "tied longest jump keeps the first, across a block edge");
+  check(serial.longStitchCount == int(longStitches.size()) && serial.firstLongStitch == longStitches[0],
+        "long stitches counted across blocks");
+  check(serial.longJumpCount == int(longJumps.size()) && serial.firstLongJump == longJumps[0],
+        "long jumps counted across blocks");
+  check(serial.colorCount == 3, "large pattern color count");
+  int sewn = 0;
+  for (int c = 0; c < serial.colorCount && c < 3; c++) {
+    check(serial.colors[c].stitchCount == colorStitches[c], "per-color stitch count");
+    check(near(serial.colors[c].threadLength, colorLengths[c]), "per-color thread length");
+    sewn += colorStitches[c];
+  }
+  check(serial.sewnCount == sewn, "large pattern sewn count");
+
+  embPatternAnalysis_free(&serial);
+  embPatternAnalysis_free(&threaded);
+  embPatternAnalysis_free(&reversed);
+  embPattern_free(p);
+
+  // Below the threshold the parallel-for is not worth calling
+  p = embPattern_create();
+  embPattern_appendStitches(p, stitches.data(), EMB_ANALYSIS_PARALLEL_STITCHES - 1);
+  calls = 0;
+  check(embPattern_analyze(p, &limits, inThreads, &calls, &serial) && calls == 0,
+        "parallel-for not used for a small pattern");
+  embPatternAnalysis_free(&serial);
+  embPattern_free(p);
+}
+
+int main() {
+  handBuilt();
+  notFinite();
+  parallel();
+
+  printf("analysis: %s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
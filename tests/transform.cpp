@@ -0,0 +1,208 @@
+#include <cmath>
+#include <cstdio>
+
+#include "emb-pattern.h"
+
+// Transform test: stitches added after a pattern has been transformed must
+// continue from where its last stitch was moved to, and views must refuse
+// stitches they do not have. Circles, ellipses and rects must keep their
+// shape through turns, uneven scales and flips, changing type where they
+// can no longer be described as they were.
+//
+// Exits 0 if every check passed.
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    fprintf(stderr, "FAILED %s\n", what);
+    failures++;
+  }
+}
+
+static bool near(double a, double b) {
+  return fabs(a - b) < 1e-9;
+}
+
+/** Returns a pattern of a few stitches ending at (4, 8). */
+static EmbPattern* sample() {
+  EmbPattern* p = embPattern_create();
+  embPattern_addStitchAbs(p, 0, 0, JUMP, 1);
+  embPattern_addStitchAbs(p, 2, 3, NORMAL, 1);
+  embPattern_addStitchRel(p, 2, 5, NORMAL, 1);
+  return p;
+}
+
+/** Returns the last stitch of p. */
+static EmbStitch last(EmbPattern* p) {
+  return *embStitchList_last(p->stitchList);
+}
+
+/** Returns true if the angles a and b, in degrees, point along the same axis. */
+static bool sameAxis(double a, double b) {
+  double turns = (a - b) / 180;
+  return fabs(turns - round(turns)) < 1e-9;
+}
+
+/** Checks what becomes of circles and ellipses under each kind of transform. */
+static void roundObjects() {
+  EmbPattern* p = embPattern_create();
+  embPattern_addCircleObjectAbs(p, 3, 4, 2);
+  embPattern_transform(p, embTransform_rotate(90));
+  check(p->circleObjList && !p->ellipseObjList, "circle stays a circle when turned");
+  if (p->circleObjList) {
+    EmbCircle c = p->circleObjList->circleObj.circle;
+    check(near(c.centerX, -4) && near(c.centerY, 3) && near(c.radius, 2), "circle turned about the origin");
+  }
+  embPattern_flipHorizontal(p);
+  check(p->circleObjList && !p->ellipseObjList, "circle stays a circle when flipped");
+  if (p->circleObjList) {
+    EmbCircle c = p->circleObjList->circleObj.circle;
+    check(near(c.centerX, 4) && near(c.centerY, 3) && near(c.radius, 2), "circle flipped");
+  }
+  embPattern_transform(p, embTransform_scale(3, 1));
+  check(!p->circleObjList && p->ellipseObjList && !p->ellipseObjList->next,
+        "circle becomes an ellipse when scaled unevenly");
+  if (p->ellipseObjList) {
+    EmbEllipseObject e = p->ellipseObjList->ellipseObj;
+    check(near(e.ellipse.centerX, 12) && near(e.ellipse.centerY, 3), "ellipse from a circle centered");
+    check(near(e.ellipse.radiusX, 6) && near(e.ellipse.radiusY, 2) && sameAxis(e.rotation, 0),
+          "ellipse from a circle has the scaled radii");
+  }
+  embPattern_free(p);
+
+  p = embPattern_create();
+  embPattern_addEllipseObjectAbs(p, 0, 0, 3, 1);
+  embPattern_transform(p, embTransform_rotate(30));
+  if (p->ellipseObjList) {
+    EmbEllipseObject e = p->ellipseObjList->ellipseObj;
+    check(near(e.ellipse.radiusX, 3) && near(e.ellipse.radiusY, 1) && sameAxis(e.rotation, 30),
+          "ellipse turned keeps its radii");
+  }
+  embPattern_transform(p, embTransform_rotate(60));
+  embPattern_transform(p, embTransform_scale(2, 1));
+  if (p->ellipseObjList) {
+    // Its long axis is now along y, which the scale leaves alone
+    EmbEllipseObject e = p->ellipseObjList->ellipseObj;
+    check(near(e.ellipse.radiusX, 3) && near(e.ellipse.radiusY, 2) && sameAxis(e.rotation, 90),
+          "turned ellipse scaled unevenly");
+  }
+  embPattern_flipVertical(p);
+  if (p->ellipseObjList) {
+    EmbEllipseObject e = p->ellipseObjList->ellipseObj;
+    check(near(e.ellipse.radiusX, 3) && near(e.ellipse.radiusY, 2) && sameAxis(e.rotation, 90),
+          "turned ellipse flipped");
+  }
+  embPattern_free(p);
+
+  p = embPattern_create();
+  embPattern_addEllipseObjectAbs(p, 0, 0, 3, 1);
+  embPattern_transform(p, embTransform_scale(2, -1));
+  if (p->ellipseObjList) {
+    EmbEllipseObject e = p->ellipseObjList->ellipseObj;
+    check(near(e.ellipse.radiusX, 6) && near(e.ellipse.radiusY, 1) && e.rotation == 0,
+          "ellipse scaled unevenly along its axes");
+  }
+  embPattern_transform(p, embTransform_rotate(90));
+  if (p->ellipseObjList) {
+    EmbEllipseObject e = p->ellipseObjList->ellipseObj;
+    check(near(e.ellipse.radiusX, 1) && near(e.ellipse.radiusY, 6) && e.rotation == 0,
+          "quarter turn swaps the radii of an ellipse");
+  }
+  embPattern_free(p);
+}
+
+/** Checks what becomes of rects under each kind of transform. */
+static void rects() {
+  EmbPattern* p = embPattern_create();
+  embPattern_addRectObjectAbs(p, 1, 2, 4, 3);
+  embPattern_flipVertical(p);
+  check(p->rectObjList && !p->polygonObjList, "rect stays a rect when flipped");
+  if (p->rectObjList) {
+    // As flips have always done it: the corners are flipped where they are
+    EmbRectObject r = p->rectObjList->rectObj;
+    check(near(r.rect.left, 1) && near(r.rect.right, 5) && near(r.rect.top, -2) && near(r.rect.bottom, -5),
+          "flipped rect has its corners flipped");
+    check(r.rotation == 0, "flipped rect is not turned");
+  }
+  embPattern_free(p);
+
+  p = embPattern_create();
+  embPattern_addRectObjectAbs(p, -2, -1, 4, 2);
+  embPattern_transform(p, embTransform_translate(10, 0));
+  embPattern_transform(p, embTransform_rotate(30));
+  check(p->rectObjList && !p->polygonObjList, "rect stays a rect when turned");
+  if (p->rectObjList) {
+    EmbRectObject r = p->rectObjList->rectObj;
+    check(near(embRect_width(r.rect), 4) && near(embRect_height(r.rect), 2), "turned rect keeps its size");
+    check(near((r.rect.left + r.rect.right) / 2, 10 * cos(M_PI / 6)) &&
+          near((r.rect.top + r.rect.bottom) / 2, 10 * sin(M_PI / 6)),
+          "turned rect turned about the origin");
+    check(near(r.rotation, 30), "turned rect has the turn");
+  }
+  embPattern_flipVertical(p);
+  if (p->rectObjList) {
+    check(near(p->rectObjList->rectObj.rotation, -30), "flipping a turned rect reverses its turn");
+  }
+  embPattern_free(p);
+
+  p = embPattern_create();
+  embPattern_addRectObjectAbs(p, -2, -1, 4, 2);
+  embPattern_transform(p, embTransform_rotate(30));
+  embPattern_transform(p, embTransform_scale(2, 1));
+  check(!p->rectObjList && p->polygonObjList && !p->polygonObjList->next,
+        "turned rect becomes a polygon when scaled unevenly");
+  if (p->polygonObjList) {
+    const double corners[4][2] = {{-2, -1}, {2, -1}, {2, 1}, {-2, 1}};
+    const double c = cos(M_PI / 6), s = sin(M_PI / 6);
+    EmbPointList* point = p->polygonObjList->polygonObj->pointList;
+    int i = 0;
+    for (; point && i < 4; point = point->next, i++) {
+      double x = 2 * (corners[i][0] * c - corners[i][1] * s);
+      double y = corners[i][0] * s + corners[i][1] * c;
+      check(near(point->point.xx, x) && near(point->point.yy, y), "polygon from a rect has its corners");
+    }
+    check(i == 4 && !point, "polygon from a rect has four corners");
+  }
+  embPattern_free(p);
+}
+
+int main() {
+  EmbPattern* p = sample();
+  embPattern_flipVertical(p);
+  embPattern_addStitchRel(p, 1, 0, NORMAL, 1);
+  check(near(last(p).xx, 5) && near(last(p).yy, -8), "stitch added after flipVertical");
+  embPattern_addStitchRel(p, 0, 0, END, 1);
+  check(near(last(p).xx, 5) && near(last(p).yy, -8), "END added after flipVertical");
+  embPattern_free(p);
+
+  p = sample();
+  embPattern_transform(p, embTransform_translate(10, -2));
+  embPattern_addStitchRel(p, 1, 1, NORMAL, 1);
+  check(near(last(p).xx, 15) && near(last(p).yy, 7), "stitch added after a translation");
+  embPattern_free(p);
+
+  p = sample();
+  embPattern_transform(p, embTransform_rotate(90));
+  embPattern_addStitchRel(p, 1, 0, NORMAL, 1);
+  check(near(last(p).xx, -7) && near(last(p).yy, 4), "stitch added after a rotation");
+  embPattern_free(p);
+
+  p = sample();
+  EmbPatternView view = embPattern_view(p, embTransform_scale(2, 2));
+  EmbStitch s = embPatternView_stitch(&view, embPatternView_stitchCount(&view) - 1);
+  check(near(s.xx, 8) && near(s.yy, 16), "stitch seen through a view");
+  s = embPatternView_stitch(&view, embPatternView_stitchCount(&view));
+  check(s.flags == 0 && s.xx == 0 && s.yy == 0 && s.color == 0, "stitch past the end of a view");
+  s = embPatternView_stitch(&view, -1);
+  check(s.flags == 0 && s.xx == 0 && s.yy == 0 && s.color == 0, "stitch before the start of a view");
+  s = embPatternView_stitch(0, 0);
+  check(s.flags == 0 && s.xx == 0 && s.yy == 0 && s.color == 0, "stitch of a null view");
+  embPattern_free(p);
+
+  roundObjects();
+  rects();
+
+  printf("transform: %s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}